@@ -0,0 +1,112 @@
+#include <nalchi/bit_stream.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+#ifndef BS_BENCH_ELEMENTS
+#define BS_BENCH_ELEMENTS 4096
+#endif
+
+#ifndef BS_BENCH_ROUNDS
+#define BS_BENCH_ROUNDS 20000
+#endif
+
+namespace nalchi::benchmarks
+{
+
+using clock_type = std::chrono::steady_clock;
+
+/// @brief Measures the write & read time per element, with one by one writes & reads and packed array ones.
+/// @tparam Int Integer type of the elements.
+/// @param name Name of the array to print.
+/// @param min Minimum value allowed for each element.
+/// @param max Maximum value allowed for each element.
+/// @param seed Seed to run the rng.
+template <typename Int>
+void run(const char* name, const Int min, const Int max, const std::uint64_t seed)
+{
+    using word_type = bit_stream_writer::word_type;
+    using size_type = bit_stream_writer::size_type;
+
+    std::mt19937_64 rng(seed);
+    std::vector<Int> data(BS_BENCH_ELEMENTS);
+    for (auto& elem : data)
+        elem = static_cast<Int>(std::uniform_int_distribution<std::int64_t>(min, max)(rng));
+
+    bit_stream_measurer measurer;
+    measurer.write_array(std::span<const Int>(data), min, max);
+    const size_type bytes = measurer.used_bytes();
+    std::vector<word_type> buffer((bytes + sizeof(word_type) - 1) / sizeof(word_type));
+
+    std::vector<Int> read_data(data.size());
+    std::uint64_t checksum = 0;
+
+    auto measure = [&](auto&& func) -> double {
+        const auto begin = clock_type::now();
+        for (int round = 0; round < BS_BENCH_ROUNDS; ++round)
+            func();
+        const auto end = clock_type::now();
+
+        return std::chrono::duration<double, std::nano>(end - begin).count() / (double(data.size()) * BS_BENCH_ROUNDS);
+    };
+
+    const double write_ns = measure([&] {
+        bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (const Int elem : data)
+            writer.write(elem, min, max);
+        if (!writer.flush_final())
+            std::exit(1);
+    });
+    const double read_ns = measure([&] {
+        bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (Int& elem : read_data)
+            reader.read(elem, min, max);
+        if (reader.fail())
+            std::exit(1);
+        checksum += static_cast<std::uint64_t>(read_data.back());
+    });
+    const double write_array_ns = measure([&] {
+        bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        writer.write_array(std::span<const Int>(data), min, max);
+        if (!writer.flush_final())
+            std::exit(1);
+    });
+    const double read_array_ns = measure([&] {
+        bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        reader.read_array(std::span<Int>(read_data), min, max);
+        if (reader.fail())
+            std::exit(1);
+        checksum += static_cast<std::uint64_t>(read_data.back());
+    });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << name << ":\n";
+    std::cout << "\twrite:       " << write_ns << " ns/element\n";
+    std::cout << "\twrite_array: " << write_array_ns << " ns/element\n";
+    std::cout << "\tread:        " << read_ns << " ns/element\n";
+    std::cout << "\tread_array:  " << read_array_ns << " ns/element\n";
+    std::cout << "\t(checksum = " << checksum << ")\n";
+}
+
+} // namespace nalchi::benchmarks
+
+int main(int argc, char** argv)
+{
+    using namespace nalchi::benchmarks;
+
+    const std::uint64_t seed = (argc > 1) ? static_cast<std::uint64_t>(std::atoll(argv[1])) : 42;
+
+    std::cout << "=== bit_stream packed array benchmark ===\n";
+    std::cout << BS_BENCH_ELEMENTS << " elements * " << BS_BENCH_ROUNDS << " rounds, seed = " << seed << "\n";
+
+    run<std::uint8_t>("uint8_t tile IDs in [0, 100]", 0, 100, seed);
+    run<std::uint16_t>("uint16_t tile IDs in [0, 1000]", 0, 1000, seed);
+    run<std::int32_t>("int32_t health buckets in [-10, 20]", -10, 20, seed);
+}
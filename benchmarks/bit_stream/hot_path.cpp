@@ -0,0 +1,140 @@
+#include <nalchi/bit_stream.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#ifndef BS_BENCH_FIELDS
+#define BS_BENCH_FIELDS 4096
+#endif
+
+#ifndef BS_BENCH_ROUNDS
+#define BS_BENCH_ROUNDS 20000
+#endif
+
+namespace nalchi::benchmarks
+{
+
+using clock_type = std::chrono::steady_clock;
+
+/// @brief Gets the name of the configuration this benchmark is built with.
+///
+/// Build this benchmark with each configuration, and compare the results.
+/// @return Name of the configuration.
+constexpr auto config_name() -> const char*
+{
+#if defined(NALCHI_INLINE_HOT_PATH)
+    return "inline hot path";
+#elif defined(NALCHI_BUILD_STATIC)
+    return "static library";
+#else
+    return "shared library";
+#endif
+}
+
+/// @brief Field with a range, whose bit width is between 1 and 32 bits.
+struct field
+{
+    std::uint32_t value;
+    std::uint32_t max;
+};
+
+/// @brief Generates fields, so that most of the writes cross the word boundary at some point.
+/// @param seed Seed to run the rng.
+/// @return Generated fields.
+auto generate_fields(const std::uint64_t seed) -> std::vector<field>
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> bits_dist(1, 32);
+
+    std::vector<field> fields(BS_BENCH_FIELDS);
+    for (auto& f : fields)
+    {
+        const int bits = bits_dist(rng);
+        f.max = (bits == 32) ? ~std::uint32_t(0) : (std::uint32_t(1) << bits) - 1;
+        f.value = std::uniform_int_distribution<std::uint32_t>(0, f.max)(rng);
+    }
+
+    return fields;
+}
+
+/// @brief Measures the write & read time per field.
+/// @param fields Fields to write & read.
+void run(const std::vector<field>& fields)
+{
+    using word_type = bit_stream_writer::word_type;
+
+    const std::size_t bytes = 4 * fields.size();
+    std::vector<word_type> buffer(bytes / sizeof(word_type));
+
+    // Measure writes.
+    bit_stream_writer::size_type used_bytes = 0;
+    const auto write_begin = clock_type::now();
+    for (int round = 0; round < BS_BENCH_ROUNDS; ++round)
+    {
+        bit_stream_writer writer(buffer.data(), buffer.size(), static_cast<bit_stream_writer::size_type>(bytes));
+        for (const auto& f : fields)
+            writer.write(f.value, std::uint32_t(0), f.max);
+        writer.flush_final();
+
+        if (writer.fail())
+        {
+            std::cout << "writer failed\n";
+            std::exit(1);
+        }
+        used_bytes = writer.used_bytes();
+    }
+    const auto write_end = clock_type::now();
+
+    // Measure reads.
+    std::uint64_t checksum = 0;
+    const auto read_begin = clock_type::now();
+    for (int round = 0; round < BS_BENCH_ROUNDS; ++round)
+    {
+        bit_stream_reader reader(buffer.data(), buffer.size(), used_bytes);
+        for (const auto& f : fields)
+        {
+            std::uint32_t value = 0;
+            reader.read(value, std::uint32_t(0), f.max);
+            checksum += value;
+        }
+
+        if (reader.fail())
+        {
+            std::cout << "reader failed\n";
+            std::exit(1);
+        }
+    }
+    const auto read_end = clock_type::now();
+
+    const double total_fields = double(fields.size()) * BS_BENCH_ROUNDS;
+
+    const double write_ns = std::chrono::duration<double, std::nano>(write_end - write_begin).count();
+    const double read_ns = std::chrono::duration<double, std::nano>(read_end - read_begin).count();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "\twrite: " << write_ns / total_fields << " ns/field\n";
+    std::cout << "\tread:  " << read_ns / total_fields << " ns/field\n";
+    std::cout << "\t(checksum = " << checksum << ")\n";
+}
+
+} // namespace nalchi::benchmarks
+
+int main(int argc, char** argv)
+{
+    using namespace nalchi::benchmarks;
+
+    const std::uint64_t seed = (argc > 1) ? static_cast<std::uint64_t>(std::atoll(argv[1])) : 42;
+
+    std::cout << "=== bit_stream hot path benchmark ===\n";
+    std::cout << BS_BENCH_FIELDS << " mixed 1~32 bits fields * " << BS_BENCH_ROUNDS << " rounds, seed = " << seed
+              << "\n";
+    std::cout << "Configuration: " << config_name() << "\n";
+
+    run(generate_fields(seed));
+}
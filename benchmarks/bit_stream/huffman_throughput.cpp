@@ -0,0 +1,155 @@
+#include <nalchi/bit_stream.hpp>
+#include <nalchi/huffman_codebook.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef BS_BENCH_ELEMENTS
+#define BS_BENCH_ELEMENTS 1024
+#endif
+
+#ifndef BS_BENCH_ROUNDS
+#define BS_BENCH_ROUNDS 2000
+#endif
+
+namespace nalchi::benchmarks
+{
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t MAX_STRING_LENGTH = 64;
+
+constexpr std::string_view WORDS[] = {
+    "the", "player", "joined", "left", "game", "gg", "lol", "attack", "defend", "base", "north", "south", "heal",
+    "me", "please", "thanks", "ready", "go", "wait", "sword", "shield", "potion", "/kick", "/ban", "/team", "/all",
+    "/whisper",
+};
+
+/// @brief Generates chat-like strings from the words.
+auto generate_strings(std::mt19937_64& rng, std::size_t count) -> std::vector<std::string>
+{
+    std::vector<std::string> strs(count);
+    for (auto& str : strs)
+    {
+        const std::size_t length = std::uniform_int_distribution<std::size_t>(1, MAX_STRING_LENGTH)(rng);
+        while (str.length() < length)
+        {
+            str += WORDS[std::uniform_int_distribution<std::size_t>(0, std::size(WORDS) - 1)(rng)];
+            str += ' ';
+        }
+        str.resize(length);
+    }
+
+    return strs;
+}
+
+/// @brief Measures the size and the time per character, with plain `write()` and the Huffman coded strings.
+/// @param seed Seed to run the rng.
+void run(const std::uint64_t seed)
+{
+    using word_type = bit_stream_writer::word_type;
+    using size_type = bit_stream_writer::size_type;
+
+    std::mt19937_64 rng(seed);
+
+    // Train the codebook from separate "captured traffic".
+    std::array<std::uint64_t, huffman_codebook::SYMBOLS> frequencies = {};
+    for (const auto& str : generate_strings(rng, 4096))
+        for (const char c : str)
+            ++frequencies[static_cast<std::uint8_t>(c)];
+    const huffman_codebook codebook = huffman_codebook::from_frequencies(frequencies);
+
+    const auto strs = generate_strings(rng, BS_BENCH_ELEMENTS);
+    std::size_t chars = 0;
+    for (const auto& str : strs)
+        chars += str.length();
+
+    bit_stream_measurer plain_measurer;
+    bit_stream_measurer coded_measurer;
+    for (const auto& str : strs)
+    {
+        plain_measurer.write(str);
+        coded_measurer.write_string_huffman(str, codebook);
+    }
+
+    const size_type bytes = plain_measurer.used_bytes();
+    std::vector<word_type> buffer((bytes + sizeof(word_type) - 1) / sizeof(word_type));
+
+    std::string read_str;
+    std::size_t checksum = 0;
+
+    auto measure = [&](auto&& func) -> double {
+        const auto begin = clock_type::now();
+        for (int round = 0; round < BS_BENCH_ROUNDS; ++round)
+            func();
+        const auto end = clock_type::now();
+
+        return std::chrono::duration<double, std::nano>(end - begin).count() / (double(chars) * BS_BENCH_ROUNDS);
+    };
+
+    const double plain_write_ns = measure([&] {
+        bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (const auto& str : strs)
+            writer.write(str);
+        if (!writer.flush_final())
+            std::exit(1);
+    });
+    const double plain_read_ns = measure([&] {
+        bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (std::size_t i = 0; i < strs.size(); ++i)
+        {
+            reader.read(read_str, MAX_STRING_LENGTH);
+            checksum += read_str.length();
+        }
+        if (reader.fail())
+            std::exit(1);
+    });
+    const double coded_write_ns = measure([&] {
+        bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (const auto& str : strs)
+            writer.write_string_huffman(str, codebook);
+        if (!writer.flush_final())
+            std::exit(1);
+    });
+    const double coded_read_ns = measure([&] {
+        bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (std::size_t i = 0; i < strs.size(); ++i)
+        {
+            reader.read_string_huffman(read_str, MAX_STRING_LENGTH, codebook);
+            checksum += read_str.length();
+        }
+        if (reader.fail())
+            std::exit(1);
+    });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "chat strings (" << double(chars) / double(strs.size()) << " chars/string):\n";
+    std::cout << "\twrite():                " << double(plain_measurer.used_bits()) / double(chars) << " bits/char, "
+              << plain_write_ns << " ns/char write, " << plain_read_ns << " ns/char read\n";
+    std::cout << "\twrite_string_huffman(): " << double(coded_measurer.used_bits()) / double(chars) << " bits/char, "
+              << coded_write_ns << " ns/char write, " << coded_read_ns << " ns/char read\n";
+    std::cout << "\t(checksum = " << checksum << ")\n";
+}
+
+} // namespace nalchi::benchmarks
+
+int main(int argc, char** argv)
+{
+    using namespace nalchi::benchmarks;
+
+    const std::uint64_t seed = (argc > 1) ? static_cast<std::uint64_t>(std::atoll(argv[1])) : 42;
+
+    std::cout << "=== bit_stream huffman benchmark ===\n";
+    std::cout << BS_BENCH_ELEMENTS << " strings * " << BS_BENCH_ROUNDS << " rounds, seed = " << seed << "\n";
+
+    run(seed);
+}
@@ -0,0 +1,166 @@
+#include <nalchi/bit_stream.hpp>
+#include <nalchi/range_coder.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#ifndef BS_BENCH_ELEMENTS
+#define BS_BENCH_ELEMENTS 4096
+#endif
+
+#ifndef BS_BENCH_ROUNDS
+#define BS_BENCH_ROUNDS 2000
+#endif
+
+namespace nalchi::benchmarks
+{
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t SYMBOLS = 16;
+
+// Each field codes a bit and a symbol with the range coder.
+constexpr std::size_t CODED_SYMBOLS_PER_FIELD = 2;
+
+/// @brief Field of a typical entity update, with a skewed flag and a skewed small state.
+struct field
+{
+    bool flag;
+    std::uint8_t state;
+};
+
+/// @brief Measures the size and the time per field, with plain `write()` and the range coder. \n
+/// For the range coder, it also prints the time per coded symbol, counting the flag bit as a symbol.
+/// @param name Name of the distribution to print.
+/// @param flag_probability Probability of the flag being set.
+/// @param state_skew Parameter of the geometric distribution of the state, which is more skewed when higher.
+/// @param seed Seed to run the rng.
+void run(const char* name, const double flag_probability, const double state_skew, const std::uint64_t seed)
+{
+    using word_type = bit_stream_writer::word_type;
+    using size_type = bit_stream_writer::size_type;
+
+    std::mt19937_64 rng(seed);
+    std::bernoulli_distribution flag_dist(flag_probability);
+    std::geometric_distribution<unsigned> state_dist(state_skew);
+
+    std::vector<field> data(BS_BENCH_ELEMENTS);
+    for (auto& f : data)
+    {
+        f.flag = flag_dist(rng);
+        f.state = static_cast<std::uint8_t>(std::min<unsigned>(state_dist(rng), SYMBOLS - 1));
+    }
+
+    auto write_plain = [&](auto& stream) {
+        for (const auto& f : data)
+        {
+            stream.write(f.flag);
+            stream.write(f.state, std::uint8_t(0), std::uint8_t(SYMBOLS - 1));
+        }
+    };
+    auto write_coded = [&](auto& stream) {
+        range_coder_writer coder(stream);
+        adaptive_bit_model flag_model;
+        adaptive_symbol_model<SYMBOLS> state_model;
+        for (const auto& f : data)
+        {
+            coder.write_bit(flag_model, f.flag);
+            coder.write_symbol(state_model, f.state);
+        }
+        return coder.flush();
+    };
+
+    bit_stream_measurer plain_measurer;
+    write_plain(plain_measurer);
+    bit_stream_measurer coded_measurer;
+    write_coded(coded_measurer);
+
+    const size_type bytes = std::max(plain_measurer.used_bytes(), coded_measurer.used_bytes());
+    std::vector<word_type> buffer((bytes + sizeof(word_type) - 1) / sizeof(word_type));
+
+    std::uint64_t checksum = 0;
+
+    // Returns the time per field.
+    auto measure = [&](auto&& func) -> double {
+        const auto begin = clock_type::now();
+        for (int round = 0; round < BS_BENCH_ROUNDS; ++round)
+            func();
+        const auto end = clock_type::now();
+
+        return std::chrono::duration<double, std::nano>(end - begin).count() / (double(data.size()) * BS_BENCH_ROUNDS);
+    };
+
+    const double plain_write_ns = measure([&] {
+        bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        write_plain(writer);
+        if (!writer.flush_final())
+            std::exit(1);
+    });
+    const double plain_read_ns = measure([&] {
+        bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            bool flag;
+            std::uint8_t state;
+            reader.read(flag);
+            reader.read(state, std::uint8_t(0), std::uint8_t(SYMBOLS - 1));
+            checksum += flag + state;
+        }
+        if (reader.fail())
+            std::exit(1);
+    });
+    const double coded_write_ns = measure([&] {
+        bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        if (!write_coded(writer) || !writer.flush_final())
+            std::exit(1);
+    });
+    const double coded_read_ns = measure([&] {
+        bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        range_coder_reader decoder(reader);
+        adaptive_bit_model flag_model;
+        adaptive_symbol_model<SYMBOLS> state_model;
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            bool flag;
+            std::size_t state;
+            decoder.read_bit(flag_model, flag);
+            decoder.read_symbol(state_model, state);
+            checksum += flag + state;
+        }
+        if (decoder.fail())
+            std::exit(1);
+    });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << name << ":\n";
+    std::cout << "\twrite():       " << double(plain_measurer.used_bits()) / double(data.size()) << " bits/field, "
+              << plain_write_ns << " ns/field write, " << plain_read_ns << " ns/field read\n";
+    std::cout << "\trange coder:   " << double(coded_measurer.used_bits()) / double(data.size()) << " bits/field, "
+              << coded_write_ns << " ns/field write, " << coded_read_ns << " ns/field read\n";
+    std::cout << "\t               " << coded_write_ns / CODED_SYMBOLS_PER_FIELD << " ns/symbol write, "
+              << coded_read_ns / CODED_SYMBOLS_PER_FIELD << " ns/symbol read\n";
+    std::cout << "\t(checksum = " << checksum << ")\n";
+}
+
+} // namespace nalchi::benchmarks
+
+int main(int argc, char** argv)
+{
+    using namespace nalchi::benchmarks;
+
+    const std::uint64_t seed = (argc > 1) ? static_cast<std::uint64_t>(std::atoll(argv[1])) : 42;
+
+    std::cout << "=== bit_stream range coder benchmark ===\n";
+    std::cout << BS_BENCH_ELEMENTS << " fields * " << BS_BENCH_ROUNDS << " rounds, seed = " << seed << "\n";
+
+    run("uniform flag, mildly skewed state", 0.5, 0.2, seed);
+    run("rare flag (5%), skewed state", 0.05, 0.6, seed);
+    run("rare flag (1%), mostly zero state", 0.01, 0.9, seed);
+}
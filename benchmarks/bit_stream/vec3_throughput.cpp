@@ -0,0 +1,117 @@
+#include <nalchi/bit_stream.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+#ifndef BS_BENCH_ELEMENTS
+#define BS_BENCH_ELEMENTS 4096
+#endif
+
+#ifndef BS_BENCH_ROUNDS
+#define BS_BENCH_ROUNDS 5000
+#endif
+
+namespace nalchi::benchmarks
+{
+
+using clock_type = std::chrono::steady_clock;
+
+using vector3 = std::array<float, 3>;
+
+/// @brief Measures the write & read time per vector, with one by one quantized writes & reads and vec3 array ones.
+/// @param name Name of the array to print.
+/// @param min Minimum value allowed for each axis.
+/// @param max Maximum value allowed for each axis.
+/// @param resolution Step between the quantized values.
+/// @param seed Seed to run the rng.
+void run(const char* name, const vector3& min, const vector3& max, const float resolution, const std::uint64_t seed)
+{
+    using word_type = bit_stream_writer::word_type;
+    using size_type = bit_stream_writer::size_type;
+
+    std::mt19937_64 rng(seed);
+    std::vector<vector3> data(BS_BENCH_ELEMENTS);
+    for (auto& vec : data)
+        for (int axis = 0; axis < 3; ++axis)
+            vec[axis] = std::uniform_real_distribution<float>(min[axis], max[axis])(rng);
+
+    bit_stream_measurer measurer;
+    measurer.write_vec3_array(data, min, max, resolution);
+    const size_type bytes = measurer.used_bytes();
+    std::vector<word_type> buffer((bytes + sizeof(word_type) - 1) / sizeof(word_type));
+
+    std::vector<vector3> read_data(data.size());
+    double checksum = 0;
+
+    auto measure = [&](auto&& func) -> double {
+        const auto begin = clock_type::now();
+        for (int round = 0; round < BS_BENCH_ROUNDS; ++round)
+            func();
+        const auto end = clock_type::now();
+
+        return std::chrono::duration<double, std::nano>(end - begin).count() / (double(data.size()) * BS_BENCH_ROUNDS);
+    };
+
+    const double write_ns = measure([&] {
+        bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (const auto& vec : data)
+            for (int axis = 0; axis < 3; ++axis)
+                writer.write_quantized(vec[axis], min[axis], max[axis], resolution);
+        if (!writer.flush_final())
+            std::exit(1);
+    });
+    const double read_ns = measure([&] {
+        bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        for (auto& vec : read_data)
+            for (int axis = 0; axis < 3; ++axis)
+                reader.read_quantized(vec[axis], min[axis], max[axis], resolution);
+        if (reader.fail())
+            std::exit(1);
+        checksum += read_data.back()[0];
+    });
+    const double write_array_ns = measure([&] {
+        bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        writer.write_vec3_array(data, min, max, resolution);
+        if (!writer.flush_final())
+            std::exit(1);
+    });
+    const double read_array_ns = measure([&] {
+        bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), bytes);
+        reader.read_vec3_array(read_data, min, max, resolution);
+        if (reader.fail())
+            std::exit(1);
+        checksum += read_data.back()[0];
+    });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << name << " (" << double(measurer.used_bits()) / double(data.size()) << " bits/vector):\n";
+    std::cout << "\twrite_quantized:  " << write_ns << " ns/vector\n";
+    std::cout << "\twrite_vec3_array: " << write_array_ns << " ns/vector\n";
+    std::cout << "\tread_quantized:   " << read_ns << " ns/vector\n";
+    std::cout << "\tread_vec3_array:  " << read_array_ns << " ns/vector\n";
+    std::cout << "\t(checksum = " << checksum << ")\n";
+}
+
+} // namespace nalchi::benchmarks
+
+int main(int argc, char** argv)
+{
+    using namespace nalchi::benchmarks;
+
+    const std::uint64_t seed = (argc > 1) ? static_cast<std::uint64_t>(std::atoll(argv[1])) : 42;
+
+    std::cout << "=== bit_stream vec3 array benchmark ===\n";
+    std::cout << BS_BENCH_ELEMENTS << " vectors * " << BS_BENCH_ROUNDS << " rounds, seed = " << seed << "\n";
+
+    run("positions in [-512, 512]^3 with 0.01 resolution", {-512, -512, -512}, {512, 512, 512}, 0.01f, seed);
+    run("positions in [-2048, 2048] x [-64, 256] x [-2048, 2048] with 0.01 resolution", {-2048, -64, -2048},
+        {2048, 256, 2048}, 0.01f, seed);
+}
@@ -0,0 +1,139 @@
+#include <nalchi/bit_stream.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#ifndef BS_BENCH_FIELDS
+#define BS_BENCH_FIELDS 4096
+#endif
+
+#ifndef BS_BENCH_ROUNDS
+#define BS_BENCH_ROUNDS 20000
+#endif
+
+namespace nalchi::benchmarks
+{
+
+using clock_type = std::chrono::steady_clock;
+
+/// @brief Small field with a range, which mimics a typical game state field.
+struct field
+{
+    std::uint32_t value;
+    std::uint32_t max;
+};
+
+/// @brief Generates mixed small fields, whose bit widths are between 1 and 16 bits.
+/// @param seed Seed to run the rng.
+/// @return Generated fields.
+auto generate_fields(const std::uint64_t seed) -> std::vector<field>
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> bits_dist(1, 16);
+
+    std::vector<field> fields(BS_BENCH_FIELDS);
+    for (auto& f : fields)
+    {
+        f.max = (std::uint32_t(1) << bits_dist(rng)) - 1;
+        f.value = std::uniform_int_distribution<std::uint32_t>(0, f.max)(rng);
+    }
+
+    return fields;
+}
+
+/// @brief Measures the write & read throughput of a bit stream writer & reader pair.
+/// @tparam Writer Bit stream writer type to measure.
+/// @tparam Reader Bit stream reader type to measure.
+/// @param name Name to print.
+/// @param fields Fields to write & read.
+template <typename Writer, typename Reader>
+void run(const std::string_view name, const std::vector<field>& fields)
+{
+    using word_type = typename Writer::word_type;
+
+    const std::size_t bytes = 4 * fields.size() + sizeof(word_type);
+    std::vector<word_type> buffer(bytes / sizeof(word_type) + 1);
+
+    // Measure writes.
+    std::uint32_t used_bytes = 0;
+    const auto write_begin = clock_type::now();
+    for (int round = 0; round < BS_BENCH_ROUNDS; ++round)
+    {
+        Writer writer(buffer.data(), buffer.size(), static_cast<typename Writer::size_type>(bytes));
+        for (const auto& f : fields)
+            writer.write(f.value, std::uint32_t(0), f.max);
+        writer.flush_final();
+
+        if (writer.fail())
+        {
+            std::cout << name << ": writer failed\n";
+            std::exit(1);
+        }
+        used_bytes = writer.used_bytes();
+    }
+    const auto write_end = clock_type::now();
+
+    // Measure reads.
+    std::uint64_t checksum = 0;
+    const auto read_begin = clock_type::now();
+    for (int round = 0; round < BS_BENCH_ROUNDS; ++round)
+    {
+        Reader reader(buffer.data(), buffer.size(), used_bytes);
+        for (const auto& f : fields)
+        {
+            std::uint32_t value = 0;
+            reader.read(value, std::uint32_t(0), f.max);
+            checksum += value;
+        }
+
+        if (reader.fail())
+        {
+            std::cout << name << ": reader failed\n";
+            std::exit(1);
+        }
+    }
+    const auto read_end = clock_type::now();
+
+    const double total_fields = double(fields.size()) * BS_BENCH_ROUNDS;
+    const double total_megabytes = double(used_bytes) * BS_BENCH_ROUNDS / (1024.0 * 1024.0);
+
+    const double write_ns = std::chrono::duration<double, std::nano>(write_end - write_begin).count();
+    const double read_ns = std::chrono::duration<double, std::nano>(read_end - read_begin).count();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << name << " (" << 8 * sizeof(word_type) << "-bit word)\n";
+    std::cout << "\twrite: " << write_ns / total_fields << " ns/field, " << total_megabytes / (write_ns * 1e-9)
+              << " MB/s\n";
+    std::cout << "\tread:  " << read_ns / total_fields << " ns/field, " << total_megabytes / (read_ns * 1e-9)
+              << " MB/s\n";
+    std::cout << "\t(checksum = " << checksum << ")\n";
+}
+
+} // namespace nalchi::benchmarks
+
+int main(int argc, char** argv)
+{
+    using namespace nalchi::benchmarks;
+
+    const std::uint64_t seed = (argc > 1) ? static_cast<std::uint64_t>(std::atoll(argv[1])) : 42;
+
+    std::cout << "=== bit_stream word size benchmark ===\n";
+    std::cout << BS_BENCH_FIELDS << " mixed 1~16 bits fields * " << BS_BENCH_ROUNDS << " rounds, seed = " << seed
+              << "\n";
+
+    const auto fields = generate_fields(seed);
+
+    run<nalchi::bit_stream_writer, nalchi::bit_stream_reader>("bit_stream", fields);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    run<nalchi::wide_bit_stream_writer, nalchi::wide_bit_stream_reader>("wide_bit_stream", fields);
+#else
+    std::cout << "wide_bit_stream is not available on this compiler\n";
+#endif
+}
@@ -0,0 +1,168 @@
+#include <nalchi/shared_payload.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifndef SP_BENCH_BATCH
+#define SP_BENCH_BATCH 256
+#endif
+
+#ifndef SP_BENCH_ROUNDS
+#define SP_BENCH_ROUNDS 20000
+#endif
+
+namespace nalchi::benchmarks
+{
+
+using clock_type = std::chrono::steady_clock;
+
+using alloc_size_t = shared_payload::alloc_size_t;
+
+/// @brief Generates payload sizes, which are mostly small as in real game messages.
+/// @param seed Seed to run the rng.
+/// @return Generated sizes.
+auto generate_sizes(const std::uint64_t seed) -> std::vector<alloc_size_t>
+{
+    std::mt19937_64 rng(seed);
+
+    std::vector<alloc_size_t> sizes(SP_BENCH_BATCH);
+    for (auto& size : sizes)
+    {
+        const int kind = std::uniform_int_distribution<int>(0, 99)(rng);
+        if (kind < 80)
+            size = std::uniform_int_distribution<alloc_size_t>(1, 128)(rng);
+        else if (kind < 98)
+            size = std::uniform_int_distribution<alloc_size_t>(129, 1200)(rng);
+        else
+            size = std::uniform_int_distribution<alloc_size_t>(1201, 16 * 1024)(rng);
+    }
+
+    return sizes;
+}
+
+/// @brief Allocates a batch of payloads.
+/// @param sizes Sizes of the payloads.
+/// @param out Buffer to store the payloads.
+void allocate_batch(const std::vector<alloc_size_t>& sizes, std::vector<shared_payload>& out)
+{
+    out.clear();
+    for (const alloc_size_t size : sizes)
+    {
+        const shared_payload payload = shared_payload::allocate(size);
+        if (!payload.ptr)
+        {
+            std::cout << "allocation failed\n";
+            std::exit(1);
+        }
+
+        // Touch the payload, as a real message would be written to it.
+        *static_cast<std::uint8_t*>(payload.ptr) = static_cast<std::uint8_t>(size);
+        out.push_back(payload);
+    }
+}
+
+/// @brief Measures the time per allocation & deallocation on the same thread.
+/// @param sizes Sizes of the payloads in a batch.
+void run_same_thread(const std::vector<alloc_size_t>& sizes)
+{
+    std::vector<shared_payload> batch;
+    batch.reserve(sizes.size());
+
+    const auto begin = clock_type::now();
+    for (int round = 0; round < SP_BENCH_ROUNDS; ++round)
+    {
+        allocate_batch(sizes, batch);
+        for (const shared_payload& payload : batch)
+            shared_payload::force_deallocate(payload);
+    }
+    const auto end = clock_type::now();
+
+    const double total = double(sizes.size()) * SP_BENCH_ROUNDS;
+    const double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+
+    std::cout << "\tsame thread:  " << ns / total << " ns/payload\n";
+}
+
+/// @brief Measures the time per allocation & deallocation,
+/// where the payloads are deallocated on another thread like the GameNetworkingSockets' service thread.
+/// @param sizes Sizes of the payloads in a batch.
+void run_cross_thread(const std::vector<alloc_size_t>& sizes)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::vector<shared_payload>> queue;
+    bool done = false;
+
+    std::thread releaser([&] {
+        std::vector<std::vector<shared_payload>> batches;
+        for (;;)
+        {
+            {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [&] { return done || !queue.empty(); });
+                if (queue.empty())
+                    return;
+                batches.swap(queue);
+            }
+
+            for (const auto& batch : batches)
+                for (const shared_payload& payload : batch)
+                    shared_payload::force_deallocate(payload);
+            batches.clear();
+        }
+    });
+
+    const auto begin = clock_type::now();
+    for (int round = 0; round < SP_BENCH_ROUNDS; ++round)
+    {
+        std::vector<shared_payload> batch;
+        batch.reserve(sizes.size());
+        allocate_batch(sizes, batch);
+
+        {
+            std::lock_guard lock(mutex);
+            queue.push_back(std::move(batch));
+        }
+        cv.notify_one();
+    }
+    {
+        std::lock_guard lock(mutex);
+        done = true;
+    }
+    cv.notify_one();
+    releaser.join();
+    const auto end = clock_type::now();
+
+    const double total = double(sizes.size()) * SP_BENCH_ROUNDS;
+    const double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+
+    std::cout << "\tcross thread: " << ns / total << " ns/payload\n";
+}
+
+} // namespace nalchi::benchmarks
+
+int main(int argc, char** argv)
+{
+    using namespace nalchi::benchmarks;
+
+    const std::uint64_t seed = (argc > 1) ? static_cast<std::uint64_t>(std::atoll(argv[1])) : 42;
+
+    std::cout << "=== shared_payload allocate throughput benchmark ===\n";
+    std::cout << SP_BENCH_BATCH << " payloads * " << SP_BENCH_ROUNDS << " rounds, seed = " << seed << "\n";
+    std::cout << "Build nalchi with and without `NALCHI_PAYLOAD_POOL` to compare.\n";
+
+    const auto sizes = generate_sizes(seed);
+
+    std::cout << std::fixed << std::setprecision(3);
+    run_same_thread(sizes);
+    run_cross_thread(sizes);
+}
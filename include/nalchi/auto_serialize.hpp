@@ -0,0 +1,560 @@
+#pragma once
+
+#include "nalchi/bit_stream.hpp"
+#include "nalchi/character.hpp"
+#include "nalchi/quantization.hpp"
+#include "nalchi/serialize.hpp"
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace nalchi
+{
+
+/// @brief Maximum number of fields an aggregate can have to be serialized automatically.
+inline constexpr std::size_t AUTO_SERIALIZE_MAX_FIELDS = 32;
+
+/// @brief Integral field with a compile-time range `[Min, Max]`, for the automatic serialization.
+///
+/// It's serialized with `write<Min, Max>()`, which has a constant bit width.
+/// @tparam Int Integer type of the value.
+/// @tparam Min Minimum value allowed.
+/// @tparam Max Maximum value allowed.
+template <ranged_integral Int, Int Min, Int Max>
+struct bounded
+{
+    static_assert(Min < Max, "`Min` must be less than `Max`");
+
+    using value_type = Int; ///< Integer type of the value.
+
+    static constexpr Int MIN = Min; ///< Minimum value allowed.
+    static constexpr Int MAX = Max; ///< Maximum value allowed.
+
+    /// @brief Number of bits the value takes.
+    static constexpr int BITS = static_cast<int>(
+        std::bit_width(static_cast<std::make_unsigned_t<Int>>(static_cast<std::make_unsigned_t<Int>>(Max) -
+                                                              static_cast<std::make_unsigned_t<Int>>(Min))));
+
+    Int value; ///< The value, which must be in `[Min, Max]` on write.
+
+    /// @brief Gets the value.
+    constexpr operator Int() const noexcept
+    {
+        return value;
+    }
+
+    /// @brief Sets the value.
+    constexpr auto operator=(Int new_value) noexcept -> bounded&
+    {
+        value = new_value;
+        return *this;
+    }
+
+    /// @brief Compares the values.
+    constexpr bool operator==(const bounded&) const noexcept = default;
+};
+
+/// @brief Float field quantized to the compile-time range `[Min, Max]` with the step of `Resolution`,
+/// for the automatic serialization.
+///
+/// It's serialized to the same bits as `write_quantized(value, Min, Max, Resolution)`,
+/// but the maximum quantized value and its bit width are constants.
+/// @tparam Min Minimum value of the range.
+/// @tparam Max Maximum value of the range.
+/// @tparam Resolution Step between the quantized values.
+template <float Min, float Max, float Resolution>
+struct quantized
+{
+    static_assert(quantized_max(Min, Max, Resolution) >= 0, "Invalid range, see `quantized_max()`");
+
+    static constexpr float MIN = Min;               ///< Minimum value of the range.
+    static constexpr float MAX = Max;               ///< Maximum value of the range.
+    static constexpr float RESOLUTION = Resolution; ///< Step between the quantized values.
+
+    /// @brief Maximum quantized value.
+    static constexpr auto MAX_CODE = static_cast<std::uint32_t>(quantized_max(Min, Max, Resolution));
+
+    /// @brief Number of bits the value takes.
+    static constexpr int BITS = quantized_bits(Min, Max, Resolution);
+
+    float value; ///< The value, which must be in `[Min, Max]` on write.
+
+    /// @brief Gets the value.
+    constexpr operator float() const noexcept
+    {
+        return value;
+    }
+
+    /// @brief Sets the value.
+    constexpr auto operator=(float new_value) noexcept -> quantized&
+    {
+        value = new_value;
+        return *this;
+    }
+
+    /// @brief Compares the values.
+    constexpr bool operator==(const quantized&) const noexcept = default;
+};
+
+/// @brief String field with the maximum length, for the automatic serialization.
+///
+/// It's serialized with `write(value)`, and reading fails if it's longer than `MaxLength`.
+/// @tparam MaxLength Maximum number of `CharT`.
+/// @tparam CharT Character type.
+template <std::size_t MaxLength, character CharT = char>
+struct bounded_string
+{
+    static constexpr std::size_t MAX_LENGTH = MaxLength; ///< Maximum number of `CharT`.
+
+    std::basic_string<CharT> value; ///< The string, which must not be longer than `MaxLength` on write.
+
+    /// @brief Compares the strings.
+    bool operator==(const bounded_string&) const = default;
+};
+
+/// @brief Serializes a `bounded` field.
+/// @tparam Stream Stream type.
+/// @tparam Int Integer type of the value.
+/// @tparam Min Minimum value allowed.
+/// @tparam Max Maximum value allowed.
+/// @param stream Stream to serialize with.
+/// @param field Field to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream, ranged_integral Int, Int Min, Int Max>
+constexpr auto serialize(Stream& stream, bounded<Int, Min, Max>& field) -> Stream&
+{
+    return serialize<Min, Max>(stream, field.value);
+}
+
+/// @brief Serializes a `quantized` field.
+///
+/// If the writing side's value is out of range (including NaN), the writer will set the fail flag and write nothing.
+/// @tparam Stream Stream type.
+/// @tparam Min Minimum value of the range.
+/// @tparam Max Maximum value of the range.
+/// @tparam Resolution Step between the quantized values.
+/// @param stream Stream to serialize with.
+/// @param field Field to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream, float Min, float Max, float Resolution>
+constexpr auto serialize(Stream& stream, quantized<Min, Max, Resolution>& field) -> Stream&
+{
+    constexpr std::uint32_t MAX_CODE = quantized<Min, Max, Resolution>::MAX_CODE;
+
+    if constexpr (Stream::is_reading)
+    {
+        std::uint32_t q;
+        if (stream.template read<0u, MAX_CODE>(q))
+            field.value = dequantize(q, Min, Max, Resolution);
+
+        return stream;
+    }
+    else if constexpr (Stream::is_measuring)
+    {
+        // The bit width doesn't depend on the value, and skipping `quantize()` allows constant evaluation.
+        return stream.template write<0u, MAX_CODE>(0u);
+    }
+    else
+    {
+        if (!(Min <= field.value && field.value <= Max))
+        {
+            stream.set_fail();
+            return stream;
+        }
+
+        return stream.template write<0u, MAX_CODE>(quantize(field.value, Min, Resolution, MAX_CODE));
+    }
+}
+
+/// @brief Serializes a `bounded_string` field.
+/// @tparam Stream Stream type.
+/// @tparam MaxLength Maximum number of `CharT`.
+/// @tparam CharT Character type.
+/// @param stream Stream to serialize with.
+/// @param field Field to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream, std::size_t MaxLength, character CharT>
+constexpr auto serialize(Stream& stream, bounded_string<MaxLength, CharT>& field) -> Stream&
+{
+    return serialize(stream, field.value, static_cast<typename Stream::size_type>(MaxLength));
+}
+
+namespace detail
+{
+
+/// @brief Placeholder that converts to any field type, to count the fields of an aggregate.
+struct any_field
+{
+    template <typename T>
+    operator T() const;
+};
+
+/// @brief Checks if @p T can be aggregate initialized with `sizeof...(Indices)` initializers.
+template <typename T, std::size_t... Indices>
+constexpr bool is_initializable_with(std::index_sequence<Indices...>)
+{
+    return requires { T{(static_cast<void>(Indices), any_field{})...}; };
+}
+
+/// @brief Counts the fields of an aggregate @p T, by adding initializers until it fails.
+template <typename T, std::size_t Count = 0>
+constexpr auto field_count() -> std::size_t
+{
+    if constexpr (Count > AUTO_SERIALIZE_MAX_FIELDS)
+        return Count;
+    else if constexpr (is_initializable_with<T>(std::make_index_sequence<Count + 1>{}))
+        return field_count<T, Count + 1>();
+    else
+        return Count;
+}
+
+/// @brief Decomposes an aggregate with the structured binding, into a tuple of references to its fields.
+template <typename T>
+constexpr auto tie_fields(T& value)
+{
+    constexpr std::size_t FIELDS = field_count<T>();
+
+    static_assert(FIELDS <= AUTO_SERIALIZE_MAX_FIELDS, "Too many fields to serialize automatically");
+
+    if constexpr (FIELDS == 0)
+        return std::tie();
+    else if constexpr (FIELDS == 1)
+    {
+        auto& [f0] = value;
+        return std::tie(f0);
+    }
+    else if constexpr (FIELDS == 2)
+    {
+        auto& [f0, f1] = value;
+        return std::tie(f0, f1);
+    }
+    else if constexpr (FIELDS == 3)
+    {
+        auto& [f0, f1, f2] = value;
+        return std::tie(f0, f1, f2);
+    }
+    else if constexpr (FIELDS == 4)
+    {
+        auto& [f0, f1, f2, f3] = value;
+        return std::tie(f0, f1, f2, f3);
+    }
+    else if constexpr (FIELDS == 5)
+    {
+        auto& [f0, f1, f2, f3, f4] = value;
+        return std::tie(f0, f1, f2, f3, f4);
+    }
+    else if constexpr (FIELDS == 6)
+    {
+        auto& [f0, f1, f2, f3, f4, f5] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5);
+    }
+    else if constexpr (FIELDS == 7)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6);
+    }
+    else if constexpr (FIELDS == 8)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+    }
+    else if constexpr (FIELDS == 9)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+    }
+    else if constexpr (FIELDS == 10)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+    }
+    else if constexpr (FIELDS == 11)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+    }
+    else if constexpr (FIELDS == 12)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+    }
+    else if constexpr (FIELDS == 13)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+    }
+    else if constexpr (FIELDS == 14)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+    }
+    else if constexpr (FIELDS == 15)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+    }
+    else if constexpr (FIELDS == 16)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+    }
+    else if constexpr (FIELDS == 17)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16);
+    }
+    else if constexpr (FIELDS == 18)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17);
+    }
+    else if constexpr (FIELDS == 19)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18);
+    }
+    else if constexpr (FIELDS == 20)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19);
+    }
+    else if constexpr (FIELDS == 21)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20);
+    }
+    else if constexpr (FIELDS == 22)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+               f21] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21);
+    }
+    else if constexpr (FIELDS == 23)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21,
+               f22] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22);
+    }
+    else if constexpr (FIELDS == 24)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23);
+    }
+    else if constexpr (FIELDS == 25)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23, f24] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24);
+    }
+    else if constexpr (FIELDS == 26)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23, f24, f25] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25);
+    }
+    else if constexpr (FIELDS == 27)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23, f24, f25, f26] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26);
+    }
+    else if constexpr (FIELDS == 28)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23, f24, f25, f26, f27] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27);
+    }
+    else if constexpr (FIELDS == 29)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23, f24, f25, f26, f27, f28] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27, f28);
+    }
+    else if constexpr (FIELDS == 30)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23, f24, f25, f26, f27, f28, f29] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27, f28, f29);
+    }
+    else if constexpr (FIELDS == 31)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23, f24, f25, f26, f27, f28, f29, f30] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27, f28, f29, f30);
+    }
+    else if constexpr (FIELDS == 32)
+    {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22,
+               f23, f24, f25, f26, f27, f28, f29, f30, f31] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20,
+                        f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31);
+    }
+}
+
+} // namespace detail
+
+/// @brief Aggregate that can be serialized automatically, field by field in the declaration order.
+///
+/// Each field must be serializable with `serialize(stream, field)`, so annotate them with
+/// `bounded`, `quantized` and `bounded_string`, or nest another auto-serializable aggregate. \n
+/// It must not have base classes, C arrays (use `std::array` instead), bit-fields,
+/// or more than `AUTO_SERIALIZE_MAX_FIELDS` fields.
+/// @tparam T Aggregate type.
+template <typename T>
+concept auto_serializable = std::is_aggregate_v<T> && std::is_class_v<T> && !std::is_union_v<T>;
+
+/// @brief Serializes an aggregate automatically, field by field in the declaration order.
+///
+/// For example, `hp` of this message takes 7 bits, and each component of `position` takes 17 bits:
+/// @code
+/// struct player_state
+/// {
+///     std::uint32_t id;
+///     nalchi::bounded<int, 0, 100> hp;
+///     std::array<nalchi::quantized<-500.0f, 500.0f, 0.01f>, 2> position;
+///     nalchi::bounded_string<16> name;
+/// };
+/// @endcode
+/// A free or member `serialize()` of your own takes precedence over this.
+/// @tparam Stream Stream type.
+/// @tparam T Aggregate type.
+/// @param stream Stream to serialize with.
+/// @param value Aggregate to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream, auto_serializable T>
+    requires(!requires(Stream& stream, T& value) { value.serialize(stream); })
+constexpr auto serialize(Stream& stream, T& value) -> Stream&
+{
+    // Serializing after a failure is a no-op, so there's no need to stop early.
+    std::apply([&stream](auto&... fields) { (serialize(stream, fields), ...); }, detail::tie_fields(value));
+    return stream;
+}
+
+/// @brief Opts @p T in to `fixed_size_serializable`, for a `serialize()` of your own which always writes the same
+/// number of bits regardless of the values.
+///
+/// That `serialize()` must be `constexpr`, as `max_bits_v` measures it at compile-time. \n
+/// Specialize this to `true` for such a type, e.g.
+/// `template <> inline constexpr bool nalchi::enable_fixed_size_serialize<my_type> = true;`
+/// @tparam T Type to opt in.
+template <typename T>
+inline constexpr bool enable_fixed_size_serialize = false;
+
+template <ranged_integral Int, Int Min, Int Max>
+inline constexpr bool enable_fixed_size_serialize<bounded<Int, Min, Max>> = true;
+
+template <float Min, float Max, float Resolution>
+inline constexpr bool enable_fixed_size_serialize<quantized<Min, Max, Resolution>> = true;
+
+namespace detail
+{
+
+namespace adl_probe
+{
+
+// Hides `nalchi::serialize()` from the unqualified lookup below, so that only the user's own ones are found by ADL.
+void serialize() = delete;
+
+/// @brief Stream that only exists to find the user's own free `serialize()`.
+struct stream
+{
+    using size_type = bit_stream_measurer::size_type;
+
+    static constexpr bool is_writing = false;
+    static constexpr bool is_reading = false;
+    static constexpr bool is_measuring = true;
+
+    constexpr bool fail() const noexcept
+    {
+        return false;
+    }
+};
+
+/// @brief Checks if @p T has a free `serialize()` of its own.
+template <typename T>
+concept has_own_serialize = requires(stream& s, T& value) { serialize(s, value); };
+
+} // namespace adl_probe
+
+template <typename T>
+struct is_std_array : std::false_type
+{
+};
+
+template <typename T, std::size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type
+{
+};
+
+/// @brief Checks if `serialize()` always writes the same number of bits for @p T, regardless of the values.
+template <typename T>
+constexpr bool is_fixed_size()
+{
+    if constexpr (enable_fixed_size_serialize<T>)
+        return true;
+    else if constexpr (std::integral<T> || std::same_as<T, float> || std::same_as<T, double>)
+        return true;
+    else if constexpr (is_std_array<T>::value)
+        return is_fixed_size<typename T::value_type>();
+    else if constexpr (auto_serializable<T>)
+    {
+        // A `serialize()` of its own might write anything, so it must opt in explicitly.
+        if constexpr (requires(T& value, bit_stream_measurer& measurer) { value.serialize(measurer); } ||
+                      adl_probe::has_own_serialize<T>)
+            return false;
+        else
+            return []<typename... Fields>(std::type_identity<std::tuple<Fields...>>) {
+                return (is_fixed_size<std::remove_cvref_t<Fields>>() && ...);
+            }(std::type_identity<decltype(tie_fields(std::declval<T&>()))>{});
+    }
+    else
+        return false;
+}
+
+} // namespace detail
+
+/// @brief Type whose `serialize()` always writes the same number of bits, regardless of the values.
+///
+/// These are fixed-size:
+/// - integral types, `float` and `double`.
+/// - `bounded` and `quantized`.
+/// - `std::array` of fixed-size types.
+/// - auto-serializable aggregates of fixed-size fields, without a `serialize()` of their own.
+/// - types opted in with `enable_fixed_size_serialize`.
+/// @tparam T Type to check.
+template <typename T>
+concept fixed_size_serializable = detail::is_fixed_size<T>();
+
+/// @brief Number of bits `serialize()` writes for any value of a fixed-layout message @p T, computed at compile-time.
+///
+/// e.g. `std::array<std::uint32_t, (nalchi::max_bytes_v<my_message> + 3) / 4> buffer;`
+/// @tparam T Fixed-size message type.
+template <fixed_size_serializable T>
+inline constexpr bit_stream_measurer::size_type max_bits_v = serialized_bits(T{});
+
+/// @brief Number of bytes `serialize()` writes for any value of a fixed-layout message @p T, computed at compile-time.
+///
+/// Use this to size a stack buffer exactly, or to pick a payload size class without measuring on each send.
+/// @tparam T Fixed-size message type.
+template <fixed_size_serializable T>
+inline constexpr bit_stream_measurer::size_type max_bytes_v = serialized_bytes(T{});
+
+} // namespace nalchi
@@ -2,18 +2,24 @@
 
 #include "nalchi/character.hpp"
 #include "nalchi/export.hpp"
+#include "nalchi/integer_codes.hpp"
 #include "nalchi/make_unsigned_allow_bool.hpp"
+#include "nalchi/orientation.hpp"
+#include "nalchi/quantization.hpp"
 #include "nalchi/shared_payload.hpp"
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 #define NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(ret_val) \
     do \
@@ -59,7 +65,7 @@
             _logical_total_bits) \
         { \
             _fail = true; \
-            return *this; \
+            return self(); \
         } \
     } while (false)
 
@@ -69,32 +75,71 @@
         if (_logical_used_bits + (8 * (str_len_bytes)) > _logical_total_bits) \
         { \
             _fail = true; \
-            return *this; \
+            return self(); \
         } \
     } while (false)
 
+// 64-bit word streams need a 128-bit scratch, which is only available as a compiler extension.
+#if defined(__SIZEOF_INT128__)
+#define NALCHI_HAS_WIDE_BIT_STREAM
+#endif
+
+// Word flush & fetch functions are defined in this header, but they're only `inline` on `NALCHI_INLINE_HOT_PATH`.
+// Otherwise, they're called through the explicit instantiations in the library.
+#if defined(NALCHI_INLINE_HOT_PATH)
+#define NALCHI_BIT_STREAM_HOT_PATH inline
+#else
+#define NALCHI_BIT_STREAM_HOT_PATH
+#endif
+
 namespace nalchi
 {
 
+class huffman_codebook;
+
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+__extension__ typedef unsigned __int128 uint128_t; ///< 128-bit unsigned integer for the wide bit stream scratch.
+#endif
+
+/// @brief Integer types that can be used with the compile-time `[Min, Max]` range.
+///
+/// `bool` and character types are excluded, as they can't be compared safely with the range bounds.
+template <typename T>
+concept ranged_integral = std::integral<T> && !std::same_as<T, bool> && !character<T>;
+
 /// @brief Helper stream to write bits to your buffer.
 ///
 /// Its design is based on the articles by Glenn Fiedler, see:
 /// * https://gafferongames.com/post/reading_and_writing_packets/
 /// * https://gafferongames.com/post/serialization_strategies/
 ///
+/// You would normally use `bit_stream_writer`, which writes 32-bit words with a 64-bit scratch. \n
+/// `wide_bit_stream_writer` writes 64-bit words with a 128-bit scratch instead, which flushes half as often,
+/// but the receiving side @b must use `wide_bit_stream_reader` to read it.
+///
 /// @note `bit_stream_writer` uses an internal scratch buffer,
 /// so the final few bytes might not be flushed to your buffer yet when you're done writing. \n
 /// So, after writing everything, you @b must call `flush_final()` to flush the remaining bytes to your buffer. \n
 /// (Destroying the `bit_stream_writer` instance won't flush them, either.)
-class bit_stream_writer final
+///
+/// This is the shared implementation of `bit_stream_writer` and `basic_bit_stream_writer`,
+/// so you would use those instead of this directly.
+/// @tparam Word Word type used to write to your buffer.
+/// @tparam Scratch Scratch type to store the temporary scratch data, which must be twice the size of @p Word.
+/// @tparam Derived Derived writer type returned from the chained writes.
+template <typename Word, typename Scratch, typename Derived>
+class bit_stream_writer_base
 {
+    friend Derived;
+
 public:
     using size_type = std::uint32_t; ///< Size type representing number of bits and bytes.
 
-    using scratch_type = std::uint64_t; ///< Internal scratch type to store the temporary scratch data.
-    using word_type = std::uint32_t;    ///< Internal word type used to write to your buffer.
+    using scratch_type = Scratch; ///< Internal scratch type to store the temporary scratch data.
+    using word_type = Word;       ///< Internal word type used to write to your buffer.
 
-    static_assert(std::is_unsigned_v<scratch_type>);
+    // `std::is_unsigned_v<>` is `false` for `unsigned __int128` on strict ISO mode, so check it manually.
+    static_assert(scratch_type(-1) > scratch_type(0), "`scratch_type` must be unsigned");
     static_assert(std::is_unsigned_v<word_type>);
     static_assert(sizeof(scratch_type) == 2 * sizeof(word_type));
 
@@ -108,6 +153,29 @@ public:
     static constexpr size_type MIN_STR_LEN_PREFIX_PREFIX = 0u;
     static constexpr size_type MAX_STR_LEN_PREFIX_PREFIX = 3u;
 
+    /// @brief Gets the number of bits of the "prefix of length prefix" + length prefix for a string.
+    /// @param len Length of the string.
+    /// @return Number of bits of the length prefixes.
+    static constexpr auto string_length_prefix_bits(std::uint64_t len) -> size_type
+    {
+        if (len <= std::numeric_limits<std::uint8_t>::max())
+            return STR_LEN_PREFIX_PREFIX_BITS + 8 * sizeof(std::uint8_t);
+        if (len <= std::numeric_limits<std::uint16_t>::max())
+            return STR_LEN_PREFIX_PREFIX_BITS + 8 * sizeof(std::uint16_t);
+        if (len <= std::numeric_limits<std::uint32_t>::max())
+            return STR_LEN_PREFIX_PREFIX_BITS + 8 * sizeof(std::uint32_t);
+        return STR_LEN_PREFIX_PREFIX_BITS + 8 * sizeof(std::uint64_t);
+    }
+
+    // Order of the Exp-Golomb code for the length of the Huffman coded string.
+    // Lengths below 16 take 5 bits, and below 48 take 7 bits.
+    static constexpr int STR_HUFFMAN_LENGTH_K = 4;
+
+    // Stream tags for `serialize()`, see `nalchi/serialize.hpp`.
+    static constexpr bool is_writing = true;
+    static constexpr bool is_reading = false;
+    static constexpr bool is_measuring = false;
+
 private:
     scratch_type _scratch;
     std::span<word_type> _words;
@@ -127,49 +195,56 @@ private:
     bool _fail;
 
     bool _final_flushed;
+    /// @brief Gets this stream as the derived writer type, which is returned from the chained writes.
+    auto self() -> Derived&
+    {
+        return static_cast<Derived&>(*this);
+    }
 
 public:
     /// @brief Deleted copy constructor.
-    bit_stream_writer(const bit_stream_writer&) = delete;
+    bit_stream_writer_base(const bit_stream_writer_base&) = delete;
 
     /// @brief Deleted copy assignment operator.
-    auto operator=(const bit_stream_writer&) -> bit_stream_writer& = delete;
+    auto operator=(const bit_stream_writer_base&) -> bit_stream_writer_base& = delete;
 
     /// @brief Constructs a `bit_stream_writer` instance without a buffer.
     ///
     /// This constructor can be useful if you want to set the buffer afterwards. \n
     /// To set the buffer, call `reset_with()`.
-    NALCHI_API bit_stream_writer();
+    bit_stream_writer_base();
 
     /// @brief Constructs a `bit_stream_writer` instance with a `shared_payload` buffer.
+    /// @note With 64-bit words, allocate @p buffer with `shared_payload::allocate_wide()`, \n
+    /// otherwise only the whole 64-bit words in it can be written.
     /// @param buffer Buffer to write bits to.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial write to the final word.
-    NALCHI_API bit_stream_writer(shared_payload buffer, size_type logical_bytes_length);
+    bit_stream_writer_base(shared_payload buffer, size_type logical_bytes_length);
 
     /// @brief Constructs a `bit_stream_writer` instance with a `std::span<word_type>` buffer.
     /// @param buffer Buffer to write bits to.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial write to the final word.
-    NALCHI_API bit_stream_writer(std::span<word_type> buffer, size_type logical_bytes_length);
+    bit_stream_writer_base(std::span<word_type> buffer, size_type logical_bytes_length);
 
     /// @brief Constructs a `bit_stream_writer` instance with a word range.
     /// @param begin Pointer to the beginning of a buffer.
     /// @param end Pointer to the end of a buffer.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial write to the final word.
-    NALCHI_API bit_stream_writer(word_type* begin, word_type* end, size_type logical_bytes_length);
+    bit_stream_writer_base(word_type* begin, word_type* end, size_type logical_bytes_length);
 
     /// @brief Constructs a `bit_stream_writer` instance with a word begin pointer and the word length.
     /// @param begin Pointer to the beginning of a buffer.
     /// @param words_length Number of words in the buffer.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial write to the final word.
-    NALCHI_API bit_stream_writer(word_type* begin, size_type words_length, size_type logical_bytes_length);
+    bit_stream_writer_base(word_type* begin, size_type words_length, size_type logical_bytes_length);
 
 public:
     /// @brief Force set the fail flag.
-    NALCHI_API void set_fail()
+    void set_fail()
     {
         _fail = true;
     }
@@ -178,7 +253,7 @@ public:
     ///
     /// If this is `true`, all the operations for this `bit_stream_writer` is no-op.
     /// @return `true` if writing has been failed, otherwise `false`.
-    NALCHI_API bool fail() const noexcept
+    bool fail() const noexcept
     {
         return _fail;
     }
@@ -187,7 +262,7 @@ public:
     /// This is effectively same as `fail()`.
     ///
     /// If this is `true`, all the operations for this `bit_stream_writer` is no-op.
-    NALCHI_API bool operator!() const noexcept
+    bool operator!() const noexcept
     {
         return fail();
     }
@@ -196,7 +271,7 @@ public:
     /// This is effectively same as `!fail()`.
     ///
     /// If this is `false`, all the operations for this `bit_stream_writer` is no-op.
-    NALCHI_API operator bool() const noexcept
+    operator bool() const noexcept
     {
         return !fail();
     }
@@ -204,39 +279,39 @@ public:
 public:
     /// @brief Gets the number of total bytes in the stream.
     /// @return Number of total bytes in the stream.
-    NALCHI_API auto total_bytes() const -> size_type
+    auto total_bytes() const -> size_type
     {
         return _logical_total_bits / 8;
     }
 
     /// @brief Gets the number of total bits in the stream.
     /// @return Number of total bits in the stream.
-    NALCHI_API auto total_bits() const -> size_type
+    auto total_bits() const -> size_type
     {
         return _logical_total_bits;
     }
 
     /// @brief Gets the number of used bytes in the stream.
     /// @return Number of used bytes in the stream.
-    NALCHI_API auto used_bytes() const -> size_type;
+    auto used_bytes() const -> size_type;
 
     /// @brief Gets the number of used bits in the stream.
     /// @return Number of used bits in the stream.
-    NALCHI_API auto used_bits() const -> size_type
+    auto used_bits() const -> size_type
     {
         return _logical_used_bits;
     }
 
     /// @brief Gets the number of unused bytes in the stream.
     /// @return Number of unused bytes in the stream.
-    NALCHI_API auto unused_bytes() const -> size_type
+    auto unused_bytes() const -> size_type
     {
         return total_bytes() - used_bytes();
     }
 
     /// @brief Gets the number of unused bits in the stream.
     /// @return Number of unused bits in the stream.
-    NALCHI_API auto unused_bits() const -> size_type
+    auto unused_bits() const -> size_type
     {
         return total_bits() - used_bits();
     }
@@ -245,20 +320,22 @@ public:
     /// @brief Restarts the stream so that it can write from the beginning again.
     /// @note This function resets internal states @b without flushing,
     /// so if you need flushing, you should call `flush_final()` beforehand.
-    NALCHI_API void restart();
+    void restart();
 
     /// @brief Resets the stream so that it no longer holds your buffer anymore.
     /// @note This function removes reference to your buffer @b without flushing, \n
     /// so if you need flushing, you should call `flush_final()` beforehand.
-    NALCHI_API void reset();
+    void reset();
 
     /// @brief Resets the stream with a `shared_payload` buffer.
     /// @note This function resets to the new buffer @b without flushing to your previous buffer, \n
     /// so if you need flushing, you should call `flush_final()` beforehand.
+    /// @note With 64-bit words, allocate @p buffer with `shared_payload::allocate_wide()`, \n
+    /// otherwise only the whole 64-bit words in it can be written.
     /// @param buffer Buffer to write bits to.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial write to the final word.
-    NALCHI_API void reset_with(shared_payload buffer, size_type logical_bytes_length);
+    void reset_with(shared_payload buffer, size_type logical_bytes_length);
 
     /// @brief Resets the stream with a `std::span<word_type>` buffer.
     /// @note This function resets to the new buffer @b without flushing to your previous buffer, \n
@@ -266,7 +343,7 @@ public:
     /// @param buffer Buffer to write bits to.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial write to the final word.
-    NALCHI_API void reset_with(std::span<word_type> buffer, size_type logical_bytes_length);
+    void reset_with(std::span<word_type> buffer, size_type logical_bytes_length);
 
     /// @brief Resets the stream with a word range.
     /// @note This function resets to the new buffer @b without flushing to your previous buffer, \n
@@ -275,7 +352,7 @@ public:
     /// @param end Pointer to the end of a buffer.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial write to the final word.
-    NALCHI_API void reset_with(word_type* begin, word_type* end, size_type logical_bytes_length);
+    void reset_with(word_type* begin, word_type* end, size_type logical_bytes_length);
 
     /// @brief Resets the stream with a word begin pointer and the word length.
     /// @note This function resets to the new buffer @b without flushing to your previous buffer, \n
@@ -284,17 +361,17 @@ public:
     /// @param words_length Number of words in the buffer.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial write to the final word.
-    NALCHI_API void reset_with(word_type* begin, size_type words_length, size_type logical_bytes_length);
+    void reset_with(word_type* begin, size_type words_length, size_type logical_bytes_length);
 
     /// @brief Flushes the last remaining bytes on the internal scratch buffer to your buffer.
     /// @note This function must be only called when you're done writing. \n
     /// Any attempt to write more data after calling this function will set the fail flag and write nothing.
     /// @return The stream itself.
-    NALCHI_API auto flush_final() -> bit_stream_writer&;
+    auto flush_final() -> Derived&;
 
     /// @brief Checks if `flush_final()` has been called or not.
     /// @return Whether the `flush_final()` has been called or not.
-    NALCHI_API bool flushed() const
+    bool flushed() const
     {
         return _final_flushed;
     }
@@ -306,7 +383,27 @@ public:
     /// @param data Pointer to the arbitrary data.
     /// @param size Size in bytes of the data.
     /// @return The stream itself.
-    NALCHI_API auto write(const void* data, size_type size) -> bit_stream_writer&;
+    auto write(const void* data, size_type size) -> Derived&;
+
+    /// @brief Pads zero bits to the next byte boundary of the bit stream.
+    ///
+    /// The reading side @b must call `align_to_byte()` at the same position.
+    /// @return The stream itself.
+    auto align_to_byte() -> Derived&;
+
+    /// @brief Pads zero bits to the next word boundary of the bit stream.
+    ///
+    /// The reading side @b must call `align_to_word()` at the same position.
+    /// @return The stream itself.
+    auto align_to_word() -> Derived&;
+
+    /// @brief Pads zero bits to the next byte boundary, and writes some arbitrary data there.
+    ///
+    /// As the data is byte aligned, the reading side can view it in place with `read_aligned_bytes()`.
+    /// @param data Pointer to the arbitrary data.
+    /// @param size Size in bytes of the data.
+    /// @return The stream itself.
+    auto write_aligned_bytes(const void* data, size_type size) -> Derived&;
 
     /// @brief Writes an integral value to the bit stream.
     /// @tparam SInt Small integer type that doesn't exceed the size of `word_type`.
@@ -317,7 +414,7 @@ public:
     template <std::integral SInt>
         requires(sizeof(SInt) <= sizeof(word_type))
     auto write(SInt data, SInt min = std::numeric_limits<SInt>::min(), SInt max = std::numeric_limits<SInt>::max())
-        -> bit_stream_writer&
+        -> Derived&
     {
         return do_write<true>(data, min, max);
     }
@@ -331,7 +428,7 @@ public:
     template <std::integral BInt>
         requires(sizeof(BInt) > sizeof(word_type))
     auto write(BInt data, BInt min = std::numeric_limits<BInt>::min(), BInt max = std::numeric_limits<BInt>::max())
-        -> bit_stream_writer&
+        -> Derived&
     {
         return do_write<true>(data, min, max);
     }
@@ -339,12 +436,328 @@ public:
     /// @brief Writes a float value to the bit stream.
     /// @param data Data to write.
     /// @return The stream itself.
-    NALCHI_API auto write(float data) -> bit_stream_writer&;
+    auto write(float data) -> Derived&;
 
     /// @brief Writes a double value to the bit stream.
     /// @param data Data to write.
     /// @return The stream itself.
-    NALCHI_API auto write(double data) -> bit_stream_writer&;
+    auto write(double data) -> Derived&;
+
+    /// @brief Writes a float value quantized in the bounded range to the bit stream.
+    ///
+    /// @p data is rounded to the nearest multiple of @p resolution from @p min,
+    /// which takes `bit_width(ceil((max - min) / resolution))` bits. \n
+    /// e.g. A position in `[-512, 512]` with `0.01` resolution takes 17 bits, instead of 32 bits. \n
+    /// If the range is invalid (see `quantized_max()`), or @p data is out of the range or NaN,
+    /// this function will set the fail flag and write nothing.
+    /// @param data Data to write.
+    /// @param min Minimum value allowed for @p data.
+    /// @param max Maximum value allowed for @p data.
+    /// @param resolution Step between the quantized values.
+    /// @return The stream itself.
+    auto write_quantized(float data, float min, float max, float resolution) -> Derived&;
+
+    /// @brief Writes a float value to the bit stream as an IEEE 754 half-precision float, which takes 16 bits.
+    ///
+    /// It's rounded to the nearest half float, which has 11 significant bits and the maximum finite value 65504.
+    /// @param data Data to write.
+    /// @return The stream itself.
+    auto write_half(float data) -> Derived&;
+
+    /// @brief Writes an array of 3D vectors, each component quantized in the bounded range of its axis,
+    /// to the bit stream.
+    ///
+    /// The result is same as writing the `x, y, z` components of each vector one by one with `write_quantized()`, \n
+    /// but the components are quantized with SIMD and packed in bulk, with a single overflow check. \n
+    /// If the range of any axis is invalid, or any component is out of the range or NaN,
+    /// this function will set the fail flag and write nothing.
+    /// @param data Array of 3D vectors to write.
+    /// @param min Minimum value allowed for each axis.
+    /// @param max Maximum value allowed for each axis.
+    /// @param resolution Step between the quantized values.
+    /// @return The stream itself.
+    auto write_vec3_array(std::span<const std::array<float, 3>> data, const std::array<float, 3>& min,
+                          const std::array<float, 3>& max, float resolution) -> Derived&;
+
+    /// @brief Writes a rotation quaternion to the bit stream with the smallest-three encoding.
+    ///
+    /// It takes `2 + 3 * bits_per_component` bits, see `encode_smallest_three()` for details. \n
+    /// If @p bits_per_component is out of
+    /// `[SMALLEST_THREE_MIN_BITS_PER_COMPONENT, SMALLEST_THREE_MAX_BITS_PER_COMPONENT]`,
+    /// or @p quat is zero or not finite, this function will set the fail flag and write nothing.
+    /// @param quat Quaternion to write, in `x, y, z, w` order.
+    /// @param bits_per_component Bits per each of the smallest three components.
+    /// @return The stream itself.
+    auto write_quaternion(const std::array<float, 4>& quat, int bits_per_component = 9) -> Derived&;
+
+    /// @brief Writes an array of rotation quaternions to the bit stream with the smallest-three encoding.
+    ///
+    /// The result is same as writing each quaternion one by one with `write_quaternion()`, \n
+    /// but the overflow check is done once for the whole array, and the codes are packed in bulk. \n
+    /// If any quaternion can't be encoded, this function will set the fail flag and write nothing.
+    /// @param quats Array of quaternions to write, in `x, y, z, w` order.
+    /// @param bits_per_component Bits per each of the smallest three components.
+    /// @return The stream itself.
+    auto write_quaternion_array(std::span<const std::array<float, 4>> quats, int bits_per_component = 9)
+        -> Derived&;
+
+    /// @brief Writes a direction to the bit stream with the octahedral encoding.
+    ///
+    /// It takes `2 * bits_per_axis` bits, see `encode_octahedral()` for details. \n
+    /// If @p bits_per_axis is out of `[OCTAHEDRAL_MIN_BITS_PER_AXIS, OCTAHEDRAL_MAX_BITS_PER_AXIS]`,
+    /// or @p vec is zero or not finite, this function will set the fail flag and write nothing.
+    /// @param vec Direction to write, which is normalized on read.
+    /// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
+    /// @return The stream itself.
+    auto write_unit_vector(const std::array<float, 3>& vec, int bits_per_axis = 12) -> Derived&;
+
+    /// @brief Writes an array of directions to the bit stream with the octahedral encoding.
+    ///
+    /// The result is same as writing each direction one by one with `write_unit_vector()`, \n
+    /// but the overflow check is done once for the whole array, and the codes are packed in bulk. \n
+    /// If any direction can't be encoded, this function will set the fail flag and write nothing.
+    /// @param vecs Array of directions to write.
+    /// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
+    /// @return The stream itself.
+    auto write_unit_vector_array(std::span<const std::array<float, 3>> vecs, int bits_per_axis = 12)
+        -> Derived&;
+
+    /// @brief Writes an integral value with a compile-time range to the bit stream.
+    ///
+    /// As the range is known at compile-time, the number of bits to write is a constant,
+    /// and an invalid range is a compile error.
+    /// @tparam Min Minimum value allowed for @p data.
+    /// @tparam Max Maximum value allowed for @p data.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to write.
+    /// @return The stream itself.
+    template <std::integral auto Min, std::integral auto Max, ranged_integral Int>
+    auto write(Int data) -> Derived&
+    {
+        static_assert(std::cmp_less(Min, Max), "`Min` must be less than `Max`");
+        static_assert(std::in_range<Int>(Min) && std::in_range<Int>(Max), "`Min` and `Max` must fit in `Int`");
+
+        using UInt = std::make_unsigned_t<Int>;
+
+        constexpr Int min = static_cast<Int>(Min);
+        constexpr Int max = static_cast<Int>(Max);
+        constexpr int BITS = std::bit_width(static_cast<UInt>(static_cast<UInt>(max) - static_cast<UInt>(min)));
+
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+        NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+        NALCHI_BIT_STREAM_WRITER_FAIL_IF_DATA_OUT_OF_RANGE(self());
+
+        // Fail if user buffer overflows.
+        if (_logical_used_bits + BITS > _logical_total_bits)
+        {
+            _fail = true;
+            return self();
+        }
+
+        do_write_bits_unchecked<BITS>(static_cast<UInt>(static_cast<UInt>(data) - static_cast<UInt>(min)));
+
+        return self();
+    }
+
+    /// @brief Writes an array of integral values, which share the same range, to the bit stream.
+    ///
+    /// The result is same as writing each element one by one with `write(data[i], min, max)`, \n
+    /// but the overflow check is done once for the whole array, and the elements are packed in bulk. \n
+    /// If any element is out of range, this function will set the fail flag and write nothing.
+    /// @tparam Int Integer type of the elements.
+    /// @param data Array to write.
+    /// @param min Minimum value allowed for each element.
+    /// @param max Maximum value allowed for each element.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    auto write_array(std::span<const Int> data, std::type_identity_t<Int> min = std::numeric_limits<Int>::min(),
+                     std::type_identity_t<Int> max = std::numeric_limits<Int>::max()) -> Derived&
+    {
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+        NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+        NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(self());
+
+        using UInt = std::make_unsigned_t<Int>;
+
+        const int bits = std::bit_width(static_cast<UInt>(static_cast<UInt>(max) - static_cast<UInt>(min)));
+
+        // Fail if user buffer overflows.
+        if (static_cast<std::uint64_t>(bits) * data.size() > _logical_total_bits - _logical_used_bits)
+        {
+            _fail = true;
+            return self();
+        }
+
+        // Fail if any element is out of range.
+        // Simple loop without early exit, so that it can be vectorized.
+        bool out_of_range = false;
+        for (const Int elem : data)
+            out_of_range |= (elem < min) | (elem > max);
+        if (out_of_range)
+        {
+            _fail = true;
+            return self();
+        }
+
+        UInt values[ARRAY_CHUNK_LENGTH];
+
+        for (std::size_t i = 0; i < data.size(); i += ARRAY_CHUNK_LENGTH)
+        {
+            const std::size_t chunk_length = std::min(data.size() - i, ARRAY_CHUNK_LENGTH);
+
+            // Convert elements to values to actually write.
+            for (std::size_t j = 0; j < chunk_length; ++j)
+                values[j] = static_cast<UInt>(static_cast<UInt>(data[i + j]) - static_cast<UInt>(min));
+
+            do_write_packed_unchecked(values, sizeof(UInt), chunk_length, bits);
+        }
+
+        return self();
+    }
+
+    /// @brief Writes an integral value to the bit stream as a varint.
+    ///
+    /// @p data is written in 7-bit groups from the least significant one,
+    /// and each group is followed by a bit telling whether more groups follow. \n
+    /// So, `[0, 127]` takes 8 bits, `[128, 16383]` takes 16 bits, and so on. \n
+    /// Signed values are zigzag encoded first, so that small negative values also take fewer bits.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to write.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    auto write_varint(Int data) -> Derived&
+    {
+        if constexpr (std::is_signed_v<Int>)
+            return do_write_varint(zigzag_encode(data));
+        else
+            return do_write_varint(data);
+    }
+
+    /// @brief Writes an integral value to the bit stream as an Exp-Golomb code of order @p k.
+    ///
+    /// With `n = bit_width(data + 2^k) - 1`, this writes `n - k` zero bits, a one bit,
+    /// and the lower `n` bits of `data + 2^k`, `2n - k + 1` bits in total. \n
+    /// So, it suits values that are mostly small, but can be large occasionally. \n
+    /// Greater @p k spends more bits on small values, but fewer bits on large values. \n
+    /// Signed values are zigzag encoded first, so that small negative values also take fewer bits.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to write.
+    /// @param k Order of the Exp-Golomb code, which must be less than the bit width of @p Int.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    auto write_exp_golomb(Int data, int k = 0) -> Derived&
+    {
+        if (k < 0 || k >= static_cast<int>(8 * sizeof(Int)))
+        {
+            _fail = true;
+            return self();
+        }
+
+        if constexpr (std::is_signed_v<Int>)
+            return do_write_exp_golomb(zigzag_encode(data), k);
+        else
+            return do_write_exp_golomb(data, k);
+    }
+
+    /// @brief Writes a positive integral value to the bit stream as an Elias gamma code.
+    ///
+    /// With `n = bit_width(data) - 1`, this writes `n` zero bits, a one bit, and the lower `n` bits of @p data. \n
+    /// This is same as the Exp-Golomb code of order 0 for `data - 1`. \n
+    /// If @p data is `0`, this function will set the fail flag and write nothing.
+    /// @tparam UInt Unsigned integer type of @p data.
+    /// @param data Data to write, which must be positive.
+    /// @return The stream itself.
+    template <ranged_integral UInt>
+        requires std::unsigned_integral<UInt>
+    auto write_elias_gamma(UInt data) -> Derived&
+    {
+        if (data == 0)
+        {
+            _fail = true;
+            return self();
+        }
+
+        return do_write_exp_golomb(data - 1u, 0);
+    }
+
+    /// @brief Writes an integral value to the bit stream, delta encoded against @p baseline.
+    ///
+    /// This writes a one bit if @p data equals @p baseline. \n
+    /// Otherwise, this writes a zero bit, and then either a one bit and the Exp-Golomb code of order 0
+    /// for `delta_code(data, baseline) - 1`, or a zero bit and @p data itself in the `[min, max]` range,
+    /// whichever is shorter, preferring the former on a tie. \n
+    /// See `delta_bits()` for the exact size. \n
+    /// If @p data or @p baseline is out of range, this function will set the fail flag and write nothing.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to write.
+    /// @param baseline Baseline to get the difference from, which the reader must know as well.
+    /// @param min Minimum value allowed for @p data and @p baseline.
+    /// @param max Maximum value allowed for @p data and @p baseline.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    auto write_delta(Int data, std::type_identity_t<Int> baseline,
+                     std::type_identity_t<Int> min = std::numeric_limits<Int>::min(),
+                     std::type_identity_t<Int> max = std::numeric_limits<Int>::max()) -> Derived&
+    {
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+        NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+        NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(self());
+        NALCHI_BIT_STREAM_WRITER_FAIL_IF_DATA_OUT_OF_RANGE(self());
+
+        // Fail if `baseline` is out of range.
+        if (baseline < min || baseline > max)
+        {
+            _fail = true;
+            return self();
+        }
+
+        const int bits = delta_bits<Int>(data, baseline, min, max);
+
+        // Fail if user buffer overflows.
+        if (_logical_used_bits + bits > _logical_total_bits)
+        {
+            _fail = true;
+            return self();
+        }
+
+        // Unchanged flag.
+        do_write_raw_bits_unchecked(data == baseline, 1);
+        if (data == baseline)
+            return self();
+
+        const auto code = static_cast<std::uint64_t>(delta_code<Int>(data, baseline) - 1u);
+        const bool use_delta = (bits - 2 == exp_golomb_bits(code, 0));
+
+        // Delta flag.
+        do_write_raw_bits_unchecked(use_delta, 1);
+        if (use_delta)
+            return do_write_exp_golomb(code, 0);
+        else
+            return do_write<false>(data, min, max);
+    }
+
+    /// @brief Writes bytes encoded with a static Huffman codebook to the bit stream.
+    ///
+    /// The number of bytes is not written, so the reading side must know it. \n
+    /// If @p codebook is invalid, or some bytes are not in @p codebook,
+    /// this function will set the fail flag and write nothing.
+    /// @param data Bytes to write.
+    /// @param size Number of bytes.
+    /// @param codebook Codebook to encode the bytes with, which must be the same one used on read.
+    /// @return The stream itself.
+    auto write_huffman(const void* data, size_type size, const huffman_codebook& codebook)
+        -> Derived&;
+
+    /// @brief Writes a string encoded with a static Huffman codebook to the bit stream.
+    ///
+    /// The length is written as an Exp-Golomb code of order `STR_HUFFMAN_LENGTH_K`,
+    /// which is shorter than the length prefix of `write()` for short strings. \n
+    /// If @p codebook is invalid, or some characters are not in @p codebook,
+    /// this function will set the fail flag and write nothing.
+    /// @param str String to write.
+    /// @param codebook Codebook to encode the characters with, which must be the same one used on read.
+    /// @return The stream itself.
+    auto write_string_huffman(std::string_view str, const huffman_codebook& codebook) -> Derived&;
 
     /// @brief Writes a string view to the bit stream.
     /// @tparam CharT Underlying character type of `std::basic_string_view`.
@@ -352,10 +765,10 @@ public:
     /// @param str String to write.
     /// @return The stream itself.
     template <character CharT, typename CharTraits>
-    auto write(std::basic_string_view<CharT, CharTraits> str) -> bit_stream_writer&
+    auto write(std::basic_string_view<CharT, CharTraits> str) -> Derived&
     {
-        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
-        NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(*this);
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+        NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
         // Get the length of the string.
         const auto len = str.length();
@@ -391,11 +804,10 @@ public:
             do_write<false>(static_cast<std::uint64_t>(len)); // length prefix
         }
 
-        // Just write every character one by one.
-        for (const auto ch : str)
-            do_write<false>(ch);
+        // Write the characters in bulk.
+        do_write_chars_unchecked(str.data(), str.length());
 
-        return *this;
+        return self();
     }
 
     /// @brief Writes a string to the bit stream.
@@ -405,93 +817,329 @@ public:
     /// @param str String to write.
     /// @return The stream itself.
     template <character CharT, typename CharTraits, typename Allocator>
-    auto write(const std::basic_string<CharT, CharTraits, Allocator>& str) -> bit_stream_writer&
+    auto write(const std::basic_string<CharT, CharTraits, Allocator>& str) -> Derived&
     {
         return write(std::basic_string_view<CharT, CharTraits>(str));
     }
 
+    /// @brief Writes a string view to the bit stream, with its characters aligned to their size.
+    ///
+    /// This pads zero bits between the length prefix and the characters, \n
+    /// so that the reading side can always view the characters in place with `read_aligned_string_view()`. \n
+    /// The reading side @b must read it with `read_aligned_string_view()`, not with `read()` or `read_view()`.
+    /// @tparam CharT Underlying character type of `std::basic_string_view`.
+    /// @tparam CharTraits Char traits for `CharT`.
+    /// @param str String to write.
+    /// @return The stream itself.
+    template <character CharT, typename CharTraits>
+    auto write_aligned_string(std::basic_string_view<CharT, CharTraits> str) -> Derived&
+    {
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+        NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+
+        constexpr size_type CHAR_BITS = 8 * sizeof(CharT);
+
+        const auto len = str.length();
+        const size_type chars_begin = _logical_used_bits + string_length_prefix_bits(len);
+        const size_type padding_bits = (CHAR_BITS - chars_begin % CHAR_BITS) % CHAR_BITS;
+
+        // Fail if user buffer overflows, including the padding.
+        if (chars_begin + padding_bits + CHAR_BITS * len > _logical_total_bits)
+        {
+            _fail = true;
+            return self();
+        }
+
+        do_write_string_length_unchecked(len);
+        if (padding_bits > 0)
+            do_write_raw_bits_unchecked(0, static_cast<int>(padding_bits));
+
+        // Write the characters in bulk.
+        do_write_chars_unchecked(str.data(), len);
+
+        return self();
+    }
+
+    /// @brief Writes a string to the bit stream, with its characters aligned to their size.
+    ///
+    /// The reading side @b must read it with `read_aligned_string_view()`.
+    /// @tparam CharT Underlying character type of `std::basic_string`.
+    /// @tparam CharTraits Char traits for `CharT`.
+    /// @tparam Allocator Underlying allocator for `std::basic_string`.
+    /// @param str String to write.
+    /// @return The stream itself.
+    template <character CharT, typename CharTraits, typename Allocator>
+    auto write_aligned_string(const std::basic_string<CharT, CharTraits, Allocator>& str) -> Derived&
+    {
+        return write_aligned_string(std::basic_string_view<CharT, CharTraits>(str));
+    }
+
     /// @brief Writes a null-terminated string to the bit stream.
     /// @tparam CharT Character type of the null-terminated string.
     /// @param str String to write.
     /// @return The stream itself.
     template <character CharT>
-    auto write(const CharT* str) -> bit_stream_writer&
+    auto write(const CharT* str) -> Derived&
     {
         return write(std::basic_string_view<CharT>(str));
     }
 
-private:
-    /// @brief Actually writes an integral value to the bit stream.
-    /// @tparam Checked Whether the checks are performed or not.
-    /// @tparam SInt Small integer type that doesn't exceed the size of `word_type`.
-    /// @param data Data to write.
-    /// @param min Minimum value allowed for @p data.
-    /// @param max Maximum value allowed for @p data.
-    /// @return The stream itself.
-    template <bool Checked, std::integral SInt>
-        requires(sizeof(SInt) <= sizeof(word_type))
-    auto do_write(SInt data, SInt min = std::numeric_limits<SInt>::min(), SInt max = std::numeric_limits<SInt>::max())
-        -> bit_stream_writer&
+public:
+    /// @brief Session that writes to the bit stream without per-field checks.
+    ///
+    /// The capacity is validated only once when the session begins, and every write after that skips
+    /// the already-failed, final-flushed, range and overflow checks. \n
+    /// This is useful when you've already sized your buffer exactly with `bit_stream_measurer`.
+    /// @note Range checks and reserved bits overrun checks are only performed on debug builds. \n
+    /// On release builds, writing out-of-range data or more bits than reserved is undefined behavior.
+    class unchecked_session final
     {
-        if constexpr (Checked)
-        {
-            NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
-            NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(*this);
-            NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(*this);
-            NALCHI_BIT_STREAM_WRITER_FAIL_IF_DATA_OUT_OF_RANGE(*this);
-        }
+    private:
+        bit_stream_writer_base& _writer;
+        bool _valid;
 
-        using UInt = make_unsigned_allow_bool_t<SInt>;
+        // Only checked on debug builds, but kept on every build,
+        // so that the layout doesn't differ between the library and the user code built with different `NDEBUG`.
+        size_type _reserved_end_bits;
 
-        // Convert `data` to `value` to actually write.
-        const scratch_type value = static_cast<UInt>(((UInt)data) - ((UInt)min));
-        const int bits = std::bit_width(static_cast<UInt>(((UInt)max) - ((UInt)min)));
+    public:
+        /// @brief Deleted copy constructor.
+        unchecked_session(const unchecked_session&) = delete;
 
-        if constexpr (Checked)
+        /// @brief Deleted copy assignment operator.
+        auto operator=(const unchecked_session&) -> unchecked_session& = delete;
+
+    private:
+        friend class bit_stream_writer_base;
+
+        /// @brief Begins the session, validating the capacity of @p writer once.
+        /// @param writer Writer to write to.
+        /// @param reserved_bits Number of bits to reserve for this session.
+        unchecked_session(bit_stream_writer_base& writer, size_type reserved_bits)
+            : _writer(writer), _valid(false), _reserved_end_bits(0)
         {
-            // Fail if user buffer overflows.
-            if (_logical_used_bits + bits > _logical_total_bits)
+            if (writer.fail())
+                return;
+
+            if (writer._final_flushed || writer._logical_used_bits + reserved_bits > writer._logical_total_bits ||
+                writer._logical_used_bits + reserved_bits < writer._logical_used_bits)
             {
-                _fail = true;
-                return *this;
+                writer._fail = true;
+                return;
             }
-        }
-
-        // Write `value` to `_scratch`, and flush if scratch overflow.
-        _scratch |= (value << _scratch_index);
-        _scratch_index += bits;
-        flush_if_scratch_overflow();
 
-        // Adjust used bits
-        _logical_used_bits += bits;
+            _valid = true;
+            _reserved_end_bits = writer._logical_used_bits + reserved_bits;
+        }
 
-        return *this;
-    }
+    public:
+        /// @brief Check if the session has been validated successfully.
+        ///
+        /// If this is `false`, all the writes for this session is no-op.
+        /// @return `true` if the session is valid, otherwise `false`.
+        bool valid() const noexcept
+        {
+            return _valid;
+        }
 
-    /// @brief Actually writes an integral value to the bit stream.
-    /// @tparam Checked Whether the checks are performed or not.
-    /// @tparam BInt Big integer type that exceeds the size of `word_type`.
-    /// @param data Data to write.
-    /// @param min Minimum value allowed for @p data.
-    /// @param max Maximum value allowed for @p data.
-    /// @return The stream itself.
-    template <bool Checked, std::integral BInt>
-        requires(sizeof(BInt) > sizeof(word_type))
-    auto do_write(BInt data, BInt min = std::numeric_limits<BInt>::min(), BInt max = std::numeric_limits<BInt>::max())
-        -> bit_stream_writer&
-    {
-        if constexpr (Checked)
+        /// @brief Check if the session has been validated successfully. \n
+        /// This is effectively same as `valid()`.
+        explicit operator bool() const noexcept
         {
-            NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
-            NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(*this);
-            NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(*this);
-            NALCHI_BIT_STREAM_WRITER_FAIL_IF_DATA_OUT_OF_RANGE(*this);
+            return valid();
         }
 
-        // Current logic assumes the only size here is 64 bits, but hey who wouldn't?
-        static_assert(sizeof(BInt) == 2 * sizeof(word_type));
+    public:
+        /// @brief Writes an integral value to the bit stream without checks.
+        /// @tparam Int Integer type to write.
+        /// @param data Data to write.
+        /// @param min Minimum value allowed for @p data.
+        /// @param max Maximum value allowed for @p data.
+        /// @return The session itself.
+        template <std::integral Int>
+        auto write(Int data, Int min = std::numeric_limits<Int>::min(), Int max = std::numeric_limits<Int>::max())
+            -> unchecked_session&
+        {
+#ifndef NDEBUG
+            using UInt = make_unsigned_allow_bool_t<Int>;
 
-        using UInt = make_unsigned_allow_bool_t<BInt>;
+            if (!debug_check(min < max && min <= data && data <= max,
+                             std::bit_width(static_cast<UInt>(((UInt)max) - ((UInt)min)))))
+                return *this;
+#endif
+
+            if (_valid)
+                _writer.template do_write<false>(data, min, max);
+
+            return *this;
+        }
+
+        /// @brief Writes an integral value with a compile-time range to the bit stream without checks.
+        /// @tparam Min Minimum value allowed for @p data.
+        /// @tparam Max Maximum value allowed for @p data.
+        /// @tparam Int Integer type of @p data.
+        /// @param data Data to write.
+        /// @return The session itself.
+        template <std::integral auto Min, std::integral auto Max, ranged_integral Int>
+        auto write(Int data) -> unchecked_session&
+        {
+            static_assert(std::cmp_less(Min, Max), "`Min` must be less than `Max`");
+            static_assert(std::in_range<Int>(Min) && std::in_range<Int>(Max), "`Min` and `Max` must fit in `Int`");
+
+            using UInt = std::make_unsigned_t<Int>;
+
+            constexpr Int min = static_cast<Int>(Min);
+            constexpr Int max = static_cast<Int>(Max);
+            constexpr int BITS = std::bit_width(static_cast<UInt>(static_cast<UInt>(max) - static_cast<UInt>(min)));
+
+#ifndef NDEBUG
+            if (!debug_check(min <= data && data <= max, BITS))
+                return *this;
+#endif
+
+            if (_valid)
+                _writer.template do_write_bits_unchecked<BITS>(
+                    static_cast<UInt>(static_cast<UInt>(data) - static_cast<UInt>(min)));
+
+            return *this;
+        }
+
+        /// @brief Writes a float value to the bit stream without checks.
+        /// @param data Data to write.
+        /// @return The session itself.
+        auto write(float data) -> unchecked_session&
+        {
+            // Use the reinterpreted value of `data` as an u32
+            return write(std::bit_cast<std::uint32_t>(data));
+        }
+
+        /// @brief Writes a double value to the bit stream without checks.
+        /// @param data Data to write.
+        /// @return The session itself.
+        auto write(double data) -> unchecked_session&
+        {
+            // Use the reinterpreted value of `data` as an u64
+            return write(std::bit_cast<std::uint64_t>(data));
+        }
+
+        /// @brief Writes some arbitrary data to the bit stream without checks.
+        /// @note Bytes in your data could be read @b swapped if it is sent to the system with different endianness.
+        /// @param data Pointer to the arbitrary data.
+        /// @param size Size in bytes of the data.
+        /// @return The session itself.
+        auto write(const void* data, size_type size) -> unchecked_session&
+        {
+#ifndef NDEBUG
+            if (!debug_check(data != nullptr || size == 0, static_cast<int>(8 * size)))
+                return *this;
+#endif
+
+            if (_valid)
+                _writer.do_write_bytes_unchecked(static_cast<const std::byte*>(data), size);
+
+            return *this;
+        }
+
+    private:
+        /// @brief Checks the debug-only conditions, and invalidates the session if they're violated.
+        /// @param ok Whether the arguments are valid or not.
+        /// @param bits Number of bits to write.
+        /// @return Whether the write can proceed or not.
+        bool debug_check(bool ok, int bits)
+        {
+            if (_valid && (!ok || _writer._logical_used_bits + bits > _reserved_end_bits))
+            {
+                _valid = false;
+                _writer._fail = true;
+            }
+
+            return _valid;
+        }
+    };
+
+    /// @brief Begins an `unchecked_session` that can write @p reserved_bits without per-field checks.
+    ///
+    /// If the stream has already failed, has been final flushed, or doesn't have enough space for @p reserved_bits,
+    /// the fail flag is set and the returned session is invalid, which makes all of its writes no-op.
+    /// @param reserved_bits Number of bits to reserve, e.g. `bit_stream_measurer::used_bits()`.
+    /// @return The session.
+    auto begin_unchecked(size_type reserved_bits) -> unchecked_session
+    {
+        return unchecked_session(*this, reserved_bits);
+    }
+
+private:
+    /// @brief Actually writes an integral value to the bit stream.
+    /// @tparam Checked Whether the checks are performed or not.
+    /// @tparam SInt Small integer type that doesn't exceed the size of `word_type`.
+    /// @param data Data to write.
+    /// @param min Minimum value allowed for @p data.
+    /// @param max Maximum value allowed for @p data.
+    /// @return The stream itself.
+    template <bool Checked, std::integral SInt>
+        requires(sizeof(SInt) <= sizeof(word_type))
+    auto do_write(SInt data, SInt min = std::numeric_limits<SInt>::min(), SInt max = std::numeric_limits<SInt>::max())
+        -> Derived&
+    {
+        if constexpr (Checked)
+        {
+            NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+            NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+            NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(self());
+            NALCHI_BIT_STREAM_WRITER_FAIL_IF_DATA_OUT_OF_RANGE(self());
+        }
+
+        using UInt = make_unsigned_allow_bool_t<SInt>;
+
+        // Convert `data` to `value` to actually write.
+        const scratch_type value = static_cast<UInt>(((UInt)data) - ((UInt)min));
+        const int bits = std::bit_width(static_cast<UInt>(((UInt)max) - ((UInt)min)));
+
+        if constexpr (Checked)
+        {
+            // Fail if user buffer overflows.
+            if (_logical_used_bits + bits > _logical_total_bits)
+            {
+                _fail = true;
+                return self();
+            }
+        }
+
+        // Write `value` to `_scratch`, and flush if scratch overflow.
+        _scratch |= (value << _scratch_index);
+        _scratch_index += bits;
+        flush_if_scratch_overflow();
+
+        // Adjust used bits
+        _logical_used_bits += bits;
+
+        return self();
+    }
+
+    /// @brief Actually writes an integral value to the bit stream.
+    /// @tparam Checked Whether the checks are performed or not.
+    /// @tparam BInt Big integer type that exceeds the size of `word_type`.
+    /// @param data Data to write.
+    /// @param min Minimum value allowed for @p data.
+    /// @param max Maximum value allowed for @p data.
+    /// @return The stream itself.
+    template <bool Checked, std::integral BInt>
+        requires(sizeof(BInt) > sizeof(word_type))
+    auto do_write(BInt data, BInt min = std::numeric_limits<BInt>::min(), BInt max = std::numeric_limits<BInt>::max())
+        -> Derived&
+    {
+        if constexpr (Checked)
+        {
+            NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+            NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+            NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(self());
+            NALCHI_BIT_STREAM_WRITER_FAIL_IF_DATA_OUT_OF_RANGE(self());
+        }
+
+        // Current logic assumes the only size here is 64 bits, but hey who wouldn't?
+        static_assert(sizeof(BInt) == 2 * sizeof(word_type));
+
+        using UInt = make_unsigned_allow_bool_t<BInt>;
 
         // Convert `data` to `value`.
         const scratch_type value = static_cast<UInt>(((UInt)data) - ((UInt)min));
@@ -503,7 +1151,7 @@ private:
             if (_logical_used_bits + bits > _logical_total_bits)
             {
                 _fail = true;
-                return *this;
+                return self();
             }
         }
 
@@ -531,31 +1179,334 @@ private:
         // Adjust used bits
         _logical_used_bits += bits;
 
-        return *this;
+        return self();
     }
 
 private:
-    NALCHI_API void flush_if_scratch_overflow();
+    /// @brief Actually writes a varint to the bit stream.
+    /// @param value Unsigned value to write.
+    /// @return The stream itself.
+    auto do_write_varint(std::uint64_t value) -> Derived&;
+
+    /// @brief Actually writes an Exp-Golomb code to the bit stream.
+    /// @param value Unsigned value to write.
+    /// @param k Order of the Exp-Golomb code, which must be between 0 and 63.
+    /// @return The stream itself.
+    auto do_write_exp_golomb(std::uint64_t value, int k) -> Derived&;
+
+    /// @brief Actually writes a runtime number of raw bits to the bit stream, without any checks.
+    /// @param value Raw bits to write, which must not have bits set above @p bits.
+    /// @param bits Number of bits to write, which must be between 1 and 64.
+    void do_write_raw_bits_unchecked(std::uint64_t value, int bits);
+
+    /// @brief Actually pads zero bits to the next multiple of @p alignment_bits.
+    /// @param alignment_bits Alignment in bits, which must be a multiple of 8 up to 64.
+    /// @return The stream itself.
+    auto do_align(int alignment_bits) -> Derived&;
+
+    /// @brief Actually writes the "prefix of length prefix" + length prefix of a string, without any checks.
+    /// @param len Length of the string.
+    void do_write_string_length_unchecked(std::uint64_t len);
+
+    /// @brief Actually writes the Huffman codes of bytes to the bit stream, without any checks.
+    /// @param data Bytes to write, which must be all in @p codebook.
+    /// @param size Number of bytes.
+    /// @param codebook Codebook to encode the bytes with.
+    void do_write_huffman_unchecked(const std::uint8_t* data, size_type size, const huffman_codebook& codebook);
+
+    /// @brief Number of array elements converted & packed at once, to keep the temporary buffers on the stack.
+    static constexpr std::size_t ARRAY_CHUNK_LENGTH = 256;
+
+    /// @brief Actually writes unsigned values with the same number of bits to the bit stream, without any checks.
+    ///
+    /// They're packed in bulk with the fastest kernel available on the running CPU, \n
+    /// and then written with `do_write_bytes_unchecked()`.
+    /// @param values Pointer to the unsigned values, each of them must not have bits set above @p bits.
+    /// @param value_size Size in bytes of each value.
+    /// @param count Number of values, which must not exceed `ARRAY_CHUNK_LENGTH`.
+    /// @param bits Number of bits for each value.
+    void do_write_packed_unchecked(const void* values, std::size_t value_size, std::size_t count, int bits);
+
+    /// @brief Actually writes some arbitrary data to the bit stream, without any checks.
+    ///
+    /// Whole words are copied directly to the user buffer if the stream is word aligned,
+    /// otherwise they're shift-merged with the internal scratch buffer in 64-bit blocks.
+    /// @param data Pointer to the arbitrary data.
+    /// @param size Size in bytes of the data.
+    void do_write_bytes_unchecked(const std::byte* data, size_type size);
+
+    /// @brief Actually writes the characters of a string to the bit stream, without any checks.
+    ///
+    /// The result is same as writing the characters one by one with their full range, \n
+    /// which means each character is written as the little endian bytes of `ch - min`. \n
+    /// So, unsigned characters are directly copied in bulk on little endian systems. \n
+    /// Otherwise, they're converted chunk by chunk (flip the sign bit, byte swap) before the bulk copy.
+    /// @tparam CharT Character type of the string.
+    /// @param str Pointer to the characters.
+    /// @param len Number of characters.
+    template <character CharT>
+    void do_write_chars_unchecked(const CharT* str, std::size_t len)
+    {
+        using UChar = std::make_unsigned_t<CharT>;
+
+        constexpr bool IS_SIGNED = std::is_signed_v<CharT>;
+        constexpr bool NEEDS_SWAP = (sizeof(CharT) > 1 && std::endian::native == std::endian::big);
+
+        if constexpr (!IS_SIGNED && !NEEDS_SWAP)
+        {
+            do_write_bytes_unchecked(reinterpret_cast<const std::byte*>(str),
+                                     static_cast<size_type>(sizeof(CharT) * len));
+        }
+        else
+        {
+            constexpr std::size_t CHUNK_LENGTH = 256 / sizeof(CharT);
+            constexpr UChar SIGN_BIT = IS_SIGNED ? static_cast<UChar>(UChar(1) << (8 * sizeof(CharT) - 1)) : UChar(0);
+
+            UChar chunk[CHUNK_LENGTH];
+
+            while (len > 0)
+            {
+                const std::size_t chunk_length = std::min(len, CHUNK_LENGTH);
+
+                // Simple loop without dependencies, so that it can be vectorized.
+                for (std::size_t i = 0; i < chunk_length; ++i)
+                {
+                    // `ch - min` is same as flipping the sign bit.
+                    UChar ch = static_cast<UChar>(static_cast<UChar>(str[i]) ^ SIGN_BIT);
+                    if constexpr (NEEDS_SWAP)
+                        ch = std::byteswap(ch);
+                    chunk[i] = ch;
+                }
+
+                do_write_bytes_unchecked(reinterpret_cast<const std::byte*>(chunk),
+                                         static_cast<size_type>(sizeof(CharT) * chunk_length));
+
+                str += chunk_length;
+                len -= chunk_length;
+            }
+        }
+    }
+
+    /// @brief Actually writes a constant number of raw bits to the bit stream, without any checks.
+    /// @tparam Bits Number of bits to write, which must not exceed twice the size of `word_type`.
+    /// @param value Raw bits to write, which must not have bits set above @p Bits.
+    template <int Bits>
+    void do_write_bits_unchecked(scratch_type value)
+    {
+        constexpr int WORD_BITS = static_cast<int>(8 * sizeof(word_type));
+
+        static_assert(0 < Bits && Bits <= 2 * WORD_BITS);
+
+        if constexpr (Bits <= WORD_BITS)
+        {
+            // Write `value` to `_scratch`, and flush if scratch overflow.
+            _scratch |= (value << _scratch_index);
+            _scratch_index += Bits;
+            flush_if_scratch_overflow();
+        }
+        else
+        {
+            // Write lower word to `_scratch`, which always flushes.
+            const scratch_type low = (value << WORD_BITS) >> WORD_BITS;
+            _scratch |= (low << _scratch_index);
+            _scratch_index += WORD_BITS;
+            do_flush_word_unchecked();
+
+            // Write higher half to `_scratch`, and flush if scratch overflow.
+            _scratch |= ((value >> WORD_BITS) << _scratch_index);
+            _scratch_index += Bits - WORD_BITS;
+            flush_if_scratch_overflow();
+        }
+
+        // Adjust used bits
+        _logical_used_bits += Bits;
+    }
+
+    /// @brief Flushes a word from the internal scratch buffer to the user buffer, if the scratch has a whole word.
+    NALCHI_BIT_STREAM_HOT_PATH void flush_if_scratch_overflow();
 
     /// @brief Actually flushes from the internal scratch buffer to the user buffer.
     /// @note This function flushes the internal scratch word as-is, \n
     /// which means calling this mid-way through writing can
     /// write some undesired additional `0` bits in the middle of your buffer. \n
     /// To avoid that, you should only call this when you're done writing everything.
-    /// @return The stream itself.
+    NALCHI_BIT_STREAM_HOT_PATH void do_flush_word_unchecked();
+};
+
+template <typename Word, typename Scratch, typename Derived>
+NALCHI_BIT_STREAM_HOT_PATH void bit_stream_writer_base<Word, Scratch, Derived>::flush_if_scratch_overflow()
+{
+    if (_scratch_index >= static_cast<int>(8 * sizeof(word_type)))
+        do_flush_word_unchecked();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+NALCHI_BIT_STREAM_HOT_PATH void bit_stream_writer_base<Word, Scratch, Derived>::do_flush_word_unchecked()
+{
+    // Get the lower word bits to flush.
+    word_type word = static_cast<word_type>((_scratch << (8 * sizeof(word_type))) >> (8 * sizeof(word_type)));
+    if constexpr (std::endian::native == std::endian::big)
+        word = std::byteswap(word);
+
+    // Flush the word.
+    _words[_words_index++] = word;
+
+    // Remove the flushed scratch data.
+    _scratch >>= (8 * sizeof(word_type));
+
+    // Adjust the scratch index.
+    _scratch_index = std::max(0, _scratch_index - static_cast<int>(8 * sizeof(word_type)));
+}
+
+/// @brief Bit stream writer that writes @p Word with a @p Scratch.
+///
+/// See `bit_stream_writer_base` for the details.
+/// @tparam Word Word type used to write to your buffer.
+/// @tparam Scratch Scratch type to store the temporary scratch data, which must be twice the size of @p Word.
+template <typename Word = std::uint32_t, typename Scratch = std::uint64_t>
+class basic_bit_stream_writer final
+    : public bit_stream_writer_base<Word, Scratch, basic_bit_stream_writer<Word, Scratch>>
+{
+    using base_type = bit_stream_writer_base<Word, Scratch, basic_bit_stream_writer<Word, Scratch>>;
+
+public:
+    using base_type::base_type;
+};
+
+/// @brief Bit stream writer that writes 32-bit words with a 64-bit scratch, which you would normally use.
+///
+/// This writes the same as `basic_bit_stream_writer<>`, but it's kept as a concrete class, \n
+/// so that its C++ symbols stay the same as the versions before the bit streams were templated.
+class bit_stream_writer final : public bit_stream_writer_base<std::uint32_t, std::uint64_t, bit_stream_writer>
+{
+    using base_type = bit_stream_writer_base<std::uint32_t, std::uint64_t, bit_stream_writer>;
+
+public:
+    /// @brief Deleted copy constructor.
+    bit_stream_writer(const bit_stream_writer&) = delete;
+
+    /// @brief Deleted copy assignment operator.
+    auto operator=(const bit_stream_writer&) -> bit_stream_writer& = delete;
+
+    // Below are the members exported before the bit streams were templated, forwarding to `bit_stream_writer_base`.
+
+    NALCHI_API bit_stream_writer();
+    NALCHI_API bit_stream_writer(shared_payload buffer, size_type logical_bytes_length);
+    NALCHI_API bit_stream_writer(std::span<word_type> buffer, size_type logical_bytes_length);
+    NALCHI_API bit_stream_writer(word_type* begin, word_type* end, size_type logical_bytes_length);
+    NALCHI_API bit_stream_writer(word_type* begin, size_type words_length, size_type logical_bytes_length);
+
+public:
+    NALCHI_API void set_fail()
+    {
+        base_type::set_fail();
+    }
+
+    NALCHI_API bool fail() const noexcept
+    {
+        return base_type::fail();
+    }
+
+    NALCHI_API bool operator!() const noexcept
+    {
+        return base_type::operator!();
+    }
+
+    NALCHI_API operator bool() const noexcept
+    {
+        return base_type::operator bool();
+    }
+
+public:
+    NALCHI_API auto total_bytes() const -> size_type
+    {
+        return base_type::total_bytes();
+    }
+
+    NALCHI_API auto total_bits() const -> size_type
+    {
+        return base_type::total_bits();
+    }
+
+    NALCHI_API auto used_bytes() const -> size_type;
+
+    NALCHI_API auto used_bits() const -> size_type
+    {
+        return base_type::used_bits();
+    }
+
+    NALCHI_API auto unused_bytes() const -> size_type
+    {
+        return base_type::unused_bytes();
+    }
+
+    NALCHI_API auto unused_bits() const -> size_type
+    {
+        return base_type::unused_bits();
+    }
+
+public:
+    using base_type::reset_with;
+
+    NALCHI_API void restart();
+    NALCHI_API void reset();
+    NALCHI_API void reset_with(shared_payload buffer, size_type logical_bytes_length);
+    NALCHI_API void reset_with(std::span<word_type> buffer, size_type logical_bytes_length);
+    NALCHI_API void reset_with(word_type* begin, word_type* end, size_type logical_bytes_length);
+    NALCHI_API void reset_with(word_type* begin, size_type words_length, size_type logical_bytes_length);
+    NALCHI_API auto flush_final() -> bit_stream_writer&;
+
+    NALCHI_API bool flushed() const
+    {
+        return base_type::flushed();
+    }
+
+public:
+    using base_type::write;
+
+    NALCHI_API auto write(const void* data, size_type size) -> bit_stream_writer&;
+    NALCHI_API auto write(float data) -> bit_stream_writer&;
+    NALCHI_API auto write(double data) -> bit_stream_writer&;
+
+private:
+    NALCHI_API void flush_if_scratch_overflow();
     NALCHI_API void do_flush_word_unchecked();
 };
 
+extern template class NALCHI_EXTERN_TEMPLATE_API
+    bit_stream_writer_base<std::uint32_t, std::uint64_t, bit_stream_writer>;
+extern template class NALCHI_EXTERN_TEMPLATE_API
+    bit_stream_writer_base<std::uint32_t, std::uint64_t, basic_bit_stream_writer<>>;
+
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+/// @brief Bit stream writer that writes 64-bit words with a 128-bit scratch.
+/// @note This is only available when the compiler provides `unsigned __int128` (`NALCHI_HAS_WIDE_BIT_STREAM`), \n
+/// so not on MSVC.
+using wide_bit_stream_writer = basic_bit_stream_writer<std::uint64_t, uint128_t>;
+
+extern template class NALCHI_EXTERN_TEMPLATE_API
+    bit_stream_writer_base<std::uint64_t, uint128_t, wide_bit_stream_writer>;
+#endif
+
 /// @brief Measures the bytes `bit_stream_writer` will use.
 ///
 /// This never actually writes any data. \n
 /// Instead, it only measures how many bytes `bit_stream_writer` would use. \n
 /// You can use this to measure the required space for the `bit_stream_writer`.
+///
+/// Every function except the Huffman ones is `constexpr`, so the size of a message can be measured
+/// at compile time, see `max_bytes_v` in `nalchi/auto_serialize.hpp`.
 class bit_stream_measurer final
 {
 public:
     using size_type = bit_stream_writer::size_type; ///< Size type representing number of bits and bytes.
 
+public:
+    // Stream tags for `serialize()`, see `nalchi/serialize.hpp`.
+    static constexpr bool is_writing = false;
+    static constexpr bool is_reading = false;
+    static constexpr bool is_measuring = true;
+
 private:
     size_type _logical_used_bits = 0;
 
@@ -567,74 +1518,375 @@ public:
     auto operator=(const bit_stream_measurer&) -> bit_stream_measurer& = delete;
 
     /// @brief Constructs a `bit_stream_measurer` instance.
-    NALCHI_API bit_stream_measurer() = default;
+    NALCHI_API constexpr bit_stream_measurer() = default;
 
 public:
     /// @brief Gets the number of used (measured) bytes.
     /// @return Number of used (measured) bytes.
-    NALCHI_API auto used_bytes() const -> size_type;
+    NALCHI_API constexpr auto used_bytes() const -> size_type
+    {
+        return (_logical_used_bits + 7) / 8;
+    }
+
+    /// @brief Gets the number of used (measured) bits.
+    /// @return Number of used (measured) bits.
+    NALCHI_API constexpr auto used_bits() const -> size_type
+    {
+        return _logical_used_bits;
+    }
+
+public:
+    /// @brief Check if measuring has been failed or not.
+    ///
+    /// Measuring never fails, so this is always `false`. \n
+    /// This only exists to match the writer and the reader in `serialize()`.
+    /// @return `false`.
+    NALCHI_API constexpr bool fail() const noexcept
+    {
+        return false;
+    }
+
+    /// @brief Check if there was an error in the measuring, which is always `false`.
+    NALCHI_API constexpr bool operator!() const noexcept
+    {
+        return fail();
+    }
+
+    /// @brief Check if there was no error in the measuring, which is always `true`.
+    NALCHI_API constexpr operator bool() const noexcept
+    {
+        return !fail();
+    }
+
+public:
+    /// @brief Restarts the measure from zero.
+    NALCHI_API constexpr void restart()
+    {
+        _logical_used_bits = 0;
+    }
+
+public:
+    /// @brief Fake-writes some arbitrary data to the bit stream.
+    /// @param data Pointer to the arbitrary data.
+    /// @param size Size in bytes of the data.
+    /// @return The stream itself.
+    NALCHI_API constexpr auto write([[maybe_unused]] const void* data, size_type size) -> bit_stream_measurer&
+    {
+        _logical_used_bits += 8 * size;
+        return *this;
+    }
+
+    /// @brief Fake-pads zero bits to the next byte boundary of the bit stream.
+    /// @return The stream itself.
+    NALCHI_API constexpr auto align_to_byte() -> bit_stream_measurer&
+    {
+        _logical_used_bits = (_logical_used_bits + 7) / 8 * 8;
+        return *this;
+    }
+
+    /// @brief Fake-pads zero bits to the next word boundary of the bit stream.
+    /// @tparam Word Word type of the bit stream writer to measure for.
+    /// @return The stream itself.
+    template <std::unsigned_integral Word = bit_stream_writer::word_type>
+    constexpr auto align_to_word() -> bit_stream_measurer&
+    {
+        constexpr size_type WORD_BITS = 8 * sizeof(Word);
+
+        _logical_used_bits = (_logical_used_bits + WORD_BITS - 1) / WORD_BITS * WORD_BITS;
+        return *this;
+    }
+
+    /// @brief Fake-pads zero bits to the next byte boundary, and fake-writes some arbitrary data there.
+    /// @param data Pointer to the arbitrary data.
+    /// @param size Size in bytes of the data.
+    /// @return The stream itself.
+    NALCHI_API constexpr auto write_aligned_bytes(const void* data, size_type size) -> bit_stream_measurer&
+    {
+        return align_to_byte().write(data, size);
+    }
+
+    /// @brief Fake-writes an integral value to the bit stream.
+    /// @tparam Int Integer type.
+    /// @param data Data to fake-write.
+    /// @param min Minimum value allowed for @p data.
+    /// @param max Maximum value allowed for @p data.
+    /// @return The stream itself.
+    template <std::integral Int>
+    constexpr auto write([[maybe_unused]] Int data, Int min = std::numeric_limits<Int>::min(),
+                         Int max = std::numeric_limits<Int>::max()) -> bit_stream_measurer&
+    {
+        using UInt = make_unsigned_allow_bool_t<Int>;
+
+        // Convert `data` to `value`.
+        const int bits = std::bit_width(static_cast<UInt>(((UInt)max) - ((UInt)min)));
+
+        // Adjust used bits
+        _logical_used_bits += static_cast<size_type>(bits);
+
+        return *this;
+    }
+
+    /// @brief Fake-writes an integral value with a compile-time range to the bit stream.
+    /// @tparam Min Minimum value allowed for @p data.
+    /// @tparam Max Maximum value allowed for @p data.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to fake-write.
+    /// @return The stream itself.
+    template <std::integral auto Min, std::integral auto Max, ranged_integral Int>
+    constexpr auto write([[maybe_unused]] Int data) -> bit_stream_measurer&
+    {
+        static_assert(std::cmp_less(Min, Max), "`Min` must be less than `Max`");
+        static_assert(std::in_range<Int>(Min) && std::in_range<Int>(Max), "`Min` and `Max` must fit in `Int`");
+
+        using UInt = std::make_unsigned_t<Int>;
+
+        constexpr int BITS = std::bit_width(static_cast<UInt>(static_cast<UInt>(Max) - static_cast<UInt>(Min)));
+
+        // Adjust used bits
+        _logical_used_bits += static_cast<size_type>(BITS);
+
+        return *this;
+    }
+
+    /// @brief Fake-writes an array of integral values, which share the same range, to the bit stream.
+    /// @tparam Int Integer type of the elements.
+    /// @param data Array to fake-write.
+    /// @param min Minimum value allowed for each element.
+    /// @param max Maximum value allowed for each element.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    constexpr auto write_array(std::span<const Int> data,
+                               std::type_identity_t<Int> min = std::numeric_limits<Int>::min(),
+                               std::type_identity_t<Int> max = std::numeric_limits<Int>::max()) -> bit_stream_measurer&
+    {
+        using UInt = std::make_unsigned_t<Int>;
+
+        const int bits = std::bit_width(static_cast<UInt>(static_cast<UInt>(max) - static_cast<UInt>(min)));
+
+        // Adjust used bits
+        _logical_used_bits += static_cast<size_type>(bits * data.size());
+
+        return *this;
+    }
+
+    /// @brief Fake-writes an integral value to the bit stream as a varint.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to fake-write.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    constexpr auto write_varint(Int data) -> bit_stream_measurer&
+    {
+        if constexpr (std::is_signed_v<Int>)
+            _logical_used_bits += static_cast<size_type>(varint_bits(zigzag_encode(data)));
+        else
+            _logical_used_bits += static_cast<size_type>(varint_bits(data));
+
+        return *this;
+    }
+
+    /// @brief Fake-writes an integral value to the bit stream as an Exp-Golomb code of order @p k.
+    ///
+    /// If @p k is out of range, this fake-writes nothing, as the writer writes nothing.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to fake-write.
+    /// @param k Order of the Exp-Golomb code, which must be less than the bit width of @p Int.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    constexpr auto write_exp_golomb(Int data, int k = 0) -> bit_stream_measurer&
+    {
+        if (k < 0 || k >= static_cast<int>(8 * sizeof(Int)))
+            return *this;
+
+        if constexpr (std::is_signed_v<Int>)
+            _logical_used_bits += static_cast<size_type>(exp_golomb_bits(zigzag_encode(data), k));
+        else
+            _logical_used_bits += static_cast<size_type>(exp_golomb_bits(data, k));
+
+        return *this;
+    }
+
+    /// @brief Fake-writes a positive integral value to the bit stream as an Elias gamma code.
+    ///
+    /// If @p data is `0`, this fake-writes nothing, as the writer writes nothing.
+    /// @tparam UInt Unsigned integer type of @p data.
+    /// @param data Data to fake-write, which must be positive.
+    /// @return The stream itself.
+    template <ranged_integral UInt>
+        requires std::unsigned_integral<UInt>
+    constexpr auto write_elias_gamma(UInt data) -> bit_stream_measurer&
+    {
+        if (data == 0)
+            return *this;
+
+        _logical_used_bits += static_cast<size_type>(exp_golomb_bits(data - 1u, 0));
 
-    /// @brief Gets the number of used (measured) bits.
-    /// @return Number of used (measured) bits.
-    NALCHI_API auto used_bits() const -> size_type
+        return *this;
+    }
+
+    /// @brief Fake-writes an integral value to the bit stream, delta encoded against @p baseline.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to fake-write.
+    /// @param baseline Baseline to get the difference from.
+    /// @param min Minimum value allowed for @p data and @p baseline.
+    /// @param max Maximum value allowed for @p data and @p baseline.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    constexpr auto write_delta(Int data, std::type_identity_t<Int> baseline,
+                               std::type_identity_t<Int> min = std::numeric_limits<Int>::min(),
+                               std::type_identity_t<Int> max = std::numeric_limits<Int>::max()) -> bit_stream_measurer&
     {
-        return _logical_used_bits;
+        _logical_used_bits += static_cast<size_type>(delta_bits<Int>(data, baseline, min, max));
+
+        return *this;
     }
 
-public:
-    /// @brief Restarts the measure from zero.
-    NALCHI_API void restart()
+    /// @brief Fake-writes bytes encoded with a static Huffman codebook to the bit stream.
+    ///
+    /// If @p codebook is invalid, or some bytes are not in @p codebook, this function will measure nothing.
+    /// @param data Bytes to fake-write.
+    /// @param size Number of bytes.
+    /// @param codebook Codebook to encode the bytes with.
+    /// @return The stream itself.
+    NALCHI_API auto write_huffman(const void* data, size_type size, const huffman_codebook& codebook)
+        -> bit_stream_measurer&;
+
+    /// @brief Fake-writes a string encoded with a static Huffman codebook to the bit stream.
+    ///
+    /// If @p codebook is invalid, or some characters are not in @p codebook, this function will measure nothing.
+    /// @param str String to fake-write.
+    /// @param codebook Codebook to encode the characters with.
+    /// @return The stream itself.
+    NALCHI_API auto write_string_huffman(std::string_view str, const huffman_codebook& codebook)
+        -> bit_stream_measurer&;
+
+    /// @brief Fake-writes a float value to the bit stream.
+    /// @param data Data to fake-write.
+    /// @return The stream itself.
+    NALCHI_API constexpr auto write(float data) -> bit_stream_measurer&
     {
-        _logical_used_bits = 0;
+        _logical_used_bits += static_cast<size_type>(8 * sizeof(data));
+        return *this;
     }
 
-public:
-    /// @brief Fake-writes some arbitrary data to the bit stream.
-    /// @param data Pointer to the arbitrary data.
-    /// @param size Size in bytes of the data.
+    /// @brief Fake-writes a double value to the bit stream.
+    /// @param data Data to fake-write.
     /// @return The stream itself.
-    NALCHI_API auto write([[maybe_unused]] const void* data, size_type size) -> bit_stream_measurer&
+    NALCHI_API constexpr auto write(double data) -> bit_stream_measurer&
     {
-        _logical_used_bits += 8 * size;
+        _logical_used_bits += static_cast<size_type>(8 * sizeof(data));
         return *this;
     }
 
-    /// @brief Fake-writes an integral value to the bit stream.
-    /// @tparam Int Integer type.
+    /// @brief Fake-writes a float value quantized in the bounded range to the bit stream.
     /// @param data Data to fake-write.
     /// @param min Minimum value allowed for @p data.
     /// @param max Maximum value allowed for @p data.
+    /// @param resolution Step between the quantized values.
     /// @return The stream itself.
-    template <std::integral Int>
-    auto write([[maybe_unused]] Int data, Int min = std::numeric_limits<Int>::min(),
-               Int max = std::numeric_limits<Int>::max()) -> bit_stream_measurer&
+    NALCHI_API constexpr auto write_quantized([[maybe_unused]] float data, float min, float max, float resolution)
+        -> bit_stream_measurer&
     {
-        using UInt = make_unsigned_allow_bool_t<Int>;
+        _logical_used_bits += static_cast<size_type>(std::max(0, quantized_bits(min, max, resolution)));
+        return *this;
+    }
 
-        // Convert `data` to `value`.
-        const int bits = std::bit_width(static_cast<UInt>(((UInt)max) - ((UInt)min)));
+    /// @brief Fake-writes a float value to the bit stream as an IEEE 754 half-precision float.
+    /// @param data Data to fake-write.
+    /// @return The stream itself.
+    NALCHI_API constexpr auto write_half([[maybe_unused]] float data) -> bit_stream_measurer&
+    {
+        _logical_used_bits += static_cast<size_type>(8 * sizeof(std::uint16_t));
+        return *this;
+    }
 
-        // Adjust used bits
-        _logical_used_bits += static_cast<size_type>(bits);
+    /// @brief Fake-writes an array of 3D vectors, each component quantized in the bounded range of its axis,
+    /// to the bit stream.
+    ///
+    /// If the range of any axis is invalid, this fake-writes nothing, as the writer writes nothing.
+    /// @param data Array of 3D vectors to fake-write.
+    /// @param min Minimum value allowed for each axis.
+    /// @param max Maximum value allowed for each axis.
+    /// @param resolution Step between the quantized values.
+    /// @return The stream itself.
+    NALCHI_API constexpr auto write_vec3_array(std::span<const std::array<float, 3>> data,
+                                               const std::array<float, 3>& min, const std::array<float, 3>& max,
+                                               float resolution) -> bit_stream_measurer&
+    {
+        int vec3_bits = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const int bits = quantized_bits(min[axis], max[axis], resolution);
+            if (bits < 0)
+                return *this;
+            vec3_bits += bits;
+        }
+        _logical_used_bits += static_cast<size_type>(vec3_bits) * data.size();
+        return *this;
+    }
+
+    /// @brief Fake-writes a rotation quaternion to the bit stream with the smallest-three encoding.
+    ///
+    /// If @p bits_per_component is out of range, this fake-writes nothing, as the writer writes nothing.
+    /// @param quat Quaternion to fake-write.
+    /// @param bits_per_component Bits per each of the smallest three components.
+    /// @return The stream itself.
+    NALCHI_API constexpr auto write_quaternion([[maybe_unused]] const std::array<float, 4>& quat,
+                                               int bits_per_component = 9) -> bit_stream_measurer&
+    {
+        if (bits_per_component < SMALLEST_THREE_MIN_BITS_PER_COMPONENT ||
+            bits_per_component > SMALLEST_THREE_MAX_BITS_PER_COMPONENT)
+            return *this;
 
+        _logical_used_bits += static_cast<size_type>(smallest_three_bits(bits_per_component));
         return *this;
     }
 
-    /// @brief Fake-writes a float value to the bit stream.
-    /// @param data Data to fake-write.
+    /// @brief Fake-writes an array of rotation quaternions to the bit stream with the smallest-three encoding.
+    ///
+    /// If @p bits_per_component is out of range, this fake-writes nothing, as the writer writes nothing.
+    /// @param quats Array of quaternions to fake-write.
+    /// @param bits_per_component Bits per each of the smallest three components.
     /// @return The stream itself.
-    NALCHI_API auto write(float data) -> bit_stream_measurer&
+    NALCHI_API constexpr auto write_quaternion_array(std::span<const std::array<float, 4>> quats,
+                                                     int bits_per_component = 9) -> bit_stream_measurer&
     {
-        _logical_used_bits += static_cast<size_type>(8 * sizeof(data));
+        if (bits_per_component < SMALLEST_THREE_MIN_BITS_PER_COMPONENT ||
+            bits_per_component > SMALLEST_THREE_MAX_BITS_PER_COMPONENT)
+            return *this;
+
+        _logical_used_bits += static_cast<size_type>(smallest_three_bits(bits_per_component) * quats.size());
         return *this;
     }
 
-    /// @brief Fake-writes a double value to the bit stream.
-    /// @param data Data to fake-write.
+    /// @brief Fake-writes a direction to the bit stream with the octahedral encoding.
+    ///
+    /// If @p bits_per_axis is out of range, this fake-writes nothing, as the writer writes nothing.
+    /// @param vec Direction to fake-write.
+    /// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
     /// @return The stream itself.
-    NALCHI_API auto write(double data) -> bit_stream_measurer&
+    NALCHI_API constexpr auto write_unit_vector([[maybe_unused]] const std::array<float, 3>& vec,
+                                                int bits_per_axis = 12) -> bit_stream_measurer&
     {
-        _logical_used_bits += static_cast<size_type>(8 * sizeof(data));
+        if (bits_per_axis < OCTAHEDRAL_MIN_BITS_PER_AXIS || bits_per_axis > OCTAHEDRAL_MAX_BITS_PER_AXIS)
+            return *this;
+
+        _logical_used_bits += static_cast<size_type>(octahedral_bits(bits_per_axis));
+        return *this;
+    }
+
+    /// @brief Fake-writes an array of directions to the bit stream with the octahedral encoding.
+    ///
+    /// If @p bits_per_axis is out of range, this fake-writes nothing, as the writer writes nothing.
+    /// @param vecs Array of directions to fake-write.
+    /// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
+    /// @return The stream itself.
+    NALCHI_API constexpr auto write_unit_vector_array(std::span<const std::array<float, 3>> vecs,
+                                                      int bits_per_axis = 12) -> bit_stream_measurer&
+    {
+        if (bits_per_axis < OCTAHEDRAL_MIN_BITS_PER_AXIS || bits_per_axis > OCTAHEDRAL_MAX_BITS_PER_AXIS)
+            return *this;
+
+        _logical_used_bits += static_cast<size_type>(octahedral_bits(bits_per_axis) * vecs.size());
         return *this;
     }
 
@@ -644,7 +1896,7 @@ public:
     /// @param str String to fake-write.
     /// @return The stream itself.
     template <character CharT, typename CharTraits>
-    auto write(std::basic_string_view<CharT, CharTraits> str) -> bit_stream_measurer&
+    constexpr auto write(std::basic_string_view<CharT, CharTraits> str) -> bit_stream_measurer&
     {
         // Fake-write a prefix of length prefix.
         _logical_used_bits += bit_stream_writer::STR_LEN_PREFIX_PREFIX_BITS;
@@ -683,17 +1935,50 @@ public:
     /// @param str String to fake-write.
     /// @return The stream itself.
     template <character CharT, typename CharTraits, typename Allocator>
-    auto write(const std::basic_string<CharT, CharTraits, Allocator>& str) -> bit_stream_measurer&
+    constexpr auto write(const std::basic_string<CharT, CharTraits, Allocator>& str) -> bit_stream_measurer&
     {
         return write(std::basic_string_view<CharT, CharTraits>(str));
     }
 
+    /// @brief Fake-writes a string view to the bit stream, with its characters aligned to their size.
+    /// @tparam CharT Underlying character type of `std::basic_string_view`.
+    /// @tparam CharTraits Char traits for `CharT`.
+    /// @param str String to fake-write.
+    /// @return The stream itself.
+    template <character CharT, typename CharTraits>
+    constexpr auto write_aligned_string(std::basic_string_view<CharT, CharTraits> str) -> bit_stream_measurer&
+    {
+        constexpr size_type CHAR_BITS = 8 * sizeof(CharT);
+
+        // Fake-write the length prefixes, and the padding after them.
+        _logical_used_bits += bit_stream_writer::string_length_prefix_bits(str.length());
+        _logical_used_bits = (_logical_used_bits + CHAR_BITS - 1) / CHAR_BITS * CHAR_BITS;
+
+        // Fake-write the string payload.
+        _logical_used_bits += static_cast<size_type>(CHAR_BITS * str.length());
+
+        return *this;
+    }
+
+    /// @brief Fake-writes a string to the bit stream, with its characters aligned to their size.
+    /// @tparam CharT Underlying character type of `std::basic_string`.
+    /// @tparam CharTraits Char traits for `CharT`.
+    /// @tparam Allocator Underlying allocator for `std::basic_string`.
+    /// @param str String to fake-write.
+    /// @return The stream itself.
+    template <character CharT, typename CharTraits, typename Allocator>
+    constexpr auto write_aligned_string(const std::basic_string<CharT, CharTraits, Allocator>& str)
+        -> bit_stream_measurer&
+    {
+        return write_aligned_string(std::basic_string_view<CharT, CharTraits>(str));
+    }
+
     /// @brief Fake-writes a null-terminated string to the bit stream.
     /// @tparam CharT Character type of the null-terminated string.
     /// @param str String to fake-write.
     /// @return The stream itself.
     template <character CharT>
-    auto write(const CharT* str) -> bit_stream_measurer&
+    constexpr auto write(const CharT* str) -> bit_stream_measurer&
     {
         return write(std::basic_string_view<CharT>(str));
     }
@@ -704,15 +1989,36 @@ public:
 /// Its design is based on the articles by Glenn Fiedler, see:
 /// * https://gafferongames.com/post/reading_and_writing_packets/
 /// * https://gafferongames.com/post/serialization_strategies/
-class bit_stream_reader final
+///
+/// You @b must use the reader with the same @p Word as the writer, \n
+/// e.g. `bit_stream_reader` for `bit_stream_writer`, and `wide_bit_stream_reader` for `wide_bit_stream_writer`.
+///
+/// This is the shared implementation of `bit_stream_reader` and `basic_bit_stream_reader`,
+/// so you would use those instead of this directly.
+/// @tparam Word Word type used to read from your buffer.
+/// @tparam Scratch Scratch type to store the temporary scratch data, which must be twice the size of @p Word.
+/// @tparam Derived Derived reader type returned from the chained reads.
+template <typename Word, typename Scratch, typename Derived>
+class bit_stream_reader_base
 {
+    friend Derived;
+
+private:
+    using writer_type = basic_bit_stream_writer<Word, Scratch>;
+
 public:
-    using size_type = bit_stream_writer::size_type;   ///< Size type representing number of bits and bytes.
-    using ssize_type = std::make_signed_t<size_type>; ///< Signed size type to allow negative error value.
+    using size_type = typename writer_type::size_type; ///< Size type representing number of bits and bytes.
+    using ssize_type = std::make_signed_t<size_type>;  ///< Signed size type to allow negative error value.
 
     using scratch_type =
-        bit_stream_writer::scratch_type;            ///< Internal scratch type to store the temporary scratch data.
-    using word_type = bit_stream_writer::word_type; ///< Internal word type used to read from your buffer.
+        typename writer_type::scratch_type;            ///< Internal scratch type to store the temporary scratch data.
+    using word_type = typename writer_type::word_type; ///< Internal word type used to read from your buffer.
+
+public:
+    // Stream tags for `serialize()`, see `nalchi/serialize.hpp`.
+    static constexpr bool is_writing = false;
+    static constexpr bool is_reading = true;
+    static constexpr bool is_measuring = false;
 
 private:
     scratch_type _scratch;
@@ -726,43 +2032,48 @@ private:
 
     bool _init_fail;
     bool _fail;
+    /// @brief Gets this stream as the derived reader type, which is returned from the chained reads.
+    auto self() -> Derived&
+    {
+        return static_cast<Derived&>(*this);
+    }
 
 public:
     /// @brief Deleted copy constructor.
-    bit_stream_reader(const bit_stream_reader&) = delete;
+    bit_stream_reader_base(const bit_stream_reader_base&) = delete;
 
     /// @brief Deleted copy assignment operator.
-    auto operator=(const bit_stream_reader&) -> bit_stream_reader& = delete;
+    auto operator=(const bit_stream_reader_base&) -> bit_stream_reader_base& = delete;
 
     /// @brief Constructs a `bit_stream_reader` instance without a buffer.
     ///
     /// This constructor can be useful if you want to set the buffer afterwards. \n
     /// To set the buffer, call `reset_with()`.
-    NALCHI_API bit_stream_reader();
+    bit_stream_reader_base();
 
     /// @brief Constructs a `bit_stream_reader` instance with a `std::span<word_type>` buffer.
     /// @param buffer Buffer to read bits from.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial read from the final word.
-    NALCHI_API bit_stream_reader(std::span<const word_type> buffer, size_type logical_bytes_length);
+    bit_stream_reader_base(std::span<const word_type> buffer, size_type logical_bytes_length);
 
     /// @brief Constructs a `bit_stream_reader` instance with a word range.
     /// @param begin Pointer to the beginning of a buffer.
     /// @param end Pointer to the end of a buffer.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial read from the final word.
-    NALCHI_API bit_stream_reader(const word_type* begin, const word_type* end, size_type logical_bytes_length);
+    bit_stream_reader_base(const word_type* begin, const word_type* end, size_type logical_bytes_length);
 
     /// @brief Constructs a `bit_stream_reader` instance with a word begin pointer and the word length.
     /// @param begin Pointer to the beginning of a buffer.
     /// @param words_length Number of words in the buffer.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial read from the final word.
-    NALCHI_API bit_stream_reader(const word_type* begin, size_type words_length, size_type logical_bytes_length);
+    bit_stream_reader_base(const word_type* begin, size_type words_length, size_type logical_bytes_length);
 
 public:
     /// @brief Force set the fail flag.
-    NALCHI_API void set_fail()
+    void set_fail()
     {
         _fail = true;
     }
@@ -771,7 +2082,7 @@ public:
     ///
     /// If this is `true`, all the operations for this `bit_stream_reader` is no-op.
     /// @return `true` if reading has been failed, otherwise `false`.
-    NALCHI_API bool fail() const noexcept
+    bool fail() const noexcept
     {
         return _fail;
     }
@@ -780,7 +2091,7 @@ public:
     /// This is effectively same as `fail()`.
     ///
     /// If this is `true`, all the operations for this `bit_stream_reader` is no-op.
-    NALCHI_API bool operator!() const noexcept
+    bool operator!() const noexcept
     {
         return fail();
     }
@@ -789,7 +2100,7 @@ public:
     /// This is effectively same as `!fail()`.
     ///
     /// If this is `false`, all the operations for this `bit_stream_reader` is no-op.
-    NALCHI_API operator bool() const noexcept
+    operator bool() const noexcept
     {
         return !fail();
     }
@@ -797,69 +2108,69 @@ public:
 public:
     /// @brief Gets the number of total bytes in the stream.
     /// @return Number of total bytes in the stream.
-    NALCHI_API auto total_bytes() const -> size_type
+    auto total_bytes() const -> size_type
     {
         return _logical_total_bits / 8;
     }
 
     /// @brief Gets the number of total bits in the stream.
     /// @return Number of total bits in the stream.
-    NALCHI_API auto total_bits() const -> size_type
+    auto total_bits() const -> size_type
     {
         return _logical_total_bits;
     }
 
     /// @brief Gets the number of used bytes in the stream.
     /// @return Number of used bytes in the stream.
-    NALCHI_API auto used_bytes() const -> size_type;
+    auto used_bytes() const -> size_type;
 
     /// @brief Gets the number of used bits in the stream.
     /// @return Number of used bits in the stream.
-    NALCHI_API auto used_bits() const -> size_type
+    auto used_bits() const -> size_type
     {
         return _logical_used_bits;
     }
 
     /// @brief Gets the number of unused bytes in the stream.
     /// @return Number of unused bytes in the stream.
-    NALCHI_API auto unused_bytes() const -> size_type
+    auto unused_bytes() const -> size_type
     {
         return total_bytes() - used_bytes();
     }
 
     /// @brief Gets the number of unused bits in the stream.
     /// @return Number of unused bits in the stream.
-    NALCHI_API auto unused_bits() const -> size_type
+    auto unused_bits() const -> size_type
     {
         return total_bits() - used_bits();
     }
 
 public:
     /// @brief Restarts the stream so that it can read from the beginning again.
-    NALCHI_API void restart();
+    void restart();
 
     /// @brief Resets the stream so that it no longer holds your buffer anymore.
-    NALCHI_API void reset();
+    void reset();
 
     /// @brief Resets the stream with a `std::span<word_type>` buffer.
     /// @param buffer Buffer to read bits from.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial read from the final word.
-    NALCHI_API void reset_with(std::span<const word_type> buffer, size_type logical_bytes_length);
+    void reset_with(std::span<const word_type> buffer, size_type logical_bytes_length);
 
     /// @brief Resets the stream with a word range.
     /// @param begin Pointer to the beginning of a buffer.
     /// @param end Pointer to the end of a buffer.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial read from the final word.
-    NALCHI_API void reset_with(const word_type* begin, const word_type* end, size_type logical_bytes_length);
+    void reset_with(const word_type* begin, const word_type* end, size_type logical_bytes_length);
 
     /// @brief Resets the stream with a word begin pointer and the word length.
     /// @param begin Pointer to the beginning of a buffer.
     /// @param words_length Number of words in the buffer.
     /// @param logical_bytes_length Number of bytes logically.
     /// This is useful if you want to only allow partial read from the final word.
-    NALCHI_API void reset_with(const word_type* begin, size_type words_length, size_type logical_bytes_length);
+    void reset_with(const word_type* begin, size_type words_length, size_type logical_bytes_length);
 
 public:
     /// @brief Reads some arbitrary data from the bit stream.
@@ -868,7 +2179,31 @@ public:
     /// @param data Pointer to the arbitrary data.
     /// @param size Size in bytes of the data.
     /// @return The stream itself.
-    NALCHI_API auto read(void* data, size_type size) -> bit_stream_reader&;
+    auto read(void* data, size_type size) -> Derived&;
+
+    /// @brief Skips the padding bits to the next byte boundary of the bit stream.
+    ///
+    /// If the padding bits are not zero, which means the writing side didn't align here,
+    /// this function will set the fail flag.
+    /// @return The stream itself.
+    auto align_to_byte() -> Derived&;
+
+    /// @brief Skips the padding bits to the next word boundary of the bit stream.
+    ///
+    /// If the padding bits are not zero, which means the writing side didn't align here,
+    /// this function will set the fail flag.
+    /// @return The stream itself.
+    auto align_to_word() -> Derived&;
+
+    /// @brief Reads some arbitrary data written by `write_aligned_bytes()`, without copying it.
+    ///
+    /// @p bytes will directly view into your buffer, so you @b must keep your buffer alive while using @p bytes. \n
+    /// If the padding bits are not zero, or there are not enough bytes,
+    /// this function will set the fail flag and read nothing.
+    /// @param bytes Span to view the data.
+    /// @param size Size in bytes of the data.
+    /// @return The stream itself.
+    auto read_aligned_bytes(std::span<const std::byte>& bytes, size_type size) -> Derived&;
 
     /// @brief Reads an integral value from the bit stream.
     /// @tparam SInt Small integer type that doesn't exceed the size of `word_type`.
@@ -879,34 +2214,336 @@ public:
     template <std::integral SInt>
         requires(sizeof(SInt) <= sizeof(word_type))
     auto read(SInt& data, SInt min = std::numeric_limits<SInt>::min(), SInt max = std::numeric_limits<SInt>::max())
-        -> bit_stream_reader&
+        -> Derived&
+    {
+        return do_read<true>(data, min, max);
+    }
+
+    /// @brief Reads an integral value from the bit stream.
+    /// @tparam BInt Big integer type that exceeds the size of `word_type`.
+    /// @param data Data to read to.
+    /// @param min Minimum value allowed for @p data.
+    /// @param max Maximum value allowed for @p data.
+    /// @return The stream itself.
+    template <std::integral BInt>
+        requires(sizeof(BInt) > sizeof(word_type))
+    auto read(BInt& data, BInt min = std::numeric_limits<BInt>::min(), BInt max = std::numeric_limits<BInt>::max())
+        -> Derived&
     {
         return do_read<true>(data, min, max);
     }
 
-    /// @brief Reads an integral value from the bit stream.
-    /// @tparam BInt Big integer type that exceeds the size of `word_type`.
+    /// @brief Reads a float value from the bit stream.
+    /// @param data Data to read to.
+    /// @return The stream itself.
+    auto read(float& data) -> Derived&;
+
+    /// @brief Reads a double value from the bit stream.
+    /// @param data Data to read to.
+    /// @return The stream itself.
+    auto read(double& data) -> Derived&;
+
+    /// @brief Reads a float value quantized in the bounded range from the bit stream.
+    ///
+    /// If the range is invalid, or the quantized value exceeds the range,
+    /// this function will set the fail flag.
+    /// @param data Data to read to.
+    /// @param min Minimum value allowed for @p data.
+    /// @param max Maximum value allowed for @p data.
+    /// @param resolution Step between the quantized values.
+    /// @return The stream itself.
+    auto read_quantized(float& data, float min, float max, float resolution) -> Derived&;
+
+    /// @brief Reads an IEEE 754 half-precision float value from the bit stream.
+    /// @param data Data to read to.
+    /// @return The stream itself.
+    auto read_half(float& data) -> Derived&;
+
+    /// @brief Reads an array of 3D vectors, each component quantized in the bounded range of its axis,
+    /// from the bit stream.
+    ///
+    /// If the range of any axis is invalid, or any quantized value exceeds the range,
+    /// this function will set the fail flag.
+    /// @param data Array of 3D vectors to read to, whose size is the number of vectors to read.
+    /// @param min Minimum value allowed for each axis.
+    /// @param max Maximum value allowed for each axis.
+    /// @param resolution Step between the quantized values.
+    /// @return The stream itself.
+    auto read_vec3_array(std::span<std::array<float, 3>> data, const std::array<float, 3>& min,
+                         const std::array<float, 3>& max, float resolution) -> Derived&;
+
+    /// @brief Reads a rotation quaternion with the smallest-three encoding from the bit stream.
+    /// @param quat Quaternion to read to, in `x, y, z, w` order, which is normalized.
+    /// @param bits_per_component Bits per each of the smallest three components.
+    /// @return The stream itself.
+    auto read_quaternion(std::array<float, 4>& quat, int bits_per_component = 9) -> Derived&;
+
+    /// @brief Reads an array of rotation quaternions with the smallest-three encoding from the bit stream.
+    /// @param quats Array of quaternions to read to, whose size is the number of quaternions to read.
+    /// @param bits_per_component Bits per each of the smallest three components.
+    /// @return The stream itself.
+    auto read_quaternion_array(std::span<std::array<float, 4>> quats, int bits_per_component = 9)
+        -> Derived&;
+
+    /// @brief Reads a direction with the octahedral encoding from the bit stream.
+    /// @param vec Direction to read to, which is normalized.
+    /// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
+    /// @return The stream itself.
+    auto read_unit_vector(std::array<float, 3>& vec, int bits_per_axis = 12) -> Derived&;
+
+    /// @brief Reads an array of directions with the octahedral encoding from the bit stream.
+    /// @param vecs Array of directions to read to, whose size is the number of directions to read.
+    /// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
+    /// @return The stream itself.
+    auto read_unit_vector_array(std::span<std::array<float, 3>> vecs, int bits_per_axis = 12)
+        -> Derived&;
+
+    /// @brief Reads an integral value with a compile-time range from the bit stream.
+    ///
+    /// As the range is known at compile-time, the number of bits to read is a constant,
+    /// and an invalid range is a compile error.
+    /// @tparam Min Minimum value allowed for @p data.
+    /// @tparam Max Maximum value allowed for @p data.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to read to.
+    /// @return The stream itself.
+    template <std::integral auto Min, std::integral auto Max, ranged_integral Int>
+    auto read(Int& data) -> Derived&
+    {
+        static_assert(std::cmp_less(Min, Max), "`Min` must be less than `Max`");
+        static_assert(std::in_range<Int>(Min) && std::in_range<Int>(Max), "`Min` and `Max` must fit in `Int`");
+
+        using UInt = std::make_unsigned_t<Int>;
+
+        constexpr UInt RANGE = static_cast<UInt>(static_cast<UInt>(Max) - static_cast<UInt>(Min));
+        constexpr int BITS = std::bit_width(RANGE);
+
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+        // Fail if no more data to be read in `_words`.
+        if (_logical_used_bits + BITS > _logical_total_bits)
+        {
+            _fail = true;
+            return self();
+        }
+
+        const UInt value = static_cast<UInt>(do_read_bits_unchecked<BITS>());
+
+        // Fail if it exceeds `Max`, which is only possible if the range is not filling the bits.
+        if constexpr (RANGE != std::numeric_limits<UInt>::max() >> (8 * sizeof(UInt) - BITS))
+        {
+            if (value > RANGE)
+            {
+                _fail = true;
+                return self();
+            }
+        }
+
+        // Convert to original range.
+        data = static_cast<Int>(static_cast<UInt>(value + static_cast<UInt>(Min)));
+
+        return self();
+    }
+
+    /// @brief Reads an array of integral values, which share the same range, from the bit stream.
+    ///
+    /// The result is same as reading each element one by one with `read(data[i], min, max)`, \n
+    /// but the overflow check is done once for the whole array, and the elements are unpacked in bulk. \n
+    /// If any element is out of range, this function will set the fail flag,
+    /// and the contents of @p data are unspecified.
+    /// @tparam Int Integer type of the elements.
+    /// @param data Array to read to, whose size is the number of elements to read.
+    /// @param min Minimum value allowed for each element.
+    /// @param max Maximum value allowed for each element.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    auto read_array(std::span<Int> data, std::type_identity_t<Int> min = std::numeric_limits<Int>::min(),
+                    std::type_identity_t<Int> max = std::numeric_limits<Int>::max()) -> Derived&
+    {
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+        NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(self());
+
+        using UInt = std::make_unsigned_t<Int>;
+
+        const UInt range = static_cast<UInt>(static_cast<UInt>(max) - static_cast<UInt>(min));
+        const int bits = std::bit_width(range);
+
+        // Fail if no more data to be read in `_words`.
+        if (static_cast<std::uint64_t>(bits) * data.size() > _logical_total_bits - _logical_used_bits)
+        {
+            _fail = true;
+            return self();
+        }
+
+        UInt values[ARRAY_CHUNK_LENGTH];
+        bool out_of_range = false;
+
+        for (std::size_t i = 0; i < data.size(); i += ARRAY_CHUNK_LENGTH)
+        {
+            const std::size_t chunk_length = std::min(data.size() - i, ARRAY_CHUNK_LENGTH);
+
+            do_read_packed_unchecked(values, sizeof(UInt), chunk_length, bits);
+
+            // Convert values to original range, and check if any exceeds `max`.
+            // Simple loop without early exit, so that it can be vectorized.
+            for (std::size_t j = 0; j < chunk_length; ++j)
+            {
+                out_of_range |= (values[j] > range);
+                data[i + j] = static_cast<Int>(static_cast<UInt>(values[j] + static_cast<UInt>(min)));
+            }
+        }
+
+        if (out_of_range)
+            _fail = true;
+
+        return self();
+    }
+
+    /// @brief Reads a varint integral value from the bit stream.
+    ///
+    /// If the varint has more groups than @p Int can hold, or its value exceeds @p Int,
+    /// this function will set the fail flag.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to read to.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    auto read_varint(Int& data) -> Derived&
+    {
+        std::uint64_t value;
+        if (do_read_varint(value, static_cast<int>(8 * sizeof(Int))))
+            data = decode_unsigned_code<Int>(value);
+
+        return self();
+    }
+
+    /// @brief Reads an Exp-Golomb coded integral value of order @p k from the bit stream.
+    ///
+    /// If its value exceeds @p Int, this function will set the fail flag.
+    /// @tparam Int Integer type of @p data.
+    /// @param data Data to read to.
+    /// @param k Order of the Exp-Golomb code, which must be less than the bit width of @p Int.
+    /// @return The stream itself.
+    template <ranged_integral Int>
+    auto read_exp_golomb(Int& data, int k = 0) -> Derived&
+    {
+        std::uint64_t value;
+        if (do_read_exp_golomb(value, k, static_cast<int>(8 * sizeof(Int))))
+            data = decode_unsigned_code<Int>(value);
+
+        return self();
+    }
+
+    /// @brief Reads an Elias gamma coded positive integral value from the bit stream.
+    ///
+    /// If its value exceeds @p UInt, this function will set the fail flag.
+    /// @tparam UInt Unsigned integer type of @p data.
+    /// @param data Data to read to.
+    /// @return The stream itself.
+    template <ranged_integral UInt>
+        requires std::unsigned_integral<UInt>
+    auto read_elias_gamma(UInt& data) -> Derived&
+    {
+        std::uint64_t value;
+        if (do_read_exp_golomb(value, 0, static_cast<int>(8 * sizeof(UInt))))
+        {
+            // `value + 1` must fit in `UInt`.
+            if (value == std::numeric_limits<UInt>::max())
+                _fail = true;
+            else
+                data = static_cast<UInt>(value + 1);
+        }
+
+        return self();
+    }
+
+    /// @brief Reads an integral value delta encoded against @p baseline from the bit stream.
+    ///
+    /// If the decoded value is out of range, this function will set the fail flag.
+    /// @tparam Int Integer type of @p data.
     /// @param data Data to read to.
+    /// @param baseline Baseline the difference is from, which must be the same one used on write.
     /// @param min Minimum value allowed for @p data.
     /// @param max Maximum value allowed for @p data.
     /// @return The stream itself.
-    template <std::integral BInt>
-        requires(sizeof(BInt) > sizeof(word_type))
-    auto read(BInt& data, BInt min = std::numeric_limits<BInt>::min(), BInt max = std::numeric_limits<BInt>::max())
-        -> bit_stream_reader&
+    template <ranged_integral Int>
+    auto read_delta(Int& data, std::type_identity_t<Int> baseline,
+                    std::type_identity_t<Int> min = std::numeric_limits<Int>::min(),
+                    std::type_identity_t<Int> max = std::numeric_limits<Int>::max()) -> Derived&
     {
-        return do_read<true>(data, min, max);
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+        NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(self());
+
+        // Unchanged flag.
+        bool unchanged;
+        if (!read(unchanged))
+            return self();
+
+        if (unchanged)
+        {
+            // Fail if `baseline` is out of range, as it should've been checked on write.
+            if (baseline < min || baseline > max)
+            {
+                _fail = true;
+                return self();
+            }
+
+            data = baseline;
+            return self();
+        }
+
+        // Delta flag.
+        bool use_delta;
+        if (!read(use_delta))
+            return self();
+
+        if (!use_delta)
+            return read(data, min, max);
+
+        using UInt = std::make_unsigned_t<Int>;
+
+        std::uint64_t code;
+        if (!do_read_exp_golomb(code, 0, static_cast<int>(8 * sizeof(Int))))
+            return self();
+
+        // `code + 1` must fit in `UInt`.
+        if (code == std::numeric_limits<UInt>::max())
+        {
+            _fail = true;
+            return self();
+        }
+
+        const Int value = apply_delta_code<Int>(static_cast<UInt>(code + 1), baseline);
+
+        // Fail if it's out of range.
+        if (value < min || value > max)
+        {
+            _fail = true;
+            return self();
+        }
+
+        data = value;
+        return self();
     }
 
-    /// @brief Reads a float value from the bit stream.
-    /// @param data Data to read to.
+    /// @brief Reads bytes encoded with a static Huffman codebook from the bit stream.
+    ///
+    /// If @p codebook is invalid, or the codes are invalid, this function will set the fail flag.
+    /// @param data Bytes to read to.
+    /// @param size Number of bytes, which must be the same one used on write.
+    /// @param codebook Codebook to decode the bytes with, which must be the same one used on write.
     /// @return The stream itself.
-    NALCHI_API auto read(float& data) -> bit_stream_reader&;
+    auto read_huffman(void* data, size_type size, const huffman_codebook& codebook) -> Derived&;
 
-    /// @brief Reads a double value from the bit stream.
-    /// @param data Data to read to.
+    /// @brief Reads a string encoded with a static Huffman codebook from the bit stream.
+    ///
+    /// If the length exceeds @p max_length, @p codebook is invalid, or the codes are invalid,
+    /// this function will set the fail flag.
+    /// @param str String to read to.
+    /// @param max_length Maximum length allowed for @p str.
+    /// @param codebook Codebook to decode the characters with, which must be the same one used on write.
     /// @return The stream itself.
-    NALCHI_API auto read(double& data) -> bit_stream_reader&;
+    auto read_string_huffman(std::string& str, size_type max_length, const huffman_codebook& codebook)
+        -> Derived&;
 
     /// @brief Reads a string from the bit stream.
     ///
@@ -920,26 +2557,104 @@ public:
     /// This is to prevent a huge allocation when a malicious message requests it.
     /// @return The stream itself.
     template <character CharT, typename CharTraits, typename Allocator>
-    auto read(std::basic_string<CharT, CharTraits, Allocator>& str, size_type max_length) -> bit_stream_reader&
+    auto read(std::basic_string<CharT, CharTraits, Allocator>& str, size_type max_length) -> Derived&
     {
-        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
 
         // Read the length of the string.
         ssize_type len = read_string_length();
         if (len < 0 || static_cast<size_type>(len) > max_length)
         {
             _fail = true;
-            return *this;
+            return self();
         }
 
         NALCHI_BIT_STREAM_READER_FAIL_IF_STR_OVERFLOW(len * sizeof(CharT));
 
-        // Resize and read every character one by one.
+        // Resize and read the characters in bulk.
         str.resize(len);
-        for (auto& ch : str)
-            do_read<false>(ch);
+        do_read_chars_unchecked(str.data(), static_cast<std::size_t>(len));
 
-        return *this;
+        return self();
+    }
+
+    /// @brief Reads a string from the bit stream as a view, without any allocation.
+    ///
+    /// If the string payload is byte aligned in the stream, and it can be viewed as `CharT` as-is, \n
+    /// @p str will directly view into your buffer, so you @b must keep your buffer alive while using @p str. \n
+    /// Otherwise, the string is copied to @p scratch, and @p str will view into @p scratch.
+    ///
+    /// The direct view is only possible for unsigned character types,
+    /// as signed characters are written with their sign bit flipped. \n
+    /// (e.g. `char8_t`, `char16_t`, `char32_t`, and `char` on the systems where it's unsigned) \n
+    /// For multi-byte characters, it also requires a little endian system and a properly aligned position. \n
+    /// If you want the direct view regardless of the stream position,
+    /// write it with `write_aligned_string()` and read it with `read_aligned_string_view()` instead.
+    ///
+    /// If the length prefix for current stream position exceeds @p max_length,
+    /// or it needs to copy but @p scratch is too small, \n
+    /// this function will set the fail flag and read nothing.
+    /// @tparam CharT Underlying character type of `std::basic_string_view`.
+    /// @param str String view to read to.
+    /// @param max_length Maximum number of `CharT` that can be read.
+    /// @param scratch Scratch space to copy the string to, if it can't be viewed directly.
+    /// @return The stream itself.
+    template <character CharT>
+    auto read_view(std::basic_string_view<CharT>& str, size_type max_length, std::span<CharT> scratch)
+        -> Derived&
+    {
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+        // Read the length of the string.
+        ssize_type len = read_string_length();
+        if (len < 0 || static_cast<size_type>(len) > max_length)
+        {
+            _fail = true;
+            return self();
+        }
+
+        NALCHI_BIT_STREAM_READER_FAIL_IF_STR_OVERFLOW(len * sizeof(CharT));
+
+        return do_read_view(str, static_cast<std::size_t>(len), scratch);
+    }
+
+    /// @brief Reads a string written with `write_aligned_string()` from the bit stream as a view,
+    /// without any allocation.
+    ///
+    /// As the characters are aligned to their size in the stream, \n
+    /// @p str always directly views into your buffer for the character types `read_view()` can view. \n
+    /// So, you @b must keep your buffer alive while using @p str. \n
+    /// For the other character types, the string is copied to @p scratch, and @p str will view into @p scratch.
+    ///
+    /// If the length prefix for current stream position exceeds @p max_length, the padding is not zero,
+    /// or it needs to copy but @p scratch is too small, \n
+    /// this function will set the fail flag.
+    /// @tparam CharT Underlying character type of `std::basic_string_view`.
+    /// @param str String view to read to.
+    /// @param max_length Maximum number of `CharT` that can be read.
+    /// @param scratch Scratch space to copy the string to, if it can't be viewed directly.
+    /// @return The stream itself.
+    template <character CharT>
+    auto read_aligned_string_view(std::basic_string_view<CharT>& str, size_type max_length, std::span<CharT> scratch)
+        -> Derived&
+    {
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+        // Read the length of the string.
+        ssize_type len = read_string_length();
+        if (len < 0 || static_cast<size_type>(len) > max_length)
+        {
+            _fail = true;
+            return self();
+        }
+
+        // Skip the padding after the length prefix.
+        if (!do_align(static_cast<int>(8 * sizeof(CharT))))
+            return self();
+
+        NALCHI_BIT_STREAM_READER_FAIL_IF_STR_OVERFLOW(len * sizeof(CharT));
+
+        return do_read_view(str, static_cast<std::size_t>(len), scratch);
     }
 
     /// @brief Reads a null-terminated string from the bit stream.
@@ -955,28 +2670,27 @@ public:
     /// @param max_length Maximum number of `CharT` that can be read.
     /// @return The stream itself.
     template <character CharT>
-    auto read(CharT* str, size_type max_length) -> bit_stream_reader&
+    auto read(CharT* str, size_type max_length) -> Derived&
     {
-        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
+        NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
 
         // Read the length of the string.
         ssize_type len = read_string_length();
         if (len < 0 || static_cast<size_type>(len) > max_length)
         {
             _fail = true;
-            return *this;
+            return self();
         }
 
         NALCHI_BIT_STREAM_READER_FAIL_IF_STR_OVERFLOW(len * sizeof(CharT));
 
-        // Read every character one by one.
-        for (ssize_type i = 0; i < len; ++i)
-            do_read<false>(str[i]);
+        // Read the characters in bulk.
+        do_read_chars_unchecked(str, static_cast<std::size_t>(len));
 
         // Insert final null character.
         str[len] = CharT(0);
 
-        return *this;
+        return self();
     }
 
     /// @brief Peeks the string length prefix from the current stream position.
@@ -985,7 +2699,7 @@ public:
     /// this function will return a negative value and set the fail flag.
     /// @note Be careful, if current stream position was not on the string length prefix, it might read garbage length!
     /// @return Length of `CharT` stored in it, or a negative value if length prefix is invalid.
-    NALCHI_API auto peek_string_length() -> ssize_type;
+    auto peek_string_length() -> ssize_type;
 
 private:
     /// @brief Reads the string length prefix from the current stream position.
@@ -994,7 +2708,7 @@ private:
     /// this function will return a negative value and set the fail flag.
     /// @note Be careful, if current stream position was not on the string length prefix, it might read garbage length!
     /// @return Length of `CharT` stored in it, or a negative value if length prefix is invalid.
-    NALCHI_API auto read_string_length() -> ssize_type;
+    auto read_string_length() -> ssize_type;
 
     /// @brief Actually reads an integral value from the bit stream.
     /// @tparam Checked Whether the checks are performed or not.
@@ -1006,12 +2720,12 @@ private:
     template <bool Checked, std::integral SInt>
         requires(sizeof(SInt) <= sizeof(word_type))
     auto do_read(SInt& data, SInt min = std::numeric_limits<SInt>::min(), SInt max = std::numeric_limits<SInt>::max())
-        -> bit_stream_reader&
+        -> Derived&
     {
         if constexpr (Checked)
         {
-            NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
-            NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(*this);
+            NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+            NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(self());
         }
 
         using UInt = make_unsigned_allow_bool_t<SInt>;
@@ -1025,7 +2739,7 @@ private:
             if (_logical_used_bits + bits > _logical_total_bits)
             {
                 _fail = true;
-                return *this;
+                return self();
             }
         }
 
@@ -1041,7 +2755,8 @@ private:
         _scratch_bits -= bits;
 
         // Convert to original range.
-        const SInt conv = static_cast<SInt>(((SInt)value) + min);
+        // Add in unsigned, as it wraps around for the full range of signed integers.
+        const SInt conv = static_cast<SInt>(static_cast<UInt>(value + static_cast<UInt>(min)));
 
         if constexpr (Checked)
         {
@@ -1049,7 +2764,7 @@ private:
             if (conv > max)
             {
                 _fail = true;
-                return *this;
+                return self();
             }
         }
 
@@ -1059,7 +2774,7 @@ private:
         // Adjust used bits
         _logical_used_bits += bits;
 
-        return *this;
+        return self();
     }
 
     /// @brief Actually reads an integral value from the bit stream.
@@ -1072,12 +2787,12 @@ private:
     template <bool Checked, std::integral BInt>
         requires(sizeof(BInt) > sizeof(word_type))
     auto do_read(BInt& data, BInt min = std::numeric_limits<BInt>::min(), BInt max = std::numeric_limits<BInt>::max())
-        -> bit_stream_reader&
+        -> Derived&
     {
         if constexpr (Checked)
         {
-            NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
-            NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(*this);
+            NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+            NALCHI_BIT_STREAM_FAIL_IF_MIN_MAX_RANGE_INVALID(self());
         }
 
         // Current logic assumes the only size here is 64 bits, but hey who wouldn't?
@@ -1094,7 +2809,7 @@ private:
             if (_logical_used_bits + bits > _logical_total_bits)
             {
                 _fail = true;
-                return *this;
+                return self();
             }
         }
 
@@ -1127,7 +2842,8 @@ private:
         }
 
         // Convert to original range.
-        const BInt conv = static_cast<BInt>(((BInt)value) + min);
+        // Add in unsigned, as it wraps around for the full range of signed integers.
+        const BInt conv = static_cast<BInt>(static_cast<UInt>(value + static_cast<UInt>(min)));
 
         if constexpr (Checked)
         {
@@ -1135,7 +2851,7 @@ private:
             if (conv > max)
             {
                 _fail = true;
-                return *this;
+                return self();
             }
         }
 
@@ -1145,11 +2861,356 @@ private:
         // Adjust used bits
         _logical_used_bits += bits;
 
-        return *this;
+        return self();
+    }
+
+private:
+    /// @brief Converts an unsigned value read from the bit stream to @p Int, zigzag decoding it if @p Int is signed.
+    /// @tparam Int Integer type to convert to.
+    /// @param value Unsigned value, which must fit in the bit width of @p Int.
+    /// @return Converted value.
+    template <ranged_integral Int>
+    static auto decode_unsigned_code(std::uint64_t value) -> Int
+    {
+        using UInt = std::make_unsigned_t<Int>;
+
+        if constexpr (std::is_signed_v<Int>)
+            return zigzag_decode(static_cast<UInt>(value));
+        else
+            return static_cast<UInt>(value);
+    }
+
+    /// @brief Actually reads a varint from the bit stream.
+    /// @param value Unsigned value to read to.
+    /// @param value_bits Maximum bit width of the value.
+    /// @return The stream itself.
+    auto do_read_varint(std::uint64_t& value, int value_bits) -> Derived&;
+
+    /// @brief Actually reads an Exp-Golomb code from the bit stream.
+    /// @param value Unsigned value to read to.
+    /// @param k Order of the Exp-Golomb code, which must be less than @p value_bits.
+    /// @param value_bits Maximum bit width of the value, which must be between 1 and 64.
+    /// @return The stream itself.
+    auto do_read_exp_golomb(std::uint64_t& value, int k, int value_bits) -> Derived&;
+
+    /// @brief Actually reads the Huffman codes of bytes from the bit stream.
+    /// @param data Bytes to read to.
+    /// @param size Number of bytes.
+    /// @param codebook Codebook to decode the bytes with, which must be valid.
+    /// @return The stream itself.
+    auto do_read_huffman(std::uint8_t* data, size_type size, const huffman_codebook& codebook)
+        -> Derived&;
+
+    /// @brief Reads a Huffman code bit by bit, for the codes longer than the lookup or near the end of the stream.
+    /// @param symbol Symbol to read to.
+    /// @param codebook Codebook to decode the symbol with, which must be valid.
+    /// @return Whether it succeeded or not.
+    bool do_read_huffman_symbol_slow(std::uint8_t& symbol, const huffman_codebook& codebook);
+
+    /// @brief Reads the zero bits until a one bit, and consumes the one bit as well.
+    ///
+    /// If there are more than @p max_zeros zero bits, or the stream ends before a one bit, \n
+    /// this function will return a negative value and set the fail flag.
+    /// @param max_zeros Maximum number of zero bits allowed.
+    /// @return Number of zero bits read, or a negative value if it fails.
+    auto read_unary_zeros(int max_zeros) -> int;
+
+    /// @brief Number of array elements unpacked & converted at once, to keep the temporary buffers on the stack.
+    static constexpr std::size_t ARRAY_CHUNK_LENGTH = 256;
+
+    /// @brief Actually reads unsigned values with the same number of bits from the bit stream, without any checks.
+    ///
+    /// This reverses `bit_stream_writer::do_write_packed_unchecked()`.
+    /// @param values Pointer to the unsigned values to read to.
+    /// @param value_size Size in bytes of each value.
+    /// @param count Number of values, which must not exceed `ARRAY_CHUNK_LENGTH`.
+    /// @param bits Number of bits for each value.
+    void do_read_packed_unchecked(void* values, std::size_t value_size, std::size_t count, int bits);
+
+    /// @brief Actually reads some arbitrary data from the bit stream, without any checks.
+    ///
+    /// Whole words are copied directly from the user buffer if the stream is word aligned,
+    /// otherwise they're shift-merged with the internal scratch buffer in 64-bit blocks.
+    /// @param data Pointer to the arbitrary data.
+    /// @param size Size in bytes of the data.
+    void do_read_bytes_unchecked(std::byte* data, size_type size);
+
+    /// @brief Actually reads the characters of a string from the bit stream, without any checks.
+    ///
+    /// This reverses `bit_stream_writer::do_write_chars_unchecked()`,
+    /// by reading them in bulk and converting them in place if needed.
+    /// @tparam CharT Character type of the string.
+    /// @param str Pointer to the characters to read to.
+    /// @param len Number of characters.
+    template <character CharT>
+    void do_read_chars_unchecked(CharT* str, std::size_t len)
+    {
+        using UChar = std::make_unsigned_t<CharT>;
+
+        constexpr bool IS_SIGNED = std::is_signed_v<CharT>;
+        constexpr bool NEEDS_SWAP = (sizeof(CharT) > 1 && std::endian::native == std::endian::big);
+
+        do_read_bytes_unchecked(reinterpret_cast<std::byte*>(str), static_cast<size_type>(sizeof(CharT) * len));
+
+        if constexpr (IS_SIGNED || NEEDS_SWAP)
+        {
+            constexpr UChar SIGN_BIT = IS_SIGNED ? static_cast<UChar>(UChar(1) << (8 * sizeof(CharT) - 1)) : UChar(0);
+
+            // Simple loop without dependencies, so that it can be vectorized.
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                UChar ch = static_cast<UChar>(str[i]);
+                if constexpr (NEEDS_SWAP)
+                    ch = std::byteswap(ch);
+                // `ch + min` is same as flipping the sign bit.
+                str[i] = static_cast<CharT>(static_cast<UChar>(ch ^ SIGN_BIT));
+            }
+        }
+    }
+
+    /// @brief Actually reads a constant number of raw bits from the bit stream, without any checks.
+    /// @tparam Bits Number of bits to read, which must not exceed twice the size of `word_type`.
+    /// @return Raw bits read.
+    template <int Bits>
+    auto do_read_bits_unchecked() -> scratch_type
+    {
+        constexpr int WORD_BITS = static_cast<int>(8 * sizeof(word_type));
+
+        static_assert(0 < Bits && Bits <= 2 * WORD_BITS);
+
+        scratch_type value;
+
+        if constexpr (Bits <= WORD_BITS)
+        {
+            // Load more bits to `_scratch` if needed.
+            if (Bits > _scratch_bits)
+                do_fetch_word_unchecked();
+
+            // Read raw `value` from `_scratch`.
+            value = _scratch & ((scratch_type(1) << Bits) - 1);
+
+            // Remove read bits from `_scratch`.
+            _scratch >>= Bits;
+            _scratch_bits -= Bits;
+        }
+        else
+        {
+            // Read lower word from `_scratch`, which always requires a fetch.
+            do_fetch_word_unchecked();
+            value = _scratch & ((scratch_type(1) << WORD_BITS) - 1);
+            _scratch >>= WORD_BITS;
+            _scratch_bits -= WORD_BITS;
+
+            // Load more bits to `_scratch` if needed.
+            if (Bits - WORD_BITS > _scratch_bits)
+                do_fetch_word_unchecked();
+
+            // Read higher bits from `_scratch`.
+            value |= (_scratch & ((scratch_type(1) << (Bits - WORD_BITS)) - 1)) << WORD_BITS;
+            _scratch >>= (Bits - WORD_BITS);
+            _scratch_bits -= (Bits - WORD_BITS);
+        }
+
+        // Adjust used bits
+        _logical_used_bits += Bits;
+
+        return value;
+    }
+
+    /// @brief Moves the current stream position to @p bit, without any checks.
+    /// @param bit Position in bits to move to, which must not exceed the total bits.
+    void seek_to_bit_unchecked(size_type bit);
+
+    /// @brief Actually skips the padding bits to the next multiple of @p alignment_bits.
+    /// @param alignment_bits Alignment in bits, which must be a multiple of 8 up to 64.
+    /// @return The stream itself.
+    auto do_align(int alignment_bits) -> Derived&;
+
+    /// @brief Actually reads the characters of a string as a view, or copies them to @p scratch if it can't.
+    ///
+    /// The length prefix @b must be already read, and checked not to overflow the stream.
+    /// @tparam CharT Character type of the string.
+    /// @param str String view to read to.
+    /// @param len Number of characters.
+    /// @param scratch Scratch space to copy the string to, if it can't be viewed directly.
+    /// @return The stream itself.
+    template <character CharT>
+    auto do_read_view(std::basic_string_view<CharT>& str, std::size_t len, std::span<CharT> scratch)
+        -> Derived&
+    {
+        // Words are stored in little endian on every system, so the stream is in byte order in your buffer.
+        constexpr bool VIEWABLE =
+            std::is_unsigned_v<CharT> && (sizeof(CharT) == 1 || std::endian::native == std::endian::little);
+
+        if constexpr (VIEWABLE)
+        {
+            if (_logical_used_bits % 8 == 0)
+            {
+                const std::byte* const begin =
+                    reinterpret_cast<const std::byte*>(_words.data()) + _logical_used_bits / 8;
+
+                if (reinterpret_cast<std::uintptr_t>(begin) % alignof(CharT) == 0)
+                {
+                    str = std::basic_string_view<CharT>(reinterpret_cast<const CharT*>(begin), len);
+                    seek_to_bit_unchecked(_logical_used_bits + static_cast<size_type>(8 * sizeof(CharT) * len));
+                    return self();
+                }
+            }
+        }
+
+        // Can't view directly, so copy to `scratch`.
+        if (len > scratch.size())
+        {
+            _fail = true;
+            return self();
+        }
+
+        do_read_chars_unchecked(scratch.data(), len);
+        str = std::basic_string_view<CharT>(scratch.data(), len);
+
+        return self();
+    }
+
+    NALCHI_BIT_STREAM_HOT_PATH void do_fetch_word_unchecked();
+};
+
+template <typename Word, typename Scratch, typename Derived>
+NALCHI_BIT_STREAM_HOT_PATH void bit_stream_reader_base<Word, Scratch, Derived>::do_fetch_word_unchecked()
+{
+    // Get the word to load to scratch.
+    word_type word = _words[_words_index++];
+    if constexpr (std::endian::native == std::endian::big)
+        word = std::byteswap(word);
+
+    // Load to scratch.
+    _scratch |= (static_cast<scratch_type>(word) << _scratch_bits);
+
+    // Adjust the scratch bits.
+    _scratch_bits += 8 * sizeof(word_type);
+}
+
+/// @brief Bit stream reader that reads @p Word with a @p Scratch.
+///
+/// See `bit_stream_reader_base` for the details.
+/// @tparam Word Word type used to read from your buffer.
+/// @tparam Scratch Scratch type to store the temporary scratch data, which must be twice the size of @p Word.
+template <typename Word = std::uint32_t, typename Scratch = std::uint64_t>
+class basic_bit_stream_reader final
+    : public bit_stream_reader_base<Word, Scratch, basic_bit_stream_reader<Word, Scratch>>
+{
+    using base_type = bit_stream_reader_base<Word, Scratch, basic_bit_stream_reader<Word, Scratch>>;
+
+public:
+    using base_type::base_type;
+};
+
+/// @brief Bit stream reader that reads 32-bit words with a 64-bit scratch, which you would normally use.
+///
+/// This reads the same as `basic_bit_stream_reader<>`, but it's kept as a concrete class, \n
+/// so that its C++ symbols stay the same as the versions before the bit streams were templated.
+class bit_stream_reader final : public bit_stream_reader_base<std::uint32_t, std::uint64_t, bit_stream_reader>
+{
+    using base_type = bit_stream_reader_base<std::uint32_t, std::uint64_t, bit_stream_reader>;
+
+public:
+    /// @brief Deleted copy constructor.
+    bit_stream_reader(const bit_stream_reader&) = delete;
+
+    /// @brief Deleted copy assignment operator.
+    auto operator=(const bit_stream_reader&) -> bit_stream_reader& = delete;
+
+    // Below are the members exported before the bit streams were templated, forwarding to `bit_stream_reader_base`.
+
+    NALCHI_API bit_stream_reader();
+    NALCHI_API bit_stream_reader(std::span<const word_type> buffer, size_type logical_bytes_length);
+    NALCHI_API bit_stream_reader(const word_type* begin, const word_type* end, size_type logical_bytes_length);
+    NALCHI_API bit_stream_reader(const word_type* begin, size_type words_length, size_type logical_bytes_length);
+
+public:
+    NALCHI_API void set_fail()
+    {
+        base_type::set_fail();
+    }
+
+    NALCHI_API bool fail() const noexcept
+    {
+        return base_type::fail();
+    }
+
+    NALCHI_API bool operator!() const noexcept
+    {
+        return base_type::operator!();
+    }
+
+    NALCHI_API operator bool() const noexcept
+    {
+        return base_type::operator bool();
+    }
+
+public:
+    NALCHI_API auto total_bytes() const -> size_type
+    {
+        return base_type::total_bytes();
+    }
+
+    NALCHI_API auto total_bits() const -> size_type
+    {
+        return base_type::total_bits();
+    }
+
+    NALCHI_API auto used_bytes() const -> size_type;
+
+    NALCHI_API auto used_bits() const -> size_type
+    {
+        return base_type::used_bits();
+    }
+
+    NALCHI_API auto unused_bytes() const -> size_type
+    {
+        return base_type::unused_bytes();
     }
 
+    NALCHI_API auto unused_bits() const -> size_type
+    {
+        return base_type::unused_bits();
+    }
+
+public:
+    using base_type::reset_with;
+
+    NALCHI_API void restart();
+    NALCHI_API void reset();
+    NALCHI_API void reset_with(std::span<const word_type> buffer, size_type logical_bytes_length);
+    NALCHI_API void reset_with(const word_type* begin, const word_type* end, size_type logical_bytes_length);
+    NALCHI_API void reset_with(const word_type* begin, size_type words_length, size_type logical_bytes_length);
+
+public:
+    using base_type::read;
+
+    NALCHI_API auto read(void* data, size_type size) -> bit_stream_reader&;
+    NALCHI_API auto read(float& data) -> bit_stream_reader&;
+    NALCHI_API auto read(double& data) -> bit_stream_reader&;
+
+    NALCHI_API auto peek_string_length() -> ssize_type;
+
 private:
+    NALCHI_API auto read_string_length() -> ssize_type;
     NALCHI_API void do_fetch_word_unchecked();
 };
 
+extern template class NALCHI_EXTERN_TEMPLATE_API
+    bit_stream_reader_base<std::uint32_t, std::uint64_t, bit_stream_reader>;
+extern template class NALCHI_EXTERN_TEMPLATE_API
+    bit_stream_reader_base<std::uint32_t, std::uint64_t, basic_bit_stream_reader<>>;
+
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+/// @brief Bit stream reader that reads 64-bit words with a 128-bit scratch.
+/// @note This is only available when the compiler provides `unsigned __int128` (`NALCHI_HAS_WIDE_BIT_STREAM`), \n
+/// so not on MSVC.
+using wide_bit_stream_reader = basic_bit_stream_reader<std::uint64_t, uint128_t>;
+
+extern template class NALCHI_EXTERN_TEMPLATE_API
+    bit_stream_reader_base<std::uint64_t, uint128_t, wide_bit_stream_reader>;
+#endif
+
 } // namespace nalchi
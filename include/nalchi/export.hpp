@@ -22,6 +22,25 @@
 
 #endif // NALCHI_BUILD
 
+// Export attributes for the explicit instantiations of the class templates.
+// MSVC ignores `dllexport` on an `extern template` declaration (C4910), so it's put on the instantiation definition.
+// GCC & Clang ignore the attributes on the definition after the `extern template` one, so it's put on the latter.
+#if defined(_WIN32)
+
+#if defined(NALCHI_BUILD_EXPORT)
+#define NALCHI_EXTERN_TEMPLATE_API
+#else
+#define NALCHI_EXTERN_TEMPLATE_API NALCHI_API
+#endif
+#define NALCHI_TEMPLATE_INSTANTIATION_API NALCHI_API
+
+#else
+
+#define NALCHI_EXTERN_TEMPLATE_API NALCHI_API
+#define NALCHI_TEMPLATE_INSTANTIATION_API
+
+#endif
+
 #if defined(__cplusplus)
 #define NALCHI_FLAT_API extern "C" NALCHI_API
 #else
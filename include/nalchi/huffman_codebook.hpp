@@ -0,0 +1,132 @@
+#pragma once
+
+#include "nalchi/export.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace nalchi
+{
+
+/// @brief Static Huffman codebook for bytes, used by `write_huffman()` and `write_string_huffman()` of bit streams.
+///
+/// Train it offline from captured traffic with `from_frequencies()`, dump its `code_lengths()` to your source,
+/// and construct it from them at runtime. \n
+/// As the codes are canonical, the code lengths are all that's needed to reproduce the same codebook.
+///
+/// Decoding is table-driven: a single lookup on the next `LOOKUP_BITS` bits yields
+/// up to `MAX_LOOKUP_SYMBOLS` symbols at once. \n
+/// Codes longer than `LOOKUP_BITS` bits are decoded bit by bit, which should be rare for a well trained codebook.
+/// @note This is a large object, so construct it once and share it.
+class NALCHI_API huffman_codebook final
+{
+public:
+    static constexpr int SYMBOLS = 256;          ///< Number of symbols, which are the byte values.
+    static constexpr int MAX_CODE_LENGTH = 15;   ///< Maximum length of a code in bits.
+    static constexpr int LOOKUP_BITS = 11;       ///< Number of bits looked up at once while decoding.
+    static constexpr int MAX_LOOKUP_SYMBOLS = 4; ///< Maximum number of symbols decoded by a lookup.
+
+    static constexpr std::uint32_t LOOKUP_MASK = (std::uint32_t(1) << LOOKUP_BITS) - 1; ///< Mask of the lookup bits.
+
+    /// @brief Code of a symbol.
+    struct code_type
+    {
+        std::uint16_t bits;  ///< Code bits in the stream order, so the first bit is the LSB.
+        std::uint8_t length; ///< Length of the code in bits, `0` if the symbol is not in the codebook.
+    };
+
+    /// @brief Decoded symbols from a lookup.
+    struct lookup_entry
+    {
+        std::array<std::uint8_t, MAX_LOOKUP_SYMBOLS> symbols; ///< Decoded symbols.
+        std::uint8_t count;      ///< Number of decoded symbols, `0` if the first code is longer than `LOOKUP_BITS`.
+        std::uint8_t bits;       ///< Total bits of the decoded symbols.
+        std::uint8_t first_bits; ///< Bits of the first decoded symbol.
+    };
+
+public:
+    /// @brief Constructs a codebook where every byte takes 8 bits.
+    huffman_codebook();
+
+    /// @brief Constructs a canonical codebook from the code lengths.
+    ///
+    /// Symbols of length `0` are not in the codebook, and writing them fails. \n
+    /// If any length exceeds `MAX_CODE_LENGTH`, no symbol has a code,
+    /// or the lengths over-subscribe the code space, the codebook will be invalid.
+    /// @param code_lengths Code length of each byte value.
+    explicit huffman_codebook(std::span<const std::uint8_t, SYMBOLS> code_lengths);
+
+    /// @brief Trains a codebook from the byte frequencies of your traffic.
+    ///
+    /// Every byte value gets a code, even if its frequency is `0`, so that any string can be written. \n
+    /// If the optimal codes exceed `MAX_CODE_LENGTH`, the frequencies are flattened until they don't.
+    /// @param frequencies Number of occurrences of each byte value.
+    /// @return Trained codebook.
+    static auto from_frequencies(std::span<const std::uint64_t, SYMBOLS> frequencies) -> huffman_codebook;
+
+public:
+    /// @brief Checks if the codebook is valid.
+    bool valid() const
+    {
+        return _valid;
+    }
+
+    /// @brief Gets the code length of each byte value, to store the codebook.
+    auto code_lengths() const -> const std::array<std::uint8_t, SYMBOLS>&
+    {
+        return _code_lengths;
+    }
+
+    /// @brief Gets the length of the shortest code.
+    int min_code_length() const
+    {
+        return _min_code_length;
+    }
+
+    /// @brief Gets the code of @p symbol.
+    auto code(std::uint8_t symbol) const -> const code_type&
+    {
+        return _codes[symbol];
+    }
+
+    /// @brief Gets the symbols decoded from the next `LOOKUP_BITS` bits.
+    /// @param window Next bits in the stream order, whose bits above `LOOKUP_BITS` are ignored.
+    auto lookup(std::uint32_t window) const -> const lookup_entry&
+    {
+        return _lookup[window & LOOKUP_MASK];
+    }
+
+    /// @brief Gets the number of bits to encode @p data.
+    /// @param data Bytes to encode.
+    /// @param size Number of bytes.
+    /// @return Number of bits, or `-1` if some bytes are not in the codebook.
+    auto encoded_bits(const void* data, std::size_t size) const -> std::int64_t;
+
+    /// @brief Finds the symbol of a code, to decode the codes longer than `LOOKUP_BITS` bit by bit.
+    /// @param code Code bits read so far, where the first bit is the MSB.
+    /// @param length Number of bits read so far.
+    /// @param symbol Found symbol.
+    /// @return Whether the symbol is found.
+    bool find_symbol(std::uint32_t code, int length, std::uint8_t& symbol) const;
+
+private:
+    void build();
+
+private:
+    std::array<std::uint8_t, SYMBOLS> _code_lengths;
+    std::array<code_type, SYMBOLS> _codes;
+    std::array<lookup_entry, std::size_t(1) << LOOKUP_BITS> _lookup;
+
+    // Canonical decoding tables, indexed by the code length.
+    std::array<std::uint32_t, MAX_CODE_LENGTH + 1> _first_code;
+    std::array<std::uint16_t, MAX_CODE_LENGTH + 1> _first_index;
+    std::array<std::uint16_t, MAX_CODE_LENGTH + 1> _length_count;
+    std::array<std::uint8_t, SYMBOLS> _sorted_symbols;
+
+    int _min_code_length;
+    bool _valid;
+};
+
+} // namespace nalchi
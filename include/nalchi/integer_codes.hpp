@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace nalchi
+{
+
+/// @brief Maps a signed value to an unsigned value, so that small magnitudes map to small values.
+///
+/// `0, -1, 1, -2, 2, ...` are mapped to `0, 1, 2, 3, 4, ...`.
+/// @param value Signed value to map.
+/// @return Mapped unsigned value.
+template <std::signed_integral SInt>
+constexpr auto zigzag_encode(SInt value) -> std::make_unsigned_t<SInt>
+{
+    using UInt = std::make_unsigned_t<SInt>;
+
+    // Arithmetic right shift fills with the sign bit.
+    return static_cast<UInt>(static_cast<UInt>(static_cast<UInt>(value) << 1) ^
+                             static_cast<UInt>(value >> (8 * sizeof(SInt) - 1)));
+}
+
+/// @brief Reverses `zigzag_encode()`.
+/// @param value Unsigned value to map.
+/// @return Mapped signed value.
+template <std::unsigned_integral UInt>
+constexpr auto zigzag_decode(UInt value) -> std::make_signed_t<UInt>
+{
+    return static_cast<std::make_signed_t<UInt>>(static_cast<UInt>((value >> 1) ^ static_cast<UInt>(-(value & 1))));
+}
+
+/// @brief Gets the number of bits @p value takes as a varint, which is a multiple of 8.
+/// @param value Value to measure.
+/// @return Number of bits.
+constexpr auto varint_bits(std::uint64_t value) -> int
+{
+    return 8 * std::max(1, (static_cast<int>(std::bit_width(value)) + 6) / 7);
+}
+
+/// @brief Gets the number of bits @p value takes as an Exp-Golomb code of order @p k.
+/// @param value Value to measure.
+/// @param k Order of the Exp-Golomb code, which must be between 0 and 63.
+/// @return Number of bits.
+constexpr auto exp_golomb_bits(std::uint64_t value, int k) -> int
+{
+    const std::uint64_t offset = std::uint64_t(1) << k;
+    const std::uint64_t biased = value + offset;
+
+    // If `value + 2^k` overflows, it has 65 bits.
+    const int n = (biased < offset) ? 64 : static_cast<int>(std::bit_width(biased)) - 1;
+
+    return 2 * n - k + 1;
+}
+
+/// @brief Gets the zigzag encoded difference `value - baseline`, wrapping around the width of @p Int.
+///
+/// As it wraps around, this is never `0` for the different values, and any difference can be reversed
+/// with `apply_delta_code()`.
+/// @param value Value to encode.
+/// @param baseline Baseline to get the difference from.
+/// @return Zigzag encoded difference.
+template <std::integral Int>
+constexpr auto delta_code(Int value, Int baseline) -> std::make_unsigned_t<Int>
+{
+    using UInt = std::make_unsigned_t<Int>;
+
+    const auto diff = static_cast<UInt>(static_cast<UInt>(value) - static_cast<UInt>(baseline));
+    return zigzag_encode(static_cast<std::make_signed_t<Int>>(diff));
+}
+
+/// @brief Reverses `delta_code()`.
+/// @param code Zigzag encoded difference.
+/// @param baseline Baseline the difference is from.
+/// @return Original value.
+template <std::integral Int>
+constexpr auto apply_delta_code(std::make_unsigned_t<Int> code, Int baseline) -> Int
+{
+    using UInt = std::make_unsigned_t<Int>;
+
+    return static_cast<Int>(static_cast<UInt>(static_cast<UInt>(zigzag_decode(code)) + static_cast<UInt>(baseline)));
+}
+
+/// @brief Gets the number of bits @p value takes when it's delta encoded against @p baseline.
+///
+/// It's 1 bit if @p value equals @p baseline. \n
+/// Otherwise, it's 2 bits plus the shorter one of the Exp-Golomb code of order 0 for `delta_code() - 1`,
+/// and @p value itself in the `[min, max]` range.
+/// @param value Value to measure.
+/// @param baseline Baseline to get the difference from.
+/// @param min Minimum value allowed for @p value.
+/// @param max Maximum value allowed for @p value.
+/// @return Number of bits.
+template <std::integral Int>
+constexpr auto delta_bits(Int value, Int baseline, Int min, Int max) -> int
+{
+    using UInt = std::make_unsigned_t<Int>;
+
+    if (value == baseline)
+        return 1;
+
+    const auto range = static_cast<UInt>(static_cast<UInt>(max) - static_cast<UInt>(min));
+    const int full_bits = static_cast<int>(std::bit_width(range));
+    const int delta_code_bits = exp_golomb_bits(delta_code(value, baseline) - 1u, 0);
+
+    return 2 + std::min(full_bits, delta_code_bits);
+}
+
+} // namespace nalchi
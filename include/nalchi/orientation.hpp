@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace nalchi
+{
+
+/// @brief Minimum bits per component for the smallest-three quaternion encoding.
+inline constexpr int SMALLEST_THREE_MIN_BITS_PER_COMPONENT = 2;
+
+/// @brief Maximum bits per component for the smallest-three quaternion encoding,
+/// so that the whole code fits in 64 bits.
+inline constexpr int SMALLEST_THREE_MAX_BITS_PER_COMPONENT = 20;
+
+/// @brief Minimum bits per axis for the octahedral unit vector encoding.
+inline constexpr int OCTAHEDRAL_MIN_BITS_PER_AXIS = 2;
+
+/// @brief Maximum bits per axis for the octahedral unit vector encoding, so that the whole code fits in 64 bits.
+inline constexpr int OCTAHEDRAL_MAX_BITS_PER_AXIS = 32;
+
+/// @brief Gets the number of bits a smallest-three quaternion code takes.
+/// @param bits_per_component Bits per each of the smallest three components.
+/// @return Number of bits, which is 2 bits for the index of the largest component, and the smallest three components.
+constexpr auto smallest_three_bits(int bits_per_component) -> int
+{
+    return 2 + 3 * bits_per_component;
+}
+
+/// @brief Gets the number of bits an octahedral unit vector code takes.
+/// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
+/// @return Number of bits.
+constexpr auto octahedral_bits(int bits_per_axis) -> int
+{
+    return 2 * bits_per_axis;
+}
+
+namespace detail
+{
+
+/// @brief Quantizes @p value in `[-1, 1]` to `[0, 2^bits - 1]`.
+inline auto quantize_signed_unit(double value, int bits) -> std::uint64_t
+{
+    const auto q_max = static_cast<double>((std::uint64_t(1) << bits) - 1);
+    return static_cast<std::uint64_t>(std::round((std::clamp(value, -1.0, 1.0) + 1) * 0.5 * q_max));
+}
+
+/// @brief Reverses `quantize_signed_unit()`.
+inline auto dequantize_signed_unit(std::uint64_t q, int bits) -> double
+{
+    const auto q_max = static_cast<double>((std::uint64_t(1) << bits) - 1);
+    return static_cast<double>(q) / q_max * 2 - 1;
+}
+
+/// @brief Gets `1` for non-negative values, and `-1` for negative values.
+inline auto sign_not_zero(double value) -> double
+{
+    return (value >= 0) ? 1.0 : -1.0;
+}
+
+} // namespace detail
+
+/// @brief Checks if @p quat can be encoded, which is finite and not zero.
+/// @param quat Quaternion to check, in `x, y, z, w` order.
+/// @return Whether it can be encoded.
+inline bool is_encodable_quaternion(const std::array<float, 4>& quat)
+{
+    const double norm_sq = static_cast<double>(quat[0]) * quat[0] + static_cast<double>(quat[1]) * quat[1] +
+                           static_cast<double>(quat[2]) * quat[2] + static_cast<double>(quat[3]) * quat[3];
+    return std::isfinite(norm_sq) && norm_sq > 0;
+}
+
+/// @brief Encodes a rotation quaternion with the smallest-three encoding.
+///
+/// As `q` and `-q` represent the same rotation, the largest component is made positive and dropped,
+/// and the other three components, which are in `[-1/sqrt(2), 1/sqrt(2)]`, are quantized. \n
+/// The code is `index | c0 << 2 | c1 << (2 + bits) | c2 << (2 + 2 * bits)`.
+/// @param quat Quaternion to encode, which must be encodable. It doesn't have to be normalized.
+/// @param bits_per_component Bits per each of the smallest three components.
+/// @return Encoded code.
+inline auto encode_smallest_three(const std::array<float, 4>& quat, int bits_per_component) -> std::uint64_t
+{
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+        if (std::abs(quat[i]) > std::abs(quat[largest]))
+            largest = i;
+
+    // Normalize, and flip the sign to make the largest component positive.
+    const double norm = std::sqrt(static_cast<double>(quat[0]) * quat[0] + static_cast<double>(quat[1]) * quat[1] +
+                                  static_cast<double>(quat[2]) * quat[2] + static_cast<double>(quat[3]) * quat[3]);
+    const double scale = detail::sign_not_zero(quat[largest]) * std::sqrt(2.0) / norm;
+
+    std::uint64_t code = static_cast<std::uint64_t>(largest);
+    int shift = 2;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+
+        code |= detail::quantize_signed_unit(quat[i] * scale, bits_per_component) << shift;
+        shift += bits_per_component;
+    }
+
+    return code;
+}
+
+/// @brief Decodes a smallest-three quaternion code.
+/// @param code Code to decode.
+/// @param bits_per_component Bits per each of the smallest three components.
+/// @return Decoded unit quaternion, in `x, y, z, w` order.
+inline auto decode_smallest_three(std::uint64_t code, int bits_per_component) -> std::array<float, 4>
+{
+    const int largest = static_cast<int>(code & 3);
+    const std::uint64_t mask = (std::uint64_t(1) << bits_per_component) - 1;
+
+    std::array<double, 4> components{};
+    double sum_sq = 0;
+    int shift = 2;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+
+        components[i] = detail::dequantize_signed_unit((code >> shift) & mask, bits_per_component) / std::sqrt(2.0);
+        sum_sq += components[i] * components[i];
+        shift += bits_per_component;
+    }
+
+    // Restore the largest component, and renormalize in case the others are too large from a malformed code.
+    components[largest] = std::sqrt(std::max(0.0, 1 - sum_sq));
+    const double inv_norm = 1 / std::sqrt(sum_sq + components[largest] * components[largest]);
+
+    std::array<float, 4> quat;
+    for (int i = 0; i < 4; ++i)
+        quat[i] = static_cast<float>(components[i] * inv_norm);
+
+    return quat;
+}
+
+/// @brief Checks if @p vec can be encoded, which is finite and not zero.
+/// @param vec Vector to check.
+/// @return Whether it can be encoded.
+inline bool is_encodable_unit_vector(const std::array<float, 3>& vec)
+{
+    const double l1_norm = std::abs(static_cast<double>(vec[0])) + std::abs(static_cast<double>(vec[1])) +
+                           std::abs(static_cast<double>(vec[2]));
+    return std::isfinite(l1_norm) && l1_norm > 0;
+}
+
+/// @brief Encodes a direction with the octahedral encoding.
+///
+/// The unit sphere is projected onto the octahedron `|x| + |y| + |z| = 1`, whose lower half is folded outward,
+/// so that it becomes the square `[-1, 1]^2`. \n
+/// The code is `x | y << bits` of the quantized square coordinates.
+/// @param vec Vector to encode, which must be encodable. It doesn't have to be normalized.
+/// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
+/// @return Encoded code.
+inline auto encode_octahedral(const std::array<float, 3>& vec, int bits_per_axis) -> std::uint64_t
+{
+    const double l1_norm = std::abs(static_cast<double>(vec[0])) + std::abs(static_cast<double>(vec[1])) +
+                           std::abs(static_cast<double>(vec[2]));
+
+    double x = vec[0] / l1_norm;
+    double y = vec[1] / l1_norm;
+
+    // Fold the lower half outward.
+    if (vec[2] < 0)
+    {
+        const double folded_x = (1 - std::abs(y)) * detail::sign_not_zero(x);
+        const double folded_y = (1 - std::abs(x)) * detail::sign_not_zero(y);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    return detail::quantize_signed_unit(x, bits_per_axis) |
+           (detail::quantize_signed_unit(y, bits_per_axis) << bits_per_axis);
+}
+
+/// @brief Decodes an octahedral unit vector code.
+/// @param code Code to decode.
+/// @param bits_per_axis Bits per each of the 2 axes on the octahedron.
+/// @return Decoded unit vector.
+inline auto decode_octahedral(std::uint64_t code, int bits_per_axis) -> std::array<float, 3>
+{
+    const std::uint64_t mask = (bits_per_axis >= 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << bits_per_axis) - 1;
+
+    double x = detail::dequantize_signed_unit(code & mask, bits_per_axis);
+    double y = detail::dequantize_signed_unit((code >> bits_per_axis) & mask, bits_per_axis);
+    const double z = 1 - std::abs(x) - std::abs(y);
+
+    // Unfold the lower half.
+    if (z < 0)
+    {
+        const double unfolded_x = (1 - std::abs(y)) * detail::sign_not_zero(x);
+        const double unfolded_y = (1 - std::abs(x)) * detail::sign_not_zero(y);
+        x = unfolded_x;
+        y = unfolded_y;
+    }
+
+    const double inv_norm = 1 / std::sqrt(x * x + y * y + z * z);
+
+    return {static_cast<float>(x * inv_norm), static_cast<float>(y * inv_norm), static_cast<float>(z * inv_norm)};
+}
+
+} // namespace nalchi
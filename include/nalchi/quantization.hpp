@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace nalchi
+{
+
+/// @brief Gets the maximum quantized value of the bounded range `[min, max]` with the step of @p resolution.
+///
+/// The range is invalid if any of them is not finite, `min >= max`, `resolution <= 0`,
+/// or the maximum quantized value doesn't fit in `std::uint32_t`.
+/// @param min Minimum value of the range.
+/// @param max Maximum value of the range.
+/// @param resolution Step between the quantized values.
+/// @return Maximum quantized value, or a negative value if the range is invalid.
+constexpr auto quantized_max(float min, float max, float resolution) -> std::int64_t
+{
+    // `std::isfinite()` and `std::ceil()` are not `constexpr` on every compiler yet, so do them by hand.
+    // `x - x` is `0` only if `x` is finite, as it's NaN for infinity and NaN.
+    if (!(min - min == 0) || !(max - max == 0) || !(resolution - resolution == 0) || !(min < max) ||
+        !(resolution > 0))
+        return -1;
+
+    const double steps = (static_cast<double>(max) - static_cast<double>(min)) / resolution;
+    if (!(steps <= static_cast<double>(std::numeric_limits<std::uint32_t>::max())))
+        return -1;
+
+    // Round up, which can't exceed the limit above, as it's an integer.
+    const auto truncated = static_cast<std::int64_t>(steps);
+    return (static_cast<double>(truncated) < steps) ? truncated + 1 : truncated;
+}
+
+/// @brief Gets the number of bits a quantized value of the bounded range takes.
+/// @param min Minimum value of the range.
+/// @param max Maximum value of the range.
+/// @param resolution Step between the quantized values.
+/// @return Number of bits, or a negative value if the range is invalid.
+constexpr auto quantized_bits(float min, float max, float resolution) -> int
+{
+    const std::int64_t q_max = quantized_max(min, max, resolution);
+    if (q_max < 0)
+        return -1;
+
+    return static_cast<int>(std::bit_width(static_cast<std::uint64_t>(q_max)));
+}
+
+/// @brief Quantizes @p value to the nearest step of the bounded range.
+/// @param value Value to quantize, which must be in `[min, max]`.
+/// @param min Minimum value of the range.
+/// @param resolution Step between the quantized values.
+/// @param q_max Maximum quantized value from `quantized_max()`.
+/// @return Quantized value.
+inline auto quantize(float value, float min, float resolution, std::uint32_t q_max) -> std::uint32_t
+{
+    const double q = std::round((static_cast<double>(value) - static_cast<double>(min)) / resolution);
+    return static_cast<std::uint32_t>(std::min(q, static_cast<double>(q_max)));
+}
+
+/// @brief Reverses `quantize()`.
+///
+/// The result differs from the original value at most by the half of @p resolution.
+/// @param q Quantized value.
+/// @param min Minimum value of the range.
+/// @param max Maximum value of the range.
+/// @param resolution Step between the quantized values.
+/// @return Dequantized value, which is in `[min, max]`.
+inline auto dequantize(std::uint32_t q, float min, float max, float resolution) -> float
+{
+    const double value = static_cast<double>(min) + static_cast<double>(q) * resolution;
+    return std::min(static_cast<float>(value), max);
+}
+
+/// @brief Converts a float to the bits of the IEEE 754 half-precision float, rounding to the nearest even.
+///
+/// Values too large for the half float become infinity, and NaN stays NaN.
+/// @param value Float to convert.
+/// @return Bits of the half float.
+constexpr auto float_to_half(float value) -> std::uint16_t
+{
+    const auto bits = std::bit_cast<std::uint32_t>(value);
+    const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+    const std::uint32_t abs = bits & 0x7FFF'FFFF;
+
+    // Infinity or NaN, keeping NaN quiet.
+    if (abs >= 0x7F80'0000)
+        return static_cast<std::uint16_t>(sign | 0x7C00 | (abs > 0x7F80'0000 ? 0x200 | ((abs >> 13) & 0x3FF) : 0));
+
+    // Overflows to infinity, as it's `65520` or greater.
+    if (abs >= 0x477F'F000)
+        return static_cast<std::uint16_t>(sign | 0x7C00);
+
+    // Underflows to zero, as it's `2^-25` or smaller.
+    if (abs <= 0x3300'0000)
+        return sign;
+
+    std::uint32_t half;
+    std::uint32_t remainder;
+    std::uint32_t halfway;
+
+    if (abs < 0x3880'0000)
+    {
+        // Subnormal half float, which is the mantissa with the implicit bit shifted to `2^-24` units.
+        const int shift = 126 - static_cast<int>(abs >> 23);
+        const std::uint32_t mantissa = (abs & 0x7F'FFFF) | 0x80'0000;
+
+        half = mantissa >> shift;
+        remainder = mantissa & ((std::uint32_t(1) << shift) - 1);
+        halfway = std::uint32_t(1) << (shift - 1);
+    }
+    else
+    {
+        // Normal half float, which only needs the exponent rebiased and the mantissa truncated.
+        half = (abs - 0x3800'0000) >> 13;
+        remainder = abs & 0x1FFF;
+        halfway = 0x1000;
+    }
+
+    // Round to the nearest even, which might carry to the exponent correctly.
+    if (remainder > halfway || (remainder == halfway && (half & 1) != 0))
+        ++half;
+
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+/// @brief Converts the bits of the IEEE 754 half-precision float to a float, which is always exact.
+/// @param half Bits of the half float.
+/// @return Converted float.
+constexpr auto half_to_float(std::uint16_t half) -> float
+{
+    const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000) << 16;
+    const std::uint32_t exponent = (half >> 10) & 0x1F;
+    const std::uint32_t mantissa = half & 0x3FF;
+
+    // Infinity or NaN.
+    if (exponent == 0x1F)
+        return std::bit_cast<float>(sign | 0x7F80'0000 | (mantissa << 13));
+
+    // Zero or subnormal, which is `mantissa * 2^-24`.
+    if (exponent == 0)
+    {
+        const float abs = static_cast<float>(mantissa) * 0x1p-24f;
+        return sign ? -abs : abs;
+    }
+
+    // Normal, which only needs the exponent rebiased.
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+} // namespace nalchi
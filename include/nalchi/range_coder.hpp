@@ -0,0 +1,321 @@
+#pragma once
+
+#include "nalchi/bit_stream.hpp"
+#include "nalchi/export.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace nalchi
+{
+
+/// @brief Adaptive probability model for a binary decision, coded with `range_coder_writer::write_bit()`.
+///
+/// It starts with the probability of `1/2`, and moves toward the observed bits by `1/32` of the difference. \n
+/// The writer and the reader must start from the same model state, and code the same sequence of bits with it.
+struct adaptive_bit_model final
+{
+    /// @brief Number of bits of the fixed-point probability.
+    static constexpr int PROBABILITY_BITS = 11;
+
+    /// @brief Adaptation rate, which moves the probability by `1 / 2^ADAPTATION_SHIFT` of the difference.
+    static constexpr int ADAPTATION_SHIFT = 5;
+
+    /// @brief Fixed-point probability of the bit being `0`.
+    std::uint16_t probability_of_zero = 1 << (PROBABILITY_BITS - 1);
+};
+
+/// @brief Maximum number of symbols `adaptive_symbol_model` can have.
+inline constexpr std::size_t ADAPTIVE_SYMBOL_MODEL_MAX_SYMBOLS = 1024;
+
+/// @brief Adaptive frequency model for a symbol in `[0, Symbols)`, coded with `range_coder_writer::write_symbol()`.
+///
+/// Every symbol starts with the same frequency, and each coded symbol increases its own frequency. \n
+/// When the total frequency exceeds `MAX_TOTAL`, every frequency is halved, so that it keeps adapting. \n
+/// The writer and the reader must start from the same model state, and code the same sequence of symbols with it.
+/// @tparam Symbols Number of symbols.
+template <std::size_t Symbols>
+class adaptive_symbol_model final
+{
+    static_assert(Symbols >= 2 && Symbols <= ADAPTIVE_SYMBOL_MODEL_MAX_SYMBOLS, "Invalid number of symbols");
+
+public:
+    /// @brief Maximum total frequency, which keeps the range coder precise enough.
+    static constexpr std::uint32_t MAX_TOTAL = std::uint32_t(1) << 16;
+
+    /// @brief Frequency added to the coded symbol.
+    static constexpr std::uint16_t INCREMENT = 32;
+
+public:
+    /// @brief Constructs a model where every symbol has the same probability.
+    adaptive_symbol_model()
+    {
+        _frequencies.fill(1);
+    }
+
+    /// @brief Gets the number of symbols.
+    static constexpr auto symbols() -> std::size_t
+    {
+        return Symbols;
+    }
+
+    /// @brief Gets the total frequency of every symbol.
+    auto total() const -> std::uint32_t
+    {
+        return _total;
+    }
+
+    /// @brief Gets the frequency of @p symbol.
+    auto frequency(std::size_t symbol) const -> std::uint32_t
+    {
+        return _frequencies[symbol];
+    }
+
+    /// @brief Gets the total frequency of the symbols below @p symbol.
+    auto cumulative(std::size_t symbol) const -> std::uint32_t
+    {
+        std::uint32_t result = 0;
+        for (std::size_t i = 0; i < symbol; ++i)
+            result += _frequencies[i];
+
+        return result;
+    }
+
+    /// @brief Finds the symbol whose cumulative frequency range contains @p target.
+    /// @param target Target frequency, which must be less than `total()`.
+    /// @param cumulative Total frequency of the symbols below the found symbol.
+    /// @return Found symbol.
+    auto find(std::uint32_t target, std::uint32_t& cumulative) const -> std::size_t
+    {
+        std::uint32_t sum = 0;
+        std::size_t symbol = 0;
+        while (symbol + 1 < Symbols && sum + _frequencies[symbol] <= target)
+            sum += _frequencies[symbol++];
+
+        cumulative = sum;
+        return symbol;
+    }
+
+    /// @brief Increases the frequency of @p symbol, which has just been coded.
+    void update(std::size_t symbol)
+    {
+        // Halve every frequency before the increment would exceed `MAX_TOTAL`, keeping them non-zero.
+        // So the total never exceeds `MAX_TOTAL`, and each frequency stays below it to fit in `std::uint16_t`.
+        if (_total + INCREMENT > MAX_TOTAL)
+        {
+            _total = 0;
+            for (auto& freq : _frequencies)
+            {
+                freq = static_cast<std::uint16_t>((freq + 1) / 2);
+                _total += freq;
+            }
+        }
+
+        _frequencies[symbol] += INCREMENT;
+        _total += INCREMENT;
+    }
+
+private:
+    std::array<std::uint16_t, Symbols> _frequencies;
+    std::uint32_t _total = static_cast<std::uint32_t>(Symbols);
+};
+
+/// @brief Adaptive range coder that entropy-codes a section of a bit stream.
+///
+/// It codes binary decisions and symbols with adaptive models, which take fewer bits than `write()`
+/// for skewed distributions. \n
+/// The coded bytes are written to @p Stream with `write(std::uint8_t)`,
+/// so they go to the same buffer as the other fields. \n
+/// Use `bit_stream_measurer` as @p Stream to measure the exact size of the coded section.
+///
+/// @note As the coder keeps a few pending bytes, you @b must not write to @p Stream while coding. \n
+/// After coding everything in the section, call `flush()`, and then continue writing to @p Stream. \n
+/// The reading side reads the section with `range_coder_reader` at the same position.
+/// @tparam Stream Bit stream writer or measurer to write the coded bytes to.
+template <typename Stream>
+class range_coder_writer final
+{
+public:
+    using stream_type = Stream; ///< Bit stream type to write the coded bytes to.
+
+public:
+    /// @brief Starts a range coded section at the current position of @p stream.
+    /// @param stream Bit stream to write the coded bytes to, which must outlive this coder.
+    explicit range_coder_writer(Stream& stream);
+
+    range_coder_writer(const range_coder_writer&) = delete;
+    auto operator=(const range_coder_writer&) -> range_coder_writer& = delete;
+
+public:
+    /// @brief Writes a binary decision with an adaptive model.
+    /// @param model Model of the bit, which is updated with @p bit.
+    /// @param bit Bit to write.
+    /// @return The coder itself.
+    auto write_bit(adaptive_bit_model& model, bool bit) -> range_coder_writer&;
+
+    /// @brief Writes a symbol with an adaptive model.
+    ///
+    /// If @p symbol is out of `[0, Symbols)`, this function will set the fail flag and write nothing.
+    /// @tparam Symbols Number of symbols of @p model.
+    /// @param model Model of the symbol, which is updated with @p symbol.
+    /// @param symbol Symbol to write.
+    /// @return The coder itself.
+    template <std::size_t Symbols>
+    auto write_symbol(adaptive_symbol_model<Symbols>& model, std::size_t symbol) -> range_coder_writer&
+    {
+        if (symbol >= Symbols)
+        {
+            _fail = true;
+            return *this;
+        }
+
+        encode(model.cumulative(symbol), model.frequency(symbol), model.total());
+        model.update(symbol);
+
+        return *this;
+    }
+
+    /// @brief Writes raw bits with equal probabilities, which takes @p bits bits.
+    ///
+    /// Use this for the fields in the section that aren't worth modeling. \n
+    /// If @p bits is out of `[1, 32]`, this function will set the fail flag and write nothing.
+    /// @param value Value to write, which must not have bits set above @p bits.
+    /// @param bits Number of bits to write.
+    /// @return The coder itself.
+    auto write_raw_bits(std::uint32_t value, int bits) -> range_coder_writer&;
+
+    /// @brief Writes the pending bytes to the stream, and ends the range coded section.
+    ///
+    /// After this, you can't write to the coder anymore, but you can continue writing to the stream.
+    /// @return Whether the coder and the stream haven't failed.
+    bool flush();
+
+    /// @brief Checks if writing to the coder or the stream has failed.
+    bool fail() const;
+
+    /// @brief Checks if the coder and the stream haven't failed.
+    explicit operator bool() const
+    {
+        return !fail();
+    }
+
+private:
+    void encode(std::uint32_t cumulative, std::uint32_t frequency, std::uint32_t total);
+    void normalize();
+    void shift_low();
+    void write_byte(std::uint8_t byte);
+
+private:
+    Stream& _stream;
+
+    std::uint64_t _low = 0;
+    std::uint32_t _range = 0xFFFF'FFFF;
+
+    // The top byte of `_low` might be changed by a carry, which also propagates to the previous `0xFF` bytes.
+    // So, the last byte and the number of bytes pending with it are kept until they can't be changed.
+    std::uint8_t _cache = 0;
+    std::uint64_t _cache_size = 1;
+
+    // The first pending byte is always `0`, which isn't written.
+    bool _leading_byte = true;
+
+    bool _flushed = false;
+    bool _fail = false;
+};
+
+/// @brief Reads a range coded section written by `range_coder_writer`.
+///
+/// It reads exactly the bytes written by `range_coder_writer`, so after decoding everything in the section,
+/// you can continue reading the other fields from @p Stream. \n
+/// You @b must not read from @p Stream while decoding.
+/// @tparam Stream Bit stream reader to read the coded bytes from.
+template <typename Stream>
+class range_coder_reader final
+{
+public:
+    using stream_type = Stream; ///< Bit stream type to read the coded bytes from.
+
+public:
+    /// @brief Starts reading a range coded section at the current position of @p stream.
+    /// @param stream Bit stream to read the coded bytes from, which must outlive this coder.
+    explicit range_coder_reader(Stream& stream);
+
+    range_coder_reader(const range_coder_reader&) = delete;
+    auto operator=(const range_coder_reader&) -> range_coder_reader& = delete;
+
+public:
+    /// @brief Reads a binary decision with an adaptive model.
+    /// @param model Model of the bit, which must be in the same state as the writer's, and is updated with @p bit.
+    /// @param bit Bit to read to.
+    /// @return The coder itself.
+    auto read_bit(adaptive_bit_model& model, bool& bit) -> range_coder_reader&;
+
+    /// @brief Reads a symbol with an adaptive model.
+    /// @tparam Symbols Number of symbols of @p model.
+    /// @param model Model of the symbol, which must be in the same state as the writer's,
+    /// and is updated with @p symbol.
+    /// @param symbol Symbol to read to.
+    /// @return The coder itself.
+    template <std::size_t Symbols>
+    auto read_symbol(adaptive_symbol_model<Symbols>& model, std::size_t& symbol) -> range_coder_reader&
+    {
+        std::uint32_t cumulative;
+        const std::size_t decoded = model.find(decode_target(model.total()), cumulative);
+
+        decode(cumulative, model.frequency(decoded), model.total());
+        model.update(decoded);
+        symbol = decoded;
+
+        return *this;
+    }
+
+    /// @brief Reads raw bits written by `range_coder_writer::write_raw_bits()`.
+    ///
+    /// If @p bits is out of `[1, 32]`, this function will set the fail flag and read nothing.
+    /// @param value Value to read to.
+    /// @param bits Number of bits to read.
+    /// @return The coder itself.
+    auto read_raw_bits(std::uint32_t& value, int bits) -> range_coder_reader&;
+
+    /// @brief Checks if reading from the coder or the stream has failed.
+    ///
+    /// Note that a corrupted section can't always be detected, as any bytes can be decoded to some values.
+    bool fail() const;
+
+    /// @brief Checks if the coder and the stream haven't failed.
+    explicit operator bool() const
+    {
+        return !fail();
+    }
+
+private:
+    auto decode_target(std::uint32_t total) -> std::uint32_t;
+    void decode(std::uint32_t cumulative, std::uint32_t frequency, std::uint32_t total);
+    void normalize();
+    auto next_byte() -> std::uint8_t;
+
+private:
+    Stream& _stream;
+
+    std::uint32_t _range = 0xFFFF'FFFF;
+    std::uint32_t _code = 0;
+
+    // `_range / total` of the symbol being decoded, shared by `decode_target()` and `decode()`.
+    std::uint32_t _scale = 0;
+
+    bool _fail = false;
+};
+
+extern template class NALCHI_EXTERN_TEMPLATE_API range_coder_writer<bit_stream_writer>;
+extern template class NALCHI_EXTERN_TEMPLATE_API range_coder_writer<bit_stream_measurer>;
+extern template class NALCHI_EXTERN_TEMPLATE_API range_coder_reader<bit_stream_reader>;
+extern template class NALCHI_EXTERN_TEMPLATE_API range_coder_writer<basic_bit_stream_writer<>>;
+extern template class NALCHI_EXTERN_TEMPLATE_API range_coder_reader<basic_bit_stream_reader<>>;
+
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+extern template class NALCHI_EXTERN_TEMPLATE_API range_coder_writer<wide_bit_stream_writer>;
+extern template class NALCHI_EXTERN_TEMPLATE_API range_coder_reader<wide_bit_stream_reader>;
+#endif
+
+} // namespace nalchi
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "nalchi/bit_stream.hpp"
+#include "nalchi/character.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+
+namespace nalchi
+{
+
+/// @brief Stream that can be passed to `serialize()`.
+///
+/// `bit_stream_writer`, `bit_stream_reader` and `bit_stream_measurer` (and the wide variants) satisfy this. \n
+/// Exactly one of `Stream::is_writing`, `Stream::is_reading` and `Stream::is_measuring` is `true`,
+/// and `fail()` tells whether the stream has failed, which is always `false` for the measurer.
+///
+/// Its design is based on the article by Glenn Fiedler, see:
+/// * https://gafferongames.com/post/serialization_strategies/
+///
+/// Write a single `serialize()` function template for your message, instead of three functions that might drift apart:
+/// @code
+/// struct player_state
+/// {
+///     std::uint32_t id;
+///     int hp;
+///     std::string name;
+/// };
+///
+/// template <nalchi::serialize_stream Stream>
+/// auto serialize(Stream& stream, player_state& state) -> Stream&
+/// {
+///     serialize(stream, state.id);
+///     serialize(stream, state.hp, 0, 100);
+///     return serialize(stream, state.name, 16);
+/// }
+/// @endcode
+/// It's instantiated for each stream, and the branches on the tags are resolved at compile time. \n
+/// Then, get the exact size with `serialized_bytes()` before allocating a `shared_payload`.
+/// @tparam Stream Stream type.
+template <typename Stream>
+concept serialize_stream = requires(const Stream& stream) {
+    { Stream::is_writing } -> std::convertible_to<bool>;
+    { Stream::is_reading } -> std::convertible_to<bool>;
+    { Stream::is_measuring } -> std::convertible_to<bool>;
+    { stream.fail() } -> std::same_as<bool>;
+} && (int(Stream::is_writing) + int(Stream::is_reading) + int(Stream::is_measuring) == 1);
+
+/// @brief Serializes a user type that has a `serialize()` member function template.
+///
+/// This lets you write `template <nalchi::serialize_stream Stream> void serialize(Stream& stream)` as a member,
+/// instead of a free function found by the argument-dependent lookup.
+/// @tparam Stream Stream type.
+/// @tparam T User type.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream, typename T>
+    requires requires(Stream& stream, T& value) { value.serialize(stream); }
+constexpr auto serialize(Stream& stream, T& value) -> Stream&
+{
+    value.serialize(stream);
+    return stream;
+}
+
+/// @brief Serializes an integral value.
+/// @tparam Stream Stream type.
+/// @tparam Int Integer type of @p value.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @param min Minimum value allowed for @p value.
+/// @param max Maximum value allowed for @p value.
+/// @return The stream itself.
+template <serialize_stream Stream, std::integral Int>
+constexpr auto serialize(Stream& stream, Int& value, std::type_identity_t<Int> min = std::numeric_limits<Int>::min(),
+                         std::type_identity_t<Int> max = std::numeric_limits<Int>::max()) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read(value, min, max);
+    else
+        return stream.write(value, min, max);
+}
+
+/// @brief Serializes an integral value with a compile-time range.
+/// @tparam Min Minimum value allowed for @p value.
+/// @tparam Max Maximum value allowed for @p value.
+/// @tparam Stream Stream type.
+/// @tparam Int Integer type of @p value.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @return The stream itself.
+template <std::integral auto Min, std::integral auto Max, serialize_stream Stream, ranged_integral Int>
+constexpr auto serialize(Stream& stream, Int& value) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.template read<Min, Max>(value);
+    else
+        return stream.template write<Min, Max>(value);
+}
+
+/// @brief Serializes a float value.
+/// @tparam Stream Stream type.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream>
+constexpr auto serialize(Stream& stream, float& value) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read(value);
+    else
+        return stream.write(value);
+}
+
+/// @brief Serializes a double value.
+/// @tparam Stream Stream type.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream>
+constexpr auto serialize(Stream& stream, double& value) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read(value);
+    else
+        return stream.write(value);
+}
+
+/// @brief Serializes a string.
+///
+/// If the writing side's @p str is longer than @p max_length, the writer will set the fail flag and write nothing,
+/// as the reading side would fail anyway.
+/// @tparam Stream Stream type.
+/// @tparam CharT Underlying character type of `std::basic_string`.
+/// @tparam CharTraits Char traits for `CharT`.
+/// @tparam Allocator Underlying allocator for `std::basic_string`.
+/// @param stream Stream to serialize with.
+/// @param str String to write from, or read to.
+/// @param max_length Maximum number of `CharT` that can be read.
+/// @return The stream itself.
+template <serialize_stream Stream, character CharT, typename CharTraits, typename Allocator>
+constexpr auto serialize(Stream& stream, std::basic_string<CharT, CharTraits, Allocator>& str,
+                         typename Stream::size_type max_length) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read(str, max_length);
+    else
+    {
+        if constexpr (Stream::is_writing)
+        {
+            if (str.length() > max_length)
+            {
+                stream.set_fail();
+                return stream;
+            }
+        }
+
+        return stream.write(str);
+    }
+}
+
+/// @brief Serializes a fixed size array, element by element.
+///
+/// Integral elements are serialized in bulk with `write_array()`, which results in the same bits.
+/// @tparam Stream Stream type.
+/// @tparam T Element type.
+/// @tparam N Number of elements.
+/// @param stream Stream to serialize with.
+/// @param values Array to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream, typename T, std::size_t N>
+constexpr auto serialize(Stream& stream, std::array<T, N>& values) -> Stream&
+{
+    if constexpr (ranged_integral<T>)
+    {
+        if constexpr (Stream::is_reading)
+            return stream.read_array(std::span<T>(values));
+        else
+            return stream.write_array(std::span<const T>(values));
+    }
+    else
+    {
+        for (T& value : values)
+            serialize(stream, value);
+
+        return stream;
+    }
+}
+
+/// @brief Serializes some arbitrary data.
+/// @tparam Stream Stream type.
+/// @param stream Stream to serialize with.
+/// @param data Pointer to the arbitrary data to write from, or read to.
+/// @param size Size in bytes of the data.
+/// @return The stream itself.
+template <serialize_stream Stream>
+constexpr auto serialize_bytes(Stream& stream, void* data, typename Stream::size_type size) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read(data, size);
+    else
+        return stream.write(data, size);
+}
+
+/// @brief Serializes a float value quantized to the bounded range `[min, max]` with the step of @p resolution.
+/// @tparam Stream Stream type.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @param min Minimum value of the range.
+/// @param max Maximum value of the range.
+/// @param resolution Step between the quantized values.
+/// @return The stream itself.
+template <serialize_stream Stream>
+constexpr auto serialize_quantized(Stream& stream, float& value, float min, float max, float resolution) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read_quantized(value, min, max, resolution);
+    else
+        return stream.write_quantized(value, min, max, resolution);
+}
+
+/// @brief Serializes a float value as a half-precision float.
+/// @tparam Stream Stream type.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream>
+constexpr auto serialize_half(Stream& stream, float& value) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read_half(value);
+    else
+        return stream.write_half(value);
+}
+
+/// @brief Serializes an integral value as a varint.
+/// @tparam Stream Stream type.
+/// @tparam Int Integer type of @p value.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @return The stream itself.
+template <serialize_stream Stream, ranged_integral Int>
+constexpr auto serialize_varint(Stream& stream, Int& value) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read_varint(value);
+    else
+        return stream.write_varint(value);
+}
+
+/// @brief Serializes an integral value as an Exp-Golomb code of order @p k.
+/// @tparam Stream Stream type.
+/// @tparam Int Integer type of @p value.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @param k Order of the Exp-Golomb code.
+/// @return The stream itself.
+template <serialize_stream Stream, ranged_integral Int>
+constexpr auto serialize_exp_golomb(Stream& stream, Int& value, int k = 0) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read_exp_golomb(value, k);
+    else
+        return stream.write_exp_golomb(value, k);
+}
+
+/// @brief Serializes an integral value, delta encoded against @p baseline.
+/// @tparam Stream Stream type.
+/// @tparam Int Integer type of @p value.
+/// @param stream Stream to serialize with.
+/// @param value Value to write from, or read to.
+/// @param baseline Baseline to get the difference from, which both sides must know.
+/// @param min Minimum value allowed for @p value and @p baseline.
+/// @param max Maximum value allowed for @p value and @p baseline.
+/// @return The stream itself.
+template <serialize_stream Stream, ranged_integral Int>
+constexpr auto serialize_delta(Stream& stream, Int& value, std::type_identity_t<Int> baseline,
+                               std::type_identity_t<Int> min = std::numeric_limits<Int>::min(),
+                               std::type_identity_t<Int> max = std::numeric_limits<Int>::max()) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read_delta(value, baseline, min, max);
+    else
+        return stream.write_delta(value, baseline, min, max);
+}
+
+/// @brief Serializes a unit quaternion with the smallest three encoding.
+/// @tparam Stream Stream type.
+/// @param stream Stream to serialize with.
+/// @param quat Quaternion to write from, or read to.
+/// @param bits_per_component Number of bits per each of the three components.
+/// @return The stream itself.
+template <serialize_stream Stream>
+constexpr auto serialize_quaternion(Stream& stream, std::array<float, 4>& quat, int bits_per_component = 9) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read_quaternion(quat, bits_per_component);
+    else
+        return stream.write_quaternion(quat, bits_per_component);
+}
+
+/// @brief Serializes a unit vector with the octahedral encoding.
+/// @tparam Stream Stream type.
+/// @param stream Stream to serialize with.
+/// @param vec Unit vector to write from, or read to.
+/// @param bits_per_axis Number of bits per each of the two octahedral axes.
+/// @return The stream itself.
+template <serialize_stream Stream>
+constexpr auto serialize_unit_vector(Stream& stream, std::array<float, 3>& vec, int bits_per_axis = 12) -> Stream&
+{
+    if constexpr (Stream::is_reading)
+        return stream.read_unit_vector(vec, bits_per_axis);
+    else
+        return stream.write_unit_vector(vec, bits_per_axis);
+}
+
+/// @brief Gets the exact number of bits `serialize()` writes for @p value.
+/// @tparam T Type of @p value, which must be serializable with `serialize(stream, value)`.
+/// @param value Value to measure.
+/// @return Number of bits.
+template <typename T>
+constexpr auto serialized_bits(const T& value) -> bit_stream_measurer::size_type
+{
+    bit_stream_measurer measurer;
+
+    // Measuring never modifies `value`.
+    serialize(measurer, const_cast<T&>(value));
+    return measurer.used_bits();
+}
+
+/// @brief Gets the exact number of bytes `serialize()` writes for @p value.
+///
+/// Pass this to `shared_payload::allocate()`, so that the payload is neither too small nor wasteful.
+/// @tparam T Type of @p value, which must be serializable with `serialize(stream, value)`.
+/// @param value Value to measure.
+/// @return Number of bytes.
+template <typename T>
+constexpr auto serialized_bytes(const T& value) -> bit_stream_measurer::size_type
+{
+    bit_stream_measurer measurer;
+
+    // Measuring never modifies `value`.
+    serialize(measurer, const_cast<T&>(value));
+    return measurer.used_bytes();
+}
+
+} // namespace nalchi
@@ -3,6 +3,7 @@
 #include "nalchi/export.hpp"
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 
 struct SteamNetworkingMessage_t;
@@ -10,6 +11,43 @@ struct SteamNetworkingMessage_t;
 namespace nalchi
 {
 
+/// @brief Statistics of the shared payloads, see `shared_payload::stats()`.
+///
+/// Only the payloads allocated while the stats are enabled are counted. \n
+/// Counters are cumulative, so take the difference between 2 snapshots to get the rates (e.g. allocations per second).
+struct shared_payload_stats
+{
+    /// @brief Number of buckets in `size_histogram`.
+    static constexpr std::size_t SIZE_HISTOGRAM_BUCKETS = 20;
+
+    std::uint64_t allocations;        ///< Number of successful allocations.
+    std::uint64_t failed_allocations; ///< Number of allocations failed due to invalid size or out of memory.
+    std::uint64_t deallocations;      ///< Number of deallocations, including the ones after sent.
+
+    std::uint64_t live_payloads; ///< Number of payloads allocated but not yet deallocated.
+    std::uint64_t live_bytes;    ///< Sum of the requested sizes of the live payloads.
+
+    /// @brief Highest `live_bytes` observed, which is approximate.
+    ///
+    /// Each thread publishes its changes of live bytes only after they add up to 64 KiB, \n
+    /// so it might be off by up to 64 KiB per thread in either direction: \n
+    /// it can miss a short peak, or count one thread's allocations before another thread's deallocations.
+    std::uint64_t peak_live_bytes;
+
+    /// @brief Number of allocations by requested size,
+    /// where bucket `i` counts the sizes in `(2^(i-1), 2^i]`. (bucket 0 counts the size 1)
+    std::uint64_t size_histogram[SIZE_HISTOGRAM_BUCKETS];
+};
+
+/// @brief Pages backing the payload arena, see `shared_payload::init_arena()`.
+enum class shared_payload_arena_pages : std::int32_t
+{
+    none,             ///< No arena, so the payload pool allocates its slabs from the global heap.
+    normal,           ///< Normal pages.
+    transparent_huge, ///< Normal pages advised with `MADV_HUGEPAGE`, which the kernel backs with huge pages if it can.
+    huge,             ///< Huge pages reserved with `MAP_HUGETLB`.
+};
+
 /// @brief Shared payload to store data to send.
 ///
 /// The payload is "shared" when it is used for multicast.
@@ -24,12 +62,26 @@ struct shared_payload
     void* ptr; ///< Pointer to the payload, allocated by nalchi.
 
     /// @brief Allocates a shared payload that can be used to send some data.
+    ///
+    /// If nalchi is built with `NALCHI_PAYLOAD_POOL` (default), it's allocated from a size-class slab pool
+    /// with thread-local caches, instead of `std::malloc()`.
     /// @note You should check if `ptr` is `nullptr` or not
     /// to see if the allocation has been successful.
     /// @param size Space in bytes to allocate.
     /// @return Shared payload instance that might hold allocated buffer.
     NALCHI_API static shared_payload allocate(alloc_size_t size);
 
+    /// @brief Allocates a shared payload that bit stream writers with 64-bit words can write to.
+    ///
+    /// This is same as `allocate()`, except that the payload is ceiled to 8 bytes instead of 4 bytes, 
+
+    /// so that the last 64-bit word can be written without overrun.
+    /// @note You should check if `ptr` is `nullptr` or not
+    /// to see if the allocation has been successful.
+    /// @param size Space in bytes to allocate.
+    /// @return Shared payload instance that might hold allocated buffer.
+    NALCHI_API static shared_payload allocate_wide(alloc_size_t size);
+
     /// @brief Force deallocates the shared payload without sending it.
     /// @note If you send the payload, nalchi takes the ownership of the payload and releases it automatically. \n
     /// So, you should @b not call this if you already sent the payload. \n \n
@@ -38,16 +90,54 @@ struct shared_payload
     /// @param payload Shared payload to force deallocate.
     NALCHI_API static void force_deallocate(shared_payload payload);
 
+    /// @brief Returns the payloads deallocated on this thread to the threads that allocated them right away.
+    ///
+    /// Payloads deallocated on a thread other than the allocating one are returned to the allocating thread
+    /// in batches, so a few of them might be held back on this thread until it deallocates more. \n
+    /// Call this on such a thread when it goes idle for a while, so that the allocating threads can reuse them. \n
+    /// This is only necessary when nalchi is built with `NALCHI_PAYLOAD_POOL`, otherwise it does nothing.
+    NALCHI_API static void flush_remote_frees();
+
+    /// @brief Enables or disables counting the allocations for `stats()`, which is disabled by default.
+    ///
+    /// Each thread counts on its own counters, so enabling this adds only a few non-atomic increments
+    /// per allocation & deallocation. \n
+    /// Payloads allocated while enabled are still counted on deallocation after disabled, and vice versa,
+    /// so that `live_payloads` and `live_bytes` stay correct.
+    /// @param enabled Whether to count the allocations or not.
+    NALCHI_API static void enable_stats(bool enabled);
+
+    /// @brief Gets the statistics of the payloads counted so far.
+    ///
+    /// This sums the counters of all threads, so don't call this too often (e.g. once per second is fine).
+    /// @return Snapshot of the statistics.
+    NALCHI_API static auto stats() -> shared_payload_stats;
+
+    /// @brief Reserves a contiguous arena that the payload pool allocates its slabs from,
+    /// backed by huge pages if possible to reduce the TLB misses.
+    ///
+    /// It first tries the huge pages reserved by the admin (`vm.nr_hugepages`) with `MAP_HUGETLB`,
+    /// then falls back to normal pages advised with `MADV_HUGEPAGE` for transparent huge pages. \n
+    /// Once the arena runs out, the pool allocates its slabs from the global heap as before. \n
+    /// The arena is reserved only once, and is kept until the process exits.
+    /// @note Call this at init, before allocating any payload, so that all the slabs are in the arena. \n
+    /// This is only supported on Linux and when nalchi is built with `NALCHI_PAYLOAD_POOL`,
+    /// otherwise it does nothing and returns `shared_payload_arena_pages::none`.
+    /// @param reserve_bytes Bytes of virtual memory to reserve, which is ceiled to the huge page size (2 MiB).
+    /// @return Pages backing the arena, or `shared_payload_arena_pages::none` if failed to reserve. \n
+    /// If the arena is already reserved, the pages of the existing one.
+    NALCHI_API static auto init_arena(std::size_t reserve_bytes) -> shared_payload_arena_pages;
+
     /// @brief Gets the requested allocation size of the payload.
     /// @return Size of the payload in bytes.
     NALCHI_API auto size() const -> alloc_size_t;
 
-    /// @brief Gets the payload size that's ceiled to `bit_stream_writer::word_size`,
+    /// @brief Gets the payload size that's ceiled to the word size of the bit stream writers,
     /// which is guaranteed to be safe to access.
     ///
-    /// As this size is ceiled to multiple of `bit_stream_writer::word_size`,
-    /// it can be bigger than the requested allocation size. \n
-    /// This is to maintain compatibility with `bit_stream_writer`.
+    /// As this size is ceiled to multiple of 8 bytes if allocated with `allocate_wide()`, \n
+    /// otherwise 4 bytes (`bit_stream_writer::word_type`), it can be bigger than the requested allocation size. \n
+    /// This is to maintain compatibility with `bit_stream_writer`, and the bit stream writers with 64-bit words.
     /// @return Size of the payload in bytes.
     NALCHI_API auto word_ceiled_size() const -> alloc_size_t;
 
@@ -61,23 +151,48 @@ struct shared_payload
     /// @brief Check if this payload used `bit_stream_writer` to fill its content.
     ///
     /// If this is `true`, the send size will be automatically
-    /// ceiled to multiple of `bit_stream_reader::word_size` when you send it. \n
+    /// ceiled to multiple of the word size of the writer used (4 or 8 bytes) when you send it. \n
     /// This is to maintain compatibility with `bit_stream_reader` on the receiving side.
     /// @return Whether the payload used `bit_stream_writer` or not.
     NALCHI_API bool used_bit_stream() const;
 
 private:
-    friend class bit_stream_writer;
+    template <typename, typename, typename>
+    friend class bit_stream_writer_base;
 
     /// @brief Set the flag indicating if this payload used `bit_stream_writer` to fill its content.
     void set_used_bit_stream(bool);
 
+    /// @brief Set the flags indicating that this payload used a bit stream writer with 64-bit words
+    /// to fill its content, so that the send size is ceiled to 8 bytes.
+    void set_used_wide_bit_stream();
+
+    /// @brief Gets the send size ceiling required by the `bit_stream_writer` used.
+    auto bit_stream_word_size() const -> alloc_size_t;
+
+private:
+    /// @brief Allocates a shared payload ceiled to 8 bytes if @p wide, otherwise 4 bytes.
+    static shared_payload do_allocate(alloc_size_t size, bool wide);
+
 private:
     friend class socket_extensions;
 
+    /// @brief Sets the message to send this payload.
+    ///
+    /// This does @b not increment the ref count, so the message doesn't hold a reference by itself. \n
+    /// The ref count is set only by `set_ref_count_before_send()`, which `socket_extensions` calls right before
+    /// sending.
+    /// @note Call `set_ref_count_before_send()` with the number of messages before sending them,
+    /// otherwise the payload is deallocated too early or never.
     NALCHI_API void add_to_message(SteamNetworkingMessage_t* msg, int logical_bytes_length);
 
-    void increase_ref_count();
+    /// @brief Sets the ref count to the number of messages sharing this payload, in a single non-RMW store.
+    ///
+    /// The payload is still owned only by the sending thread, and sending the messages publishes it to
+    /// GameNetworkingSockets, so this doesn't need an atomic RMW per message.
+    /// @param count Number of messages that will release this payload.
+    NALCHI_API void set_ref_count_before_send(std::int32_t count);
+
     void decrease_ref_count_and_deallocate_if_zero();
 
     static void decrease_ref_count_and_deallocate_if_zero_callback(SteamNetworkingMessage_t* msg);
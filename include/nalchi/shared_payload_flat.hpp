@@ -14,25 +14,80 @@
 /// @return Shared payload instance that might hold allocated buffer.
 NALCHI_FLAT_API nalchi::shared_payload nalchi_shared_payload_allocate(nalchi::shared_payload::alloc_size_t size);
 
+/// @brief Allocates a shared payload that bit stream writers with 64-bit words can write to.
+///
+/// This is same as `nalchi_shared_payload_allocate()`, except that the payload is ceiled to 8 bytes
+/// instead of 4 bytes, \n
+/// so that the last 64-bit word can be written without overrun.
+/// @note You should check if `ptr` is `nullptr` or not
+/// to see if the allocation has been successful.
+/// @param size Space in bytes to allocate.
+/// @return Shared payload instance that might hold allocated buffer.
+NALCHI_FLAT_API nalchi::shared_payload nalchi_shared_payload_allocate_wide(
+    nalchi::shared_payload::alloc_size_t size);
+
 /// @brief Force deallocates the shared payload without sending it.
 /// @note If you send the payload, nalchi takes the ownership of the payload and releases it automatically. \n
-/// So, you should @b not call this if you already sent the payload. \n \n
+/// So, you should @b not call this if you already sent the payload. \n
+/// The ref count of the payload is set to the number of messages only right before sending them
+/// in `nalchi_socket_extensions_unicast()` and `nalchi_socket_extensions_multicast()`,
+/// and adding the payload to a message doesn't increment it, \n
+/// so send the payload only with these functions. \n \n
 /// Calling this is only necessary when you have some exceptions in your program
 /// that prevents sending the allocated payload.
 /// @param payload Shared payload to force deallocate.
 NALCHI_FLAT_API void nalchi_shared_payload_force_deallocate(nalchi::shared_payload payload);
 
+/// @brief Returns the payloads deallocated on this thread to the threads that allocated them right away.
+///
+/// Payloads deallocated on a thread other than the allocating one are returned to the allocating thread
+/// in batches, so a few of them might be held back on this thread until it deallocates more. \n
+/// Call this on such a thread when it goes idle for a while, so that the allocating threads can reuse them. \n
+/// This is only necessary when nalchi is built with `NALCHI_PAYLOAD_POOL`, otherwise it does nothing.
+NALCHI_FLAT_API void nalchi_shared_payload_flush_remote_frees();
+
+/// @brief Enables or disables counting the allocations for `nalchi_shared_payload_stats()`,
+/// which is disabled by default.
+///
+/// Each thread counts on its own counters, so enabling this adds only a few non-atomic increments
+/// per allocation & deallocation. \n
+/// Payloads allocated while enabled are still counted on deallocation after disabled, and vice versa,
+/// so that `live_payloads` and `live_bytes` stay correct.
+/// @param enabled Whether to count the allocations or not.
+NALCHI_FLAT_API void nalchi_shared_payload_enable_stats(bool enabled);
+
+/// @brief Gets the statistics of the payloads counted so far.
+///
+/// This sums the counters of all threads, so don't call this too often (e.g. once per second is fine).
+/// @return Snapshot of the statistics.
+NALCHI_FLAT_API auto nalchi_shared_payload_stats() -> nalchi::shared_payload_stats;
+
+/// @brief Reserves a contiguous arena that the payload pool allocates its slabs from,
+/// backed by huge pages if possible to reduce the TLB misses.
+///
+/// It first tries the huge pages reserved by the admin (`vm.nr_hugepages`) with `MAP_HUGETLB`,
+/// then falls back to normal pages advised with `MADV_HUGEPAGE` for transparent huge pages. \n
+/// Once the arena runs out, the pool allocates its slabs from the global heap as before. \n
+/// The arena is reserved only once, and is kept until the process exits.
+/// @note Call this at init, before allocating any payload, so that all the slabs are in the arena. \n
+/// This is only supported on Linux and when nalchi is built with `NALCHI_PAYLOAD_POOL`,
+/// otherwise it does nothing and returns `shared_payload_arena_pages::none`.
+/// @param reserve_bytes Bytes of virtual memory to reserve, which is ceiled to the huge page size (2 MiB).
+/// @return Pages backing the arena, or `shared_payload_arena_pages::none` if failed to reserve. \n
+/// If the arena is already reserved, the pages of the existing one.
+NALCHI_FLAT_API auto nalchi_shared_payload_init_arena(std::size_t reserve_bytes) -> nalchi::shared_payload_arena_pages;
+
 /// @brief Gets the requested allocation size of the payload.
 /// @return Size of the payload in bytes.
 NALCHI_FLAT_API auto nalchi_shared_payload_size(const nalchi::shared_payload payload)
     -> nalchi::shared_payload::alloc_size_t;
 
-/// @brief Gets the payload size that's ceiled to `bit_stream_writer::word_size`,
+/// @brief Gets the payload size that's ceiled to the word size of the bit stream writers,
 /// which is guaranteed to be safe to access.
 ///
-/// As this size is ceiled to multiple of `bit_stream_writer::word_size`,
-/// it can be bigger than the requested allocation size. \n
-/// This is to maintain compatibility with `bit_stream_writer`.
+/// As this size is ceiled to multiple of 8 bytes if allocated with `nalchi_shared_payload_allocate_wide()`, \n
+/// otherwise 4 bytes (`bit_stream_writer::word_type`), it can be bigger than the requested allocation size. \n
+/// This is to maintain compatibility with `bit_stream_writer`, and the bit stream writers with 64-bit words.
 /// @return Size of the payload in bytes.
 NALCHI_FLAT_API auto nalchi_shared_payload_word_ceiled_size(const nalchi::shared_payload payload)
     -> nalchi::shared_payload::alloc_size_t;
@@ -48,7 +103,7 @@ NALCHI_FLAT_API auto nalchi_shared_payload_internal_alloc_size(const nalchi::sha
 /// @brief Check if this payload used `bit_stream_writer` to fill its content.
 ///
 /// If this is `true`, the send size will be automatically
-/// ceiled to multiple of `bit_stream_reader::word_size` when you send it. \n
+/// ceiled to multiple of the word size of the writer used (4 or 8 bytes) when you send it. \n
 /// This is to maintain compatibility with `bit_stream_reader` on the receiving side.
 /// @return Whether the payload used `bit_stream_writer` or not.
 NALCHI_FLAT_API bool nalchi_shared_payload_used_bit_stream(const nalchi::shared_payload payload);
@@ -102,6 +102,9 @@ public:
             ++i;
         }
 
+        // Set the ref count to the number of messages at once, instead of an atomic increment per message.
+        payload.set_ref_count_before_send(static_cast<std::int32_t>(connections_count));
+
         // Send all messages.
         sockets->SendMessages(static_cast<int>(connections_count), messages,
                               reinterpret_cast<int64*>(out_message_number_or_result.data()));
@@ -0,0 +1,271 @@
+#include "bit_packing.hpp"
+
+#include "cpu_features.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(NALCHI_X86_64)
+#include <immintrin.h>
+#endif
+
+namespace nalchi
+{
+
+namespace
+{
+
+auto load_le64(const std::byte* in) -> std::uint64_t
+{
+    std::uint64_t value;
+    std::memcpy(&value, in, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big)
+        value = std::byteswap(value);
+    return value;
+}
+
+void store_le64(std::byte* out, std::uint64_t value, std::size_t bytes)
+{
+    if constexpr (std::endian::native == std::endian::big)
+        value = std::byteswap(value);
+    std::memcpy(out, &value, bytes);
+}
+
+template <typename UInt>
+auto load_value(const std::byte* values, std::size_t index) -> UInt
+{
+    UInt value;
+    std::memcpy(&value, values + sizeof(UInt) * index, sizeof(UInt));
+    return value;
+}
+
+template <typename UInt>
+void store_value(std::byte* values, std::size_t index, UInt value)
+{
+    std::memcpy(values + sizeof(UInt) * index, &value, sizeof(UInt));
+}
+
+auto low_bits_mask(int bits) -> std::uint64_t
+{
+    return (bits >= 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+}
+
+/// @brief Appends bits to the packed bits buffer, 64 bits at a time.
+class packed_bits_sink final
+{
+public:
+    explicit packed_bits_sink(std::byte* out) : _out(out)
+    {
+    }
+
+    /// @brief Appends @p bits bits of @p value.
+    /// @param value Value to append, which must not have bits set above @p bits.
+    /// @param bits Number of bits to append, which must be between 1 and 64.
+    void append(std::uint64_t value, int bits)
+    {
+        _acc |= (value << _acc_bits);
+
+        if (_acc_bits + bits >= 64)
+        {
+            store_le64(_out, _acc, sizeof(_acc));
+            _out += sizeof(_acc);
+
+            // Keep the bits that didn't fit in the stored accumulator.
+            const int stored_bits = 64 - _acc_bits;
+            _acc = (stored_bits < 64) ? (value >> stored_bits) : 0;
+            _acc_bits = bits - stored_bits;
+        }
+        else
+        {
+            _acc_bits += bits;
+        }
+    }
+
+    /// @brief Stores the remaining bits in the accumulator.
+    void finish()
+    {
+        if (_acc_bits > 0)
+            store_le64(_out, _acc, static_cast<std::size_t>((_acc_bits + 7) / 8));
+    }
+
+private:
+    std::byte* _out;
+    std::uint64_t _acc = 0;
+    int _acc_bits = 0;
+};
+
+/// @brief Takes bits from the packed bits buffer.
+class packed_bits_source final
+{
+public:
+    explicit packed_bits_source(const std::byte* in) : _in(in)
+    {
+    }
+
+    /// @brief Takes @p bits bits.
+    /// @param bits Number of bits to take, which must be between 1 and 64.
+    /// @return Bits taken.
+    auto take(int bits) -> std::uint64_t
+    {
+        const std::byte* in = _in + (_pos / 8);
+        const int shift = static_cast<int>(_pos % 8);
+
+        std::uint64_t value = load_le64(in) >> shift;
+        if (shift > 0 && bits > 64 - shift)
+            value |= load_le64(in + 8) << (64 - shift);
+
+        _pos += static_cast<std::size_t>(bits);
+
+        return value & low_bits_mask(bits);
+    }
+
+private:
+    const std::byte* _in;
+    std::size_t _pos = 0;
+};
+
+template <typename UInt>
+void pack_scalar(const std::byte* values, std::size_t count, int bits, std::byte* out)
+{
+    packed_bits_sink sink(out);
+    for (std::size_t i = 0; i < count; ++i)
+        sink.append(load_value<UInt>(values, i), bits);
+    sink.finish();
+}
+
+template <typename UInt>
+void unpack_scalar(const std::byte* in, std::size_t count, int bits, std::byte* values)
+{
+    packed_bits_source source(in);
+    for (std::size_t i = 0; i < count; ++i)
+        store_value(values, i, static_cast<UInt>(source.take(bits)));
+}
+
+#if defined(NALCHI_X86_64)
+
+/// @brief Gets the mask that selects the lower @p bits bits of each `UInt` lane in a 64-bit integer.
+template <typename UInt>
+auto lane_mask(int bits) -> std::uint64_t
+{
+    // 0x0101... for 8-bit lanes, 0x0001'0001... for 16-bit lanes, and so on.
+    constexpr std::uint64_t LANE_ONES = ~std::uint64_t(0) / std::numeric_limits<UInt>::max();
+
+    return low_bits_mask(bits) * LANE_ONES;
+}
+
+/// @brief Packs 64 bits of `UInt` lanes at once with `PEXT`, which gathers the masked bits contiguously.
+template <typename UInt>
+NALCHI_TARGET_BMI2 void pack_bmi2(const std::byte* values, std::size_t count, int bits, std::byte* out)
+{
+    constexpr std::size_t LANES = sizeof(std::uint64_t) / sizeof(UInt);
+
+    const std::uint64_t mask = lane_mask<UInt>(bits);
+    const int lanes_bits = static_cast<int>(LANES) * bits;
+
+    packed_bits_sink sink(out);
+
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES)
+    {
+        std::uint64_t lanes;
+        std::memcpy(&lanes, values + sizeof(UInt) * i, sizeof(lanes));
+        sink.append(_pext_u64(lanes, mask), lanes_bits);
+    }
+    for (; i < count; ++i)
+        sink.append(load_value<UInt>(values, i), bits);
+
+    sink.finish();
+}
+
+/// @brief Unpacks 64 bits of `UInt` lanes at once with `PDEP`, which scatters the bits to the masked positions.
+template <typename UInt>
+NALCHI_TARGET_BMI2 void unpack_bmi2(const std::byte* in, std::size_t count, int bits, std::byte* values)
+{
+    constexpr std::size_t LANES = sizeof(std::uint64_t) / sizeof(UInt);
+
+    const std::uint64_t mask = lane_mask<UInt>(bits);
+    const int lanes_bits = static_cast<int>(LANES) * bits;
+
+    packed_bits_source source(in);
+
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES)
+    {
+        const std::uint64_t lanes = _pdep_u64(source.take(lanes_bits), mask);
+        std::memcpy(values + sizeof(UInt) * i, &lanes, sizeof(lanes));
+    }
+    for (; i < count; ++i)
+        store_value(values, i, static_cast<UInt>(source.take(bits)));
+}
+
+#endif
+
+} // namespace
+
+void pack_bits(const void* values, std::size_t value_size, std::size_t count, int bits, std::byte* out)
+{
+    const auto* bytes = static_cast<const std::byte*>(values);
+
+#if defined(NALCHI_X86_64)
+    if (value_size < sizeof(std::uint64_t) && cpu_has_fast_bmi2())
+    {
+        switch (value_size)
+        {
+        case 1:
+            return pack_bmi2<std::uint8_t>(bytes, count, bits, out);
+        case 2:
+            return pack_bmi2<std::uint16_t>(bytes, count, bits, out);
+        default:
+            return pack_bmi2<std::uint32_t>(bytes, count, bits, out);
+        }
+    }
+#endif
+
+    switch (value_size)
+    {
+    case 1:
+        return pack_scalar<std::uint8_t>(bytes, count, bits, out);
+    case 2:
+        return pack_scalar<std::uint16_t>(bytes, count, bits, out);
+    case 4:
+        return pack_scalar<std::uint32_t>(bytes, count, bits, out);
+    default:
+        return pack_scalar<std::uint64_t>(bytes, count, bits, out);
+    }
+}
+
+void unpack_bits(const std::byte* in, std::size_t value_size, std::size_t count, int bits, void* values)
+{
+    auto* bytes = static_cast<std::byte*>(values);
+
+#if defined(NALCHI_X86_64)
+    if (value_size < sizeof(std::uint64_t) && cpu_has_fast_bmi2())
+    {
+        switch (value_size)
+        {
+        case 1:
+            return unpack_bmi2<std::uint8_t>(in, count, bits, bytes);
+        case 2:
+            return unpack_bmi2<std::uint16_t>(in, count, bits, bytes);
+        default:
+            return unpack_bmi2<std::uint32_t>(in, count, bits, bytes);
+        }
+    }
+#endif
+
+    switch (value_size)
+    {
+    case 1:
+        return unpack_scalar<std::uint8_t>(in, count, bits, bytes);
+    case 2:
+        return unpack_scalar<std::uint16_t>(in, count, bits, bytes);
+    case 4:
+        return unpack_scalar<std::uint32_t>(in, count, bits, bytes);
+    default:
+        return unpack_scalar<std::uint64_t>(in, count, bits, bytes);
+    }
+}
+
+} // namespace nalchi
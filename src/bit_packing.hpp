@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace nalchi
+{
+
+/// @brief Extra bytes required after the packed bits buffer, as `unpack_bits()` loads 8 bytes at a time.
+inline constexpr std::size_t PACKED_BITS_PADDING = 16;
+
+/// @brief Packs unsigned values to a little endian bit sequence, each of them with the same number of bits.
+///
+/// Values are packed from the LSB of the first byte, same as writing them one by one to the bit stream. \n
+/// The last byte is zero-padded if the total bits is not a multiple of 8.
+/// @param values Pointer to the unsigned values, each of them must not have bits set above @p bits.
+/// @param value_size Size in bytes of each value, which must be 1, 2, 4 or 8.
+/// @param count Number of values.
+/// @param bits Number of bits for each value, which must be between 1 and `8 * value_size`.
+/// @param out Buffer to pack to, which must have at least `(count * bits + 7) / 8` bytes.
+void pack_bits(const void* values, std::size_t value_size, std::size_t count, int bits, std::byte* out);
+
+/// @brief Unpacks unsigned values from a little endian bit sequence, which was packed with `pack_bits()`.
+/// @param in Buffer to unpack from, which must have `PACKED_BITS_PADDING` readable bytes after the packed bits.
+/// @param value_size Size in bytes of each value, which must be 1, 2, 4 or 8.
+/// @param count Number of values.
+/// @param bits Number of bits for each value, which must be between 1 and `8 * value_size`.
+/// @param values Pointer to the unsigned values to unpack to.
+void unpack_bits(const std::byte* in, std::size_t value_size, std::size_t count, int bits, void* values);
+
+} // namespace nalchi
@@ -1,13 +1,19 @@
 #include "nalchi/bit_stream.hpp"
 
+#include "nalchi/huffman_codebook.hpp"
 #include "nalchi/shared_payload.hpp"
 
+#include "bit_packing.hpp"
 #include "math.hpp"
+#include "vector_quantization.hpp"
 
 #include <steam/steamnetworkingtypes.h>
 
 #include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <utility>
 
 namespace nalchi
@@ -20,40 +26,90 @@ constexpr auto GNS_MAX_MSG_RECV_SIZE = 2 * k_cbMaxSteamNetworkingSocketsMessageS
 static_assert(8 * GNS_MAX_MSG_RECV_SIZE <= std::numeric_limits<bit_stream_writer::size_type>::max(),
               "`bit_stream_writer::size_type` too small to represent incoming GNS message in number of bits");
 
+/// @brief Counts the trailing zero bits of the scratch, which might be wider than the standard integer types.
+template <typename Scratch>
+auto scratch_countr_zero(Scratch scratch) -> int
+{
+    if constexpr (sizeof(Scratch) <= sizeof(std::uint64_t))
+    {
+        return std::countr_zero(static_cast<std::uint64_t>(scratch));
+    }
+    else
+    {
+        const auto low = static_cast<std::uint64_t>(scratch);
+        if (low != 0)
+            return std::countr_zero(low);
+        return 64 + std::countr_zero(static_cast<std::uint64_t>(scratch >> 64));
+    }
+}
+
+constexpr auto low_bits_mask(int bits) -> std::uint64_t
+{
+    return (bits >= 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+}
+
+/// @brief Gets the maximum quantized value and the number of bits for each axis of the 3D vectors.
+/// @return Whether the ranges of all axes are valid.
+bool get_vec3_quantized_ranges(const std::array<float, 3>& min, const std::array<float, 3>& max, float resolution,
+                               std::array<std::uint32_t, 3>& q_max, std::array<int, 3>& bits)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const std::int64_t axis_q_max = quantized_max(min[axis], max[axis], resolution);
+        if (axis_q_max < 0)
+            return false;
+
+        q_max[axis] = static_cast<std::uint32_t>(axis_q_max);
+        bits[axis] = static_cast<int>(std::bit_width(q_max[axis]));
+    }
+
+    return true;
+}
+
 } // namespace
 
-NALCHI_API bit_stream_writer::bit_stream_writer()
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_writer_base<Word, Scratch, Derived>::bit_stream_writer_base()
 {
     reset();
 }
 
-NALCHI_API bit_stream_writer::bit_stream_writer(shared_payload buffer, size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_writer_base<Word, Scratch, Derived>::bit_stream_writer_base(shared_payload buffer,
+                                                                       size_type logical_bytes_length)
 {
     reset_with(buffer, logical_bytes_length);
 }
 
-NALCHI_API bit_stream_writer::bit_stream_writer(std::span<word_type> buffer, size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_writer_base<Word, Scratch, Derived>::bit_stream_writer_base(std::span<word_type> buffer,
+                                                                       size_type logical_bytes_length)
 {
     reset_with(buffer, logical_bytes_length);
 }
 
-NALCHI_API bit_stream_writer::bit_stream_writer(word_type* begin, word_type* end, size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_writer_base<Word, Scratch, Derived>::bit_stream_writer_base(word_type* begin, word_type* end,
+                                                                       size_type logical_bytes_length)
 {
     reset_with(begin, end, logical_bytes_length);
 }
 
-NALCHI_API bit_stream_writer::bit_stream_writer(word_type* begin, size_type words_length,
-                                                size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_writer_base<Word, Scratch, Derived>::bit_stream_writer_base(word_type* begin, size_type words_length,
+                                                                       size_type logical_bytes_length)
 {
     reset_with(begin, words_length, logical_bytes_length);
 }
 
-NALCHI_API auto bit_stream_writer::used_bytes() const -> size_type
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::used_bytes() const -> size_type
 {
     return ceil_to_multiple_of<8>(used_bits()) / 8;
 }
 
-NALCHI_API void bit_stream_writer::restart()
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::restart()
 {
     _scratch = 0;
 
@@ -66,7 +122,8 @@ NALCHI_API void bit_stream_writer::restart()
     _final_flushed = false;
 }
 
-NALCHI_API void bit_stream_writer::reset()
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::reset()
 {
     _words = decltype(_words)();
     _logical_total_bits = 0;
@@ -75,16 +132,24 @@ NALCHI_API void bit_stream_writer::reset()
     restart();
 }
 
-NALCHI_API void bit_stream_writer::reset_with(shared_payload buffer, size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::reset_with(shared_payload buffer, size_type logical_bytes_length)
 {
-    buffer.set_used_bit_stream(true);
+    if constexpr (sizeof(word_type) > sizeof(bit_stream_writer::word_type))
+        buffer.set_used_wide_bit_stream();
+    else
+        buffer.set_used_bit_stream(true);
 
+    // Payload not allocated with `shared_payload::allocate_wide()` might not fit the last wide word,
+    // so only the whole words are used.
     reset_with(
         std::span<word_type>(reinterpret_cast<word_type*>(buffer.ptr), buffer.word_ceiled_size() / sizeof(word_type)),
         logical_bytes_length);
 }
 
-NALCHI_API void bit_stream_writer::reset_with(std::span<word_type> buffer, size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::reset_with(std::span<word_type> buffer,
+                                                                size_type logical_bytes_length)
 {
     _words = buffer;
     _logical_total_bits = 8 * logical_bytes_length;
@@ -93,23 +158,28 @@ NALCHI_API void bit_stream_writer::reset_with(std::span<word_type> buffer, size_
     restart();
 }
 
-NALCHI_API void bit_stream_writer::reset_with(word_type* begin, word_type* end, size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::reset_with(word_type* begin, word_type* end,
+                                                                size_type logical_bytes_length)
 {
     reset_with(std::span<word_type>(begin, end), logical_bytes_length);
 }
 
-NALCHI_API void bit_stream_writer::reset_with(word_type* begin, size_type words_length, size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::reset_with(word_type* begin, size_type words_length,
+                                                                size_type logical_bytes_length)
 {
     reset_with(std::span<word_type>(begin, words_length), logical_bytes_length);
 }
 
-NALCHI_API auto bit_stream_writer::flush_final() -> bit_stream_writer&
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::flush_final() -> Derived&
 {
-    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
 
     // No-op if already flushed
     if (_final_flushed)
-        return *this;
+        return self();
 
     // No-op if nothing to flush
     if (_scratch_index > 0)
@@ -117,31 +187,64 @@ NALCHI_API auto bit_stream_writer::flush_final() -> bit_stream_writer&
 
     _final_flushed = true;
 
-    return *this;
+    return self();
 }
 
-NALCHI_API auto bit_stream_writer::write(const void* data, size_type size) -> bit_stream_writer&
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write(const void* data, size_type size) -> Derived&
 {
-    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
-    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(*this);
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
     // Overflow check.
     if (_logical_used_bits + 8 * size > _logical_total_bits)
     {
         _fail = true;
-        return *this;
+        return self();
     }
 
-    const std::uint8_t* ptr = reinterpret_cast<const std::uint8_t*>(data);
+    do_write_bytes_unchecked(static_cast<const std::byte*>(data), size);
 
-    // Write each byte one by one.
-    for (size_type i = 0; i < size; ++i)
-        do_write<false>(ptr[i]);
+    return self();
+}
 
-    return *this;
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::align_to_byte() -> Derived&
+{
+    return do_align(8);
 }
 
-NALCHI_API auto bit_stream_writer::write(float data) -> bit_stream_writer&
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::align_to_word() -> Derived&
+{
+    return do_align(static_cast<int>(8 * sizeof(word_type)));
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_aligned_bytes(const void* data, size_type size)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+
+    const size_type padding_bits = (8 - _logical_used_bits % 8) % 8;
+
+    // Overflow check, including the padding.
+    if (_logical_used_bits + padding_bits + 8 * size > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    if (padding_bits > 0)
+        do_write_raw_bits_unchecked(0, static_cast<int>(padding_bits));
+    do_write_bytes_unchecked(static_cast<const std::byte*>(data), size);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write(float data) -> Derived&
 {
     // Use the reinterpreted value of `data` as an u32
     std::uint32_t converted = std::bit_cast<std::uint32_t>(data);
@@ -149,7 +252,8 @@ NALCHI_API auto bit_stream_writer::write(float data) -> bit_stream_writer&
     return write(converted);
 }
 
-NALCHI_API auto bit_stream_writer::write(double data) -> bit_stream_writer&
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write(double data) -> Derived&
 {
     // Use the reinterpreted value of `data` as an u64
     std::uint64_t converted = std::bit_cast<std::uint64_t>(data);
@@ -157,226 +261,1587 @@ NALCHI_API auto bit_stream_writer::write(double data) -> bit_stream_writer&
     return write(converted);
 }
 
-NALCHI_API void bit_stream_writer::flush_if_scratch_overflow()
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_quantized(float data, float min, float max, float resolution)
+    -> Derived&
 {
-    if (_scratch_index >= static_cast<int>(8 * sizeof(word_type)))
-        do_flush_word_unchecked();
-}
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
-NALCHI_API void bit_stream_writer::do_flush_word_unchecked()
-{
-    // Get the lower word bits to flush.
-    word_type word = static_cast<word_type>((_scratch << (8 * sizeof(word_type))) >> (8 * sizeof(word_type)));
-    if constexpr (std::endian::native == std::endian::big)
-        word = std::byteswap(word);
+    const std::int64_t q_max = quantized_max(min, max, resolution);
 
-    // Flush the word.
-    _words[_words_index++] = word;
+    // Fail if the range is invalid, or `data` is out of range (including NaN).
+    if (q_max < 0 || !(min <= data && data <= max))
+    {
+        _fail = true;
+        return self();
+    }
 
-    // Remove the flushed scratch data.
-    _scratch >>= (8 * sizeof(word_type));
+    const int bits = static_cast<int>(std::bit_width(static_cast<std::uint64_t>(q_max)));
 
-    // Adjust the scratch index.
-    _scratch_index = std::max(0, _scratch_index - static_cast<int>(8 * sizeof(word_type)));
-}
+    // Fail if user buffer overflows.
+    if (_logical_used_bits + bits > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
 
-NALCHI_API auto bit_stream_measurer::used_bytes() const -> size_type
-{
-    return ceil_to_multiple_of<8>(used_bits()) / 8;
-}
+    do_write_raw_bits_unchecked(quantize(data, min, resolution, static_cast<std::uint32_t>(q_max)), bits);
 
-NALCHI_API bit_stream_reader::bit_stream_reader()
-{
-    reset();
+    return self();
 }
 
-NALCHI_API bit_stream_reader::bit_stream_reader(std::span<const word_type> buffer, size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_half(float data) -> Derived&
 {
-    reset_with(buffer, logical_bytes_length);
+    return write(float_to_half(data));
 }
 
-NALCHI_API bit_stream_reader::bit_stream_reader(const word_type* begin, const word_type* end,
-                                                size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_vec3_array(std::span<const std::array<float, 3>> data,
+                                                                      const std::array<float, 3>& min,
+                                                                      const std::array<float, 3>& max, float resolution)
+    -> Derived&
 {
-    reset_with(begin, end, logical_bytes_length);
-}
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
-NALCHI_API bit_stream_reader::bit_stream_reader(const word_type* begin, size_type words_length,
-                                                size_type logical_bytes_length)
-{
-    reset_with(begin, words_length, logical_bytes_length);
-}
+    std::array<std::uint32_t, 3> q_max;
+    std::array<int, 3> bits;
 
-NALCHI_API auto bit_stream_reader::used_bytes() const -> size_type
-{
-    return ceil_to_multiple_of<8>(used_bits()) / 8;
-}
+    // Fail if the range of any axis is invalid, or any component is out of range (including NaN).
+    if (!get_vec3_quantized_ranges(min, max, resolution, q_max, bits) ||
+        !vec3_in_range(data.data(), data.size(), min, max))
+    {
+        _fail = true;
+        return self();
+    }
 
-NALCHI_API void bit_stream_reader::restart()
-{
-    _scratch = 0;
+    const int vec3_bits = bits[0] + bits[1] + bits[2];
 
-    _scratch_bits = 0;
-    _words_index = 0;
+    // Fail if user buffer overflows.
+    if (static_cast<std::uint64_t>(vec3_bits) * data.size() > _logical_total_bits - _logical_used_bits)
+    {
+        _fail = true;
+        return self();
+    }
 
-    _logical_used_bits = 0;
-    _fail = _init_fail;
-}
+    std::uint32_t quantized[3 * ARRAY_CHUNK_LENGTH];
+    std::uint64_t codes[ARRAY_CHUNK_LENGTH];
 
-NALCHI_API void bit_stream_reader::reset()
-{
-    _words = decltype(_words)();
-    _logical_total_bits = 0;
-    _init_fail = true;
+    for (std::size_t i = 0; i < data.size(); i += ARRAY_CHUNK_LENGTH)
+    {
+        const std::size_t chunk_length = std::min(data.size() - i, ARRAY_CHUNK_LENGTH);
 
-    restart();
-}
+        quantize_vec3(data.data() + i, chunk_length, min, resolution, q_max, quantized);
 
-NALCHI_API void bit_stream_reader::reset_with(std::span<const word_type> buffer, size_type logical_bytes_length)
-{
-    _words = buffer;
-    _logical_total_bits = 8 * logical_bytes_length;
-    _init_fail = (!buffer.data() || buffer.size() == 0 || std::size_t(logical_bytes_length) > buffer.size_bytes());
+        if (vec3_bits <= 64)
+        {
+            // Combine the components to a code per vector, which is same as writing them one by one.
+            for (std::size_t j = 0; j < chunk_length; ++j)
+                codes[j] = quantized[3 * j] | (static_cast<std::uint64_t>(quantized[3 * j + 1]) << bits[0]) |
+                           (static_cast<std::uint64_t>(quantized[3 * j + 2]) << (bits[0] + bits[1]));
 
-    restart();
-}
+            do_write_packed_unchecked(codes, sizeof(std::uint64_t), chunk_length, vec3_bits);
+        }
+        else
+        {
+            for (std::size_t j = 0; j < 3 * chunk_length; ++j)
+                do_write_raw_bits_unchecked(quantized[j], bits[j % 3]);
+        }
+    }
 
-NALCHI_API void bit_stream_reader::reset_with(const word_type* begin, const word_type* end,
-                                              size_type logical_bytes_length)
-{
-    reset_with(std::span<const word_type>(begin, end), logical_bytes_length);
+    return self();
 }
 
-NALCHI_API void bit_stream_reader::reset_with(const word_type* begin, size_type words_length,
-                                              size_type logical_bytes_length)
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_quaternion(const std::array<float, 4>& quat,
+                                                                      int bits_per_component) -> Derived&
 {
-    reset_with(std::span<const word_type>(begin, words_length), logical_bytes_length);
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+
+    // Fail if the bits are out of range, or `quat` can't be encoded.
+    if (bits_per_component < SMALLEST_THREE_MIN_BITS_PER_COMPONENT ||
+        bits_per_component > SMALLEST_THREE_MAX_BITS_PER_COMPONENT || !is_encodable_quaternion(quat))
+    {
+        _fail = true;
+        return self();
+    }
+
+    const int bits = smallest_three_bits(bits_per_component);
+
+    // Fail if user buffer overflows.
+    if (_logical_used_bits + bits > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    do_write_raw_bits_unchecked(encode_smallest_three(quat, bits_per_component), bits);
+
+    return self();
 }
 
-NALCHI_API auto bit_stream_reader::read(void* data, size_type size) -> bit_stream_reader&
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_quaternion_array(std::span<const std::array<float, 4>> quats,
+                                                                            int bits_per_component) -> Derived&
 {
-    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
-    // Overflow check.
-    if (_logical_used_bits + 8 * size > _logical_total_bits)
+    // Fail if the bits are out of range, or any of `quats` can't be encoded.
+    if (bits_per_component < SMALLEST_THREE_MIN_BITS_PER_COMPONENT ||
+        bits_per_component > SMALLEST_THREE_MAX_BITS_PER_COMPONENT ||
+        !std::all_of(quats.begin(), quats.end(), is_encodable_quaternion))
     {
         _fail = true;
-        return *this;
+        return self();
     }
 
-    std::uint8_t* ptr = reinterpret_cast<std::uint8_t*>(data);
+    const int bits = smallest_three_bits(bits_per_component);
 
-    // Read each byte one by one.
-    for (size_type i = 0; i < size; ++i)
-        do_read<false>(ptr[i]);
+    // Fail if user buffer overflows.
+    if (static_cast<std::uint64_t>(bits) * quats.size() > _logical_total_bits - _logical_used_bits)
+    {
+        _fail = true;
+        return self();
+    }
 
-    return *this;
+    std::uint64_t codes[ARRAY_CHUNK_LENGTH];
+
+    for (std::size_t i = 0; i < quats.size(); i += ARRAY_CHUNK_LENGTH)
+    {
+        const std::size_t chunk_length = std::min(quats.size() - i, ARRAY_CHUNK_LENGTH);
+
+        for (std::size_t j = 0; j < chunk_length; ++j)
+            codes[j] = encode_smallest_three(quats[i + j], bits_per_component);
+
+        do_write_packed_unchecked(codes, sizeof(std::uint64_t), chunk_length, bits);
+    }
+
+    return self();
 }
 
-NALCHI_API auto bit_stream_reader::read(float& data) -> bit_stream_reader&
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_unit_vector(const std::array<float, 3>& vec,
+                                                                       int bits_per_axis) -> Derived&
 {
-    // Read value as `u32`
-    std::uint32_t raw;
-    if (!read(raw))
-        return *this;
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
-    // Read to `data` by reinterpreting `raw` to float
-    data = std::bit_cast<float>(raw);
+    // Fail if the bits are out of range, or `vec` can't be encoded.
+    if (bits_per_axis < OCTAHEDRAL_MIN_BITS_PER_AXIS || bits_per_axis > OCTAHEDRAL_MAX_BITS_PER_AXIS ||
+        !is_encodable_unit_vector(vec))
+    {
+        _fail = true;
+        return self();
+    }
 
-    return *this;
+    const int bits = octahedral_bits(bits_per_axis);
+
+    // Fail if user buffer overflows.
+    if (_logical_used_bits + bits > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    do_write_raw_bits_unchecked(encode_octahedral(vec, bits_per_axis), bits);
+
+    return self();
 }
 
-NALCHI_API auto bit_stream_reader::read(double& data) -> bit_stream_reader&
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_unit_vector_array(std::span<const std::array<float, 3>> vecs,
+                                                                             int bits_per_axis) -> Derived&
 {
-    // Read value as `u64`
-    std::uint64_t raw;
-    if (!read(raw))
-        return *this;
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
-    // Read to `data` by reinterpreting `raw` to double
-    data = std::bit_cast<double>(raw);
+    // Fail if the bits are out of range, or any of `vecs` can't be encoded.
+    if (bits_per_axis < OCTAHEDRAL_MIN_BITS_PER_AXIS || bits_per_axis > OCTAHEDRAL_MAX_BITS_PER_AXIS ||
+        !std::all_of(vecs.begin(), vecs.end(), is_encodable_unit_vector))
+    {
+        _fail = true;
+        return self();
+    }
 
-    return *this;
+    const int bits = octahedral_bits(bits_per_axis);
+
+    // Fail if user buffer overflows.
+    if (static_cast<std::uint64_t>(bits) * vecs.size() > _logical_total_bits - _logical_used_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    std::uint64_t codes[ARRAY_CHUNK_LENGTH];
+
+    for (std::size_t i = 0; i < vecs.size(); i += ARRAY_CHUNK_LENGTH)
+    {
+        const std::size_t chunk_length = std::min(vecs.size() - i, ARRAY_CHUNK_LENGTH);
+
+        for (std::size_t j = 0; j < chunk_length; ++j)
+            codes[j] = encode_octahedral(vecs[i + j], bits_per_axis);
+
+        do_write_packed_unchecked(codes, sizeof(std::uint64_t), chunk_length, bits);
+    }
+
+    return self();
 }
 
-NALCHI_API auto bit_stream_reader::peek_string_length() -> ssize_type
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_huffman(const void* data, size_type size,
+                                                                   const huffman_codebook& codebook)
+    -> Derived&
 {
-    // Back up previous stream states
-    const auto prev_scratch = _scratch;
-    const auto prev_scratch_bits = _scratch_bits;
-    const auto prev_words_index = _words_index;
-    const auto prev_logical_used_bits = _logical_used_bits;
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
-    // Read string length
-    const auto result = read_string_length();
+    const std::int64_t bits = codebook.encoded_bits(data, size);
 
-    // Restore previous stream states
-    _scratch = prev_scratch;
-    _scratch_bits = prev_scratch_bits;
-    _words_index = prev_words_index;
-    _logical_used_bits = prev_logical_used_bits;
+    // Fail if any byte can't be encoded, or user buffer overflows.
+    if (bits < 0 || static_cast<size_type>(bits) > _logical_total_bits - _logical_used_bits)
+    {
+        _fail = true;
+        return self();
+    }
 
-    return result;
+    do_write_huffman_unchecked(static_cast<const std::uint8_t*>(data), size, codebook);
+
+    return self();
 }
 
-NALCHI_API auto bit_stream_reader::read_string_length() -> ssize_type
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::write_string_huffman(std::string_view str,
+                                                                          const huffman_codebook& codebook)
+    -> Derived&
 {
-    ssize_type result = -1;
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
 
-    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(result);
+    const std::int64_t bits = codebook.encoded_bits(str.data(), str.length());
+    const int length_bits = exp_golomb_bits(str.length(), STR_HUFFMAN_LENGTH_K);
 
-    // Read prefix of string length prefix
-    size_type len_of_len;
-    if (do_read<true>(len_of_len, bit_stream_writer::MIN_STR_LEN_PREFIX_PREFIX,
-                      bit_stream_writer::MAX_STR_LEN_PREFIX_PREFIX))
+    // Fail if any character can't be encoded, or user buffer overflows.
+    if (bits < 0 || static_cast<size_type>(bits) + length_bits > _logical_total_bits - _logical_used_bits)
     {
-        // Read string length prefix
-        switch (len_of_len)
-        {
-        case size_type(0): {
-            std::uint8_t len;
-            if (do_read<true>(len))
-                result = static_cast<ssize_type>(len);
-            break;
-        }
-        case size_type(1): {
-            std::uint16_t len;
-            if (do_read<true>(len))
-                result = static_cast<ssize_type>(len);
-            break;
-        }
-        case size_type(2): {
-            std::uint32_t len;
-            if (do_read<true>(len))
-                result = static_cast<ssize_type>(len);
-            break;
-        }
-        case size_type(3): {
-            std::uint64_t len;
-            if (do_read<true>(len))
-                result = static_cast<ssize_type>(len);
-            break;
-        }
-        default:
-            std::unreachable();
-        }
+        _fail = true;
+        return self();
     }
 
-    return result;
+    do_write_exp_golomb(str.length(), STR_HUFFMAN_LENGTH_K);
+    do_write_huffman_unchecked(reinterpret_cast<const std::uint8_t*>(str.data()), str.length(), codebook);
+
+    return self();
 }
 
-NALCHI_API void bit_stream_reader::do_fetch_word_unchecked()
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::do_write_bytes_unchecked(const std::byte* data, size_type size)
 {
-    // Get the word to load to scratch.
-    word_type word = _words[_words_index++];
-    if constexpr (std::endian::native == std::endian::big)
-        word = std::byteswap(word);
+    using block_type = std::uint64_t;
+
+    constexpr size_type WORD_BYTES = sizeof(word_type);
+    constexpr size_type BLOCK_BYTES = sizeof(block_type);
+    constexpr int BLOCK_BITS = static_cast<int>(8 * sizeof(block_type));
+
+    static_assert(BLOCK_BYTES % WORD_BYTES == 0);
+
+    std::byte* const dest = reinterpret_cast<std::byte*>(_words.data());
+
+    if (_scratch_index == 0)
+    {
+        // Word aligned, so the bytes are already in the stream order.
+        // Just copy the whole words directly to the user buffer.
+        const size_type words = size / WORD_BYTES;
+
+        // `memcpy()` with `nullptr` is undefined behavior, even with zero size.
+        if (words > 0)
+            std::memcpy(dest + WORD_BYTES * _words_index, data, WORD_BYTES * words);
+
+        _words_index += static_cast<int>(words);
+        _logical_used_bits += 8 * WORD_BYTES * words;
+
+        data += WORD_BYTES * words;
+        size -= WORD_BYTES * words;
+    }
+    else
+    {
+        // Not word aligned, so shift-merge each 64-bit block with the bits remaining in `_scratch`.
+        // `_scratch_index` stays the same, as we always write whole words.
+        const size_type blocks = size / BLOCK_BYTES;
+        const int shift = _scratch_index;
+
+        block_type carry = static_cast<block_type>(_scratch);
+
+        for (size_type i = 0; i < blocks; ++i)
+        {
+            block_type block;
+            std::memcpy(&block, data + BLOCK_BYTES * i, BLOCK_BYTES);
+            if constexpr (std::endian::native == std::endian::big)
+                block = std::byteswap(block);
+
+            block_type merged = carry | (block << shift);
+            carry = block >> (BLOCK_BITS - shift);
 
-    // Load to scratch.
-    _scratch |= (static_cast<scratch_type>(word) << _scratch_bits);
+            if constexpr (std::endian::native == std::endian::big)
+                merged = std::byteswap(merged);
+            std::memcpy(dest + WORD_BYTES * _words_index, &merged, BLOCK_BYTES);
 
-    // Adjust the scratch bits.
-    _scratch_bits += 8 * sizeof(word_type);
+            _words_index += static_cast<int>(BLOCK_BYTES / WORD_BYTES);
+        }
+
+        _scratch = static_cast<scratch_type>(carry);
+        _logical_used_bits += 8 * BLOCK_BYTES * blocks;
+
+        data += BLOCK_BYTES * blocks;
+        size -= BLOCK_BYTES * blocks;
+    }
+
+    // Write the remaining bytes one by one.
+    for (size_type i = 0; i < size; ++i)
+        do_write<false>(std::to_integer<std::uint8_t>(data[i]));
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::do_write_varint(std::uint64_t value) -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+
+    const int bits = varint_bits(value);
+
+    // Fail if user buffer overflows.
+    if (_logical_used_bits + bits > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    // Write 7-bit groups, with the continuation bit on top of each.
+    for (int groups = bits / 8; groups > 0; --groups)
+    {
+        const auto group = static_cast<std::uint8_t>((value & 0x7F) | (groups > 1 ? 0x80 : 0));
+        do_write<false>(group);
+        value >>= 7;
+    }
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::do_write_exp_golomb(std::uint64_t value, int k)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+
+    // Fail if user buffer overflows.
+    if (_logical_used_bits + exp_golomb_bits(value, k) > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    const std::uint64_t offset = std::uint64_t(1) << k;
+    const std::uint64_t biased = value + offset;
+
+    // If `value + 2^k` overflows, it has 65 bits, and `biased` holds the lower 64 bits of it.
+    const int n = (biased < offset) ? 64 : std::bit_width(biased) - 1;
+    const int zeros = n - k;
+
+    // Write the unary prefix: `zeros` zero bits and a one bit.
+    if (zeros < 64)
+    {
+        do_write_raw_bits_unchecked(std::uint64_t(1) << zeros, zeros + 1);
+    }
+    else
+    {
+        do_write_raw_bits_unchecked(0, 64);
+        do_write_raw_bits_unchecked(1, 1);
+    }
+
+    // Write the lower `n` bits of `value + 2^k`, as the leading one bit is implied by the prefix.
+    if (n > 0)
+        do_write_raw_bits_unchecked(biased & low_bits_mask(n), n);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::do_write_raw_bits_unchecked(std::uint64_t value, int bits)
+{
+    do_write<false>(value, std::uint64_t(0), low_bits_mask(bits));
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_writer_base<Word, Scratch, Derived>::do_align(int alignment_bits) -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+    NALCHI_BIT_STREAM_WRITER_FAIL_IF_WRITE_AFTER_FINAL_FLUSH(self());
+
+    const auto alignment = static_cast<size_type>(alignment_bits);
+    const size_type padding_bits = (alignment - _logical_used_bits % alignment) % alignment;
+
+    // Fail if user buffer overflows.
+    if (_logical_used_bits + padding_bits > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    if (padding_bits > 0)
+        do_write_raw_bits_unchecked(0, static_cast<int>(padding_bits));
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::do_write_string_length_unchecked(std::uint64_t len)
+{
+    // Write a "prefix of length prefix" + length prefix, same as `write()` for strings.
+    // 0: u8 / 1: u16 / 2: u32 / 3: u64
+    if (len <= std::numeric_limits<std::uint8_t>::max())
+    {
+        do_write<false>(size_type(0), MIN_STR_LEN_PREFIX_PREFIX, MAX_STR_LEN_PREFIX_PREFIX);
+        do_write<false>(static_cast<std::uint8_t>(len));
+    }
+    else if (len <= std::numeric_limits<std::uint16_t>::max())
+    {
+        do_write<false>(size_type(1), MIN_STR_LEN_PREFIX_PREFIX, MAX_STR_LEN_PREFIX_PREFIX);
+        do_write<false>(static_cast<std::uint16_t>(len));
+    }
+    else if (len <= std::numeric_limits<std::uint32_t>::max())
+    {
+        do_write<false>(size_type(2), MIN_STR_LEN_PREFIX_PREFIX, MAX_STR_LEN_PREFIX_PREFIX);
+        do_write<false>(static_cast<std::uint32_t>(len));
+    }
+    else // len <= std::numeric_limits<std::uint64_t>::max()
+    {
+        do_write<false>(size_type(3), MIN_STR_LEN_PREFIX_PREFIX, MAX_STR_LEN_PREFIX_PREFIX);
+        do_write<false>(static_cast<std::uint64_t>(len));
+    }
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::do_write_huffman_unchecked(const std::uint8_t* data,
+                                                                                size_type size,
+                                                                                const huffman_codebook& codebook)
+{
+    // Gather the codes up to 64 bits, to write them at once.
+    std::uint64_t pending = 0;
+    int pending_bits = 0;
+
+    for (size_type i = 0; i < size; ++i)
+    {
+        const auto& code = codebook.code(data[i]);
+        if (pending_bits + code.length > 64)
+        {
+            do_write_raw_bits_unchecked(pending, pending_bits);
+            pending = 0;
+            pending_bits = 0;
+        }
+
+        pending |= static_cast<std::uint64_t>(code.bits) << pending_bits;
+        pending_bits += code.length;
+    }
+
+    if (pending_bits > 0)
+        do_write_raw_bits_unchecked(pending, pending_bits);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_writer_base<Word, Scratch, Derived>::do_write_packed_unchecked(const void* values,
+                                                                               std::size_t value_size,
+                                                                               std::size_t count, int bits)
+{
+    std::byte packed[ARRAY_CHUNK_LENGTH * sizeof(std::uint64_t)];
+    pack_bits(values, value_size, count, bits, packed);
+
+    const std::size_t total_bits = count * static_cast<std::size_t>(bits);
+    const auto whole_bytes = static_cast<size_type>(total_bits / 8);
+
+    do_write_bytes_unchecked(packed, whole_bytes);
+
+    // Write the remaining bits of the last byte.
+    if (const int remaining_bits = static_cast<int>(total_bits % 8); remaining_bits > 0)
+        do_write<false>(std::to_integer<std::uint8_t>(packed[whole_bytes]), std::uint8_t(0),
+                        static_cast<std::uint8_t>((1u << remaining_bits) - 1));
+}
+
+NALCHI_API auto bit_stream_measurer::write_huffman(const void* data, size_type size,
+                                                   const huffman_codebook& codebook) -> bit_stream_measurer&
+{
+    if (const std::int64_t bits = codebook.encoded_bits(data, size); bits >= 0)
+        _logical_used_bits += static_cast<size_type>(bits);
+
+    return *this;
+}
+
+NALCHI_API auto bit_stream_measurer::write_string_huffman(std::string_view str, const huffman_codebook& codebook)
+    -> bit_stream_measurer&
+{
+    if (const std::int64_t bits = codebook.encoded_bits(str.data(), str.length()); bits >= 0)
+    {
+        _logical_used_bits += static_cast<size_type>(bits);
+        _logical_used_bits +=
+            static_cast<size_type>(exp_golomb_bits(str.length(), bit_stream_writer::STR_HUFFMAN_LENGTH_K));
+    }
+
+    return *this;
+}
+
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_reader_base<Word, Scratch, Derived>::bit_stream_reader_base()
+{
+    reset();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_reader_base<Word, Scratch, Derived>::bit_stream_reader_base(std::span<const word_type> buffer,
+                                                                       size_type logical_bytes_length)
+{
+    reset_with(buffer, logical_bytes_length);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_reader_base<Word, Scratch, Derived>::bit_stream_reader_base(const word_type* begin, const word_type* end,
+                                                                       size_type logical_bytes_length)
+{
+    reset_with(begin, end, logical_bytes_length);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+bit_stream_reader_base<Word, Scratch, Derived>::bit_stream_reader_base(const word_type* begin, size_type words_length,
+                                                                       size_type logical_bytes_length)
+{
+    reset_with(begin, words_length, logical_bytes_length);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::used_bytes() const -> size_type
+{
+    return ceil_to_multiple_of<8>(used_bits()) / 8;
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_reader_base<Word, Scratch, Derived>::restart()
+{
+    _scratch = 0;
+
+    _scratch_bits = 0;
+    _words_index = 0;
+
+    _logical_used_bits = 0;
+    _fail = _init_fail;
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_reader_base<Word, Scratch, Derived>::reset()
+{
+    _words = decltype(_words)();
+    _logical_total_bits = 0;
+    _init_fail = true;
+
+    restart();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_reader_base<Word, Scratch, Derived>::reset_with(std::span<const word_type> buffer,
+                                                                size_type logical_bytes_length)
+{
+    _words = buffer;
+    _logical_total_bits = 8 * logical_bytes_length;
+    _init_fail = (!buffer.data() || buffer.size() == 0 || std::size_t(logical_bytes_length) > buffer.size_bytes());
+
+    restart();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_reader_base<Word, Scratch, Derived>::reset_with(const word_type* begin, const word_type* end,
+                                                                size_type logical_bytes_length)
+{
+    reset_with(std::span<const word_type>(begin, end), logical_bytes_length);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_reader_base<Word, Scratch, Derived>::reset_with(const word_type* begin, size_type words_length,
+                                                                size_type logical_bytes_length)
+{
+    reset_with(std::span<const word_type>(begin, words_length), logical_bytes_length);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read(void* data, size_type size) -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    // Overflow check.
+    if (_logical_used_bits + 8 * size > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    do_read_bytes_unchecked(static_cast<std::byte*>(data), size);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::align_to_byte() -> Derived&
+{
+    return do_align(8);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::align_to_word() -> Derived&
+{
+    return do_align(static_cast<int>(8 * sizeof(word_type)));
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_aligned_bytes(std::span<const std::byte>& bytes,
+                                                                        size_type size) -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    const size_type padding_bits = (8 - _logical_used_bits % 8) % 8;
+
+    // Overflow check, including the padding.
+    if (_logical_used_bits + padding_bits + 8 * size > _logical_total_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    if (!align_to_byte())
+        return self();
+
+    // Words are stored in little endian on every system, so the stream is in byte order in your buffer.
+    const std::byte* const begin = reinterpret_cast<const std::byte*>(_words.data()) + _logical_used_bits / 8;
+    bytes = std::span<const std::byte>(begin, static_cast<std::size_t>(size));
+
+    seek_to_bit_unchecked(_logical_used_bits + 8 * size);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read(float& data) -> Derived&
+{
+    // Read value as `u32`
+    std::uint32_t raw;
+    if (!read(raw))
+        return self();
+
+    // Read to `data` by reinterpreting `raw` to float
+    data = std::bit_cast<float>(raw);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read(double& data) -> Derived&
+{
+    // Read value as `u64`
+    std::uint64_t raw;
+    if (!read(raw))
+        return self();
+
+    // Read to `data` by reinterpreting `raw` to double
+    data = std::bit_cast<double>(raw);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_quantized(float& data, float min, float max, float resolution)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    const std::int64_t q_max = quantized_max(min, max, resolution);
+
+    // Fail if the range is invalid.
+    if (q_max < 0)
+    {
+        _fail = true;
+        return self();
+    }
+
+    // Read the quantized value, which fails if it exceeds `q_max`.
+    std::uint32_t q;
+    if (!read(q, std::uint32_t(0), static_cast<std::uint32_t>(q_max)))
+        return self();
+
+    data = dequantize(q, min, max, resolution);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_half(float& data) -> Derived&
+{
+    std::uint16_t half;
+    if (!read(half))
+        return self();
+
+    data = half_to_float(half);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_vec3_array(std::span<std::array<float, 3>> data,
+                                                                     const std::array<float, 3>& min,
+                                                                     const std::array<float, 3>& max, float resolution)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    std::array<std::uint32_t, 3> q_max;
+    std::array<int, 3> bits;
+
+    // Fail if the range of any axis is invalid.
+    if (!get_vec3_quantized_ranges(min, max, resolution, q_max, bits))
+    {
+        _fail = true;
+        return self();
+    }
+
+    const int vec3_bits = bits[0] + bits[1] + bits[2];
+
+    // Fail if no more data to be read in `_words`.
+    if (static_cast<std::uint64_t>(vec3_bits) * data.size() > _logical_total_bits - _logical_used_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    std::uint32_t quantized[3 * ARRAY_CHUNK_LENGTH];
+    std::uint64_t codes[ARRAY_CHUNK_LENGTH];
+    bool out_of_range = false;
+
+    for (std::size_t i = 0; i < data.size(); i += ARRAY_CHUNK_LENGTH)
+    {
+        const std::size_t chunk_length = std::min(data.size() - i, ARRAY_CHUNK_LENGTH);
+
+        if (vec3_bits <= 64)
+        {
+            do_read_packed_unchecked(codes, sizeof(std::uint64_t), chunk_length, vec3_bits);
+
+            for (std::size_t j = 0; j < chunk_length; ++j)
+            {
+                quantized[3 * j] = static_cast<std::uint32_t>(codes[j] & low_bits_mask(bits[0]));
+                quantized[3 * j + 1] = static_cast<std::uint32_t>((codes[j] >> bits[0]) & low_bits_mask(bits[1]));
+                quantized[3 * j + 2] = static_cast<std::uint32_t>(codes[j] >> (bits[0] + bits[1]));
+            }
+        }
+        else
+        {
+            for (std::size_t j = 0; j < 3 * chunk_length; ++j)
+                do_read<false>(quantized[j], std::uint32_t(0), q_max[j % 3]);
+        }
+
+        // Check if any exceeds the range, and dequantize.
+        for (std::size_t j = 0; j < chunk_length; ++j)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const std::uint32_t q = quantized[3 * j + axis];
+                out_of_range |= (q > q_max[axis]);
+                data[i + j][axis] = dequantize(q, min[axis], max[axis], resolution);
+            }
+        }
+    }
+
+    if (out_of_range)
+        _fail = true;
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_quaternion(std::array<float, 4>& quat, int bits_per_component)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    // Fail if the bits are out of range.
+    if (bits_per_component < SMALLEST_THREE_MIN_BITS_PER_COMPONENT ||
+        bits_per_component > SMALLEST_THREE_MAX_BITS_PER_COMPONENT)
+    {
+        _fail = true;
+        return self();
+    }
+
+    const int bits = smallest_three_bits(bits_per_component);
+
+    std::uint64_t code;
+    if (!read(code, std::uint64_t(0), low_bits_mask(bits)))
+        return self();
+
+    quat = decode_smallest_three(code, bits_per_component);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_quaternion_array(std::span<std::array<float, 4>> quats,
+                                                                           int bits_per_component) -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    // Fail if the bits are out of range.
+    if (bits_per_component < SMALLEST_THREE_MIN_BITS_PER_COMPONENT ||
+        bits_per_component > SMALLEST_THREE_MAX_BITS_PER_COMPONENT)
+    {
+        _fail = true;
+        return self();
+    }
+
+    const int bits = smallest_three_bits(bits_per_component);
+
+    // Fail if no more data to be read in `_words`.
+    if (static_cast<std::uint64_t>(bits) * quats.size() > _logical_total_bits - _logical_used_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    std::uint64_t codes[ARRAY_CHUNK_LENGTH];
+
+    for (std::size_t i = 0; i < quats.size(); i += ARRAY_CHUNK_LENGTH)
+    {
+        const std::size_t chunk_length = std::min(quats.size() - i, ARRAY_CHUNK_LENGTH);
+
+        do_read_packed_unchecked(codes, sizeof(std::uint64_t), chunk_length, bits);
+
+        for (std::size_t j = 0; j < chunk_length; ++j)
+            quats[i + j] = decode_smallest_three(codes[j], bits_per_component);
+    }
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_unit_vector(std::array<float, 3>& vec, int bits_per_axis)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    // Fail if the bits are out of range.
+    if (bits_per_axis < OCTAHEDRAL_MIN_BITS_PER_AXIS || bits_per_axis > OCTAHEDRAL_MAX_BITS_PER_AXIS)
+    {
+        _fail = true;
+        return self();
+    }
+
+    const int bits = octahedral_bits(bits_per_axis);
+
+    std::uint64_t code;
+    if (!read(code, std::uint64_t(0), low_bits_mask(bits)))
+        return self();
+
+    vec = decode_octahedral(code, bits_per_axis);
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_unit_vector_array(std::span<std::array<float, 3>> vecs,
+                                                                            int bits_per_axis) -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    // Fail if the bits are out of range.
+    if (bits_per_axis < OCTAHEDRAL_MIN_BITS_PER_AXIS || bits_per_axis > OCTAHEDRAL_MAX_BITS_PER_AXIS)
+    {
+        _fail = true;
+        return self();
+    }
+
+    const int bits = octahedral_bits(bits_per_axis);
+
+    // Fail if no more data to be read in `_words`.
+    if (static_cast<std::uint64_t>(bits) * vecs.size() > _logical_total_bits - _logical_used_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    std::uint64_t codes[ARRAY_CHUNK_LENGTH];
+
+    for (std::size_t i = 0; i < vecs.size(); i += ARRAY_CHUNK_LENGTH)
+    {
+        const std::size_t chunk_length = std::min(vecs.size() - i, ARRAY_CHUNK_LENGTH);
+
+        do_read_packed_unchecked(codes, sizeof(std::uint64_t), chunk_length, bits);
+
+        for (std::size_t j = 0; j < chunk_length; ++j)
+            vecs[i + j] = decode_octahedral(codes[j], bits_per_axis);
+    }
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_huffman(void* data, size_type size,
+                                                                  const huffman_codebook& codebook)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    // Fail if the codebook is invalid, or even the shortest codes can't fit in the remaining bits.
+    if (!codebook.valid() ||
+        size > (_logical_total_bits - _logical_used_bits) / static_cast<size_type>(codebook.min_code_length()))
+    {
+        _fail = true;
+        return self();
+    }
+
+    return do_read_huffman(static_cast<std::uint8_t*>(data), size, codebook);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_string_huffman(std::string& str, size_type max_length,
+                                                                         const huffman_codebook& codebook)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    if (!codebook.valid())
+    {
+        _fail = true;
+        return self();
+    }
+
+    std::uint64_t length;
+    if (!do_read_exp_golomb(length, writer_type::STR_HUFFMAN_LENGTH_K, 64))
+        return self();
+
+    // Fail if the length exceeds `max_length`, or even the shortest codes can't fit in the remaining bits.
+    if (length > max_length ||
+        length > (_logical_total_bits - _logical_used_bits) / static_cast<size_type>(codebook.min_code_length()))
+    {
+        _fail = true;
+        return self();
+    }
+
+    str.resize(static_cast<std::size_t>(length));
+    return do_read_huffman(reinterpret_cast<std::uint8_t*>(str.data()), static_cast<size_type>(length), codebook);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::peek_string_length() -> ssize_type
+{
+    // Back up previous stream states
+    const auto prev_scratch = _scratch;
+    const auto prev_scratch_bits = _scratch_bits;
+    const auto prev_words_index = _words_index;
+    const auto prev_logical_used_bits = _logical_used_bits;
+
+    // Read string length
+    const auto result = read_string_length();
+
+    // Restore previous stream states
+    _scratch = prev_scratch;
+    _scratch_bits = prev_scratch_bits;
+    _words_index = prev_words_index;
+    _logical_used_bits = prev_logical_used_bits;
+
+    return result;
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_string_length() -> ssize_type
+{
+    ssize_type result = -1;
+
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(result);
+
+    // Read prefix of string length prefix
+    size_type len_of_len;
+    if (do_read<true>(len_of_len, writer_type::MIN_STR_LEN_PREFIX_PREFIX, writer_type::MAX_STR_LEN_PREFIX_PREFIX))
+    {
+        // Read string length prefix
+        switch (len_of_len)
+        {
+        case size_type(0): {
+            std::uint8_t len;
+            if (do_read<true>(len))
+                result = static_cast<ssize_type>(len);
+            break;
+        }
+        case size_type(1): {
+            std::uint16_t len;
+            if (do_read<true>(len))
+                result = static_cast<ssize_type>(len);
+            break;
+        }
+        case size_type(2): {
+            std::uint32_t len;
+            if (do_read<true>(len))
+                result = static_cast<ssize_type>(len);
+            break;
+        }
+        case size_type(3): {
+            std::uint64_t len;
+            if (do_read<true>(len))
+                result = static_cast<ssize_type>(len);
+            break;
+        }
+        default:
+            std::unreachable();
+        }
+    }
+
+    return result;
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_reader_base<Word, Scratch, Derived>::do_read_bytes_unchecked(std::byte* data, size_type size)
+{
+    using block_type = std::uint64_t;
+
+    constexpr size_type WORD_BYTES = sizeof(word_type);
+    constexpr size_type BLOCK_BYTES = sizeof(block_type);
+    constexpr int BLOCK_BITS = static_cast<int>(8 * sizeof(block_type));
+
+    static_assert(BLOCK_BYTES % WORD_BYTES == 0);
+
+    const std::byte* const src = reinterpret_cast<const std::byte*>(_words.data());
+
+    if (_scratch_bits == 0)
+    {
+        // Word aligned, so the bytes are already in the stream order.
+        // Just copy the whole words directly from the user buffer.
+        const size_type words = size / WORD_BYTES;
+
+        // `memcpy()` with `nullptr` is undefined behavior, even with zero size.
+        if (words > 0)
+            std::memcpy(data, src + WORD_BYTES * _words_index, WORD_BYTES * words);
+
+        _words_index += static_cast<int>(words);
+        _logical_used_bits += 8 * WORD_BYTES * words;
+
+        data += WORD_BYTES * words;
+        size -= WORD_BYTES * words;
+    }
+    else
+    {
+        // Not word aligned, so shift-merge each 64-bit block with the bits remaining in `_scratch`.
+        // `_scratch_bits` stays the same, as we always fetch whole words.
+        //
+        // A block might fetch a word past the last one required for `data`,
+        // so we limit the blocks to the words that are actually in the user buffer.
+        const size_type words_left = static_cast<size_type>(_words.size() - _words_index);
+        const size_type blocks = std::min(size / BLOCK_BYTES, words_left / (BLOCK_BYTES / WORD_BYTES));
+        const int shift = _scratch_bits;
+
+        block_type carry = static_cast<block_type>(_scratch);
+
+        for (size_type i = 0; i < blocks; ++i)
+        {
+            block_type block;
+            std::memcpy(&block, src + WORD_BYTES * _words_index, BLOCK_BYTES);
+            if constexpr (std::endian::native == std::endian::big)
+                block = std::byteswap(block);
+
+            block_type merged = carry | (block << shift);
+            carry = block >> (BLOCK_BITS - shift);
+
+            if constexpr (std::endian::native == std::endian::big)
+                merged = std::byteswap(merged);
+            std::memcpy(data + BLOCK_BYTES * i, &merged, BLOCK_BYTES);
+
+            _words_index += static_cast<int>(BLOCK_BYTES / WORD_BYTES);
+        }
+
+        _scratch = static_cast<scratch_type>(carry);
+        _logical_used_bits += 8 * BLOCK_BYTES * blocks;
+
+        data += BLOCK_BYTES * blocks;
+        size -= BLOCK_BYTES * blocks;
+    }
+
+    // Read the remaining bytes one by one.
+    for (size_type i = 0; i < size; ++i)
+    {
+        std::uint8_t byte;
+        do_read<false>(byte);
+        data[i] = static_cast<std::byte>(byte);
+    }
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::do_read_varint(std::uint64_t& value, int value_bits)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    const int max_groups = (value_bits + 6) / 7;
+
+    std::uint64_t result = 0;
+    for (int group_index = 0;; ++group_index)
+    {
+        // Fail if there are more groups than the value can hold.
+        if (group_index == max_groups)
+        {
+            _fail = true;
+            return self();
+        }
+
+        std::uint8_t group;
+        if (!do_read<true>(group))
+            return self();
+
+        const int shift = 7 * group_index;
+        const std::uint64_t payload = group & 0x7F;
+
+        // Fail if the payload has bits set above `value_bits`.
+        if (shift + 7 > value_bits && (payload >> (value_bits - shift)) != 0)
+        {
+            _fail = true;
+            return self();
+        }
+
+        result |= (payload << shift);
+
+        // Stop if the continuation bit is not set.
+        if ((group & 0x80) == 0)
+            break;
+    }
+
+    value = result;
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::do_read_exp_golomb(std::uint64_t& value, int k, int value_bits)
+    -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    if (k < 0 || k >= value_bits)
+    {
+        _fail = true;
+        return self();
+    }
+
+    // `value + 2^k` has at most `value_bits + 1` bits, so `n` can't exceed `value_bits`.
+    const int zeros = read_unary_zeros(value_bits - k);
+    if (zeros < 0)
+        return self();
+
+    const int n = zeros + k;
+
+    // Read the lower `n` bits of `value + 2^k`.
+    std::uint64_t low = 0;
+    if (n > 0 && !do_read<true>(low, std::uint64_t(0), low_bits_mask(n)))
+        return self();
+
+    const std::uint64_t offset = std::uint64_t(1) << k;
+    std::uint64_t result;
+
+    if (n == 64)
+    {
+        // `value + 2^k` has 65 bits, so `value` fits in 64 bits only if `low < 2^k`.
+        if (low >= offset)
+        {
+            _fail = true;
+            return self();
+        }
+        result = low - offset;
+    }
+    else
+    {
+        result = ((std::uint64_t(1) << n) | low) - offset;
+    }
+
+    // Fail if it exceeds `value_bits`.
+    if (value_bits < 64 && (result >> value_bits) != 0)
+    {
+        _fail = true;
+        return self();
+    }
+
+    value = result;
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::do_read_huffman(std::uint8_t* data, size_type size,
+                                                                     const huffman_codebook& codebook)
+    -> Derived&
+{
+    constexpr int LOOKUP_BITS = huffman_codebook::LOOKUP_BITS;
+
+    size_type decoded = 0;
+    while (decoded < size)
+    {
+        const size_type remaining_bits = _logical_total_bits - _logical_used_bits;
+
+        // Load more bits to `_scratch` for a whole lookup, if there are more bits to read.
+        if (_scratch_bits < LOOKUP_BITS && static_cast<size_type>(_scratch_bits) < remaining_bits)
+            do_fetch_word_unchecked();
+
+        // Bits above `_scratch_bits` are zero, so they never complete a code within `available`.
+        const int available = static_cast<int>(std::min<size_type>(static_cast<size_type>(_scratch_bits),
+                                                                   remaining_bits));
+        const auto& entry = codebook.lookup(static_cast<std::uint32_t>(_scratch));
+
+        int consumed;
+        if (entry.count > 0 && entry.bits <= available && entry.count <= size - decoded)
+        {
+            // Take every symbol of the lookup.
+            for (int i = 0; i < entry.count; ++i)
+                data[decoded + i] = entry.symbols[i];
+            decoded += entry.count;
+            consumed = entry.bits;
+        }
+        else if (entry.count > 0 && entry.first_bits <= available)
+        {
+            // Take only the first symbol, near the end of the data or the stream.
+            data[decoded++] = entry.symbols[0];
+            consumed = entry.first_bits;
+        }
+        else
+        {
+            // The code is longer than the lookup, or it's cut by the end of the stream.
+            if (!do_read_huffman_symbol_slow(data[decoded], codebook))
+                return self();
+            ++decoded;
+            continue;
+        }
+
+        // Remove read bits from `_scratch`.
+        _scratch >>= consumed;
+        _scratch_bits -= consumed;
+        _logical_used_bits += static_cast<size_type>(consumed);
+    }
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+bool bit_stream_reader_base<Word, Scratch, Derived>::do_read_huffman_symbol_slow(std::uint8_t& symbol,
+                                                                                 const huffman_codebook& codebook)
+{
+    // Canonical codes are compared with the first bit as the MSB.
+    std::uint32_t code = 0;
+    for (int length = 1; length <= huffman_codebook::MAX_CODE_LENGTH; ++length)
+    {
+        bool bit;
+        if (!do_read<true>(bit))
+            return false;
+
+        code = (code << 1) | static_cast<std::uint32_t>(bit);
+        if (codebook.find_symbol(code, length, symbol))
+            return true;
+    }
+
+    // The code is not in the codebook.
+    _fail = true;
+    return false;
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::read_unary_zeros(int max_zeros) -> int
+{
+    int zeros = 0;
+
+    while (_logical_used_bits < _logical_total_bits)
+    {
+        // Load more bits to `_scratch` if needed.
+        // There's a word to fetch, as there are more bits to read.
+        if (_scratch_bits == 0)
+            do_fetch_word_unchecked();
+
+        // Look through the bits in `_scratch`, but not beyond the total bits.
+        const int available =
+            static_cast<int>(std::min<size_type>(static_cast<size_type>(_scratch_bits),
+                                                 _logical_total_bits - _logical_used_bits));
+        const scratch_type window = _scratch & ((scratch_type(1) << available) - 1);
+
+        const bool found = (window != 0);
+        const int window_zeros = found ? scratch_countr_zero(window) : available;
+        const int consumed = found ? window_zeros + 1 : available;
+
+        zeros += window_zeros;
+        if (zeros > max_zeros)
+            break;
+
+        // Remove read bits from `_scratch`.
+        _scratch >>= consumed;
+        _scratch_bits -= consumed;
+        _logical_used_bits += static_cast<size_type>(consumed);
+
+        if (found)
+            return zeros;
+    }
+
+    _fail = true;
+    return -1;
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_reader_base<Word, Scratch, Derived>::do_read_packed_unchecked(void* values, std::size_t value_size,
+                                                                              std::size_t count, int bits)
+{
+    std::byte packed[ARRAY_CHUNK_LENGTH * sizeof(std::uint64_t) + PACKED_BITS_PADDING];
+
+    const std::size_t total_bits = count * static_cast<std::size_t>(bits);
+    auto packed_bytes = static_cast<size_type>(total_bits / 8);
+
+    do_read_bytes_unchecked(packed, packed_bytes);
+
+    // Read the remaining bits of the last byte.
+    if (const int remaining_bits = static_cast<int>(total_bits % 8); remaining_bits > 0)
+    {
+        std::uint8_t last_byte;
+        do_read<false>(last_byte, std::uint8_t(0), static_cast<std::uint8_t>((1u << remaining_bits) - 1));
+        packed[packed_bytes++] = std::byte(last_byte);
+    }
+
+    // `unpack_bits()` might load the padding, but it never uses them.
+    std::memset(packed + packed_bytes, 0, PACKED_BITS_PADDING);
+
+    unpack_bits(packed, value_size, count, bits, values);
+}
+
+template <typename Word, typename Scratch, typename Derived>
+auto bit_stream_reader_base<Word, Scratch, Derived>::do_align(int alignment_bits) -> Derived&
+{
+    NALCHI_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(self());
+
+    const auto alignment = static_cast<size_type>(alignment_bits);
+    const auto padding_bits = static_cast<int>((alignment - _logical_used_bits % alignment) % alignment);
+
+    if (padding_bits == 0)
+        return self();
+
+    // Non-zero padding means the writing side didn't align here.
+    std::uint64_t padding;
+    if (do_read<true>(padding, std::uint64_t(0), low_bits_mask(padding_bits)) && padding != 0)
+        _fail = true;
+
+    return self();
+}
+
+template <typename Word, typename Scratch, typename Derived>
+void bit_stream_reader_base<Word, Scratch, Derived>::seek_to_bit_unchecked(size_type bit)
+{
+    constexpr size_type WORD_BITS = 8 * sizeof(word_type);
+
+    // Discard the scratch, and start from the word containing `bit`.
+    _scratch = 0;
+    _scratch_bits = 0;
+    _words_index = static_cast<int>(bit / WORD_BITS);
+    _logical_used_bits = bit;
+
+    // Drop the bits before `bit` in that word.
+    const int skip_bits = static_cast<int>(bit % WORD_BITS);
+    if (skip_bits > 0)
+    {
+        do_fetch_word_unchecked();
+        _scratch >>= skip_bits;
+        _scratch_bits -= skip_bits;
+    }
+}
+
+template class NALCHI_TEMPLATE_INSTANTIATION_API
+    bit_stream_writer_base<std::uint32_t, std::uint64_t, bit_stream_writer>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API
+    bit_stream_reader_base<std::uint32_t, std::uint64_t, bit_stream_reader>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API
+    bit_stream_writer_base<std::uint32_t, std::uint64_t, basic_bit_stream_writer<>>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API
+    bit_stream_reader_base<std::uint32_t, std::uint64_t, basic_bit_stream_reader<>>;
+
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+template class NALCHI_TEMPLATE_INSTANTIATION_API
+    bit_stream_writer_base<std::uint64_t, uint128_t, wide_bit_stream_writer>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API
+    bit_stream_reader_base<std::uint64_t, uint128_t, wide_bit_stream_reader>;
+#endif
+
+NALCHI_API bit_stream_writer::bit_stream_writer() : base_type()
+{
+}
+
+NALCHI_API bit_stream_writer::bit_stream_writer(shared_payload buffer, size_type logical_bytes_length)
+    : base_type(std::move(buffer), logical_bytes_length)
+{
+}
+
+NALCHI_API bit_stream_writer::bit_stream_writer(std::span<word_type> buffer, size_type logical_bytes_length)
+    : base_type(buffer, logical_bytes_length)
+{
+}
+
+NALCHI_API bit_stream_writer::bit_stream_writer(word_type* begin, word_type* end, size_type logical_bytes_length)
+    : base_type(begin, end, logical_bytes_length)
+{
+}
+
+NALCHI_API bit_stream_writer::bit_stream_writer(word_type* begin, size_type words_length,
+                                                size_type logical_bytes_length)
+    : base_type(begin, words_length, logical_bytes_length)
+{
+}
+
+NALCHI_API auto bit_stream_writer::used_bytes() const -> size_type
+{
+    return base_type::used_bytes();
+}
+
+NALCHI_API void bit_stream_writer::restart()
+{
+    base_type::restart();
+}
+
+NALCHI_API void bit_stream_writer::reset()
+{
+    base_type::reset();
+}
+
+NALCHI_API void bit_stream_writer::reset_with(shared_payload buffer, size_type logical_bytes_length)
+{
+    base_type::reset_with(std::move(buffer), logical_bytes_length);
+}
+
+NALCHI_API void bit_stream_writer::reset_with(std::span<word_type> buffer, size_type logical_bytes_length)
+{
+    base_type::reset_with(buffer, logical_bytes_length);
+}
+
+NALCHI_API void bit_stream_writer::reset_with(word_type* begin, word_type* end, size_type logical_bytes_length)
+{
+    base_type::reset_with(begin, end, logical_bytes_length);
+}
+
+NALCHI_API void bit_stream_writer::reset_with(word_type* begin, size_type words_length,
+                                              size_type logical_bytes_length)
+{
+    base_type::reset_with(begin, words_length, logical_bytes_length);
+}
+
+NALCHI_API auto bit_stream_writer::flush_final() -> bit_stream_writer&
+{
+    return base_type::flush_final();
+}
+
+NALCHI_API auto bit_stream_writer::write(const void* data, size_type size) -> bit_stream_writer&
+{
+    return base_type::write(data, size);
+}
+
+NALCHI_API auto bit_stream_writer::write(float data) -> bit_stream_writer&
+{
+    return base_type::write(data);
+}
+
+NALCHI_API auto bit_stream_writer::write(double data) -> bit_stream_writer&
+{
+    return base_type::write(data);
+}
+
+NALCHI_API void bit_stream_writer::flush_if_scratch_overflow()
+{
+    base_type::flush_if_scratch_overflow();
+}
+
+NALCHI_API void bit_stream_writer::do_flush_word_unchecked()
+{
+    base_type::do_flush_word_unchecked();
+}
+
+NALCHI_API bit_stream_reader::bit_stream_reader() : base_type()
+{
+}
+
+NALCHI_API bit_stream_reader::bit_stream_reader(std::span<const word_type> buffer, size_type logical_bytes_length)
+    : base_type(buffer, logical_bytes_length)
+{
+}
+
+NALCHI_API bit_stream_reader::bit_stream_reader(const word_type* begin, const word_type* end,
+                                                size_type logical_bytes_length)
+    : base_type(begin, end, logical_bytes_length)
+{
+}
+
+NALCHI_API bit_stream_reader::bit_stream_reader(const word_type* begin, size_type words_length,
+                                                size_type logical_bytes_length)
+    : base_type(begin, words_length, logical_bytes_length)
+{
+}
+
+NALCHI_API auto bit_stream_reader::used_bytes() const -> size_type
+{
+    return base_type::used_bytes();
+}
+
+NALCHI_API void bit_stream_reader::restart()
+{
+    base_type::restart();
+}
+
+NALCHI_API void bit_stream_reader::reset()
+{
+    base_type::reset();
+}
+
+NALCHI_API void bit_stream_reader::reset_with(std::span<const word_type> buffer, size_type logical_bytes_length)
+{
+    base_type::reset_with(buffer, logical_bytes_length);
+}
+
+NALCHI_API void bit_stream_reader::reset_with(const word_type* begin, const word_type* end,
+                                              size_type logical_bytes_length)
+{
+    base_type::reset_with(begin, end, logical_bytes_length);
+}
+
+NALCHI_API void bit_stream_reader::reset_with(const word_type* begin, size_type words_length,
+                                              size_type logical_bytes_length)
+{
+    base_type::reset_with(begin, words_length, logical_bytes_length);
+}
+
+NALCHI_API auto bit_stream_reader::read(void* data, size_type size) -> bit_stream_reader&
+{
+    return base_type::read(data, size);
+}
+
+NALCHI_API auto bit_stream_reader::read(float& data) -> bit_stream_reader&
+{
+    return base_type::read(data);
+}
+
+NALCHI_API auto bit_stream_reader::read(double& data) -> bit_stream_reader&
+{
+    return base_type::read(data);
+}
+
+NALCHI_API auto bit_stream_reader::peek_string_length() -> ssize_type
+{
+    return base_type::peek_string_length();
+}
+
+NALCHI_API auto bit_stream_reader::read_string_length() -> ssize_type
+{
+    return base_type::read_string_length();
+}
+
+NALCHI_API void bit_stream_reader::do_fetch_word_unchecked()
+{
+    base_type::do_fetch_word_unchecked();
 }
 
 } // namespace nalchi
@@ -0,0 +1,101 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NALCHI_X86_64
+#endif
+
+#if defined(NALCHI_X86_64) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Functions using BMI2 or AVX2 intrinsics must be compiled for them,
+// but only called after checking `cpu_has_fast_bmi2()` or `cpu_has_avx2()`.
+#if defined(NALCHI_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define NALCHI_TARGET_BMI2 __attribute__((target("bmi2")))
+#define NALCHI_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NALCHI_TARGET_BMI2
+#define NALCHI_TARGET_AVX2
+#endif
+
+namespace nalchi
+{
+
+/// @brief Checks if the CPU supports BMI2 instructions, and `PDEP` & `PEXT` are fast on it.
+///
+/// AMD CPUs before Zen 3 support BMI2, but `PDEP` & `PEXT` are microcoded on them,
+/// which makes them much slower than the scalar fallback. \n
+/// So, they're treated as not supported.
+/// @return Whether fast `PDEP` & `PEXT` are available.
+inline bool cpu_has_fast_bmi2()
+{
+#if defined(NALCHI_X86_64)
+    static const bool result = []() -> bool {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+
+        __cpuid(info, 0);
+        const bool is_amd = (info[1] == 0x68747541 && info[3] == 0x69746E65 && info[2] == 0x444D4163);
+        if (info[0] < 7)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        const bool has_bmi2 = (info[1] & (1 << 8)) != 0;
+
+        __cpuid(info, 1);
+        const int base_family = (info[0] >> 8) & 0xF;
+        const int family = (base_family == 0xF) ? base_family + ((info[0] >> 20) & 0xFF) : base_family;
+
+        // Zen 3 is family 19h.
+        return has_bmi2 && (!is_amd || family >= 0x19);
+#else
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("bmi2"))
+            return false;
+
+        // Zen 1 & 2 are family 17h, and the older ones with BMI2 are family 15h.
+        return !__builtin_cpu_is("amdfam15h") && !__builtin_cpu_is("amdfam17h");
+#endif
+    }();
+
+    return result;
+#else
+    return false;
+#endif
+}
+
+/// @brief Checks if the CPU supports AVX2 instructions, and the OS saves the AVX registers.
+/// @return Whether AVX2 is available.
+inline bool cpu_has_avx2()
+{
+#if defined(NALCHI_X86_64)
+    static const bool result = []() -> bool {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // OS must have enabled saving the XMM & YMM registers.
+        __cpuid(info, 1);
+        const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+        if (!has_osxsave || (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        // This also checks if the OS saves the YMM registers.
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }();
+
+    return result;
+#else
+    return false;
+#endif
+}
+
+} // namespace nalchi
@@ -0,0 +1,228 @@
+#include "nalchi/huffman_codebook.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace nalchi
+{
+
+namespace
+{
+
+/// @brief Reverses the lower @p length bits of @p code, to convert it to the stream order.
+auto reverse_bits(std::uint32_t code, int length) -> std::uint16_t
+{
+    std::uint32_t result = 0;
+    for (int i = 0; i < length; ++i)
+        result |= ((code >> i) & 1) << (length - 1 - i);
+
+    return static_cast<std::uint16_t>(result);
+}
+
+/// @brief Gets the optimal code lengths for @p weights, which might exceed `huffman_codebook::MAX_CODE_LENGTH`.
+auto optimal_code_lengths(const std::array<std::uint64_t, huffman_codebook::SYMBOLS>& weights)
+    -> std::array<int, huffman_codebook::SYMBOLS>
+{
+    constexpr int SYMBOLS = huffman_codebook::SYMBOLS;
+
+    // Leaves are `[0, SYMBOLS)`, and the internal nodes follow them.
+    std::vector<int> parents(2 * SYMBOLS - 1, -1);
+
+    // Ties are broken by the node index, so that the result is the same on every platform.
+    using item = std::pair<std::uint64_t, int>;
+    std::priority_queue<item, std::vector<item>, std::greater<item>> queue;
+    for (int i = 0; i < SYMBOLS; ++i)
+        queue.emplace(weights[i], i);
+
+    for (int next = SYMBOLS; queue.size() > 1; ++next)
+    {
+        const item a = queue.top();
+        queue.pop();
+        const item b = queue.top();
+        queue.pop();
+
+        parents[a.second] = next;
+        parents[b.second] = next;
+        queue.emplace(a.first + b.first, next);
+    }
+
+    std::array<int, SYMBOLS> lengths;
+    for (int i = 0; i < SYMBOLS; ++i)
+    {
+        int length = 0;
+        for (int node = i; parents[node] != -1; node = parents[node])
+            ++length;
+        lengths[i] = length;
+    }
+
+    return lengths;
+}
+
+} // namespace
+
+huffman_codebook::huffman_codebook()
+{
+    _code_lengths.fill(8);
+    build();
+}
+
+huffman_codebook::huffman_codebook(std::span<const std::uint8_t, SYMBOLS> code_lengths)
+{
+    std::copy(code_lengths.begin(), code_lengths.end(), _code_lengths.begin());
+    build();
+}
+
+auto huffman_codebook::from_frequencies(std::span<const std::uint64_t, SYMBOLS> frequencies) -> huffman_codebook
+{
+    // Scale down the frequencies, so that their sum can't overflow.
+    const std::uint64_t max_frequency = *std::max_element(frequencies.begin(), frequencies.end());
+    const int shift = std::max(0, static_cast<int>(std::bit_width(max_frequency)) - 54);
+
+    // Every byte value gets at least a weight of 1, so that it has a code.
+    std::array<std::uint64_t, SYMBOLS> weights;
+    for (int i = 0; i < SYMBOLS; ++i)
+        weights[i] = std::max<std::uint64_t>(frequencies[i] >> shift, 1);
+
+    // Flatten the weights until the codes fit in `MAX_CODE_LENGTH`,
+    // which ends at the latest when every weight becomes 1.
+    std::array<int, SYMBOLS> lengths = optimal_code_lengths(weights);
+    while (*std::max_element(lengths.begin(), lengths.end()) > MAX_CODE_LENGTH)
+    {
+        for (auto& weight : weights)
+            weight = (weight >> 1) | 1;
+        lengths = optimal_code_lengths(weights);
+    }
+
+    std::array<std::uint8_t, SYMBOLS> code_lengths;
+    for (int i = 0; i < SYMBOLS; ++i)
+        code_lengths[i] = static_cast<std::uint8_t>(lengths[i]);
+
+    return huffman_codebook(code_lengths);
+}
+
+auto huffman_codebook::encoded_bits(const void* data, std::size_t size) const -> std::int64_t
+{
+    if (!_valid)
+        return -1;
+
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+
+    std::int64_t bits = 0;
+    bool missing = false;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const int length = _code_lengths[bytes[i]];
+        bits += length;
+        missing |= (length == 0);
+    }
+
+    return missing ? -1 : bits;
+}
+
+bool huffman_codebook::find_symbol(std::uint32_t code, int length, std::uint8_t& symbol) const
+{
+    if (length < 1 || length > MAX_CODE_LENGTH)
+        return false;
+
+    const std::uint32_t offset = code - _first_code[length];
+    if (offset >= _length_count[length])
+        return false;
+
+    symbol = _sorted_symbols[_first_index[length] + offset];
+    return true;
+}
+
+void huffman_codebook::build()
+{
+    _codes = {};
+    _lookup = {};
+    _first_code = {};
+    _first_index = {};
+    _length_count = {};
+    _sorted_symbols = {};
+    _min_code_length = 0;
+    _valid = false;
+
+    // Validate the lengths, and count them.
+    std::uint32_t kraft_sum = 0;
+    for (const std::uint8_t length : _code_lengths)
+    {
+        if (length > MAX_CODE_LENGTH)
+            return;
+        if (length > 0)
+        {
+            ++_length_count[length];
+            kraft_sum += std::uint32_t(1) << (MAX_CODE_LENGTH - length);
+        }
+    }
+
+    // Fail if there's no code, or the codes over-subscribe the code space.
+    if (kraft_sum == 0 || kraft_sum > (std::uint32_t(1) << MAX_CODE_LENGTH))
+        return;
+
+    // Assign the canonical codes, which are sequential in each length, ordered by the symbol.
+    std::uint32_t code = 0;
+    std::uint16_t index = 0;
+    for (int length = 1; length <= MAX_CODE_LENGTH; ++length)
+    {
+        code = (code + _length_count[length - 1]) << 1;
+        _first_code[length] = code;
+        _first_index[length] = index;
+        index = static_cast<std::uint16_t>(index + _length_count[length]);
+
+        if (_min_code_length == 0 && _length_count[length] > 0)
+            _min_code_length = length;
+    }
+
+    std::array<std::uint32_t, MAX_CODE_LENGTH + 1> next_code = _first_code;
+    std::array<std::uint16_t, MAX_CODE_LENGTH + 1> next_index = _first_index;
+    for (int symbol = 0; symbol < SYMBOLS; ++symbol)
+    {
+        const int length = _code_lengths[symbol];
+        if (length == 0)
+            continue;
+
+        _codes[symbol] = {reverse_bits(next_code[length]++, length), static_cast<std::uint8_t>(length)};
+        _sorted_symbols[next_index[length]++] = static_cast<std::uint8_t>(symbol);
+    }
+
+    // Fill the first symbol of every window, which is repeated for every bits after its code.
+    for (int symbol = 0; symbol < SYMBOLS; ++symbol)
+    {
+        const code_type& c = _codes[symbol];
+        if (c.length == 0 || c.length > LOOKUP_BITS)
+            continue;
+
+        for (std::uint32_t high = 0; high < (std::uint32_t(1) << (LOOKUP_BITS - c.length)); ++high)
+        {
+            lookup_entry& entry = _lookup[c.bits | (high << c.length)];
+            entry.symbols[0] = static_cast<std::uint8_t>(symbol);
+            entry.count = 1;
+            entry.bits = c.length;
+            entry.first_bits = c.length;
+        }
+    }
+
+    // Extend each window with the following symbols, as long as their codes are complete in the window.
+    for (std::uint32_t window = 0; window <= LOOKUP_MASK; ++window)
+    {
+        lookup_entry& entry = _lookup[window];
+        while (entry.count > 0 && entry.count < MAX_LOOKUP_SYMBOLS)
+        {
+            const lookup_entry& next = _lookup[window >> entry.bits];
+            if (next.count == 0 || entry.bits + next.first_bits > LOOKUP_BITS)
+                break;
+
+            entry.symbols[entry.count++] = next.symbols[0];
+            entry.bits = static_cast<std::uint8_t>(entry.bits + next.first_bits);
+        }
+    }
+
+    _valid = true;
+}
+
+} // namespace nalchi
@@ -0,0 +1,134 @@
+#include "payload_arena.hpp"
+
+#include "math.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace nalchi
+{
+
+namespace
+{
+
+// Size of the huge pages on x86-64 & AArch64 with 4 KiB base pages.
+constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/// @brief Reserved region, which is published once and never unmapped.
+struct arena_region
+{
+    std::byte* begin;
+    std::size_t size;
+    std::atomic<std::size_t> used;
+    shared_payload_arena_pages pages;
+};
+
+std::mutex g_init_mutex;
+std::atomic<arena_region*> g_region{nullptr};
+
+#if defined(__linux__)
+
+/// @brief Maps the region, trying huge pages first.
+/// @param size Bytes to map, which is a multiple of `HUGE_PAGE_SIZE`.
+/// @param out_pages Pages backing the mapped region.
+/// @return Mapped region, or `nullptr` if failed.
+auto map_region(std::size_t size, shared_payload_arena_pages& out_pages) -> std::byte*
+{
+    constexpr int PROT = PROT_READ | PROT_WRITE;
+
+    // Explicit huge pages, which only works if the admin reserved them (`vm.nr_hugepages`).
+    // This commits the huge pages right now, so it fails here instead of on page fault if there aren't enough.
+    void* region = mmap(nullptr, size, PROT, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (region != MAP_FAILED)
+    {
+        out_pages = shared_payload_arena_pages::huge;
+        return static_cast<std::byte*>(region);
+    }
+
+    // Otherwise, reserve normal pages aligned to the huge page size, so that transparent huge pages can back them.
+    // Over-reserve by a huge page and trim both ends to align the region.
+    const std::size_t padded_size = size + HUGE_PAGE_SIZE;
+    region = mmap(nullptr, padded_size, PROT, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (region == MAP_FAILED)
+        return nullptr;
+
+    std::byte* const padded = static_cast<std::byte*>(region);
+    std::byte* const aligned = reinterpret_cast<std::byte*>(
+        ceil_to_multiple_of<HUGE_PAGE_SIZE>(reinterpret_cast<std::uintptr_t>(padded)));
+
+    if (aligned != padded)
+        munmap(padded, static_cast<std::size_t>(aligned - padded));
+    if (const std::size_t tail = static_cast<std::size_t>(padded + padded_size - (aligned + size)); tail != 0)
+        munmap(aligned + size, tail);
+
+#if defined(MADV_HUGEPAGE)
+    if (madvise(aligned, size, MADV_HUGEPAGE) == 0)
+    {
+        out_pages = shared_payload_arena_pages::transparent_huge;
+        return aligned;
+    }
+#endif
+
+    out_pages = shared_payload_arena_pages::normal;
+    return aligned;
+}
+
+#endif
+
+} // namespace
+
+auto payload_arena::init(std::size_t reserve_bytes) -> shared_payload_arena_pages
+{
+    std::lock_guard lock(g_init_mutex);
+
+    if (const arena_region* const existing = g_region.load(std::memory_order_relaxed))
+        return existing->pages;
+
+#if defined(__linux__)
+    if (reserve_bytes == 0 || reserve_bytes > SIZE_MAX - 2 * HUGE_PAGE_SIZE)
+        return shared_payload_arena_pages::none;
+
+    const std::size_t size = ceil_to_multiple_of<HUGE_PAGE_SIZE>(reserve_bytes);
+
+    shared_payload_arena_pages pages;
+    std::byte* const begin = map_region(size, pages);
+    if (!begin)
+        return shared_payload_arena_pages::none;
+
+    // Never destroyed, as the slabs in the arena are used until the process exits.
+    arena_region* const region = new arena_region{begin, size, 0, pages};
+    g_region.store(region, std::memory_order_release);
+
+    return pages;
+#else
+    ((void)reserve_bytes);
+    return shared_payload_arena_pages::none;
+#endif
+}
+
+auto payload_arena::allocate(std::size_t bytes) -> void*
+{
+    arena_region* const region = g_region.load(std::memory_order_acquire);
+    if (!region)
+        return nullptr;
+
+    const std::size_t slab_bytes = ceil_to_multiple_of<SLAB_ALIGNMENT>(bytes);
+
+    // Bump the used bytes only if the slab fits, so that the smaller slabs can still use the rest.
+    std::size_t used = region->used.load(std::memory_order_relaxed);
+    do
+    {
+        if (region->size - used < slab_bytes)
+            return nullptr;
+    } while (!region->used.compare_exchange_weak(used, used + slab_bytes, std::memory_order_relaxed));
+
+    return region->begin + used;
+}
+
+} // namespace nalchi
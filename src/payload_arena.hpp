@@ -0,0 +1,32 @@
+#pragma once
+
+#include "nalchi/shared_payload.hpp"
+
+#include <cstddef>
+
+namespace nalchi
+{
+
+/// @brief Contiguous virtual memory reserved once, which the payload pool carves its slabs from.
+///
+/// Keeping the slabs in one region backed by huge pages cuts the TLB misses of touching many payloads,
+/// compared to the slabs scattered over the normal pages of the global heap. \n
+/// The arena is only supported on Linux, and is never unmapped until the process exits.
+class payload_arena
+{
+public:
+    /// @brief Alignment of the slabs, which is enough for `slab_header`.
+    static constexpr std::size_t SLAB_ALIGNMENT = alignof(std::max_align_t);
+
+    /// @brief Reserves the arena, if it's not reserved yet.
+    /// @param reserve_bytes Bytes to reserve, which is ceiled to the huge page size.
+    /// @return Pages backing the arena, which is the existing one's if already reserved.
+    static auto init(std::size_t reserve_bytes) -> shared_payload_arena_pages;
+
+    /// @brief Allocates a slab from the arena.
+    /// @param bytes Slab size in bytes.
+    /// @return Slab aligned to `SLAB_ALIGNMENT`, or `nullptr` if there's no arena or not enough space left.
+    static auto allocate(std::size_t bytes) -> void*;
+};
+
+} // namespace nalchi
@@ -0,0 +1,535 @@
+#include "payload_pool.hpp"
+
+#include "payload_arena.hpp"
+
+#include <steam/steamnetworkingtypes.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace nalchi
+{
+
+namespace
+{
+
+constexpr std::size_t GNS_MAX_MSG_SEND_SIZE = k_cbMaxSteamNetworkingSocketsMessageSizeSend;
+
+constexpr std::size_t SIZE_CLASSES = payload_pool::size_class_of(GNS_MAX_MSG_SEND_SIZE) + 1;
+
+static_assert(payload_pool::class_payload_size(SIZE_CLASSES - 1) >= GNS_MAX_MSG_SEND_SIZE);
+static_assert(payload_pool::HEADER_SIZE % payload_pool::BLOCK_ALIGNMENT == 0);
+
+static_assert(
+    [] {
+        for (std::size_t size_class = 0; size_class < SIZE_CLASSES; ++size_class)
+        {
+            const std::size_t size = payload_pool::class_payload_size(size_class);
+            const std::size_t prev_size = size_class ? payload_pool::class_payload_size(size_class - 1) : 0;
+
+            if (size % payload_pool::BLOCK_ALIGNMENT != 0 || payload_pool::size_class_of(size) != size_class ||
+                payload_pool::size_class_of(prev_size + 1) != size_class)
+                return false;
+        }
+        return true;
+    }(),
+    "Every size class should be word-ceiled, and cover the sizes right after the previous class");
+
+// Bytes of blocks a magazine holds at most, which bounds the memory each thread caches per size class.
+constexpr std::size_t MAGAZINE_BYTES = 64 * 1024;
+
+// Blocks a magazine holds at most, so that small size classes don't take too long to exchange.
+constexpr std::size_t MAGAZINE_MAX_BLOCKS = 256;
+
+// Bytes of blocks a slab has at least, so that small size classes don't hit the global heap too often.
+constexpr std::size_t SLAB_BYTES = 256 * 1024;
+
+// Blocks deallocated on a non-owning thread are returned to their owner at once, when this many are gathered.
+constexpr std::size_t REMOTE_BATCH_BLOCKS = 64;
+
+// Bytes of blocks a remote batch holds at most, which bounds the memory held back from the owner
+// by a thread that stops deallocating, e.g. an idle GameNetworkingSockets' service thread.
+constexpr std::size_t REMOTE_BATCH_BYTES = 64 * 1024;
+
+struct owner;
+
+/// @brief Pool-private prefix of a block, which is on front of the hidden fields of `shared_payload`.
+struct alignas(payload_pool::BLOCK_ALIGNMENT) block_prefix
+{
+    /// @brief Pool of the thread that allocated the block, or `nullptr` if there's none.
+    owner* block_owner;
+};
+
+constexpr std::size_t PREFIX_SIZE = sizeof(block_prefix);
+
+constexpr auto block_size(std::size_t size_class) -> std::size_t
+{
+    return PREFIX_SIZE + payload_pool::HEADER_SIZE + payload_pool::class_payload_size(size_class);
+}
+
+// Precomputed, as the deallocation checks it every time.
+constexpr auto MAGAZINE_CAPACITIES = [] {
+    std::array<std::size_t, SIZE_CLASSES> capacities{};
+    for (std::size_t size_class = 0; size_class < SIZE_CLASSES; ++size_class)
+    {
+        const std::size_t blocks = MAGAZINE_BYTES / block_size(size_class);
+        capacities[size_class] = std::clamp<std::size_t>(blocks, 1, MAGAZINE_MAX_BLOCKS);
+    }
+    return capacities;
+}();
+
+constexpr auto magazine_capacity(std::size_t size_class) -> std::size_t
+{
+    return MAGAZINE_CAPACITIES[size_class];
+}
+
+constexpr auto slab_blocks(std::size_t size_class) -> std::size_t
+{
+    return std::max(magazine_capacity(size_class), SLAB_BYTES / block_size(size_class));
+}
+
+/// @brief Free block, whose first bytes are reused as a link to the next free block.
+struct free_block
+{
+    free_block* next;
+
+    /// @brief Size class of the block, which is only set while it's returned to its owner.
+    std::uint32_t size_class;
+};
+
+static_assert(sizeof(free_block) <= PREFIX_SIZE + payload_pool::HEADER_SIZE + payload_pool::LINEAR_STEP);
+
+/// @brief Singly linked list of free blocks of a size class.
+struct magazine
+{
+    free_block* head = nullptr;
+    free_block* tail = nullptr;
+    std::size_t count = 0;
+
+    void push(void* block)
+    {
+        free_block* const node = static_cast<free_block*>(block);
+
+        node->next = head;
+        if (!head)
+            tail = node;
+        head = node;
+        ++count;
+    }
+
+    auto pop() -> void*
+    {
+        free_block* const node = head;
+
+        head = node->next;
+        if (!head)
+            tail = nullptr;
+        --count;
+
+        return node;
+    }
+
+    /// @brief Moves all the blocks of @p other to the front of this, without walking them.
+    void splice(magazine& other)
+    {
+        if (other.count == 0)
+            return;
+
+        other.tail->next = head;
+        if (!head)
+            tail = other.tail;
+        head = other.head;
+        count += other.count;
+
+        other = magazine{};
+    }
+};
+
+/// @brief Header on front of a slab, which links all the slabs of a size class.
+struct alignas(std::max_align_t) slab_header
+{
+    slab_header* next;
+};
+
+static_assert(sizeof(slab_header) % payload_pool::BLOCK_ALIGNMENT == 0);
+
+/// @brief Global free blocks of a size class, shared by all threads.
+class depot
+{
+public:
+    /// @brief Takes up to @p count blocks, carving a new slab if there's not enough free blocks.
+    /// @param size_class Index of the size class of this depot.
+    /// @param count Number of blocks to take.
+    /// @return Blocks taken, which is empty only if out of memory.
+    auto take(std::size_t size_class, std::size_t count) -> magazine
+    {
+        magazine result;
+
+        std::lock_guard lock(_mutex);
+
+        while (result.count < count && _free.count != 0)
+            result.push(_free.pop());
+
+        while (result.count < count)
+        {
+            if (_carve_cursor == _carve_end && !add_slab(size_class))
+                break;
+
+            result.push(_carve_cursor);
+            _carve_cursor += block_size(size_class);
+        }
+
+        return result;
+    }
+
+    /// @brief Puts back all the blocks of @p blocks.
+    /// @param blocks Blocks to put back, which becomes empty.
+    void put(magazine& blocks)
+    {
+        if (blocks.count == 0)
+            return;
+
+        std::lock_guard lock(_mutex);
+
+        _free.splice(blocks);
+    }
+
+private:
+    bool add_slab(std::size_t size_class)
+    {
+        const std::size_t bytes = sizeof(slab_header) + slab_blocks(size_class) * block_size(size_class);
+
+        // Carve from the arena if reserved, falling back to the global heap once it runs out.
+        // Both are already sufficiently aligned for the slab header.
+        static_assert(payload_arena::SLAB_ALIGNMENT >= alignof(slab_header));
+        void* space = payload_arena::allocate(bytes);
+        if (!space)
+            space = std::malloc(bytes);
+        if (!space)
+            return false;
+
+        slab_header* const slab = static_cast<slab_header*>(space);
+
+        // Keep the slabs linked, so that they're never reported as leaked.
+        slab->next = _slabs;
+        _slabs = slab;
+
+        _carve_cursor = reinterpret_cast<std::byte*>(slab) + sizeof(slab_header);
+        _carve_end = reinterpret_cast<std::byte*>(slab) + bytes;
+
+        return true;
+    }
+
+private:
+    std::mutex _mutex;
+    magazine _free;
+    slab_header* _slabs = nullptr;
+    std::byte* _carve_cursor = nullptr;
+    std::byte* _carve_end = nullptr;
+};
+
+/// @brief Gets the depots of all size classes.
+auto depots() -> std::array<depot, SIZE_CLASSES>&
+{
+    // Never destroyed, as payloads can be deallocated after the static destructors,
+    // e.g. when GameNetworkingSockets is killed at exit.
+    static auto* const instance = new std::array<depot, SIZE_CLASSES>;
+
+    return *instance;
+}
+
+/// @brief Pool of a thread, which the other threads return its blocks to.
+///
+/// Never destroyed, as its blocks can be returned even after its thread exits. \n
+/// A retired one is reused by a new thread, which takes over the blocks returned to it.
+struct owner
+{
+    /// @brief Blocks returned by the other threads.
+    ///
+    /// Any thread pushes a chain of blocks with a CAS, and the owning thread takes all of them with an exchange,
+    /// so there's no ABA problem.
+    std::atomic<free_block*> remote_frees{nullptr};
+
+    /// @brief Next retired owner, while retired.
+    owner* next_retired = nullptr;
+};
+
+/// @brief Retired owners, waiting to be reused by a new thread.
+class owner_registry
+{
+public:
+    /// @brief Gets an owner for a new thread.
+    /// @return Retired owner if any, or a new one. \n
+    /// If out of memory, `nullptr`, which makes the blocks not returned to the allocating thread.
+    auto acquire() -> owner*
+    {
+        std::lock_guard lock(_mutex);
+
+        if (owner* const reused = _retired)
+        {
+            _retired = reused->next_retired;
+            return reused;
+        }
+
+        return new (std::nothrow) owner;
+    }
+
+    /// @brief Retires the owner of an exiting thread.
+    void retire(owner* retiring)
+    {
+        std::lock_guard lock(_mutex);
+
+        retiring->next_retired = _retired;
+        _retired = retiring;
+    }
+
+private:
+    std::mutex _mutex;
+    owner* _retired = nullptr;
+};
+
+auto owners() -> owner_registry&
+{
+    // Never destroyed, same as the depots.
+    static auto* const instance = new owner_registry;
+
+    return *instance;
+}
+
+/// @brief Blocks to return to an owner at once.
+struct remote_batch
+{
+    owner* target = nullptr;
+    free_block* head = nullptr;
+    free_block* tail = nullptr;
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+};
+
+/// @brief Free blocks of a size class cached by a thread.
+///
+/// `previous` is always either full or empty, so a whole magazine is exchanged with the depot at once,
+/// and a thread alternating allocation & deallocation on the boundary doesn't thrash the depot.
+struct class_cache
+{
+    magazine loaded;
+    magazine previous;
+};
+
+/// @brief Free blocks cached by a thread, which are put back to the depots on the thread exit.
+///
+/// Blocks allocated by this thread are cached here again when deallocated, wherever they're deallocated. \n
+/// The other threads (e.g. GameNetworkingSockets' service thread) return them in batches,
+/// to the lock-free remote free list of this thread's `owner`, which is taken all at once on a cache miss.
+class thread_cache
+{
+public:
+    ~thread_cache();
+
+    auto allocate(std::size_t size_class) -> void*
+    {
+        class_cache& cache = _classes[size_class];
+
+        if (cache.loaded.count == 0 && !refill(size_class)) [[unlikely]]
+            return nullptr;
+
+        void* const block = cache.loaded.pop();
+        static_cast<block_prefix*>(block)->block_owner = _owner;
+
+        return block;
+    }
+
+    void deallocate(void* block, std::size_t size_class)
+    {
+        owner* const block_owner = static_cast<block_prefix*>(block)->block_owner;
+
+        // Blocks without an owner are cached by any thread.
+        if (block_owner == _owner || !block_owner) [[likely]]
+            deallocate_local(block, size_class);
+        else
+            deallocate_remote(block_owner, block, size_class);
+    }
+
+    /// @brief Returns the gathered blocks to their owner, with a single CAS.
+    void flush_remote()
+    {
+        if (_remote.count == 0)
+            return;
+
+        std::atomic<free_block*>& remote_frees = _remote.target->remote_frees;
+
+        // Release the block contents written by this thread to the owner.
+        free_block* head = remote_frees.load(std::memory_order_relaxed);
+        do
+            _remote.tail->next = head;
+        while (!remote_frees.compare_exchange_weak(head, _remote.head, std::memory_order_release,
+                                                   std::memory_order_relaxed));
+
+        _remote = remote_batch{};
+    }
+
+private:
+    void deallocate_local(void* block, std::size_t size_class)
+    {
+        class_cache& cache = _classes[size_class];
+
+        if (cache.loaded.count == magazine_capacity(size_class)) [[unlikely]]
+        {
+            // Put back the full `previous` if any, then the full `loaded` becomes the `previous`.
+            depots()[size_class].put(cache.previous);
+            cache.previous = std::exchange(cache.loaded, magazine{});
+        }
+
+        cache.loaded.push(block);
+    }
+
+    void deallocate_remote(owner* block_owner, void* block, std::size_t size_class)
+    {
+        if (_remote.target != block_owner)
+        {
+            flush_remote();
+            _remote.target = block_owner;
+        }
+
+        free_block* const node = static_cast<free_block*>(block);
+        node->next = _remote.head;
+        node->size_class = static_cast<std::uint32_t>(size_class);
+        if (!_remote.head)
+            _remote.tail = node;
+        _remote.head = node;
+        ++_remote.count;
+        _remote.bytes += block_size(size_class);
+
+        // Don't hold back a partial batch when the owner has taken all the returned blocks,
+        // as it would go to the depot on its next cache miss.
+        if (_remote.count == REMOTE_BATCH_BLOCKS || _remote.bytes >= REMOTE_BATCH_BYTES ||
+            !_remote.target->remote_frees.load(std::memory_order_relaxed))
+            flush_remote();
+    }
+
+    /// @brief Takes all the blocks returned by the other threads into the cache.
+    /// @return Whether any block was returned.
+    bool drain_remote()
+    {
+        // Check without a RMW first, as the cache line is shared with the returning threads.
+        if (!_owner || !_owner->remote_frees.load(std::memory_order_relaxed))
+            return false;
+
+        free_block* node = _owner->remote_frees.exchange(nullptr, std::memory_order_acquire);
+        while (node)
+        {
+            free_block* const next = node->next;
+            deallocate_local(node, node->size_class);
+            node = next;
+        }
+
+        return true;
+    }
+
+    /// @brief Refills the empty `loaded` magazine of the size class.
+    /// @return Whether it's refilled, which is `false` only if out of memory.
+    bool refill(std::size_t size_class)
+    {
+        class_cache& cache = _classes[size_class];
+
+        // The first allocation of this thread always comes here.
+        if (!_owner) [[unlikely]]
+            _owner = owners().acquire();
+
+        if (cache.previous.count == 0 && drain_remote() && cache.loaded.count != 0)
+            return true;
+
+        if (cache.previous.count != 0)
+            std::swap(cache.loaded, cache.previous);
+        else
+            cache.loaded = depots()[size_class].take(size_class, magazine_capacity(size_class));
+
+        return cache.loaded.count != 0;
+    }
+
+private:
+    std::array<class_cache, SIZE_CLASSES> _classes;
+    owner* _owner = nullptr;
+    remote_batch _remote;
+};
+
+thread_local thread_cache t_cache;
+
+// Blocks deallocated after the `t_cache` destructor go directly to the depots.
+thread_local constinit bool t_cache_destroyed = false;
+
+thread_cache::~thread_cache()
+{
+    flush_remote();
+    drain_remote();
+
+    for (std::size_t size_class = 0; size_class < SIZE_CLASSES; ++size_class)
+    {
+        depots()[size_class].put(_classes[size_class].loaded);
+        depots()[size_class].put(_classes[size_class].previous);
+    }
+
+    // Blocks returned from now on are taken over by the next thread reusing this owner.
+    if (_owner)
+        owners().retire(_owner);
+
+    t_cache_destroyed = true;
+}
+
+} // namespace
+
+auto payload_pool::allocate(std::size_t payload_size) -> void*
+{
+    const std::size_t size_class = size_class_of(payload_size);
+
+    void* block;
+    if (t_cache_destroyed) [[unlikely]]
+    {
+        magazine blocks = depots()[size_class].take(size_class, 1);
+        if (blocks.count == 0)
+            return nullptr;
+
+        block = blocks.pop();
+        static_cast<block_prefix*>(block)->block_owner = nullptr;
+    }
+    else
+    {
+        block = t_cache.allocate(size_class);
+        if (!block) [[unlikely]]
+            return nullptr;
+    }
+
+    return static_cast<std::byte*>(block) + PREFIX_SIZE;
+}
+
+void payload_pool::flush_remote_frees()
+{
+    if (!t_cache_destroyed)
+        t_cache.flush_remote();
+}
+
+void payload_pool::deallocate(void* block, std::size_t payload_size)
+{
+    const std::size_t size_class = size_class_of(payload_size);
+
+    void* const prefixed_block = static_cast<std::byte*>(block) - PREFIX_SIZE;
+
+    if (t_cache_destroyed) [[unlikely]]
+    {
+        magazine blocks;
+        blocks.push(prefixed_block);
+        depots()[size_class].put(blocks);
+        return;
+    }
+
+    t_cache.deallocate(prefixed_block, size_class);
+}
+
+} // namespace nalchi
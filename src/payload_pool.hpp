@@ -0,0 +1,101 @@
+#pragma once
+
+#include "nalchi/shared_payload.hpp"
+
+#include <bit>
+#include <cstddef>
+
+namespace nalchi
+{
+
+/// @brief Size-class slab pool that `shared_payload::allocate()` allocates from.
+///
+/// Blocks are grouped into word-ceiled size classes: every 8 bytes up to 64 bytes,
+/// then 4 classes per doubling up to the GameNetworkingSockets' max send size. \n
+/// Each thread caches free blocks of each class in 2 magazines, so most allocations and deallocations
+/// don't touch any lock nor the global heap. \n
+/// Magazines are exchanged with the global depot of the class only when both are full or empty,
+/// and the depot carves new slabs from the arena (if reserved) or the global heap when it runs out. \n
+/// Blocks deallocated on another thread (e.g. GameNetworkingSockets' service thread) are returned to
+/// the allocating thread in batches of up to 64 blocks or 64 KiB, through its lock-free remote free list. \n
+/// A partial batch is returned early when the allocating thread has taken all the returned blocks,
+/// or when `flush_remote_frees()` is called. \n
+/// Pooled memory is kept for reuse until the process exits.
+class payload_pool
+{
+public:
+    /// @brief Size of the hidden ref count & size fields in front of the payload.
+    static constexpr std::size_t HEADER_SIZE =
+        sizeof(shared_payload::ref_count_t) + sizeof(shared_payload::alloc_size_t);
+
+    /// @brief Alignment of the blocks.
+    static constexpr std::size_t BLOCK_ALIGNMENT = 8;
+
+    /// @brief Largest payload in the first (linear) part of the size classes.
+    static constexpr std::size_t LINEAR_MAX_SIZE = 64;
+
+    /// @brief Step between the size classes in the linear part.
+    static constexpr std::size_t LINEAR_STEP = 8;
+
+    /// @brief Number of size classes per doubling, after the linear part.
+    static constexpr std::size_t CLASSES_PER_DOUBLING = 4;
+
+    /// @brief Gets the size class of the payload.
+    /// @param payload_size Payload size, which must be in `[1, GNS max send size]`.
+    /// @return Index of the size class.
+    static constexpr auto size_class_of(std::size_t payload_size) -> std::size_t
+    {
+        if (payload_size <= LINEAR_MAX_SIZE)
+            return (payload_size - 1) / LINEAR_STEP;
+
+        // `2^exp < payload_size <= 2^(exp + 1)`, and the step between the classes is `2^(exp - STEP_SHIFT)`.
+        const int exp = std::bit_width(payload_size - 1) - 1;
+
+        return LINEAR_MAX_SIZE / LINEAR_STEP + (exp - LINEAR_EXP) * CLASSES_PER_DOUBLING +
+               ((payload_size - 1 - (std::size_t(1) << exp)) >> (exp - STEP_SHIFT));
+    }
+
+    /// @brief Gets the biggest payload size of the size class.
+    /// @param size_class Index of the size class.
+    /// @return Payload size in bytes, which is a multiple of 8.
+    static constexpr auto class_payload_size(std::size_t size_class) -> std::size_t
+    {
+        if (size_class < LINEAR_MAX_SIZE / LINEAR_STEP)
+            return (size_class + 1) * LINEAR_STEP;
+
+        const std::size_t index = size_class - LINEAR_MAX_SIZE / LINEAR_STEP;
+        const int exp = LINEAR_EXP + static_cast<int>(index / CLASSES_PER_DOUBLING);
+        const std::size_t step = (std::size_t(1) << exp) / CLASSES_PER_DOUBLING;
+
+        return (std::size_t(1) << exp) + (index % CLASSES_PER_DOUBLING + 1) * step;
+    }
+
+public:
+    /// @brief Allocates a block for the payload from the pool.
+    /// @param payload_size Word-ceiled payload size, which must be in `[1, GNS max send size]`.
+    /// @return Block of at least `HEADER_SIZE + payload_size` bytes, or `nullptr` if out of memory.
+    static auto allocate(std::size_t payload_size) -> void*;
+
+    /// @brief Returns the block to the pool.
+    /// @param block Block allocated with `allocate()`.
+    /// @param payload_size Word-ceiled payload size, same as the one passed to `allocate()`.
+    static void deallocate(void* block, std::size_t payload_size);
+
+    /// @brief Returns the blocks this thread deallocated for the other threads right away,
+    /// without waiting for a full batch.
+    static void flush_remote_frees();
+
+private:
+    /// @brief `2^LINEAR_EXP == LINEAR_MAX_SIZE`
+    static constexpr int LINEAR_EXP = std::bit_width(LINEAR_MAX_SIZE) - 1;
+
+    /// @brief `2^STEP_SHIFT == CLASSES_PER_DOUBLING`
+    static constexpr int STEP_SHIFT = std::bit_width(CLASSES_PER_DOUBLING) - 1;
+
+    static_assert(std::has_single_bit(LINEAR_MAX_SIZE));
+    static_assert(std::has_single_bit(CLASSES_PER_DOUBLING));
+    static_assert(LINEAR_MAX_SIZE / CLASSES_PER_DOUBLING % LINEAR_STEP == 0,
+                  "Size classes after the linear part should be word-ceiled");
+};
+
+} // namespace nalchi
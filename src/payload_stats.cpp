@@ -0,0 +1,258 @@
+#include "payload_stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace nalchi
+{
+
+namespace
+{
+
+constexpr std::size_t BUCKETS = shared_payload_stats::SIZE_HISTOGRAM_BUCKETS;
+
+// Each thread publishes its live bytes to the global sum for the peak,
+// only after it changed by this much.
+constexpr std::int64_t PEAK_FLUSH_BYTES = 64 * 1024;
+
+/// @brief Gets the histogram bucket of the requested size, which is `ceil(log2(size))`.
+constexpr auto bucket_of(std::size_t size) -> std::size_t
+{
+    return std::min<std::size_t>(std::bit_width(size - 1), BUCKETS - 1);
+}
+
+static_assert(bucket_of(1) == 0 && bucket_of(2) == 1 && bucket_of(3) == 2 && bucket_of(4) == 2);
+static_assert(bucket_of(512 * 1024) == 19 && bucket_of(512 * 1024 + 1) == BUCKETS - 1);
+
+/// @brief Counters written only by their thread, without any RMW.
+///
+/// They're still atomics, as `payload_stats::collect()` reads them from another thread.
+struct thread_counters
+{
+    std::atomic<std::uint64_t> allocations;
+    std::atomic<std::uint64_t> failed_allocations;
+    std::atomic<std::uint64_t> deallocations;
+    std::atomic<std::uint64_t> allocated_bytes;
+    std::atomic<std::uint64_t> deallocated_bytes;
+    std::array<std::atomic<std::uint64_t>, BUCKETS> size_histogram;
+
+    // Live bytes changed since the last flush to `registry::live_bytes`, which only this thread accesses.
+    std::int64_t unflushed_bytes;
+};
+
+/// @brief Increments the counter written only by this thread.
+void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/// @brief Sums of the `thread_counters`.
+struct counter_sums
+{
+    std::uint64_t allocations = 0;
+    std::uint64_t failed_allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t allocated_bytes = 0;
+    std::uint64_t deallocated_bytes = 0;
+    std::array<std::uint64_t, BUCKETS> size_histogram{};
+
+    void add(const thread_counters& counters)
+    {
+        allocations += counters.allocations.load(std::memory_order_relaxed);
+        failed_allocations += counters.failed_allocations.load(std::memory_order_relaxed);
+        deallocations += counters.deallocations.load(std::memory_order_relaxed);
+        allocated_bytes += counters.allocated_bytes.load(std::memory_order_relaxed);
+        deallocated_bytes += counters.deallocated_bytes.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < BUCKETS; ++i)
+            size_histogram[i] += counters.size_histogram[i].load(std::memory_order_relaxed);
+    }
+};
+
+/// @brief Counters of all threads, including the ones already exited.
+struct registry
+{
+    std::mutex mutex;
+    std::vector<thread_counters*> threads;
+
+    // Counters of the exited threads, or the ones counted during the thread exit.
+    counter_sums exited;
+
+    // Approximate sum of live bytes, which is off by up to `PEAK_FLUSH_BYTES` per thread in either direction,
+    // as the unflushed bytes of a thread can be either positive or negative.
+    // So the peak can also be either under or over the exact one.
+    std::atomic<std::int64_t> live_bytes{0};
+    std::atomic<std::uint64_t> peak_live_bytes{0};
+
+    void update_peak(std::uint64_t live)
+    {
+        std::uint64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+        while (peak < live && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            ;
+    }
+
+    void flush(thread_counters& counters)
+    {
+        const std::int64_t live =
+            live_bytes.fetch_add(counters.unflushed_bytes, std::memory_order_relaxed) + counters.unflushed_bytes;
+        counters.unflushed_bytes = 0;
+
+        update_peak(static_cast<std::uint64_t>(std::max<std::int64_t>(live, 0)));
+    }
+};
+
+/// @brief Gets the registry, which is never destroyed,
+/// as payloads can be deallocated during the static destruction.
+auto stats_registry() -> registry&
+{
+    static registry* const instance = new registry;
+    return *instance;
+}
+
+/// @brief Registers the counters of this thread on first use, and unregisters them on thread exit.
+class thread_counters_handle
+{
+public:
+    ~thread_counters_handle();
+
+    auto get() -> thread_counters&
+    {
+        if (!_counters) [[unlikely]]
+        {
+            _counters = new thread_counters{};
+
+            registry& reg = stats_registry();
+            std::lock_guard lock(reg.mutex);
+            reg.threads.push_back(_counters);
+        }
+        return *_counters;
+    }
+
+private:
+    thread_counters* _counters = nullptr;
+};
+
+thread_local thread_counters_handle t_counters;
+
+// Set once `t_counters` is destroyed, after which the counts go directly to `registry::exited`.
+thread_local constinit bool t_counters_destroyed = false;
+
+thread_counters_handle::~thread_counters_handle()
+{
+    t_counters_destroyed = true;
+
+    if (!_counters)
+        return;
+
+    registry& reg = stats_registry();
+    reg.flush(*_counters);
+
+    std::lock_guard lock(reg.mutex);
+    reg.exited.add(*_counters);
+    std::erase(reg.threads, _counters);
+
+    delete _counters;
+}
+
+/// @brief Counts on `registry::exited`, for the threads whose counters are already gone.
+template <typename Count>
+void count_exited(Count count)
+{
+    registry& reg = stats_registry();
+
+    thread_counters counters{};
+    count(counters);
+    reg.flush(counters);
+
+    std::lock_guard lock(reg.mutex);
+    reg.exited.add(counters);
+}
+
+void count_allocate(thread_counters& counters, std::size_t size)
+{
+    bump(counters.allocations);
+    bump(counters.allocated_bytes, size);
+    bump(counters.size_histogram[bucket_of(size)]);
+
+    counters.unflushed_bytes += static_cast<std::int64_t>(size);
+}
+
+void count_deallocate(thread_counters& counters, std::size_t size)
+{
+    bump(counters.deallocations);
+    bump(counters.deallocated_bytes, size);
+
+    counters.unflushed_bytes -= static_cast<std::int64_t>(size);
+}
+
+} // namespace
+
+void payload_stats::on_allocate(std::size_t size)
+{
+    if (t_counters_destroyed) [[unlikely]]
+        return count_exited([size](thread_counters& counters) { count_allocate(counters, size); });
+
+    thread_counters& counters = t_counters.get();
+    count_allocate(counters, size);
+
+    if (counters.unflushed_bytes >= PEAK_FLUSH_BYTES)
+        stats_registry().flush(counters);
+}
+
+void payload_stats::on_allocate_fail()
+{
+    if (t_counters_destroyed) [[unlikely]]
+        return count_exited([](thread_counters& counters) { bump(counters.failed_allocations); });
+
+    bump(t_counters.get().failed_allocations);
+}
+
+void payload_stats::on_deallocate(std::size_t size)
+{
+    if (t_counters_destroyed) [[unlikely]]
+        return count_exited([size](thread_counters& counters) { count_deallocate(counters, size); });
+
+    thread_counters& counters = t_counters.get();
+    count_deallocate(counters, size);
+
+    if (counters.unflushed_bytes <= -PEAK_FLUSH_BYTES)
+        stats_registry().flush(counters);
+}
+
+auto payload_stats::collect() -> shared_payload_stats
+{
+    registry& reg = stats_registry();
+
+    counter_sums sums;
+    {
+        std::lock_guard lock(reg.mutex);
+
+        sums = reg.exited;
+        for (const thread_counters* counters : reg.threads)
+            sums.add(*counters);
+    }
+
+    shared_payload_stats stats{};
+    stats.allocations = sums.allocations;
+    stats.failed_allocations = sums.failed_allocations;
+    stats.deallocations = sums.deallocations;
+    std::copy(sums.size_histogram.begin(), sums.size_histogram.end(), stats.size_histogram);
+
+    // Counters of the threads are read one by one, so a payload deallocated on another thread
+    // might be counted before its allocation is.
+    stats.live_payloads = (sums.allocations > sums.deallocations) ? sums.allocations - sums.deallocations : 0;
+    stats.live_bytes =
+        (sums.allocated_bytes > sums.deallocated_bytes) ? sums.allocated_bytes - sums.deallocated_bytes : 0;
+
+    reg.update_peak(stats.live_bytes);
+    stats.peak_live_bytes = reg.peak_live_bytes.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+} // namespace nalchi
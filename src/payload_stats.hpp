@@ -0,0 +1,48 @@
+#pragma once
+
+#include "nalchi/shared_payload.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace nalchi
+{
+
+/// @brief Per-thread counters of `shared_payload` allocations, which are summed on `collect()`.
+///
+/// Each thread only writes to its own counters without any RMW, so counting doesn't bounce cache lines
+/// between the allocating threads and GameNetworkingSockets' service thread.
+class payload_stats
+{
+public:
+    /// @brief Checks if new allocations should be counted.
+    static bool enabled() noexcept
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Sets if new allocations should be counted.
+    static void set_enabled(bool enabled) noexcept
+    {
+        _enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    /// @brief Counts an allocation.
+    /// @param size Requested payload size.
+    static void on_allocate(std::size_t size);
+
+    /// @brief Counts a failed allocation.
+    static void on_allocate_fail();
+
+    /// @brief Counts a deallocation of a payload whose allocation was counted.
+    /// @param size Requested payload size.
+    static void on_deallocate(std::size_t size);
+
+    /// @brief Sums the counters of all threads.
+    static auto collect() -> shared_payload_stats;
+
+private:
+    static inline std::atomic<bool> _enabled{false};
+};
+
+} // namespace nalchi
@@ -0,0 +1,269 @@
+#include "nalchi/range_coder.hpp"
+
+#include <algorithm>
+
+namespace nalchi
+{
+
+namespace
+{
+
+/// @brief The range is renormalized by a byte when it drops below this.
+constexpr std::uint32_t RANGE_TOP = std::uint32_t(1) << 24;
+
+constexpr std::uint32_t PROBABILITY_ONE = std::uint32_t(1) << adaptive_bit_model::PROBABILITY_BITS;
+
+/// @brief Checks if @p stream has failed, which is never for `bit_stream_measurer`.
+template <typename Stream>
+bool stream_failed(const Stream& stream)
+{
+    if constexpr (requires { stream.fail(); })
+        return stream.fail();
+    else
+        return false;
+}
+
+} // namespace
+
+template <typename Stream>
+range_coder_writer<Stream>::range_coder_writer(Stream& stream) : _stream(stream)
+{
+}
+
+template <typename Stream>
+auto range_coder_writer<Stream>::write_bit(adaptive_bit_model& model, bool bit) -> range_coder_writer&
+{
+    if (_flushed)
+    {
+        _fail = true;
+        return *this;
+    }
+
+    const std::uint32_t bound = (_range >> adaptive_bit_model::PROBABILITY_BITS) * model.probability_of_zero;
+    if (!bit)
+    {
+        _range = bound;
+        model.probability_of_zero += static_cast<std::uint16_t>((PROBABILITY_ONE - model.probability_of_zero) >>
+                                                                adaptive_bit_model::ADAPTATION_SHIFT);
+    }
+    else
+    {
+        _low += bound;
+        _range -= bound;
+        model.probability_of_zero -= static_cast<std::uint16_t>(model.probability_of_zero >>
+                                                                adaptive_bit_model::ADAPTATION_SHIFT);
+    }
+    normalize();
+
+    return *this;
+}
+
+template <typename Stream>
+auto range_coder_writer<Stream>::write_raw_bits(std::uint32_t value, int bits) -> range_coder_writer&
+{
+    if (_flushed || bits < 1 || bits > 32)
+    {
+        _fail = true;
+        return *this;
+    }
+
+    for (int i = bits - 1; i >= 0; --i)
+    {
+        _range >>= 1;
+        if ((value >> i) & 1)
+            _low += _range;
+        normalize();
+    }
+
+    return *this;
+}
+
+template <typename Stream>
+bool range_coder_writer<Stream>::flush()
+{
+    if (!_flushed)
+    {
+        // Push every byte of `_low` out, so that the reader can fill its code with them.
+        for (int i = 0; i < 5; ++i)
+            shift_low();
+        _flushed = true;
+    }
+
+    return !fail();
+}
+
+template <typename Stream>
+bool range_coder_writer<Stream>::fail() const
+{
+    return _fail || stream_failed(_stream);
+}
+
+template <typename Stream>
+void range_coder_writer<Stream>::encode(std::uint32_t cumulative, std::uint32_t frequency, std::uint32_t total)
+{
+    if (_flushed)
+    {
+        _fail = true;
+        return;
+    }
+
+    // The last symbol takes the remainder of the division, instead of wasting it.
+    const std::uint32_t scale = _range / total;
+    _low += static_cast<std::uint64_t>(scale) * cumulative;
+    _range = (cumulative + frequency < total) ? scale * frequency : _range - scale * cumulative;
+    normalize();
+}
+
+template <typename Stream>
+void range_coder_writer<Stream>::normalize()
+{
+    while (_range < RANGE_TOP)
+    {
+        _range <<= 8;
+        shift_low();
+    }
+}
+
+template <typename Stream>
+void range_coder_writer<Stream>::shift_low()
+{
+    // The top byte can be written only if it's not `0xFF`, which a later carry might overflow,
+    // or the carry has already happened.
+    if (static_cast<std::uint32_t>(_low) < 0xFF00'0000 || (_low >> 32) != 0)
+    {
+        const auto carry = static_cast<std::uint8_t>(_low >> 32);
+
+        write_byte(static_cast<std::uint8_t>(_cache + carry));
+        for (; _cache_size > 1; --_cache_size)
+            write_byte(static_cast<std::uint8_t>(0xFF + carry));
+
+        _cache_size = 0;
+        _cache = static_cast<std::uint8_t>(_low >> 24);
+    }
+
+    ++_cache_size;
+    _low = (_low & 0x00FF'FFFF) << 8;
+}
+
+template <typename Stream>
+void range_coder_writer<Stream>::write_byte(std::uint8_t byte)
+{
+    if (_leading_byte)
+    {
+        _leading_byte = false;
+        return;
+    }
+
+    _stream.write(byte);
+}
+
+template <typename Stream>
+range_coder_reader<Stream>::range_coder_reader(Stream& stream) : _stream(stream)
+{
+    for (int i = 0; i < 4; ++i)
+        _code = (_code << 8) | next_byte();
+}
+
+template <typename Stream>
+auto range_coder_reader<Stream>::read_bit(adaptive_bit_model& model, bool& bit) -> range_coder_reader&
+{
+    const std::uint32_t bound = (_range >> adaptive_bit_model::PROBABILITY_BITS) * model.probability_of_zero;
+    if (_code < bound)
+    {
+        _range = bound;
+        model.probability_of_zero += static_cast<std::uint16_t>((PROBABILITY_ONE - model.probability_of_zero) >>
+                                                                adaptive_bit_model::ADAPTATION_SHIFT);
+        bit = false;
+    }
+    else
+    {
+        _code -= bound;
+        _range -= bound;
+        model.probability_of_zero -= static_cast<std::uint16_t>(model.probability_of_zero >>
+                                                                adaptive_bit_model::ADAPTATION_SHIFT);
+        bit = true;
+    }
+    normalize();
+
+    return *this;
+}
+
+template <typename Stream>
+auto range_coder_reader<Stream>::read_raw_bits(std::uint32_t& value, int bits) -> range_coder_reader&
+{
+    if (bits < 1 || bits > 32)
+    {
+        _fail = true;
+        return *this;
+    }
+
+    std::uint32_t result = 0;
+    for (int i = 0; i < bits; ++i)
+    {
+        _range >>= 1;
+        const bool bit = (_code >= _range);
+        if (bit)
+            _code -= _range;
+        result = (result << 1) | static_cast<std::uint32_t>(bit);
+        normalize();
+    }
+    value = result;
+
+    return *this;
+}
+
+template <typename Stream>
+bool range_coder_reader<Stream>::fail() const
+{
+    return _fail || _stream.fail();
+}
+
+template <typename Stream>
+auto range_coder_reader<Stream>::decode_target(std::uint32_t total) -> std::uint32_t
+{
+    _scale = _range / total;
+
+    // Clamp it, as the last symbol also takes the remainder of the division.
+    return std::min(_code / _scale, total - 1);
+}
+
+template <typename Stream>
+void range_coder_reader<Stream>::decode(std::uint32_t cumulative, std::uint32_t frequency, std::uint32_t total)
+{
+    _code -= _scale * cumulative;
+    _range = (cumulative + frequency < total) ? _scale * frequency : _range - _scale * cumulative;
+    normalize();
+}
+
+template <typename Stream>
+void range_coder_reader<Stream>::normalize()
+{
+    while (_range < RANGE_TOP)
+    {
+        _range <<= 8;
+        _code = (_code << 8) | next_byte();
+    }
+}
+
+template <typename Stream>
+auto range_coder_reader<Stream>::next_byte() -> std::uint8_t
+{
+    std::uint8_t byte = 0;
+    _stream.read(byte);
+
+    // Keep decoding zeros after the stream has failed, which is reported with `fail()`.
+    return _stream.fail() ? std::uint8_t(0) : byte;
+}
+
+template class NALCHI_TEMPLATE_INSTANTIATION_API range_coder_writer<bit_stream_writer>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API range_coder_writer<bit_stream_measurer>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API range_coder_reader<bit_stream_reader>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API range_coder_writer<basic_bit_stream_writer<>>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API range_coder_reader<basic_bit_stream_reader<>>;
+
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+template class NALCHI_TEMPLATE_INSTANTIATION_API range_coder_writer<wide_bit_stream_writer>;
+template class NALCHI_TEMPLATE_INSTANTIATION_API range_coder_reader<wide_bit_stream_reader>;
+#endif
+
+} // namespace nalchi
@@ -4,6 +4,9 @@
 
 #include "aligned_alloc.hpp"
 #include "math.hpp"
+#include "payload_arena.hpp"
+#include "payload_pool.hpp"
+#include "payload_stats.hpp"
 
 #include <steam/steamnetworkingtypes.h>
 
@@ -22,14 +25,39 @@ constexpr auto GNS_MAX_MSG_SEND_SIZE = k_cbMaxSteamNetworkingSocketsMessageSizeS
 
 constexpr shared_payload::alloc_size_t BIT_STREAM_USED_FLAG_MASK = shared_payload::alloc_size_t(1)
                                                                    << (8 * sizeof(shared_payload::alloc_size_t) - 1);
-constexpr shared_payload::alloc_size_t PAYLOAD_SIZE_MASK = ~BIT_STREAM_USED_FLAG_MASK;
+constexpr shared_payload::alloc_size_t WIDE_BIT_STREAM_USED_FLAG_MASK = BIT_STREAM_USED_FLAG_MASK >> 1;
+// Set if the allocation was counted for `shared_payload::stats()`, so that its deallocation is counted too.
+constexpr shared_payload::alloc_size_t STATS_COUNTED_FLAG_MASK = WIDE_BIT_STREAM_USED_FLAG_MASK >> 1;
+// Set if the payload was allocated with `shared_payload::allocate_wide()`, so that it's ceiled to 8 bytes.
+constexpr shared_payload::alloc_size_t WIDE_ALLOCATED_FLAG_MASK = STATS_COUNTED_FLAG_MASK >> 1;
+constexpr shared_payload::alloc_size_t PAYLOAD_SIZE_MASK =
+    ~(BIT_STREAM_USED_FLAG_MASK | WIDE_BIT_STREAM_USED_FLAG_MASK | STATS_COUNTED_FLAG_MASK | WIDE_ALLOCATED_FLAG_MASK);
 
 static_assert(GNS_MAX_MSG_SEND_SIZE <= PAYLOAD_SIZE_MASK,
-              "Not enough space to store bit stream used flag in msb of payload size field");
+              "Not enough space to store bit stream used, stats & wide flags in msbs of payload size field");
+
+// Payload allocated with `shared_payload::allocate_wide()` is ceiled to the biggest word among the bit stream writers,
+// so that any of them can write to the payload without overrun.
+constexpr std::size_t BIT_STREAM_MAX_WORD_SIZE = sizeof(std::uint64_t);
+
+static_assert(sizeof(bit_stream_writer::word_type) <= BIT_STREAM_MAX_WORD_SIZE);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+static_assert(sizeof(wide_bit_stream_writer::word_type) <= BIT_STREAM_MAX_WORD_SIZE);
+#endif
 
 } // namespace
 
 NALCHI_API shared_payload shared_payload::allocate(alloc_size_t size)
+{
+    return do_allocate(size, false);
+}
+
+NALCHI_API shared_payload shared_payload::allocate_wide(alloc_size_t size)
+{
+    return do_allocate(size, true);
+}
+
+shared_payload shared_payload::do_allocate(alloc_size_t size, bool wide)
 {
     shared_payload payload{};
 
@@ -42,26 +70,34 @@ NALCHI_API shared_payload shared_payload::allocate(alloc_size_t size)
         constexpr std::size_t ALLOC_ALIGNMENT = std::max({
             alignof(ref_count_t),                  // to store ref count
             alignof(alloc_size_t),                 // to store requested payload size + bit stream used flag
-            alignof(bit_stream_writer::word_type), // to store payload data
+            BIT_STREAM_MAX_WORD_SIZE,              // to store payload data
         });
 
         // If these were not true, write to payload with `bit_stream_writer` would be unaligned.
         // In that case, we should call `std::align()` to manually align the buffer.
         // But that's slow, and we don't need that right now.
         static_assert(sizeof(ref_count_t) % alignof(alloc_size_t) == 0);
-        static_assert((sizeof(ref_count_t) + sizeof(alloc_size_t)) % alignof(bit_stream_writer::word_type) == 0);
+        static_assert((sizeof(ref_count_t) + sizeof(alloc_size_t)) % BIT_STREAM_MAX_WORD_SIZE == 0);
 
         // Calculate the required space for (ref count + payload size & bit stream used flag + actual payload)
-        // Actual payload size should be ceiled to `bit_stream_writer`'s word's multiple,
+        // Actual payload size should be ceiled to `bit_stream_writer`'s word's multiple (or the biggest one if `wide`),
         // to avoid buffer overrun on last scratch write in `bit_stream_writer`.
-        const alloc_size_t alloc_size =
-            static_cast<alloc_size_t>(sizeof(ref_count_t) + sizeof(alloc_size_t) +
-                                      ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(size));
-
+        const alloc_size_t alloc_size = static_cast<alloc_size_t>(
+            sizeof(ref_count_t) + sizeof(alloc_size_t) +
+            (wide ? ceil_to_multiple_of<BIT_STREAM_MAX_WORD_SIZE>(size)
+                  : ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(size)));
+
+#if defined(NALCHI_PAYLOAD_POOL)
+        // Reuse a block of the same size class, instead of hitting the global heap on every message.
+        static_assert(payload_pool::BLOCK_ALIGNMENT >= ALLOC_ALIGNMENT);
+        static_assert(payload_pool::HEADER_SIZE == sizeof(ref_count_t) + sizeof(alloc_size_t));
+        void* raw_space = payload_pool::allocate(alloc_size - payload_pool::HEADER_SIZE);
+#else
         // We actually don't need `std::aligned_alloc()`.
         // `std::malloc()` is already sufficiently aligned.
         static_assert(alignof(std::max_align_t) >= ALLOC_ALIGNMENT);
         void* raw_space = std::malloc(alloc_size);
+#endif
 
         if (raw_space)
         {
@@ -77,13 +113,24 @@ NALCHI_API shared_payload shared_payload::allocate(alloc_size_t size)
             // Use the second space to store requested payload size + bit stream used flag.
             alloc_size_t* req_payload_len =
                 reinterpret_cast<alloc_size_t*>((std::byte*)raw_space + sizeof(ref_count_t));
-            *req_payload_len = size;
+            *req_payload_len = wide ? (size | WIDE_ALLOCATED_FLAG_MASK) : size;
 
             // Point to the actual payload space.
             payload.ptr = static_cast<void*>((std::byte*)raw_space + sizeof(ref_count_t) + sizeof(alloc_size_t));
         }
     }
 
+    if (payload_stats::enabled()) [[unlikely]]
+    {
+        if (payload.ptr)
+        {
+            payload_stats::on_allocate(size);
+            payload.payload_size_and_bit_stream_used_flag() |= STATS_COUNTED_FLAG_MASK;
+        }
+        else
+            payload_stats::on_allocate_fail();
+    }
+
     return payload;
 }
 
@@ -92,11 +139,51 @@ NALCHI_API void shared_payload::force_deallocate(shared_payload payload)
     // Get the hidden ref count
     ref_count_t* ref_count_ptr = &payload.ref_count();
 
+    if (payload.payload_size_and_bit_stream_used_flag() & STATS_COUNTED_FLAG_MASK) [[unlikely]]
+        payload_stats::on_deallocate(payload.size());
+
+#if defined(NALCHI_PAYLOAD_POOL)
+    // Get the size class before the fields are gone.
+    const alloc_size_t payload_size = payload.word_ceiled_size();
+#endif
+
     // Destroy the ref count. (Is this actually necessary?)
     std::destroy_at(ref_count_ptr);
 
     // Free the space (ref count is the real alloc address)
+#if defined(NALCHI_PAYLOAD_POOL)
+    payload_pool::deallocate(ref_count_ptr, payload_size);
+#else
     std::free(ref_count_ptr);
+#endif
+}
+
+NALCHI_API void shared_payload::flush_remote_frees()
+{
+#if defined(NALCHI_PAYLOAD_POOL)
+    payload_pool::flush_remote_frees();
+#endif
+}
+
+NALCHI_API void shared_payload::enable_stats(bool enabled)
+{
+    payload_stats::set_enabled(enabled);
+}
+
+NALCHI_API auto shared_payload::stats() -> shared_payload_stats
+{
+    return payload_stats::collect();
+}
+
+NALCHI_API auto shared_payload::init_arena(std::size_t reserve_bytes) -> shared_payload_arena_pages
+{
+#if defined(NALCHI_PAYLOAD_POOL)
+    return payload_arena::init(reserve_bytes);
+#else
+    // Nothing to feed the arena to, as payloads are allocated from `std::malloc()`.
+    ((void)reserve_bytes);
+    return shared_payload_arena_pages::none;
+#endif
 }
 
 NALCHI_API auto shared_payload::size() const -> alloc_size_t
@@ -110,12 +197,22 @@ NALCHI_API auto shared_payload::size() const -> alloc_size_t
 
 NALCHI_API auto shared_payload::word_ceiled_size() const -> alloc_size_t
 {
+    if (payload_size_and_bit_stream_used_flag() & WIDE_ALLOCATED_FLAG_MASK)
+        return ceil_to_multiple_of<BIT_STREAM_MAX_WORD_SIZE>(size());
+
     return ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(size());
 }
 
 NALCHI_API auto shared_payload::internal_alloc_size() const -> alloc_size_t
 {
+#if defined(NALCHI_PAYLOAD_POOL)
+    // The block is as big as its size class.
+    const std::size_t size_class = payload_pool::size_class_of(word_ceiled_size());
+    const std::size_t payload_size = payload_pool::class_payload_size(size_class);
+    return static_cast<alloc_size_t>(sizeof(ref_count_t) + sizeof(alloc_size_t) + payload_size);
+#else
     return static_cast<alloc_size_t>(sizeof(ref_count_t) + sizeof(alloc_size_t) + word_ceiled_size());
+#endif
 }
 
 bool shared_payload::used_bit_stream() const
@@ -133,20 +230,38 @@ void shared_payload::set_used_bit_stream(bool used)
     alloc_size_t& raw_field = payload_size_and_bit_stream_used_flag();
 
     // Set the bit stream used flag part
+    raw_field &= ~WIDE_BIT_STREAM_USED_FLAG_MASK;
     if (used)
         raw_field |= BIT_STREAM_USED_FLAG_MASK;
     else
         raw_field &= ~BIT_STREAM_USED_FLAG_MASK;
 }
 
+void shared_payload::set_used_wide_bit_stream()
+{
+    payload_size_and_bit_stream_used_flag() |= (BIT_STREAM_USED_FLAG_MASK | WIDE_BIT_STREAM_USED_FLAG_MASK);
+}
+
+auto shared_payload::bit_stream_word_size() const -> alloc_size_t
+{
+    // Get the hidden requested payload size + bit stream used flag
+    const alloc_size_t raw_field = payload_size_and_bit_stream_used_flag();
+
+    return (raw_field & WIDE_BIT_STREAM_USED_FLAG_MASK) ? alloc_size_t(BIT_STREAM_MAX_WORD_SIZE)
+                                                        : alloc_size_t(sizeof(bit_stream_reader::word_type));
+}
+
 NALCHI_API void shared_payload::add_to_message(SteamNetworkingMessage_t* msg, int logical_bytes_length)
 {
-    // If used bit stream, ceil the send size to `bit_stream_reader::word_type`.
+    // If used bit stream, ceil the send size to the reader's `word_type`.
     // Otherwise, the receiving side might read out-of-bound memory.
     if (used_bit_stream())
-        logical_bytes_length = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(logical_bytes_length);
-
-    increase_ref_count();
+    {
+        if (bit_stream_word_size() == BIT_STREAM_MAX_WORD_SIZE)
+            logical_bytes_length = ceil_to_multiple_of<BIT_STREAM_MAX_WORD_SIZE>(logical_bytes_length);
+        else
+            logical_bytes_length = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(logical_bytes_length);
+    }
 
     // Add the payload to the message
     msg->m_pData = ptr;
@@ -161,19 +276,31 @@ void shared_payload::decrease_ref_count_and_deallocate_if_zero_callback(SteamNet
     payload.decrease_ref_count_and_deallocate_if_zero();
 }
 
-void shared_payload::increase_ref_count()
+NALCHI_API void shared_payload::set_ref_count_before_send(std::int32_t count)
 {
     ref_count_t* ref_count_ptr = &ref_count();
 
-    ref_count_ptr->fetch_add(1, std::memory_order_relaxed);
+    // No other thread can see the payload yet, and `SendMessages()` publishes it along with the messages.
+    ref_count_ptr->store(count, std::memory_order_relaxed);
 }
 
 void shared_payload::decrease_ref_count_and_deallocate_if_zero()
 {
     ref_count_t* ref_count_ptr = &ref_count();
 
-    // if this was the last reference, deallocate self
-    if (1 == ref_count_ptr->fetch_sub(1, std::memory_order_relaxed))
+    // The ref count never increases after sent, so if this is the only reference left, no one else can touch it.
+    // This skips the RMW for every unicast, and for the last message of a multicast released after the others.
+    // Acquire pairs with the release decrements of the other references, so that their accesses happen before.
+    if (1 == ref_count_ptr->load(std::memory_order_acquire))
+    {
+        force_deallocate(*this);
+        return;
+    }
+
+    // If this was the last reference, deallocate self.
+    // Release publishes the accesses through this reference to the last one, which acquires them all.
+    // (`acq_rel` instead of a release decrement + acquire fence, as sanitizers don't understand fences.)
+    if (1 == ref_count_ptr->fetch_sub(1, std::memory_order_acq_rel))
         force_deallocate(*this);
 }
 
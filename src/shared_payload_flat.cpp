@@ -7,11 +7,36 @@ NALCHI_FLAT_API nalchi::shared_payload nalchi_shared_payload_allocate(nalchi::sh
     return nalchi::shared_payload::allocate(size);
 }
 
+NALCHI_FLAT_API nalchi::shared_payload nalchi_shared_payload_allocate_wide(nalchi::shared_payload::alloc_size_t size)
+{
+    return nalchi::shared_payload::allocate_wide(size);
+}
+
 NALCHI_FLAT_API void nalchi_shared_payload_force_deallocate(nalchi::shared_payload payload)
 {
     return nalchi::shared_payload::force_deallocate(payload);
 }
 
+NALCHI_FLAT_API void nalchi_shared_payload_flush_remote_frees()
+{
+    return nalchi::shared_payload::flush_remote_frees();
+}
+
+NALCHI_FLAT_API void nalchi_shared_payload_enable_stats(bool enabled)
+{
+    return nalchi::shared_payload::enable_stats(enabled);
+}
+
+NALCHI_FLAT_API auto nalchi_shared_payload_stats() -> nalchi::shared_payload_stats
+{
+    return nalchi::shared_payload::stats();
+}
+
+NALCHI_FLAT_API auto nalchi_shared_payload_init_arena(std::size_t reserve_bytes) -> nalchi::shared_payload_arena_pages
+{
+    return nalchi::shared_payload::init_arena(reserve_bytes);
+}
+
 NALCHI_FLAT_API auto nalchi_shared_payload_size(const nalchi::shared_payload payload)
     -> nalchi::shared_payload::alloc_size_t
 {
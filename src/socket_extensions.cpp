@@ -18,6 +18,9 @@ NALCHI_API void socket_extensions::unicast(ISteamNetworkingSockets* sockets, HSt
     msg->m_idxLane = lane;
     msg->m_nUserData = user_data;
 
+    // The message is the only reference.
+    payload.set_ref_count_before_send(1);
+
     // Send the message.
     sockets->SendMessages(1, &msg, reinterpret_cast<int64*>(out_message_number_or_result));
 }
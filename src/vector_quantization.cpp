@@ -0,0 +1,107 @@
+#include "vector_quantization.hpp"
+
+#include "nalchi/quantization.hpp"
+
+#include "cpu_features.hpp"
+
+#if defined(NALCHI_X86_64)
+#include <immintrin.h>
+#endif
+
+namespace nalchi
+{
+
+static_assert(sizeof(std::array<float, 3>) == 3 * sizeof(float), "3D vectors must be tightly packed floats");
+
+namespace
+{
+
+void quantize_vec3_scalar(const std::array<float, 3>* values, std::size_t count, const std::array<float, 3>& min,
+                          float resolution, const std::array<std::uint32_t, 3>& q_max, std::uint32_t* out)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        for (int axis = 0; axis < 3; ++axis)
+            out[3 * i + axis] = quantize(values[i][axis], min[axis], resolution, q_max[axis]);
+}
+
+#if defined(NALCHI_X86_64)
+
+/// @brief Quantizes 4 vectors at a time, which are 3 groups of 4 components.
+///
+/// Each group spans the axes in a different order, `x y z x`, `y z x y` and `z x y z`,
+/// so the per-axis constants are broadcasted in the same 3 patterns.
+NALCHI_TARGET_AVX2 void quantize_vec3_avx2(const std::array<float, 3>* values, std::size_t count,
+                                           const std::array<float, 3>& min, float resolution,
+                                           const std::array<std::uint32_t, 3>& q_max, std::uint32_t* out)
+{
+    constexpr int GROUP_AXES[3][4] = {{0, 1, 2, 0}, {1, 2, 0, 1}, {2, 0, 1, 2}};
+
+    __m256d min_v[3];
+    __m256d q_max_v[3];
+    for (int g = 0; g < 3; ++g)
+    {
+        const int* axes = GROUP_AXES[g];
+        min_v[g] = _mm256_setr_pd(min[axes[0]], min[axes[1]], min[axes[2]], min[axes[3]]);
+        q_max_v[g] = _mm256_setr_pd(q_max[axes[0]], q_max[axes[1]], q_max[axes[2]], q_max[axes[3]]);
+    }
+
+    const __m256d resolution_v = _mm256_set1_pd(resolution);
+    const __m256d half_v = _mm256_set1_pd(0.5);
+    const __m256d one_v = _mm256_set1_pd(1.0);
+
+    // Adding `2^52` to an integral double below `2^52` puts it on the low bits of the mantissa.
+    const __m256d magic_v = _mm256_set1_pd(0x1p52);
+    const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+    const auto* floats = reinterpret_cast<const float*>(values);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        for (int g = 0; g < 3; ++g)
+        {
+            const __m256d value = _mm256_cvtps_pd(_mm_loadu_ps(floats + 3 * i + 4 * g));
+            const __m256d scaled = _mm256_div_pd(_mm256_sub_pd(value, min_v[g]), resolution_v);
+
+            // `std::round()` rounds half away from zero, which is `trunc(x) + (frac(x) >= 0.5)` for `x >= 0`.
+            __m256d q = _mm256_round_pd(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m256d round_up = _mm256_cmp_pd(_mm256_sub_pd(scaled, q), half_v, _CMP_GE_OQ);
+            q = _mm256_min_pd(_mm256_add_pd(q, _mm256_and_pd(round_up, one_v)), q_max_v[g]);
+
+            const __m256i bits = _mm256_castpd_si256(_mm256_add_pd(q, magic_v));
+            const __m256i packed = _mm256_permutevar8x32_epi32(bits, low_halves);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 3 * i + 4 * g), _mm256_castsi256_si128(packed));
+        }
+    }
+
+    quantize_vec3_scalar(values + i, count - i, min, resolution, q_max, out + 3 * i);
+}
+
+#endif
+
+} // namespace
+
+bool vec3_in_range(const std::array<float, 3>* values, std::size_t count, const std::array<float, 3>& min,
+                   const std::array<float, 3>& max)
+{
+    // Simple loop without early exit, so that it can be vectorized.
+    bool in_range = true;
+    for (std::size_t i = 0; i < count; ++i)
+        for (int axis = 0; axis < 3; ++axis)
+            in_range &= (min[axis] <= values[i][axis]) & (values[i][axis] <= max[axis]);
+
+    return in_range;
+}
+
+void quantize_vec3(const std::array<float, 3>* values, std::size_t count, const std::array<float, 3>& min,
+                   float resolution, const std::array<std::uint32_t, 3>& q_max, std::uint32_t* out)
+{
+#if defined(NALCHI_X86_64)
+    if (cpu_has_avx2())
+        return quantize_vec3_avx2(values, count, min, resolution, q_max, out);
+#endif
+
+    quantize_vec3_scalar(values, count, min, resolution, q_max, out);
+}
+
+} // namespace nalchi
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace nalchi
+{
+
+/// @brief Checks if every component of the 3D vectors is in the range of its axis.
+/// @param values Pointer to the 3D vectors.
+/// @param count Number of vectors.
+/// @param min Minimum value allowed for each axis.
+/// @param max Maximum value allowed for each axis.
+/// @return Whether all components are in range, which is `false` if any of them is NaN.
+bool vec3_in_range(const std::array<float, 3>* values, std::size_t count, const std::array<float, 3>& min,
+                   const std::array<float, 3>& max);
+
+/// @brief Quantizes every component of the 3D vectors, same as calling `quantize()` on each of them.
+///
+/// Uses AVX2 if available, which gives the exact same result as the scalar `quantize()`.
+/// @param values Pointer to the 3D vectors, all components of which must be in range.
+/// @param count Number of vectors.
+/// @param min Minimum value for each axis.
+/// @param resolution Step between the quantized values.
+/// @param q_max Maximum quantized value for each axis from `quantized_max()`.
+/// @param out Buffer to store `3 * count` quantized values, in `x, y, z` order for each vector.
+void quantize_vec3(const std::array<float, 3>* values, std::size_t count, const std::array<float, 3>& min,
+                   float resolution, const std::array<std::uint32_t, 3>& q_max, std::uint32_t* out);
+
+} // namespace nalchi
@@ -0,0 +1,264 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define AL_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::size_t MAX_OPERATIONS = 64;
+constexpr std::size_t MAX_BLOB_SIZE = 100;
+
+enum class operation_kind
+{
+    FIELD,
+    ALIGN_TO_BYTE,
+    ALIGN_TO_WORD,
+    ALIGNED_BYTES,
+};
+
+/// @brief Operation to write & read.
+struct operation
+{
+    operation_kind kind;
+    std::uint32_t value;          ///< Value of `FIELD`.
+    std::uint32_t max;            ///< Maximum value of `FIELD`, which makes it an odd-width field.
+    std::vector<std::byte> bytes; ///< Data of `ALIGNED_BYTES`.
+};
+
+/// @brief Generates random operations.
+/// @param rng Rng to use.
+/// @return Generated operations.
+auto generate_operations(rng_type& rng) -> std::vector<operation>
+{
+    std::vector<operation> ops(std::uniform_int_distribution<std::size_t>(0, MAX_OPERATIONS)(rng));
+
+    for (auto& op : ops)
+    {
+        switch (std::uniform_int_distribution<int>(0, 5)(rng))
+        {
+        case 0:
+            op.kind = operation_kind::ALIGN_TO_BYTE;
+            break;
+        case 1:
+            op.kind = operation_kind::ALIGN_TO_WORD;
+            break;
+        case 2: {
+            op.kind = operation_kind::ALIGNED_BYTES;
+            op.bytes.resize(std::uniform_int_distribution<std::size_t>(0, MAX_BLOB_SIZE)(rng));
+            for (auto& byte : op.bytes)
+                byte = static_cast<std::byte>(rng());
+            break;
+        }
+        default:
+            op.kind = operation_kind::FIELD;
+            op.max = std::max<std::uint32_t>(1, std::uniform_int_distribution<std::uint32_t>(1, 0xFFFF'FFFF)(rng) >>
+                                                    std::uniform_int_distribution<int>(0, 31)(rng));
+            op.value = std::uniform_int_distribution<std::uint32_t>(0, op.max)(rng);
+            break;
+        }
+    }
+
+    return ops;
+}
+
+/// @brief Tests that alignments and aligned bytes are measured, written and read correctly,
+/// and the aligned bytes are viewed in place.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_alignment(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    constexpr size_type WORD_BITS = 8 * sizeof(word_type);
+
+    rng_type rng(seed);
+
+    const auto ops = generate_operations(rng);
+
+    bit_stream_measurer measurer;
+    for (const auto& op : ops)
+    {
+        switch (op.kind)
+        {
+        case operation_kind::FIELD:
+            measurer.write(op.value, std::uint32_t(0), op.max);
+            break;
+        case operation_kind::ALIGN_TO_BYTE:
+            measurer.align_to_byte();
+            break;
+        case operation_kind::ALIGN_TO_WORD:
+            measurer.align_to_word<word_type>();
+            break;
+        case operation_kind::ALIGNED_BYTES:
+            measurer.write_aligned_bytes(op.bytes.data(), static_cast<size_type>(op.bytes.size()));
+            break;
+        }
+    }
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    for (const auto& op : ops)
+    {
+        switch (op.kind)
+        {
+        case operation_kind::FIELD:
+            writer.write(op.value, std::uint32_t(0), op.max);
+            break;
+        case operation_kind::ALIGN_TO_BYTE:
+            writer.align_to_byte();
+            AL_ASSERT(writer.used_bits() % 8 == 0, "writer not byte aligned");
+            break;
+        case operation_kind::ALIGN_TO_WORD:
+            writer.align_to_word();
+            AL_ASSERT(writer.used_bits() % WORD_BITS == 0, "writer not word aligned");
+            break;
+        case operation_kind::ALIGNED_BYTES:
+            writer.write_aligned_bytes(op.bytes.data(), static_cast<size_type>(op.bytes.size()));
+            break;
+        }
+    }
+    AL_ASSERT(writer.flush_final(), "writer failed");
+    AL_ASSERT(writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", writer.used_bits());
+
+    const auto* const buffer_begin = reinterpret_cast<const std::byte*>(buffer.data());
+
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    for (std::size_t i = 0; i < ops.size(); ++i)
+    {
+        const auto& op = ops[i];
+        switch (op.kind)
+        {
+        case operation_kind::FIELD: {
+            std::uint32_t value;
+            reader.read(value, std::uint32_t(0), op.max);
+            AL_ASSERT(reader, "read #", i, " failed");
+            AL_ASSERT(value == op.value, "read #", i, ", expected = ", op.value, ", got = ", value);
+            break;
+        }
+        case operation_kind::ALIGN_TO_BYTE:
+            reader.align_to_byte();
+            AL_ASSERT(reader && reader.used_bits() % 8 == 0, "reader not byte aligned on #", i);
+            break;
+        case operation_kind::ALIGN_TO_WORD:
+            reader.align_to_word();
+            AL_ASSERT(reader && reader.used_bits() % WORD_BITS == 0, "reader not word aligned on #", i);
+            break;
+        case operation_kind::ALIGNED_BYTES: {
+            const size_type begin_bits = (reader.used_bits() + 7) / 8 * 8;
+
+            std::span<const std::byte> bytes;
+            reader.read_aligned_bytes(bytes, static_cast<size_type>(op.bytes.size()));
+            AL_ASSERT(reader, "read #", i, " failed");
+            AL_ASSERT(bytes.size() == op.bytes.size() &&
+                          std::equal(bytes.begin(), bytes.end(), op.bytes.begin(), op.bytes.end()),
+                      "read #", i, " bytes mismatch");
+
+            // Should view in place, not a copy.
+            AL_ASSERT(bytes.data() == buffer_begin + begin_bits / 8, "read #", i, " is not viewed in place");
+            break;
+        }
+        }
+    }
+    AL_ASSERT(reader.used_bits() == measurer.used_bits(), "read bits = ", reader.used_bits());
+
+    // Non-zero padding should fail.
+    word_type small_buffer[2] = {};
+    Writer padding_writer(small_buffer, 2, sizeof(small_buffer));
+    padding_writer.write(std::uint8_t(0xFF));
+    AL_ASSERT(padding_writer.flush_final(), "padding writer failed");
+
+    Reader padding_reader(small_buffer, 2, sizeof(small_buffer));
+    bool bit = false;
+    padding_reader.read(bit);
+    padding_reader.align_to_byte();
+    AL_ASSERT(padding_reader.fail(), "reader not failed on non-zero padding");
+
+    // Overflow should fail, without writing or reading anything.
+    const size_type small_bits = 8 * sizeof(small_buffer);
+    Writer overflow_writer(small_buffer, 2, sizeof(small_buffer));
+    overflow_writer.write(bit);
+    overflow_writer.write_aligned_bytes(small_buffer, sizeof(small_buffer));
+    AL_ASSERT(overflow_writer.fail() && overflow_writer.used_bits() == 1, "writer not failed on overflow");
+
+    Reader overflow_reader(small_buffer, 2, sizeof(small_buffer));
+    overflow_reader.read(bit);
+    std::span<const std::byte> bytes;
+    overflow_reader.read_aligned_bytes(bytes, small_bits / 8);
+    AL_ASSERT(overflow_reader.fail() && overflow_reader.used_bits() == 1, "reader not failed on overflow");
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_alignment_all(const seed_type seed)
+{
+    test_alignment<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_alignment<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_alignment`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_alignment <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream alignment test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_alignment_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_alignment_all(rng());
+    }
+
+    std::cout << "bit_stream alignment test succeeded" << std::endl;
+}
@@ -0,0 +1,270 @@
+#include <nalchi/auto_serialize.hpp>
+
+#include "../assert.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define AS_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr float POSITION_MIN = -1000.0f;
+constexpr float POSITION_MAX = 1000.0f;
+constexpr float POSITION_RESOLUTION = 0.01f;
+
+constexpr std::size_t MAX_NAME_LENGTH = 16;
+
+using position_component = quantized<POSITION_MIN, POSITION_MAX, POSITION_RESOLUTION>;
+
+/// @brief Nested aggregate, serialized automatically.
+struct vitals
+{
+    bounded<int, 0, 100> hp;
+    bounded<std::int16_t, -500, 500> mana;
+    bool alive;
+
+    bool operator==(const vitals&) const = default;
+};
+
+/// @brief Aggregate with its own member `serialize()`, which takes precedence over the automatic one.
+struct custom_flags
+{
+    std::uint32_t bits;
+
+    template <serialize_stream Stream>
+    void serialize(Stream& stream)
+    {
+        // Only the lower 5 bits, which the automatic one can't know.
+        nalchi::serialize(stream, bits, 0, 31);
+    }
+
+    bool operator==(const custom_flags&) const = default;
+};
+
+/// @brief Message serialized automatically.
+struct player_state
+{
+    std::uint32_t id;
+    vitals vit;
+    std::array<position_component, 3> position;
+    quantized<0.0f, 1.0f, 1.0f / 255> charge;
+    bounded_string<MAX_NAME_LENGTH> name;
+    std::array<std::uint8_t, 8> token;
+    std::array<bounded<std::uint8_t, 0, 9>, 4> digits;
+    custom_flags flags;
+    double score;
+    std::int64_t gold;
+};
+
+static_assert(auto_serializable<player_state>);
+static_assert(detail::field_count<vitals>() == 3);
+static_assert(detail::field_count<player_state>() == 10);
+
+static_assert(bounded<int, 0, 100>::BITS == 7);
+static_assert(bounded<std::int16_t, -500, 500>::BITS == 10);
+static_assert(bounded<std::int64_t, std::numeric_limits<std::int64_t>::min(),
+                      std::numeric_limits<std::int64_t>::max()>::BITS == 64);
+static_assert(position_component::BITS == 18);
+
+/// @brief Gets the value a `quantized` field should be read as.
+template <float Min, float Max, float Resolution>
+auto expected_quantized(float value) -> float
+{
+    constexpr std::uint32_t MAX_CODE = quantized<Min, Max, Resolution>::MAX_CODE;
+    return dequantize(quantize(value, Min, Resolution, MAX_CODE), Min, Max, Resolution);
+}
+
+/// @brief Generates a random message.
+/// @param rng Rng to use.
+/// @return Generated message.
+auto generate_player(rng_type& rng) -> player_state
+{
+    player_state player;
+
+    player.id = static_cast<std::uint32_t>(rng());
+    player.vit.hp = std::uniform_int_distribution<int>(0, 100)(rng);
+    player.vit.mana = static_cast<std::int16_t>(std::uniform_int_distribution<int>(-500, 500)(rng));
+    player.vit.alive = std::uniform_int_distribution<int>(0, 1)(rng);
+    for (auto& c : player.position)
+        c = std::uniform_real_distribution<float>(POSITION_MIN, POSITION_MAX)(rng);
+    player.charge = std::uniform_real_distribution<float>(0, 1)(rng);
+    player.name.value.resize(std::uniform_int_distribution<std::size_t>(0, MAX_NAME_LENGTH)(rng));
+    for (char& c : player.name.value)
+        c = static_cast<char>(std::uniform_int_distribution<int>('a', 'z')(rng));
+    for (auto& byte : player.token)
+        byte = static_cast<std::uint8_t>(rng());
+    for (auto& digit : player.digits)
+        digit = static_cast<std::uint8_t>(std::uniform_int_distribution<int>(0, 9)(rng));
+    player.flags.bits = std::uniform_int_distribution<std::uint32_t>(0, 31)(rng);
+    player.score = std::uniform_real_distribution<double>(-1e9, 1e9)(rng);
+    player.gold = static_cast<std::int64_t>(rng());
+
+    return player;
+}
+
+/// @brief Writes the message by hand, which the automatic serialization should match bit by bit.
+template <typename Stream>
+void write_by_hand(Stream& stream, const player_state& player)
+{
+    stream.write(player.id);
+    stream.template write<0, 100>(player.vit.hp.value);
+    stream.template write<-500, 500>(player.vit.mana.value);
+    stream.write(player.vit.alive);
+    for (const auto& c : player.position)
+        stream.write_quantized(c.value, POSITION_MIN, POSITION_MAX, POSITION_RESOLUTION);
+    stream.write_quantized(player.charge.value, 0.0f, 1.0f, 1.0f / 255);
+    stream.write(player.name.value);
+    stream.write_array(std::span<const std::uint8_t>(player.token));
+    for (const auto& digit : player.digits)
+        stream.template write<0, 9>(digit.value);
+    stream.write(player.flags.bits, 0u, 31u);
+    stream.write(player.score);
+    stream.write(player.gold);
+}
+
+/// @brief Tests that the automatic serialization measures, writes and reads the same bits as the hand-written one.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_auto_serialize(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    const player_state player = generate_player(rng);
+
+    AS_ASSERT(position_component::MAX_CODE == quantized_max(POSITION_MIN, POSITION_MAX, POSITION_RESOLUTION),
+              "MAX_CODE = ", position_component::MAX_CODE);
+
+    bit_stream_measurer hand_measurer;
+    write_by_hand(hand_measurer, player);
+
+    const size_type bits = serialized_bits(player);
+    const size_type logical_bytes_length = serialized_bytes(player);
+    AS_ASSERT(bits == hand_measurer.used_bits(), "auto bits = ", bits, ", hand bits = ", hand_measurer.used_bits());
+
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+    std::vector<word_type> hand_buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    player_state write_player = player;
+    AS_ASSERT(serialize(writer, write_player).flush_final(), "writer failed");
+    AS_ASSERT(writer.used_bits() == bits, "measured bits = ", bits, ", written bits = ", writer.used_bits());
+
+    Writer hand_writer(hand_buffer.data(), words_length, logical_bytes_length);
+    write_by_hand(hand_writer, player);
+    AS_ASSERT(hand_writer.flush_final(), "hand writer failed");
+    AS_ASSERT(buffer == hand_buffer, "automatic serialization differs from the hand-written one");
+
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    player_state read_player;
+    AS_ASSERT(serialize(reader, read_player), "reader failed");
+    AS_ASSERT(reader.used_bits() == bits, "read bits = ", reader.used_bits());
+
+    AS_ASSERT(read_player.id == player.id && read_player.vit == player.vit && read_player.name == player.name &&
+                  read_player.token == player.token && read_player.digits == player.digits &&
+                  read_player.flags == player.flags && read_player.score == player.score &&
+                  read_player.gold == player.gold,
+              "lossless fields mismatch");
+    for (std::size_t i = 0; i < player.position.size(); ++i)
+    {
+        const float expected =
+            expected_quantized<POSITION_MIN, POSITION_MAX, POSITION_RESOLUTION>(player.position[i].value);
+        AS_ASSERT(read_player.position[i].value == expected, "position[", i, "] = ", read_player.position[i].value,
+                  ", expected = ", expected);
+    }
+    const float expected_charge = expected_quantized<0.0f, 1.0f, 1.0f / 255>(player.charge.value);
+    AS_ASSERT(read_player.charge.value == expected_charge, "charge = ", read_player.charge.value,
+              ", expected = ", expected_charge);
+
+    // Out of range fields should fail on write.
+    auto expect_write_fail = [&](player_state bad_player, const char* field) {
+        std::vector<word_type> bad_buffer(words_length + 4);
+        Writer bad_writer(bad_buffer.data(), static_cast<size_type>(bad_buffer.size()),
+                          static_cast<size_type>(sizeof(word_type) * bad_buffer.size()));
+        AS_ASSERT(!serialize(bad_writer, bad_player), "writer not failed on out of range ", field);
+    };
+
+    player_state bad_hp = player;
+    bad_hp.vit.hp = 101;
+    expect_write_fail(bad_hp, "hp");
+
+    player_state bad_position = player;
+    bad_position.position[1] = std::numeric_limits<float>::quiet_NaN();
+    expect_write_fail(bad_position, "position");
+
+    player_state bad_name = player;
+    bad_name.name.value.assign(MAX_NAME_LENGTH + 1, 'x');
+    expect_write_fail(bad_name, "name");
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_auto_serialize_all(const seed_type seed)
+{
+    test_auto_serialize<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_auto_serialize<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_auto_serialize`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_auto_serialize <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream auto_serialize test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_auto_serialize_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_auto_serialize_all(rng());
+    }
+
+    std::cout << "bit_stream auto_serialize test succeeded" << std::endl;
+}
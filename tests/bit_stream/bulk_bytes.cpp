@@ -0,0 +1,225 @@
+#include <nalchi/bit_stream.hpp>
+#include <nalchi/shared_payload.hpp>
+
+#include "../assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define BB_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, ", prefix bits = ", prefix_bits, ", blob size = ", blob_size, \
+                        '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+// The default instantiation is the 32-bit word / 64-bit scratch one, which `bit_stream_writer` also uses.
+static_assert(std::is_same_v<basic_bit_stream_writer<>::word_type, bit_stream_writer::word_type>);
+static_assert(std::is_same_v<basic_bit_stream_writer<>::scratch_type, bit_stream_writer::scratch_type>);
+static_assert(std::is_same_v<basic_bit_stream_reader<>::word_type, bit_stream_reader::word_type>);
+static_assert(std::is_same_v<basic_bit_stream_reader<>::scratch_type, bit_stream_reader::scratch_type>);
+
+constexpr size_type MAX_BLOB_SIZE = 4096;
+constexpr size_type BUFFER_SIZE = MAX_BLOB_SIZE + 2 * sizeof(std::uint64_t);
+
+/// @brief Tests that the bulk byte paths produce bit-identical results to the per-byte paths.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_bulk_bytes(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    static word_type bulk_buffer[BUFFER_SIZE / sizeof(word_type)];
+    static word_type per_byte_buffer[BUFFER_SIZE / sizeof(word_type)];
+
+    rng_type rng(seed);
+
+    // Generate the inputs: prefix bits to unalign the stream, a blob, and a suffix.
+    const int prefix_bits = std::uniform_int_distribution<int>(0, 64)(rng);
+    const std::uint64_t prefix_max = (prefix_bits == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << prefix_bits) - 1;
+    const std::uint64_t prefix = std::uniform_int_distribution<std::uint64_t>(0, prefix_max)(rng);
+
+    const size_type blob_size = std::uniform_int_distribution<size_type>(0, MAX_BLOB_SIZE)(rng);
+    std::vector<std::uint8_t> blob(blob_size);
+    for (auto& byte : blob)
+        byte = static_cast<std::uint8_t>(std::uniform_int_distribution<unsigned>(0, 255)(rng));
+
+    const std::uint16_t suffix = static_cast<std::uint16_t>(std::uniform_int_distribution<unsigned>(0, 0xFFFF)(rng));
+
+    // Use the exact lengths, so that the bulk paths meet the end of the buffer.
+    const size_type logical_bits = static_cast<size_type>(prefix_bits) + 8 * blob_size + 16;
+    const size_type logical_bytes_length = (logical_bits + 7) / 8;
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+
+    std::fill(std::begin(bulk_buffer), std::end(bulk_buffer), static_cast<word_type>(0xCDCDCDCDCDCDCDCDull));
+    std::fill(std::begin(per_byte_buffer), std::end(per_byte_buffer), static_cast<word_type>(0xCDCDCDCDCDCDCDCDull));
+
+    // Write with the bulk path.
+    Writer bulk_writer(bulk_buffer, words_length, logical_bytes_length);
+    if (prefix_bits > 0)
+        bulk_writer.write(prefix, std::uint64_t(0), prefix_max);
+    bulk_writer.write(blob.data(), blob_size);
+    bulk_writer.write(suffix);
+    BB_ASSERT(bulk_writer.flush_final(), "bulk writer failed");
+
+    // Write with the per-byte path.
+    Writer per_byte_writer(per_byte_buffer, words_length, logical_bytes_length);
+    if (prefix_bits > 0)
+        per_byte_writer.write(prefix, std::uint64_t(0), prefix_max);
+    for (const auto byte : blob)
+        per_byte_writer.write(byte);
+    per_byte_writer.write(suffix);
+    BB_ASSERT(per_byte_writer.flush_final(), "per-byte writer failed");
+
+    // Compare the writers.
+    BB_ASSERT(bulk_writer.used_bits() == per_byte_writer.used_bits(), "writer used bits mismatch, bulk = ",
+              bulk_writer.used_bits(), ", per-byte = ", per_byte_writer.used_bits());
+    BB_ASSERT(std::equal(std::begin(bulk_buffer), std::end(bulk_buffer), std::begin(per_byte_buffer)),
+              "written buffer mismatch");
+
+    // Read with the bulk path.
+    Reader bulk_reader(bulk_buffer, words_length, logical_bytes_length);
+    std::uint64_t bulk_prefix = 0;
+    std::vector<std::uint8_t> bulk_blob(blob_size);
+    std::uint16_t bulk_suffix;
+    if (prefix_bits > 0)
+        bulk_reader.read(bulk_prefix, std::uint64_t(0), prefix_max);
+    bulk_reader.read(bulk_blob.data(), blob_size);
+    const size_type bulk_used_bits = bulk_reader.used_bits();
+    bulk_reader.read(bulk_suffix);
+    BB_ASSERT(bulk_reader, "bulk reader failed");
+
+    // Read with the per-byte path.
+    Reader per_byte_reader(bulk_buffer, words_length, logical_bytes_length);
+    std::uint64_t per_byte_prefix = 0;
+    std::vector<std::uint8_t> per_byte_blob(blob_size);
+    std::uint16_t per_byte_suffix;
+    if (prefix_bits > 0)
+        per_byte_reader.read(per_byte_prefix, std::uint64_t(0), prefix_max);
+    for (auto& byte : per_byte_blob)
+        per_byte_reader.read(byte);
+    const size_type per_byte_used_bits = per_byte_reader.used_bits();
+    per_byte_reader.read(per_byte_suffix);
+    BB_ASSERT(per_byte_reader, "per-byte reader failed");
+
+    // Compare the readers.
+    BB_ASSERT(bulk_used_bits == per_byte_used_bits, "reader used bits mismatch, bulk = ", bulk_used_bits,
+              ", per-byte = ", per_byte_used_bits);
+    BB_ASSERT(bulk_prefix == prefix && per_byte_prefix == prefix, "prefix mismatch");
+    BB_ASSERT(bulk_blob == per_byte_blob, "read blob mismatch between bulk and per-byte");
+    BB_ASSERT(bulk_blob == blob, "read blob mismatch with the input");
+    BB_ASSERT(bulk_suffix == suffix && per_byte_suffix == suffix, "suffix mismatch");
+}
+
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+/// @brief Tests that the wide writer writes the last partial word only to the payloads allocated as wide.
+void test_wide_shared_payload()
+{
+    constexpr size_type SIZE = 12;
+
+    // Payload not allocated as wide is ceiled to 12 bytes, which only has 1 whole 64-bit word.
+    const shared_payload payload = shared_payload::allocate(SIZE);
+    wide_bit_stream_writer narrow_writer(payload, SIZE);
+    NALCHI_TESTS_ASSERT(narrow_writer.fail(), "wide writer accepted the partial word of a narrow payload");
+    narrow_writer.reset_with(payload, sizeof(std::uint64_t));
+    NALCHI_TESTS_ASSERT(!narrow_writer.fail(), "wide writer rejected the whole word of a payload");
+    shared_payload::force_deallocate(payload);
+
+    const shared_payload wide_payload = shared_payload::allocate_wide(SIZE);
+    NALCHI_TESTS_ASSERT(wide_payload.word_ceiled_size() == 2 * sizeof(std::uint64_t),
+                        "word_ceiled_size = ", wide_payload.word_ceiled_size());
+
+    wide_bit_stream_writer writer(wide_payload, SIZE);
+    for (size_type i = 0; i < SIZE; ++i)
+        writer.write(static_cast<std::uint8_t>(i));
+    writer.flush_final();
+    NALCHI_TESTS_ASSERT(!writer.fail() && writer.used_bytes() == SIZE, "used_bytes = ", writer.used_bytes());
+    NALCHI_TESTS_ASSERT(wide_payload.used_bit_stream(), "wide payload not marked as used bit stream");
+
+    wide_bit_stream_reader reader(static_cast<const std::uint64_t*>(wide_payload.ptr), 2, SIZE);
+    for (size_type i = 0; i < SIZE; ++i)
+    {
+        std::uint8_t value = 0;
+        reader.read(value);
+        NALCHI_TESTS_ASSERT(!reader.fail() && value == i, "read ", int(value), " at ", i);
+    }
+
+    shared_payload::force_deallocate(wide_payload);
+}
+#endif
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_bulk_bytes`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_bulk_bytes <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream bulk bytes test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_bulk_bytes<nalchi::bit_stream_writer, nalchi::bit_stream_reader>(seed);
+        test_bulk_bytes<nalchi::basic_bit_stream_writer<>, nalchi::bit_stream_reader>(seed);
+        test_bulk_bytes<nalchi::bit_stream_writer, nalchi::basic_bit_stream_reader<>>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+        test_bulk_bytes<nalchi::wide_bit_stream_writer, nalchi::wide_bit_stream_reader>(seed);
+#endif
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+        {
+            const seed_type seed = rng();
+
+            test_bulk_bytes<nalchi::bit_stream_writer, nalchi::bit_stream_reader>(seed);
+            test_bulk_bytes<nalchi::basic_bit_stream_writer<>, nalchi::bit_stream_reader>(seed);
+            test_bulk_bytes<nalchi::bit_stream_writer, nalchi::basic_bit_stream_reader<>>(seed);
+        test_bulk_bytes<nalchi::basic_bit_stream_writer<>, nalchi::bit_stream_reader>(seed);
+        test_bulk_bytes<nalchi::bit_stream_writer, nalchi::basic_bit_stream_reader<>>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+            test_bulk_bytes<nalchi::wide_bit_stream_writer, nalchi::wide_bit_stream_reader>(seed);
+#endif
+        }
+    }
+
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_wide_shared_payload();
+#endif
+
+    std::cout << "bit_stream bulk bytes test succeeded" << std::endl;
+}
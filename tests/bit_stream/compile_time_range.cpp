@@ -0,0 +1,197 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define CR_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+/// @brief Compile-time range to test.
+template <typename Int, auto Min, auto Max>
+struct range
+{
+    using value_type = Int;
+    static constexpr Int min = Min;
+    static constexpr Int max = Max;
+};
+
+template <typename Int>
+using full_range = range<Int, std::numeric_limits<Int>::min(), std::numeric_limits<Int>::max()>;
+
+/// @brief Calls @p func with every range to test.
+template <typename Func>
+void for_each_range(Func&& func)
+{
+    func(range<std::uint8_t, 0, 1>{});
+    func(range<std::uint8_t, 3, 200>{});
+    func(range<std::int8_t, -100, 27>{});
+    func(range<std::int16_t, -1000, 1000>{});
+    func(range<std::uint16_t, 0, 0x7FFF>{});
+    func(range<std::int32_t, -5, 70000>{});
+    func(range<std::uint32_t, 1, 0xFFFFFFFE>{});
+    func(range<std::int64_t, -(std::int64_t(1) << 40), std::int64_t(1) << 40>{});
+    func(range<std::uint64_t, 7, 0xFFFFFFFFFFFF>{});
+    func(full_range<std::int8_t>{});
+    func(full_range<std::uint16_t>{});
+    func(full_range<std::int32_t>{});
+    func(full_range<std::uint32_t>{});
+    func(full_range<std::int64_t>{});
+    func(full_range<std::uint64_t>{});
+}
+
+/// @brief Tests that the compile-time range writes & reads are same as the runtime range ones.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_compile_time_range(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    constexpr int REPEAT = 8;
+
+    // Generate the values, stored as `std::uint64_t`.
+    std::vector<std::uint64_t> values;
+    for_each_range([&]<typename Range>(Range) {
+        using Int = typename Range::value_type;
+        using WideInt = std::conditional_t<std::is_signed_v<Int>, std::int64_t, std::uint64_t>;
+
+        for (int i = 0; i < REPEAT; ++i)
+        {
+            const WideInt value = std::uniform_int_distribution<WideInt>(Range::min, Range::max)(rng);
+            values.push_back(static_cast<std::uint64_t>(value));
+        }
+    });
+
+    // Measure with both ways.
+    bit_stream_measurer runtime_measurer, compile_time_measurer;
+    std::size_t value_index = 0;
+    for_each_range([&]<typename Range>(Range) {
+        using Int = typename Range::value_type;
+        for (int i = 0; i < REPEAT; ++i, ++value_index)
+        {
+            const Int value = static_cast<Int>(values[value_index]);
+            runtime_measurer.write(value, Range::min, Range::max);
+            compile_time_measurer.write<Range::min, Range::max>(value);
+        }
+    });
+    CR_ASSERT(runtime_measurer.used_bits() == compile_time_measurer.used_bits(), "measured bits mismatch");
+
+    const size_type logical_bytes_length = runtime_measurer.used_bytes();
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> runtime_buffer(words_length), compile_time_buffer(words_length);
+
+    // Write with both ways.
+    Writer runtime_writer(runtime_buffer.data(), words_length, logical_bytes_length);
+    Writer compile_time_writer(compile_time_buffer.data(), words_length, logical_bytes_length);
+    value_index = 0;
+    for_each_range([&]<typename Range>(Range) {
+        using Int = typename Range::value_type;
+        for (int i = 0; i < REPEAT; ++i, ++value_index)
+        {
+            const Int value = static_cast<Int>(values[value_index]);
+            runtime_writer.write(value, Range::min, Range::max);
+            compile_time_writer.template write<Range::min, Range::max>(value);
+        }
+    });
+    CR_ASSERT(runtime_writer.flush_final(), "runtime writer failed");
+    CR_ASSERT(compile_time_writer.flush_final(), "compile-time writer failed");
+    CR_ASSERT(runtime_writer.used_bits() == compile_time_writer.used_bits(), "written bits mismatch");
+    CR_ASSERT(runtime_buffer == compile_time_buffer, "written buffer mismatch");
+
+    // Read with the compile-time range.
+    Reader reader(compile_time_buffer.data(), words_length, logical_bytes_length);
+    value_index = 0;
+    for_each_range([&]<typename Range>(Range) {
+        using Int = typename Range::value_type;
+        for (int i = 0; i < REPEAT; ++i, ++value_index)
+        {
+            Int value;
+            CR_ASSERT((reader.template read<Range::min, Range::max>(value)), "read #", value_index, " failed");
+            CR_ASSERT(value == static_cast<Int>(values[value_index]), "read #", value_index, " mismatch");
+        }
+    });
+
+    // Out of range data should fail.
+    Writer fail_writer(runtime_buffer.data(), words_length, logical_bytes_length);
+    fail_writer.template write<3, 200>(std::uint8_t(201));
+    CR_ASSERT(fail_writer.fail(), "writer not failed on out of range data");
+
+    // Out of range raw value should fail on read.
+    const word_type raw = static_cast<word_type>(-1);
+    Reader fail_reader(&raw, 1, sizeof(raw));
+    std::uint8_t out_of_range;
+    fail_reader.template read<3, 200>(out_of_range);
+    CR_ASSERT(fail_reader.fail(), "reader not failed on out of range raw value");
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_compile_time_range_all(const seed_type seed)
+{
+    test_compile_time_range<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_compile_time_range<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_compile_time_range`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_compile_time_range <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream compile-time range test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_compile_time_range_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_compile_time_range_all(rng());
+    }
+
+    std::cout << "bit_stream compile-time range test succeeded" << std::endl;
+}
@@ -0,0 +1,270 @@
+#include <nalchi/auto_serialize.hpp>
+
+#include "../assert.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define CM_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_measurer::size_type;
+
+using axis_component = quantized<-1.0f, 1.0f, 1.0f / 127>;
+using position_component = quantized<-1000.0f, 1000.0f, 0.01f>;
+
+/// @brief Nested fixed-layout aggregate.
+struct aim
+{
+    bounded<std::int16_t, -180, 180> yaw;
+    bounded<std::int16_t, -90, 90> pitch;
+
+    bool operator==(const aim&) const = default;
+};
+
+/// @brief Fixed-layout message, serialized automatically.
+struct input_command
+{
+    bounded<std::uint16_t, 0, 1023> tick;
+    std::array<axis_component, 2> move;
+    aim look;
+    bool jump;
+    bool fire;
+    std::uint8_t weapon;
+    std::array<position_component, 3> predicted;
+    float speed;
+    std::int64_t client_time;
+};
+
+/// @brief Aggregate with a member `serialize()` which always writes 5 bits, opted in below.
+struct opted_in_flags
+{
+    std::uint32_t bits;
+
+    template <serialize_stream Stream>
+    constexpr void serialize(Stream& stream)
+    {
+        nalchi::serialize(stream, bits, 0, 31);
+    }
+};
+
+/// @brief Aggregate with a member `serialize()`, not opted in.
+struct own_member_serialize
+{
+    std::uint32_t value;
+
+    template <serialize_stream Stream>
+    void serialize(Stream& stream)
+    {
+        serialize_varint(stream, value);
+    }
+};
+
+/// @brief Aggregate with a free `serialize()`, not opted in.
+struct own_free_serialize
+{
+    std::uint32_t value;
+};
+
+template <serialize_stream Stream>
+auto serialize(Stream& stream, own_free_serialize& message) -> Stream&
+{
+    return serialize_varint(stream, message.value);
+}
+
+/// @brief Aggregate with a variable length field.
+struct chat_message
+{
+    std::uint32_t sender;
+    bounded_string<64> text;
+};
+
+/// @brief Aggregate with a fixed-size field opted in.
+struct flagged_command
+{
+    opted_in_flags flags;
+    std::array<bounded<std::uint8_t, 0, 9>, 4> digits;
+};
+
+} // namespace nalchi::tests
+
+template <>
+inline constexpr bool nalchi::enable_fixed_size_serialize<nalchi::tests::opted_in_flags> = true;
+
+namespace nalchi::tests
+{
+
+// The measurer works in constant evaluation.
+static_assert([] {
+    bit_stream_measurer measurer;
+    measurer.write(std::uint32_t{});
+    measurer.write<0, 100>(42);
+    measurer.write(0.5f);
+    measurer.write<0, 7>(3);
+    return measurer.used_bits();
+}() == 32 + 7 + 32 + 3);
+
+static_assert([] {
+    bit_stream_measurer measurer;
+    measurer.write(true);
+    measurer.align_to_byte();
+    measurer.write(nullptr, 5);
+    return measurer.used_bytes();
+}() == 1 + 5);
+
+static_assert(quantized_max(-1.0f, 1.0f, 0.5f) == 4);
+static_assert(quantized_bits(-1.0f, 1.0f, 0.5f) == 3);
+
+static_assert(fixed_size_serializable<int>);
+static_assert(fixed_size_serializable<double>);
+static_assert(fixed_size_serializable<position_component>);
+static_assert(fixed_size_serializable<std::array<aim, 3>>);
+static_assert(fixed_size_serializable<input_command>);
+static_assert(fixed_size_serializable<opted_in_flags>);
+static_assert(fixed_size_serializable<flagged_command>);
+
+static_assert(!fixed_size_serializable<bounded_string<8>>);
+static_assert(!fixed_size_serializable<chat_message>);
+static_assert(!fixed_size_serializable<own_member_serialize>);
+static_assert(!fixed_size_serializable<own_free_serialize>);
+static_assert(!fixed_size_serializable<std::array<own_free_serialize, 2>>);
+
+static_assert(max_bits_v<aim> == 9 + 8);
+static_assert(max_bits_v<input_command> == 10 + 2 * axis_component::BITS + (9 + 8) + 1 + 1 + 8 +
+                                               3 * position_component::BITS + 32 + 64);
+static_assert(max_bytes_v<input_command> == (max_bits_v<input_command> + 7) / 8);
+static_assert(max_bits_v<flagged_command> == 5 + 4 * 4);
+
+/// @brief Generates a random message.
+/// @param rng Rng to use.
+/// @return Generated message.
+auto generate_command(rng_type& rng) -> input_command
+{
+    input_command command;
+
+    command.tick = static_cast<std::uint16_t>(std::uniform_int_distribution<int>(0, 1023)(rng));
+    for (auto& axis : command.move)
+        axis = std::uniform_real_distribution<float>(-1, 1)(rng);
+    command.look.yaw = static_cast<std::int16_t>(std::uniform_int_distribution<int>(-180, 180)(rng));
+    command.look.pitch = static_cast<std::int16_t>(std::uniform_int_distribution<int>(-90, 90)(rng));
+    command.jump = std::uniform_int_distribution<int>(0, 1)(rng);
+    command.fire = std::uniform_int_distribution<int>(0, 1)(rng);
+    command.weapon = static_cast<std::uint8_t>(rng());
+    for (auto& c : command.predicted)
+        c = std::uniform_real_distribution<float>(-1000, 1000)(rng);
+    command.speed = std::uniform_real_distribution<float>(0, 30)(rng);
+    command.client_time = static_cast<std::int64_t>(rng());
+
+    return command;
+}
+
+/// @brief Tests that a fixed-layout message measures `max_bits_v` for any value,
+/// and fits in a stack buffer sized with `max_bytes_v`.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_constexpr_measure(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    constexpr size_type BYTES = max_bytes_v<input_command>;
+    constexpr size_type WORDS = (BYTES + sizeof(word_type) - 1) / sizeof(word_type);
+
+    rng_type rng(seed);
+
+    const input_command command = generate_command(rng);
+
+    CM_ASSERT(serialized_bits(command) == max_bits_v<input_command>, "measured bits = ", serialized_bits(command),
+              ", max_bits_v = ", max_bits_v<input_command>);
+
+    std::array<word_type, WORDS> buffer{};
+
+    Writer writer(buffer.data(), WORDS, BYTES);
+    input_command write_command = command;
+    CM_ASSERT(serialize(writer, write_command).flush_final(), "writer failed");
+    CM_ASSERT(writer.used_bits() == max_bits_v<input_command>, "written bits = ", writer.used_bits());
+
+    Reader reader(buffer.data(), WORDS, BYTES);
+    input_command read_command;
+    CM_ASSERT(serialize(reader, read_command), "reader failed");
+    CM_ASSERT(reader.used_bits() == max_bits_v<input_command>, "read bits = ", reader.used_bits());
+
+    CM_ASSERT(read_command.tick == command.tick && read_command.look == command.look &&
+                  read_command.jump == command.jump && read_command.fire == command.fire &&
+                  read_command.weapon == command.weapon && read_command.speed == command.speed &&
+                  read_command.client_time == command.client_time,
+              "lossless fields mismatch");
+    for (std::size_t i = 0; i < command.move.size(); ++i)
+        CM_ASSERT(std::abs(read_command.move[i].value - command.move[i].value) <= axis_component::RESOLUTION / 2,
+                  "move[", i, "] = ", read_command.move[i].value, ", expected = ", command.move[i].value);
+    for (std::size_t i = 0; i < command.predicted.size(); ++i)
+        CM_ASSERT(std::abs(read_command.predicted[i].value - command.predicted[i].value) <=
+                      position_component::RESOLUTION,
+                  "predicted[", i, "] = ", read_command.predicted[i].value,
+                  ", expected = ", command.predicted[i].value);
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_constexpr_measure_all(const seed_type seed)
+{
+    test_constexpr_measure<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_constexpr_measure<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_constexpr_measure`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_constexpr_measure <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream constexpr_measure test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_constexpr_measure_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_constexpr_measure_all(rng());
+    }
+
+    std::cout << "bit_stream constexpr_measure test succeeded" << std::endl;
+}
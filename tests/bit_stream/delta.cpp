@@ -0,0 +1,278 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define DT_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, ", type = ", typeid(Int).name(), \
+                        '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::size_t MAX_FIELDS = 256;
+
+/// @brief Field to write delta encoded against its baseline.
+template <typename Int>
+struct delta_field
+{
+    Int value;
+    Int baseline;
+    Int min;
+    Int max;
+};
+
+/// @brief Generates a random value in `[min, max]`.
+template <typename Int>
+auto random_value(rng_type& rng, Int min, Int max) -> Int
+{
+    return std::uniform_int_distribution<Int>(min, max)(rng);
+}
+
+template <>
+auto random_value(rng_type& rng, std::int8_t min, std::int8_t max) -> std::int8_t
+{
+    return static_cast<std::int8_t>(std::uniform_int_distribution<int>(min, max)(rng));
+}
+
+template <>
+auto random_value(rng_type& rng, std::uint8_t min, std::uint8_t max) -> std::uint8_t
+{
+    return static_cast<std::uint8_t>(std::uniform_int_distribution<unsigned>(min, max)(rng));
+}
+
+/// @brief Gets `to - from` without overflow, which must not be negative.
+template <typename Int>
+auto distance(Int from, Int to) -> std::make_unsigned_t<Int>
+{
+    using UInt = std::make_unsigned_t<Int>;
+    return static_cast<UInt>(static_cast<UInt>(to) - static_cast<UInt>(from));
+}
+
+/// @brief Generates random fields, which are mostly unchanged or slightly changed from their baselines.
+/// @param rng Rng to use.
+/// @return Generated fields.
+template <typename Int>
+auto generate_fields(rng_type& rng) -> std::vector<delta_field<Int>>
+{
+    using UInt = std::make_unsigned_t<Int>;
+
+    constexpr Int VALUE_MIN = std::numeric_limits<Int>::min();
+    constexpr Int VALUE_MAX = std::numeric_limits<Int>::max();
+
+    std::vector<delta_field<Int>> fields(std::uniform_int_distribution<std::size_t>(0, MAX_FIELDS)(rng));
+
+    for (auto& f : fields)
+    {
+        // Sometimes use the full range of `Int`.
+        if (std::uniform_int_distribution<int>(0, 3)(rng) == 0)
+        {
+            f.min = VALUE_MIN;
+            f.max = VALUE_MAX;
+        }
+        else
+        {
+            do
+            {
+                f.min = random_value<Int>(rng, VALUE_MIN, VALUE_MAX);
+                f.max = random_value<Int>(rng, VALUE_MIN, VALUE_MAX);
+                if (f.min > f.max)
+                    std::swap(f.min, f.max);
+            } while (f.min == f.max);
+        }
+
+        f.baseline = random_value<Int>(rng, f.min, f.max);
+
+        switch (std::uniform_int_distribution<int>(0, 3)(rng))
+        {
+        case 0:
+            // Unchanged.
+            f.value = f.baseline;
+            break;
+        case 1:
+            // Anywhere in the range.
+            f.value = random_value<Int>(rng, f.min, f.max);
+            break;
+        default: {
+            // Small change, clamped to the range.
+            const int delta = std::uniform_int_distribution<int>(-40, 40)(rng);
+            if (delta < 0)
+                f.value = (distance(f.min, f.baseline) < UInt(-delta)) ? f.min : static_cast<Int>(f.baseline + delta);
+            else
+                f.value = (distance(f.baseline, f.max) < UInt(delta)) ? f.max : static_cast<Int>(f.baseline + delta);
+            break;
+        }
+        }
+    }
+
+    return fields;
+}
+
+/// @brief Tests that delta encoded values are measured, written and read correctly.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @tparam Int Integer type of the fields.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader, typename Int>
+void test_delta(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    const auto fields = generate_fields<Int>(rng);
+
+    bit_stream_measurer measurer;
+    for (const auto& f : fields)
+    {
+        const auto before = measurer.used_bits();
+        measurer.write_delta(f.value, f.baseline, f.min, f.max);
+        const auto bits = measurer.used_bits() - before;
+
+        // Unchanged ones take only 1 bit, and the others never take more than 2 extra bits.
+        // Small changes up to 40 take at most 13 bits for the delta.
+        const int full_bits = static_cast<int>(std::bit_width(distance(f.min, f.max)));
+        const auto change = (f.value > f.baseline) ? distance(f.baseline, f.value) : distance(f.value, f.baseline);
+        const bool small_change = (change <= 40);
+        if (f.value == f.baseline)
+            DT_ASSERT(bits == 1, "unchanged value took ", bits, " bits");
+        else
+            DT_ASSERT(bits >= 2 && static_cast<int>(bits) <= 2 + (small_change ? std::min(full_bits, 13) : full_bits),
+                      "value = ", +f.value, ", baseline = ", +f.baseline, " took ", bits, " bits");
+    }
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    for (const auto& f : fields)
+        writer.write_delta(f.value, f.baseline, f.min, f.max);
+    DT_ASSERT(writer.flush_final(), "writer failed");
+    DT_ASSERT(writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", writer.used_bits());
+
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        const auto& f = fields[i];
+
+        Int value;
+        reader.read_delta(value, f.baseline, f.min, f.max);
+        DT_ASSERT(reader, "read #", i, " failed");
+        DT_ASSERT(value == f.value, "read #", i, ", expected = ", +f.value, ", got = ", +value);
+    }
+    DT_ASSERT(reader.used_bits() == measurer.used_bits(), "read bits = ", reader.used_bits());
+
+    // Out of range value or baseline should fail, without writing anything.
+    if (!fields.empty())
+    {
+        const auto& f = fields.front();
+        if (f.min > std::numeric_limits<Int>::min())
+        {
+            Writer fail_writer(buffer.data(), words_length, logical_bytes_length);
+            fail_writer.write_delta(static_cast<Int>(f.min - 1), f.baseline, f.min, f.max);
+            DT_ASSERT(fail_writer.fail() && fail_writer.used_bits() == 0, "writer not failed on value below min");
+
+            Writer fail_baseline_writer(buffer.data(), words_length, logical_bytes_length);
+            fail_baseline_writer.write_delta(f.value, static_cast<Int>(f.min - 1), f.min, f.max);
+            DT_ASSERT(fail_baseline_writer.fail() && fail_baseline_writer.used_bits() == 0,
+                      "writer not failed on baseline below min");
+        }
+    }
+
+    // Decoded value exceeding the range should fail on read.
+    word_type small_buffer[4] = {};
+    Writer small_writer(small_buffer, 4, sizeof(small_buffer));
+    small_writer.write_delta(Int(5), Int(0), Int(0), Int(100));
+    DT_ASSERT(small_writer.flush_final(), "small writer failed");
+
+    Reader fail_reader(small_buffer, 4, sizeof(small_buffer));
+    Int out_of_range;
+    fail_reader.read_delta(out_of_range, Int(0), Int(0), Int(3));
+    DT_ASSERT(fail_reader.fail(), "reader not failed on decoded value exceeding the range");
+}
+
+/// @brief Tests every integer types.
+template <typename Writer, typename Reader>
+void test_delta_all_types(const seed_type seed)
+{
+    test_delta<Writer, Reader, std::int8_t>(seed);
+    test_delta<Writer, Reader, std::uint8_t>(seed);
+    test_delta<Writer, Reader, std::int16_t>(seed);
+    test_delta<Writer, Reader, std::uint16_t>(seed);
+    test_delta<Writer, Reader, std::int32_t>(seed);
+    test_delta<Writer, Reader, std::uint32_t>(seed);
+    test_delta<Writer, Reader, std::int64_t>(seed);
+    test_delta<Writer, Reader, std::uint64_t>(seed);
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_delta_all(const seed_type seed)
+{
+    test_delta_all_types<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_delta_all_types<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_delta`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_delta <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream delta test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_delta_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_delta_all(rng());
+    }
+
+    std::cout << "bit_stream delta test succeeded" << std::endl;
+}
@@ -0,0 +1,324 @@
+#include <nalchi/bit_stream.hpp>
+#include <nalchi/huffman_codebook.hpp>
+
+#include "../assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define HF_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::size_t MAX_STRINGS = 64;
+constexpr std::size_t MAX_STRING_LENGTH = 120;
+constexpr std::size_t MAX_BLOB_SIZE = 600;
+
+constexpr std::string_view WORDS[] = {
+    "the", "player", "joined", "left", "game", "gg", "lol", "attack", "defend", "base", "north", "south",
+    "heal", "me", "please", "thanks", "ready", "go", "wait", "sword", "shield", "potion", "/kick", "/ban",
+    "textures/rock_01.dds", "models/tree_oak.mdl", "sounds/hit_02.wav",
+};
+
+/// @brief Generates a chat-like string from the words, sometimes with random bytes.
+auto generate_string(rng_type& rng) -> std::string
+{
+    const std::size_t max_length = std::uniform_int_distribution<std::size_t>(0, MAX_STRING_LENGTH)(rng);
+
+    std::string str;
+    while (str.length() < max_length)
+    {
+        if (std::uniform_int_distribution<int>(0, 19)(rng) == 0)
+            str += static_cast<char>(rng());
+        else
+            str += WORDS[std::uniform_int_distribution<std::size_t>(0, std::size(WORDS) - 1)(rng)];
+        str += ' ';
+    }
+    str.resize(max_length);
+
+    return str;
+}
+
+/// @brief Gets the codebook trained from the words.
+auto word_codebook() -> const huffman_codebook&
+{
+    static const huffman_codebook codebook = [] {
+        std::array<std::uint64_t, huffman_codebook::SYMBOLS> frequencies = {};
+        rng_type rng(0);
+        for (int i = 0; i < 1000; ++i)
+            for (const char c : generate_string(rng))
+                ++frequencies[static_cast<std::uint8_t>(c)];
+
+        return huffman_codebook::from_frequencies(frequencies);
+    }();
+
+    return codebook;
+}
+
+/// @brief Gets the codebook trained from exponentially skewed frequencies, whose codes are limited to 15 bits.
+auto skewed_codebook() -> const huffman_codebook&
+{
+    static const huffman_codebook codebook = [] {
+        std::array<std::uint64_t, huffman_codebook::SYMBOLS> frequencies = {};
+        for (int i = 0; i < 40; ++i)
+            frequencies[i] = std::uint64_t(1) << (62 - i);
+
+        return huffman_codebook::from_frequencies(frequencies);
+    }();
+
+    return codebook;
+}
+
+/// @brief Tests that Huffman coded strings and blobs are measured, written and read correctly.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_huffman(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    const huffman_codebook& codebook = std::uniform_int_distribution<int>(0, 3)(rng) ? word_codebook()
+                                                                                      : skewed_codebook();
+
+    std::vector<std::string> strs(std::uniform_int_distribution<std::size_t>(0, MAX_STRINGS)(rng));
+    for (auto& str : strs)
+        str = generate_string(rng);
+
+    // Blob of skewed bytes, which uses the long codes of the skewed codebook.
+    std::vector<std::uint8_t> blob(std::uniform_int_distribution<std::size_t>(0, MAX_BLOB_SIZE)(rng));
+    std::geometric_distribution<int> byte_dist(0.3);
+    for (auto& byte : blob)
+        byte = static_cast<std::uint8_t>(std::min(byte_dist(rng), 255));
+
+    // Unaligned prefix, so that the codes don't start on the word boundary.
+    const int prefix_bits = std::uniform_int_distribution<int>(1, 40)(rng);
+    const std::uint64_t prefix_max = (std::uint64_t(1) << prefix_bits) - 1;
+    const std::uint64_t prefix = rng() & prefix_max;
+
+    bit_stream_measurer measurer;
+    measurer.write(prefix, std::uint64_t(0), prefix_max);
+    for (const auto& str : strs)
+        measurer.write_string_huffman(str, codebook);
+    measurer.write_huffman(blob.data(), static_cast<size_type>(blob.size()), codebook);
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    writer.write(prefix, std::uint64_t(0), prefix_max);
+    for (const auto& str : strs)
+        writer.write_string_huffman(str, codebook);
+    writer.write_huffman(blob.data(), static_cast<size_type>(blob.size()), codebook);
+    HF_ASSERT(writer.flush_final(), "writer failed");
+    HF_ASSERT(writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", writer.used_bits());
+
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    std::uint64_t read_prefix;
+    reader.read(read_prefix, std::uint64_t(0), prefix_max);
+    HF_ASSERT(read_prefix == prefix, "prefix mismatch");
+
+    for (std::size_t i = 0; i < strs.size(); ++i)
+    {
+        std::string str;
+        reader.read_string_huffman(str, MAX_STRING_LENGTH, codebook);
+        HF_ASSERT(reader, "read #", i, " failed");
+        HF_ASSERT(str == strs[i], "read #", i, ", expected = ", strs[i], ", got = ", str);
+    }
+
+    std::vector<std::uint8_t> read_blob(blob.size());
+    reader.read_huffman(read_blob.data(), static_cast<size_type>(read_blob.size()), codebook);
+    HF_ASSERT(reader, "blob read failed");
+    HF_ASSERT(read_blob == blob, "blob mismatch");
+    HF_ASSERT(reader.used_bits() == measurer.used_bits(), "read bits = ", reader.used_bits());
+
+    // Truncated stream should fail.
+    if (!blob.empty())
+    {
+        Reader truncated_reader(buffer.data(), words_length, logical_bytes_length);
+        truncated_reader.read(read_prefix, std::uint64_t(0), prefix_max);
+        for (std::size_t i = 0; i < strs.size(); ++i)
+        {
+            std::string str;
+            truncated_reader.read_string_huffman(str, MAX_STRING_LENGTH, codebook);
+        }
+        std::vector<std::uint8_t> longer_blob(blob.size() + 8);
+        truncated_reader.read_huffman(longer_blob.data(), static_cast<size_type>(longer_blob.size()), codebook);
+        HF_ASSERT(truncated_reader.fail(), "reader not failed on truncated stream");
+    }
+
+    // Too long string should fail.
+    if (!strs.empty() && !strs.front().empty())
+    {
+        Reader long_reader(buffer.data(), words_length, logical_bytes_length);
+        long_reader.read(read_prefix, std::uint64_t(0), prefix_max);
+        std::string str;
+        long_reader.read_string_huffman(str, strs.front().length() - 1, codebook);
+        HF_ASSERT(long_reader.fail(), "reader not failed on too long string");
+    }
+
+    // Too small buffer should fail, without writing anything.
+    if (measurer.used_bits() > static_cast<size_type>(prefix_bits))
+    {
+        Writer small_writer(buffer.data(), words_length, logical_bytes_length);
+        small_writer.write(prefix, std::uint64_t(0), prefix_max);
+        const std::string big(8 * logical_bytes_length, 'x');
+        small_writer.write_string_huffman(big, codebook);
+        HF_ASSERT(small_writer.fail() && small_writer.used_bits() == static_cast<size_type>(prefix_bits),
+                  "writer not failed on too small buffer");
+    }
+}
+
+/// @brief Tests the codebook construction, which doesn't depend on the seed.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_huffman_codebook(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    // Codebooks constructed from the code lengths should be the same.
+    for (const huffman_codebook* trained : {&word_codebook(), &skewed_codebook()})
+    {
+        HF_ASSERT(trained->valid(), "trained codebook is invalid");
+
+        const huffman_codebook restored(trained->code_lengths());
+        HF_ASSERT(restored.valid(), "restored codebook is invalid");
+        for (int symbol = 0; symbol < huffman_codebook::SYMBOLS; ++symbol)
+        {
+            const auto& a = trained->code(static_cast<std::uint8_t>(symbol));
+            const auto& b = restored.code(static_cast<std::uint8_t>(symbol));
+            HF_ASSERT(a.length > 0 && a.length <= huffman_codebook::MAX_CODE_LENGTH && a.length == b.length &&
+                          a.bits == b.bits,
+                      "code mismatch on symbol = ", symbol);
+        }
+    }
+
+    // Trained codebook should beat the plain `write()` for the strings it's trained on.
+    {
+        rng_type rng(seed);
+        bit_stream_measurer plain;
+        bit_stream_measurer coded;
+        for (int i = 0; i < 16; ++i)
+        {
+            const std::string str = generate_string(rng);
+            plain.write(str);
+            coded.write_string_huffman(str, word_codebook());
+        }
+        HF_ASSERT(coded.used_bits() < plain.used_bits() * 3 / 4, "plain bits = ", plain.used_bits(),
+                  ", coded bits = ", coded.used_bits());
+    }
+
+    // Default codebook takes 8 bits per byte.
+    const huffman_codebook identity;
+    HF_ASSERT(identity.valid() && identity.encoded_bits("abc", 3) == 24, "default codebook isn't 8 bits per byte");
+
+    // Over-subscribed code lengths should be invalid.
+    std::array<std::uint8_t, huffman_codebook::SYMBOLS> lengths = {};
+    lengths['a'] = 1;
+    lengths['b'] = 1;
+    lengths['c'] = 1;
+    const huffman_codebook over_subscribed(lengths);
+    HF_ASSERT(!over_subscribed.valid(), "over-subscribed codebook is valid");
+
+    // Bytes not in the codebook should fail, without writing anything.
+    lengths['c'] = 0;
+    const huffman_codebook partial(lengths);
+    HF_ASSERT(partial.valid(), "partial codebook is invalid");
+
+    word_type buffer[4] = {};
+    Writer writer(buffer, 4, sizeof(buffer));
+    writer.write_string_huffman("abc", partial);
+    HF_ASSERT(writer.fail() && writer.used_bits() == 0, "writer not failed on missing symbol");
+
+    Writer invalid_writer(buffer, 4, sizeof(buffer));
+    invalid_writer.write_string_huffman("ab", over_subscribed);
+    HF_ASSERT(invalid_writer.fail(), "writer not failed on invalid codebook");
+
+    // Codes not in the incomplete codebook should fail on read.
+    lengths['b'] = 0;
+    const huffman_codebook only_a(lengths);
+    Writer ones_writer(buffer, 4, sizeof(buffer));
+    ones_writer.write(std::uint32_t(0xFFFF'FFFF));
+    HF_ASSERT(ones_writer.flush_final(), "ones writer failed");
+
+    Reader reader(buffer, 4, sizeof(buffer));
+    std::uint8_t symbol;
+    reader.read_huffman(&symbol, 1, only_a);
+    HF_ASSERT(reader.fail(), "reader not failed on code not in the codebook");
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_huffman_all(const seed_type seed)
+{
+    test_huffman<bit_stream_writer, bit_stream_reader>(seed);
+    test_huffman_codebook<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_huffman<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+    test_huffman_codebook<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_huffman`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_huffman <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream huffman test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_huffman_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_huffman_all(rng());
+    }
+
+    std::cout << "bit_stream huffman test succeeded" << std::endl;
+}
@@ -0,0 +1,390 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define IC_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, ", fields = ", fields.size(), '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::size_t MAX_FIELDS = 256;
+
+/// @brief Field to write with one of the variable-length integer codes.
+struct field
+{
+    enum class code
+    {
+        varint,
+        exp_golomb,
+        elias_gamma,
+    };
+
+    enum class kind
+    {
+        s8,
+        u8,
+        s16,
+        u16,
+        s32,
+        u32,
+        s64,
+        u64,
+    };
+
+    code type;
+    kind int_type;
+    std::uint64_t value; // Stored as `std::uint64_t`, which is converted to `int_type` on use.
+    int k;
+};
+
+/// @brief Calls @p func with the value of @p f converted to its integer type.
+template <typename Func>
+void visit_value(const field& f, Func&& func)
+{
+    switch (f.int_type)
+    {
+    case field::kind::s8:
+        return func(static_cast<std::int8_t>(f.value));
+    case field::kind::u8:
+        return func(static_cast<std::uint8_t>(f.value));
+    case field::kind::s16:
+        return func(static_cast<std::int16_t>(f.value));
+    case field::kind::u16:
+        return func(static_cast<std::uint16_t>(f.value));
+    case field::kind::s32:
+        return func(static_cast<std::int32_t>(f.value));
+    case field::kind::u32:
+        return func(static_cast<std::uint32_t>(f.value));
+    case field::kind::s64:
+        return func(static_cast<std::int64_t>(f.value));
+    case field::kind::u64:
+        return func(static_cast<std::uint64_t>(f.value));
+    }
+}
+
+/// @brief Generates random fields, whose values are mostly small but sometimes extreme.
+/// @param rng Rng to use.
+/// @return Generated fields.
+auto generate_fields(rng_type& rng) -> std::vector<field>
+{
+    std::vector<field> fields(std::uniform_int_distribution<std::size_t>(0, MAX_FIELDS)(rng));
+
+    for (auto& f : fields)
+    {
+        f.type = static_cast<field::code>(std::uniform_int_distribution<int>(0, 2)(rng));
+        f.int_type = static_cast<field::kind>(std::uniform_int_distribution<int>(0, 7)(rng));
+
+        // Elias gamma only supports unsigned types.
+        if (f.type == field::code::elias_gamma)
+            f.int_type = static_cast<field::kind>(static_cast<int>(f.int_type) | 1);
+
+        const int int_bits = 8 << (static_cast<int>(f.int_type) / 2);
+
+        // Pick a bit width with exponential distribution, and a random value in it.
+        const int value_bits = std::uniform_int_distribution<int>(0, 3)(rng) == 0
+                                   ? std::uniform_int_distribution<int>(0, int_bits)(rng)
+                                   : std::uniform_int_distribution<int>(0, 6)(rng);
+        const std::uint64_t value_max = (value_bits >= 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << value_bits) - 1;
+        f.value = std::uniform_int_distribution<std::uint64_t>(0, value_max)(rng);
+        if (std::uniform_int_distribution<int>(0, 1)(rng) == 0)
+            f.value = ~f.value; // Small negative values for signed types, or extreme values for unsigned types.
+
+        if (f.type == field::code::elias_gamma)
+        {
+            visit_value(f, [&](auto value) {
+                if (value == 0)
+                    f.value = 1;
+            });
+        }
+
+        f.k = std::uniform_int_distribution<int>(0, std::min(int_bits - 1, 8))(rng);
+    }
+
+    return fields;
+}
+
+/// @brief Writes the fields to the stream.
+/// @param stream Stream to write to.
+/// @param fields Fields to write.
+template <typename Stream>
+void write_fields(Stream& stream, const std::vector<field>& fields)
+{
+    for (const auto& f : fields)
+    {
+        visit_value(f, [&]<typename Int>(Int value) {
+            switch (f.type)
+            {
+            case field::code::varint:
+                stream.write_varint(value);
+                break;
+            case field::code::exp_golomb:
+                stream.write_exp_golomb(value, f.k);
+                break;
+            case field::code::elias_gamma:
+                if constexpr (std::is_unsigned_v<Int>)
+                    stream.write_elias_gamma(value);
+                break;
+            }
+        });
+    }
+}
+
+/// @brief Tests that the variable-length integer codes are measured, written and read correctly.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_integer_codes(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    const std::vector<field> fields = generate_fields(rng);
+
+    bit_stream_measurer measurer;
+    write_fields(measurer, fields);
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    write_fields(writer, fields);
+    IC_ASSERT(writer.flush_final(), "writer failed");
+    IC_ASSERT(writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", writer.used_bits());
+
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        const field& f = fields[i];
+        visit_value(f, [&]<typename Int>(Int value) {
+            Int read_value{};
+            switch (f.type)
+            {
+            case field::code::varint:
+                reader.read_varint(read_value);
+                break;
+            case field::code::exp_golomb:
+                reader.read_exp_golomb(read_value, f.k);
+                break;
+            case field::code::elias_gamma:
+                if constexpr (std::is_unsigned_v<Int>)
+                    reader.read_elias_gamma(read_value);
+                break;
+            }
+            IC_ASSERT(reader, "read #", i, " failed");
+            IC_ASSERT(read_value == value, "read #", i, " mismatch, expected = ", +value, ", got = ", +read_value);
+        });
+    }
+    IC_ASSERT(reader.used_bits() == writer.used_bits(), "read bits mismatch");
+}
+
+/// @brief Tests the known encodings and the malformed inputs.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+template <typename Writer, typename Reader>
+void test_integer_codes_edge_cases()
+{
+    using word_type = typename Writer::word_type;
+
+    const seed_type seed = 0;
+    const std::vector<field> fields;
+
+    // Sizes of the known values.
+    IC_ASSERT(varint_bits(0) == 8);
+    IC_ASSERT(varint_bits(127) == 8);
+    IC_ASSERT(varint_bits(128) == 16);
+    IC_ASSERT(varint_bits(~std::uint64_t(0)) == 80);
+    IC_ASSERT(exp_golomb_bits(0, 0) == 1);
+    IC_ASSERT(exp_golomb_bits(1, 0) == 3);
+    IC_ASSERT(exp_golomb_bits(2, 0) == 3);
+    IC_ASSERT(exp_golomb_bits(3, 0) == 5);
+    IC_ASSERT(exp_golomb_bits(0, 2) == 3);
+    IC_ASSERT(exp_golomb_bits(~std::uint64_t(0), 0) == 129);
+    IC_ASSERT(zigzag_encode(std::int8_t(-1)) == 1);
+    IC_ASSERT(zigzag_encode(std::int8_t(1)) == 2);
+    IC_ASSERT(zigzag_encode(std::int8_t(-128)) == 255);
+    IC_ASSERT(zigzag_decode(std::uint8_t(255)) == -128);
+
+    word_type buffer[8] = {};
+    constexpr size_type WORDS_LENGTH = 8;
+    constexpr size_type BYTES_LENGTH = 8 * sizeof(word_type);
+
+    // Varint `300` is `0xAC 0x02`, same as the protobuf varint.
+    {
+        Writer writer(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        writer.write_varint(300u);
+        IC_ASSERT(writer.flush_final());
+
+        Reader reader(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        std::uint8_t bytes[2] = {};
+        reader.read(bytes[0]).read(bytes[1]);
+        IC_ASSERT(bytes[0] == 0xAC && bytes[1] == 0x02, "bytes = ", +bytes[0], ' ', +bytes[1]);
+    }
+
+    // Exp-Golomb `3` of order 0 is `00` `1` `00`.
+    {
+        Writer writer(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        writer.write_exp_golomb(3u);
+        IC_ASSERT(writer.flush_final());
+
+        Reader reader(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        std::uint8_t bits = 0;
+        reader.read(bits, std::uint8_t(0), std::uint8_t(31));
+        IC_ASSERT(bits == 0b00100, "bits = ", +bits);
+    }
+
+    // Varint with too many groups for `std::uint8_t` should fail.
+    {
+        Writer writer(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        writer.write_varint(static_cast<std::uint16_t>(1u << 14));
+        IC_ASSERT(writer.flush_final());
+
+        Reader reader(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        std::uint8_t value = 0;
+        reader.read_varint(value);
+        IC_ASSERT(reader.fail(), "reader not failed on too many varint groups");
+    }
+
+    // Varint exceeding `std::uint8_t` should fail.
+    {
+        Writer writer(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        writer.write_varint(std::uint16_t(256));
+        IC_ASSERT(writer.flush_final());
+
+        Reader reader(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        std::uint8_t value = 0;
+        reader.read_varint(value);
+        IC_ASSERT(reader.fail(), "reader not failed on varint exceeding the type");
+    }
+
+    // Exp-Golomb exceeding `std::uint8_t` should fail.
+    {
+        Writer writer(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        writer.write_exp_golomb(std::uint16_t(255), 3);
+        writer.write_exp_golomb(std::uint16_t(256), 3);
+        IC_ASSERT(writer.flush_final());
+
+        Reader reader(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        std::uint8_t value = 0;
+        reader.read_exp_golomb(value, 3);
+        IC_ASSERT(reader && value == 255, "reader failed on the maximum value");
+        reader.read_exp_golomb(value, 3);
+        IC_ASSERT(reader.fail(), "reader not failed on Exp-Golomb exceeding the type");
+    }
+
+    // All zero bits should fail, instead of reading beyond the buffer.
+    {
+        const word_type zeros[2] = {};
+        Reader reader(zeros, 2, 2 * sizeof(word_type));
+        std::uint64_t value = 0;
+        reader.read_exp_golomb(value);
+        IC_ASSERT(reader.fail(), "reader not failed on all zero bits");
+    }
+
+    // Elias gamma of `0` is invalid.
+    {
+        Writer writer(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        writer.write_elias_gamma(0u);
+        IC_ASSERT(writer.fail(), "writer not failed on Elias gamma of 0");
+
+        // The measurer should count nothing, as the writer writes nothing.
+        bit_stream_measurer measurer;
+        measurer.write_elias_gamma(0u);
+        IC_ASSERT(measurer.used_bits() == 0, "measured bits = ", measurer.used_bits());
+    }
+
+    // Invalid order should fail.
+    {
+        Writer writer(buffer, WORDS_LENGTH, BYTES_LENGTH);
+        writer.write_exp_golomb(std::uint8_t(0), 8);
+        IC_ASSERT(writer.fail(), "writer not failed on invalid order");
+
+        bit_stream_measurer measurer;
+        measurer.write_exp_golomb(std::uint8_t(0), 8).write_exp_golomb(std::uint8_t(0), -1);
+        IC_ASSERT(measurer.used_bits() == 0, "measured bits = ", measurer.used_bits());
+    }
+
+    // Overflow should fail.
+    {
+        Writer writer(buffer, 1, 1);
+        writer.write_varint(std::uint16_t(128));
+        IC_ASSERT(writer.fail(), "writer not failed on overflow");
+    }
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_integer_codes_all(const seed_type seed)
+{
+    test_integer_codes<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_integer_codes<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_integer_codes`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_integer_codes <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi;
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream integer codes test ===\n";
+
+    test_integer_codes_edge_cases<bit_stream_writer, bit_stream_reader>();
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_integer_codes_edge_cases<wide_bit_stream_writer, wide_bit_stream_reader>();
+#endif
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_integer_codes_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_integer_codes_all(rng());
+    }
+
+    std::cout << "bit_stream integer codes test succeeded" << std::endl;
+}
@@ -0,0 +1,348 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define OR_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+using quaternion = std::array<float, 4>;
+using vector3 = std::array<float, 3>;
+
+constexpr std::size_t MAX_ELEMENTS = 600;
+
+/// @brief Generates a random rotation, which is not normalized.
+auto random_quaternion(rng_type& rng) -> quaternion
+{
+    std::normal_distribution<float> dist;
+    quaternion quat;
+    do
+    {
+        quat = {dist(rng), dist(rng), dist(rng), dist(rng)};
+    } while (!is_encodable_quaternion(quat));
+
+    // Sometimes scale it, or zero out some components.
+    const float scale = std::pow(10.0f, std::uniform_real_distribution<float>(-3, 3)(rng));
+    for (auto& c : quat)
+        c *= scale;
+    if (std::uniform_int_distribution<int>(0, 3)(rng) == 0)
+        quat[std::uniform_int_distribution<int>(0, 3)(rng)] = 0;
+
+    return quat;
+}
+
+/// @brief Generates a random direction, which is not normalized.
+auto random_vector(rng_type& rng) -> vector3
+{
+    std::normal_distribution<float> dist;
+    vector3 vec;
+    do
+    {
+        vec = {dist(rng), dist(rng), dist(rng)};
+
+        // Sometimes pick the axes.
+        if (std::uniform_int_distribution<int>(0, 7)(rng) == 0)
+        {
+            vec = {0, 0, 0};
+            const float sign = std::uniform_int_distribution<int>(0, 1)(rng) ? 1.0f : -1.0f;
+            vec[std::uniform_int_distribution<int>(0, 2)(rng)] = sign;
+        }
+    } while (!is_encodable_unit_vector(vec));
+
+    const float scale = std::pow(10.0f, std::uniform_real_distribution<float>(-3, 3)(rng));
+    for (auto& c : vec)
+        c *= scale;
+
+    return vec;
+}
+
+/// @brief Gets the angle between two rotations, which is the same for `q` and `-q`.
+auto rotation_angle(const quaternion& a, const quaternion& b) -> double
+{
+    double dot = 0, norm_a = 0, norm_b = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        dot += static_cast<double>(a[i]) * b[i];
+        norm_a += static_cast<double>(a[i]) * a[i];
+        norm_b += static_cast<double>(b[i]) * b[i];
+    }
+
+    return 2 * std::acos(std::min(1.0, std::abs(dot) / std::sqrt(norm_a * norm_b)));
+}
+
+/// @brief Gets the angle between two directions.
+auto direction_angle(const vector3& a, const vector3& b) -> double
+{
+    double dot = 0, norm_a = 0, norm_b = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        dot += static_cast<double>(a[i]) * b[i];
+        norm_a += static_cast<double>(a[i]) * a[i];
+        norm_b += static_cast<double>(b[i]) * b[i];
+    }
+
+    return std::acos(std::clamp(dot / std::sqrt(norm_a * norm_b), -1.0, 1.0));
+}
+
+/// @brief Gets the length of @p vec.
+template <std::size_t N>
+auto length(const std::array<float, N>& vec) -> double
+{
+    double norm_sq = 0;
+    for (const float c : vec)
+        norm_sq += static_cast<double>(c) * c;
+
+    return std::sqrt(norm_sq);
+}
+
+/// @brief Tests that quaternions and unit vectors are measured, written and read correctly,
+/// and the array versions match the single value versions bit by bit.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_orientation(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    const int quat_bits = std::uniform_int_distribution<int>(SMALLEST_THREE_MIN_BITS_PER_COMPONENT,
+                                                             SMALLEST_THREE_MAX_BITS_PER_COMPONENT)(rng);
+    const int vec_bits =
+        std::uniform_int_distribution<int>(OCTAHEDRAL_MIN_BITS_PER_AXIS, OCTAHEDRAL_MAX_BITS_PER_AXIS)(rng);
+
+    std::vector<quaternion> quats(std::uniform_int_distribution<std::size_t>(0, MAX_ELEMENTS)(rng));
+    for (auto& quat : quats)
+        quat = random_quaternion(rng);
+
+    std::vector<vector3> vecs(std::uniform_int_distribution<std::size_t>(0, MAX_ELEMENTS)(rng));
+    for (auto& vec : vecs)
+        vec = random_vector(rng);
+
+    // Unaligned prefix, so that the arrays don't start on the word boundary.
+    const int prefix_bits = std::uniform_int_distribution<int>(1, 40)(rng);
+    const std::uint64_t prefix = rng() & ((std::uint64_t(1) << prefix_bits) - 1);
+    const std::uint64_t prefix_max = (std::uint64_t(1) << prefix_bits) - 1;
+
+    bit_stream_measurer measurer;
+    measurer.write(prefix, std::uint64_t(0), prefix_max);
+    measurer.write_quaternion_array(quats, quat_bits).write_unit_vector_array(vecs, vec_bits);
+    OR_ASSERT(measurer.used_bits() == static_cast<size_type>(prefix_bits + quats.size() * (2 + 3 * quat_bits) +
+                                                             vecs.size() * 2 * vec_bits),
+              "measured bits = ", measurer.used_bits());
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> single_buffer(words_length);
+    std::vector<word_type> array_buffer(words_length);
+
+    // Write one by one.
+    Writer single_writer(single_buffer.data(), words_length, logical_bytes_length);
+    single_writer.write(prefix, std::uint64_t(0), prefix_max);
+    for (const auto& quat : quats)
+        single_writer.write_quaternion(quat, quat_bits);
+    for (const auto& vec : vecs)
+        single_writer.write_unit_vector(vec, vec_bits);
+    OR_ASSERT(single_writer.flush_final(), "single writer failed");
+    OR_ASSERT(single_writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", single_writer.used_bits());
+
+    // Write as arrays.
+    Writer array_writer(array_buffer.data(), words_length, logical_bytes_length);
+    array_writer.write(prefix, std::uint64_t(0), prefix_max);
+    array_writer.write_quaternion_array(quats, quat_bits).write_unit_vector_array(vecs, vec_bits);
+    OR_ASSERT(array_writer.flush_final(), "array writer failed");
+    OR_ASSERT(array_writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", array_writer.used_bits());
+
+    OR_ASSERT(single_buffer == array_buffer, "array writer result differs from single writer");
+
+    // Worst case errors: a component step is `sqrt(2) / (2^bits - 1)` for quaternions,
+    // and an axis step on the octahedron is `2 / (2^bits - 1)` for unit vectors.
+    // The float precision bounds the error for the large bits.
+    const double quat_tolerance = 4 * std::sqrt(2.0) / ((std::uint64_t(1) << quat_bits) - 1) + 1e-3;
+    const double vec_tolerance = 4 * 2.0 / ((std::uint64_t(1) << vec_bits) - 1) + 1e-3;
+
+    // Read one by one, and as arrays.
+    for (const bool as_array : {false, true})
+    {
+        Reader reader(array_buffer.data(), words_length, logical_bytes_length);
+
+        std::uint64_t read_prefix;
+        reader.read(read_prefix, std::uint64_t(0), prefix_max);
+        OR_ASSERT(reader && read_prefix == prefix, "prefix mismatch");
+
+        std::vector<quaternion> read_quats(quats.size());
+        std::vector<vector3> read_vecs(vecs.size());
+        if (as_array)
+        {
+            reader.read_quaternion_array(read_quats, quat_bits).read_unit_vector_array(read_vecs, vec_bits);
+        }
+        else
+        {
+            for (auto& quat : read_quats)
+                reader.read_quaternion(quat, quat_bits);
+            for (auto& vec : read_vecs)
+                reader.read_unit_vector(vec, vec_bits);
+        }
+        OR_ASSERT(reader, "reader failed, as_array = ", as_array);
+        OR_ASSERT(reader.used_bits() == measurer.used_bits(), "read bits = ", reader.used_bits());
+
+        for (std::size_t i = 0; i < quats.size(); ++i)
+        {
+            const double angle = rotation_angle(quats[i], read_quats[i]);
+            OR_ASSERT(angle <= quat_tolerance, "quaternion #", i, ", bits = ", quat_bits, ", angle = ", angle);
+            OR_ASSERT(std::abs(length(read_quats[i]) - 1) <= 1e-5, "quaternion #", i, " not normalized");
+        }
+        for (std::size_t i = 0; i < vecs.size(); ++i)
+        {
+            const double angle = direction_angle(vecs[i], read_vecs[i]);
+            OR_ASSERT(angle <= vec_tolerance, "unit vector #", i, ", bits = ", vec_bits, ", angle = ", angle);
+            OR_ASSERT(std::abs(length(read_vecs[i]) - 1) <= 1e-5, "unit vector #", i, " not normalized");
+        }
+    }
+
+    // Invalid values and bits should fail, without writing anything.
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+
+    const quaternion invalid_quats[] = {{0, 0, 0, 0}, {nan, 0, 0, 1}, {inf, 0, 0, 1}};
+    for (const auto& quat : invalid_quats)
+    {
+        Writer fail_writer(array_buffer.data(), words_length, logical_bytes_length);
+        fail_writer.write_quaternion(quat);
+        OR_ASSERT(fail_writer.fail(), "writer not failed on invalid quaternion");
+
+        const quaternion array[] = {quaternion{0, 0, 0, 1}, quat};
+        Writer fail_array_writer(array_buffer.data(), words_length, logical_bytes_length);
+        fail_array_writer.write_quaternion_array(array);
+        OR_ASSERT(fail_array_writer.fail() && fail_array_writer.used_bits() == 0,
+                  "array writer not failed on invalid quaternion");
+    }
+
+    const vector3 invalid_vecs[] = {{0, 0, 0}, {nan, 0, 1}, {0, -inf, 0}};
+    for (const auto& vec : invalid_vecs)
+    {
+        Writer fail_writer(array_buffer.data(), words_length, logical_bytes_length);
+        fail_writer.write_unit_vector(vec);
+        OR_ASSERT(fail_writer.fail(), "writer not failed on invalid unit vector");
+
+        const vector3 array[] = {vector3{0, 0, 1}, vec};
+        Writer fail_array_writer(array_buffer.data(), words_length, logical_bytes_length);
+        fail_array_writer.write_unit_vector_array(array);
+        OR_ASSERT(fail_array_writer.fail() && fail_array_writer.used_bits() == 0,
+                  "array writer not failed on invalid unit vector");
+    }
+
+    for (const int bits : {SMALLEST_THREE_MIN_BITS_PER_COMPONENT - 1, SMALLEST_THREE_MAX_BITS_PER_COMPONENT + 1})
+    {
+        Writer fail_writer(array_buffer.data(), words_length, logical_bytes_length);
+        fail_writer.write_quaternion(quaternion{0, 0, 0, 1}, bits);
+        OR_ASSERT(fail_writer.fail(), "writer not failed on quaternion bits = ", bits);
+
+        Reader fail_reader(array_buffer.data(), words_length, logical_bytes_length);
+        quaternion quat;
+        fail_reader.read_quaternion(quat, bits);
+        OR_ASSERT(fail_reader.fail(), "reader not failed on quaternion bits = ", bits);
+
+        bit_stream_measurer fail_measurer;
+        fail_measurer.write_quaternion(quaternion{0, 0, 0, 1}, bits).write_quaternion_array(quats, bits);
+        OR_ASSERT(fail_measurer.used_bits() == 0, "measurer counted ", fail_measurer.used_bits(),
+                  " bits on quaternion bits = ", bits);
+    }
+    for (const int bits : {OCTAHEDRAL_MIN_BITS_PER_AXIS - 1, OCTAHEDRAL_MAX_BITS_PER_AXIS + 1})
+    {
+        Writer fail_writer(array_buffer.data(), words_length, logical_bytes_length);
+        fail_writer.write_unit_vector(vector3{0, 0, 1}, bits);
+        OR_ASSERT(fail_writer.fail(), "writer not failed on unit vector bits = ", bits);
+
+        Reader fail_reader(array_buffer.data(), words_length, logical_bytes_length);
+        vector3 vec;
+        fail_reader.read_unit_vector(vec, bits);
+        OR_ASSERT(fail_reader.fail(), "reader not failed on unit vector bits = ", bits);
+
+        bit_stream_measurer fail_measurer;
+        fail_measurer.write_unit_vector(vector3{0, 0, 1}, bits).write_unit_vector_array(vecs, bits);
+        OR_ASSERT(fail_measurer.used_bits() == 0, "measurer counted ", fail_measurer.used_bits(),
+                  " bits on unit vector bits = ", bits);
+    }
+
+    // Reading past the end should fail.
+    Reader overflow_reader(array_buffer.data(), words_length, logical_bytes_length);
+    std::vector<quaternion> overflow_quats(logical_bytes_length * 8 / (2 + 3 * quat_bits) + 1);
+    overflow_reader.read_quaternion_array(overflow_quats, quat_bits);
+    OR_ASSERT(overflow_reader.fail(), "reader not failed on reading past the end");
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_orientation_all(const seed_type seed)
+{
+    test_orientation<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_orientation<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_orientation`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_orientation <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream orientation test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_orientation_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_orientation_all(rng());
+    }
+
+    std::cout << "bit_stream orientation test succeeded" << std::endl;
+}
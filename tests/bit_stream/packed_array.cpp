@@ -0,0 +1,229 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define PA_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, ", prefix bits = ", prefix_bits, ", length = ", data.size(), \
+                        '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::size_t MAX_ARRAY_LENGTH = 1000;
+
+/// @brief Tests that `write_array()` & `read_array()` are same as writing & reading each element one by one.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @tparam Int Integer type of the elements.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader, ranged_integral Int>
+void test_packed_array(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+    using WideInt = std::conditional_t<std::is_signed_v<Int>, std::int64_t, std::uint64_t>;
+
+    rng_type rng(seed);
+
+    // Generate the inputs: prefix bits to unalign the stream, a range, and an array in it.
+    const int prefix_bits = std::uniform_int_distribution<int>(1, 40)(rng);
+    const std::uint64_t prefix_max = (std::uint64_t(1) << prefix_bits) - 1;
+    const std::uint64_t prefix = std::uniform_int_distribution<std::uint64_t>(0, prefix_max)(rng);
+
+    Int min = std::numeric_limits<Int>::min();
+    Int max = std::numeric_limits<Int>::max();
+    if (std::uniform_int_distribution<int>(0, 3)(rng) != 0)
+    {
+        const WideInt a = std::uniform_int_distribution<WideInt>(min, max)(rng);
+        const WideInt b = std::uniform_int_distribution<WideInt>(min, max)(rng);
+        if (a != b)
+        {
+            min = static_cast<Int>(std::min(a, b));
+            max = static_cast<Int>(std::max(a, b));
+        }
+    }
+
+    std::vector<Int> data(std::uniform_int_distribution<std::size_t>(0, MAX_ARRAY_LENGTH)(rng));
+    for (auto& elem : data)
+        elem = static_cast<Int>(std::uniform_int_distribution<WideInt>(min, max)(rng));
+
+    // Measure with both ways.
+    bit_stream_measurer measurer, array_measurer;
+    measurer.write(prefix, std::uint64_t(0), prefix_max);
+    array_measurer.write(prefix, std::uint64_t(0), prefix_max);
+    for (const Int elem : data)
+        measurer.write(elem, min, max);
+    array_measurer.write_array(std::span<const Int>(data), min, max);
+    PA_ASSERT(measurer.used_bits() == array_measurer.used_bits(), "measured bits mismatch");
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length), array_buffer(words_length);
+
+    // Write with both ways.
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    writer.write(prefix, std::uint64_t(0), prefix_max);
+    for (const Int elem : data)
+        writer.write(elem, min, max);
+    PA_ASSERT(writer.flush_final(), "writer failed");
+
+    Writer array_writer(array_buffer.data(), words_length, logical_bytes_length);
+    array_writer.write(prefix, std::uint64_t(0), prefix_max);
+    array_writer.write_array(std::span<const Int>(data), min, max);
+    PA_ASSERT(array_writer.flush_final(), "array writer failed");
+
+    PA_ASSERT(writer.used_bits() == array_writer.used_bits(), "written bits mismatch");
+    PA_ASSERT(buffer == array_buffer, "written buffer mismatch");
+
+    // Read with `read_array()`.
+    std::vector<Int> read_data(data.size());
+    std::uint64_t read_prefix;
+
+    Reader reader(array_buffer.data(), words_length, logical_bytes_length);
+    reader.read(read_prefix, std::uint64_t(0), prefix_max);
+    reader.read_array(std::span<Int>(read_data), min, max);
+    PA_ASSERT(reader, "reader failed");
+    PA_ASSERT(reader.used_bits() == array_writer.used_bits(), "read bits mismatch");
+    PA_ASSERT(read_prefix == prefix, "prefix mismatch");
+    PA_ASSERT(read_data == data, "array mismatch");
+
+    // Reading more than written should fail.
+    Reader overflow_reader(array_buffer.data(), words_length, logical_bytes_length);
+    read_data.resize(data.size() + 8 * sizeof(word_type) + 1);
+    overflow_reader.read(read_prefix, std::uint64_t(0), prefix_max);
+    overflow_reader.read_array(std::span<Int>(read_data), min, max);
+    PA_ASSERT(overflow_reader.fail(), "reader not failed on overflow");
+
+    // Out of range element should fail, and write nothing.
+    if (!data.empty() && (min != std::numeric_limits<Int>::min() || max != std::numeric_limits<Int>::max()))
+    {
+        const std::size_t index = std::uniform_int_distribution<std::size_t>(0, data.size() - 1)(rng);
+        data[index] = (min != std::numeric_limits<Int>::min()) ? static_cast<Int>(min - 1) : static_cast<Int>(max + 1);
+
+        Writer fail_writer(buffer.data(), words_length, logical_bytes_length);
+        fail_writer.write_array(std::span<const Int>(data), min, max);
+        PA_ASSERT(fail_writer.fail(), "writer not failed on out of range element #", index);
+        PA_ASSERT(fail_writer.used_bits() == 0, "failed writer wrote something");
+    }
+}
+
+/// @brief Tests out of range raw values are detected on read.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_packed_array_out_of_range_read(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    // Write in `[0, 7]`, but read in `[0, 4]`, which also uses 3 bits.
+    std::vector<std::uint8_t> data(std::uniform_int_distribution<std::size_t>(1, MAX_ARRAY_LENGTH)(rng));
+    for (auto& elem : data)
+        elem = static_cast<std::uint8_t>(std::uniform_int_distribution<unsigned>(0, 4)(rng));
+    const std::size_t index = std::uniform_int_distribution<std::size_t>(0, data.size() - 1)(rng);
+    data[index] = 7;
+
+    const int prefix_bits = std::uniform_int_distribution<int>(1, 40)(rng);
+    const std::uint64_t prefix_max = (std::uint64_t(1) << prefix_bits) - 1;
+
+    const size_type logical_bytes_length = static_cast<size_type>((prefix_bits + 3 * data.size() + 7) / 8);
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    writer.write(prefix_max, std::uint64_t(0), prefix_max);
+    writer.write_array(std::span<const std::uint8_t>(data), std::uint8_t(0), std::uint8_t(7));
+    PA_ASSERT(writer.flush_final(), "writer failed");
+
+    std::vector<std::uint8_t> read_data(data.size());
+    std::uint64_t read_prefix;
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    reader.read(read_prefix, std::uint64_t(0), prefix_max);
+    reader.read_array(std::span<std::uint8_t>(read_data), std::uint8_t(0), std::uint8_t(4));
+    PA_ASSERT(reader.fail(), "reader not failed on out of range element #", index);
+}
+
+/// @brief Tests every bit stream variants with every integer types.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_packed_array_all_types(const seed_type seed)
+{
+    test_packed_array<Writer, Reader, std::int8_t>(seed);
+    test_packed_array<Writer, Reader, std::uint8_t>(seed);
+    test_packed_array<Writer, Reader, std::int16_t>(seed);
+    test_packed_array<Writer, Reader, std::uint16_t>(seed);
+    test_packed_array<Writer, Reader, std::int32_t>(seed);
+    test_packed_array<Writer, Reader, std::uint32_t>(seed);
+    test_packed_array<Writer, Reader, std::int64_t>(seed);
+    test_packed_array<Writer, Reader, std::uint64_t>(seed);
+    test_packed_array_out_of_range_read<Writer, Reader>(seed);
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_packed_array_all(const seed_type seed)
+{
+    test_packed_array_all_types<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_packed_array_all_types<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_packed_array`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_packed_array <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream packed array test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_packed_array_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_packed_array_all(rng());
+    }
+
+    std::cout << "bit_stream packed array test succeeded" << std::endl;
+}
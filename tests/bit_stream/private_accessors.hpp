@@ -5,13 +5,17 @@
 namespace nalchi::tests
 {
 
+// Private variables are declared in the shared implementation of the bit streams.
+using writer_base = bit_stream_writer_base<std::uint32_t, std::uint64_t, bit_stream_writer>;
+using reader_base = bit_stream_reader_base<std::uint32_t, std::uint64_t, bit_stream_reader>;
+
 // Hack to access private variables of an arbitrary class.
 // See https://www.worldcadaccess.com/blog/2020/05/how-to-hack-c-with-templates-and-friends.html
-template <bit_stream_writer::scratch_type bit_stream_writer::* Scratch,
-          std::span<bit_stream_writer::word_type> bit_stream_writer::* Words, int bit_stream_writer::* ScratchIndex,
-          int bit_stream_writer::* WordsIndex, bit_stream_writer::size_type bit_stream_writer::* LogicalTotalBits,
-          bit_stream_writer::size_type bit_stream_writer::* LogicalUsedBits, bool bit_stream_writer::* InitFail,
-          bool bit_stream_writer::* Fail, bool bit_stream_writer::* FinalFlushed>
+template <bit_stream_writer::scratch_type writer_base::* Scratch,
+          std::span<bit_stream_writer::word_type> writer_base::* Words, int writer_base::* ScratchIndex,
+          int writer_base::* WordsIndex, bit_stream_writer::size_type writer_base::* LogicalTotalBits,
+          bit_stream_writer::size_type writer_base::* LogicalUsedBits, bool writer_base::* InitFail,
+          bool writer_base::* Fail, bool writer_base::* FinalFlushed>
 struct bit_stream_writer_private_accessor
 {
     friend auto get_writer_scratch(bit_stream_writer& writer) -> bit_stream_writer::scratch_type&
@@ -60,12 +64,11 @@ struct bit_stream_writer_private_accessor
     }
 };
 
-template <bit_stream_reader::scratch_type bit_stream_reader::* Scratch,
-          std::span<const bit_stream_reader::word_type> bit_stream_reader::* Words,
-          int bit_stream_reader::* ScratchBits, int bit_stream_reader::* WordsIndex,
-          bit_stream_reader::size_type bit_stream_reader::* LogicalTotalBits,
-          bit_stream_reader::size_type bit_stream_reader::* LogicalUsedBits, bool bit_stream_reader::* InitFail,
-          bool bit_stream_reader::* Fail>
+template <bit_stream_reader::scratch_type reader_base::* Scratch,
+          std::span<const bit_stream_reader::word_type> reader_base::* Words, int reader_base::* ScratchBits,
+          int reader_base::* WordsIndex, bit_stream_reader::size_type reader_base::* LogicalTotalBits,
+          bit_stream_reader::size_type reader_base::* LogicalUsedBits, bool reader_base::* InitFail,
+          bool reader_base::* Fail>
 struct bit_stream_reader_private_accessor
 {
     friend auto get_reader_scratch(bit_stream_reader& reader) -> bit_stream_reader::scratch_type&
@@ -110,14 +113,13 @@ struct bit_stream_reader_private_accessor
 };
 
 template struct bit_stream_writer_private_accessor<
-    &bit_stream_writer::_scratch, &bit_stream_writer::_words, &bit_stream_writer::_scratch_index,
-    &bit_stream_writer::_words_index, &bit_stream_writer::_logical_total_bits, &bit_stream_writer::_logical_used_bits,
-    &bit_stream_writer::_init_fail, &bit_stream_writer::_fail, &bit_stream_writer::_final_flushed>;
+    &writer_base::_scratch, &writer_base::_words, &writer_base::_scratch_index, &writer_base::_words_index,
+    &writer_base::_logical_total_bits, &writer_base::_logical_used_bits, &writer_base::_init_fail, &writer_base::_fail,
+    &writer_base::_final_flushed>;
 
 template struct bit_stream_reader_private_accessor<
-    &bit_stream_reader::_scratch, &bit_stream_reader::_words, &bit_stream_reader::_scratch_bits,
-    &bit_stream_reader::_words_index, &bit_stream_reader::_logical_total_bits, &bit_stream_reader::_logical_used_bits,
-    &bit_stream_reader::_init_fail, &bit_stream_reader::_fail>;
+    &reader_base::_scratch, &reader_base::_words, &reader_base::_scratch_bits, &reader_base::_words_index,
+    &reader_base::_logical_total_bits, &reader_base::_logical_used_bits, &reader_base::_init_fail, &reader_base::_fail>;
 
 auto get_writer_scratch(bit_stream_writer&) -> bit_stream_writer::scratch_type&;
 auto get_writer_words(bit_stream_writer& writer) -> std::span<bit_stream_writer::word_type>&;
@@ -0,0 +1,223 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define QT_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::size_t MAX_FIELDS = 256;
+
+/// @brief Quantized float to write.
+struct quantized_field
+{
+    float value;
+    float min;
+    float max;
+    float resolution;
+};
+
+/// @brief Tests that every half float converts to float and back exactly,
+/// and the float to half conversion rounds to the nearest even.
+void test_half_conversion()
+{
+    const seed_type seed = 0;
+
+    for (std::uint32_t i = 0; i <= 0xFFFF; ++i)
+    {
+        const auto half = static_cast<std::uint16_t>(i);
+        const float value = half_to_float(half);
+
+        if (std::isnan(value))
+            QT_ASSERT(std::isnan(half_to_float(float_to_half(value))), "half = ", half, " is not NaN after round trip");
+        else
+            QT_ASSERT(float_to_half(value) == half, "half = ", half, ", got = ", float_to_half(value));
+
+        // Halfway to the next half float should round to even.
+        if ((half & 0x7FFF) < 0x7BFF)
+        {
+            const float next = half_to_float(static_cast<std::uint16_t>(half + 1));
+            const float halfway = static_cast<float>((static_cast<double>(value) + next) / 2);
+            const auto expected = static_cast<std::uint16_t>((half & 1) ? half + 1 : half);
+            QT_ASSERT(float_to_half(halfway) == expected, "halfway after half = ", half, ", got = ",
+                      float_to_half(halfway));
+        }
+    }
+
+    QT_ASSERT(float_to_half(65504.0f) == 0x7BFF);
+    QT_ASSERT(float_to_half(65519.0f) == 0x7BFF);
+    QT_ASSERT(float_to_half(65520.0f) == 0x7C00);
+    QT_ASSERT(float_to_half(-1e10f) == 0xFC00);
+    QT_ASSERT(float_to_half(std::numeric_limits<float>::infinity()) == 0x7C00);
+    QT_ASSERT(float_to_half(0x1p-25f) == 0x0000);
+    QT_ASSERT(float_to_half(0x1.000002p-25f) == 0x0001);
+    QT_ASSERT(float_to_half(-0.0f) == 0x8000);
+}
+
+/// @brief Tests that quantized floats are measured, written and read correctly.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_quantization(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    // Generate the fields: quantized ones, and half floats in between.
+    std::vector<quantized_field> fields(std::uniform_int_distribution<std::size_t>(0, MAX_FIELDS)(rng));
+    for (auto& f : fields)
+    {
+        const float center = std::uniform_real_distribution<float>(-1000, 1000)(rng);
+        const float extent = std::uniform_real_distribution<float>(0.5f, 2000)(rng);
+        f.min = center - extent;
+        f.max = center + extent;
+        f.resolution = std::pow(10.0f, std::uniform_real_distribution<float>(-3, 1)(rng));
+
+        // Sometimes pick the bounds themselves.
+        switch (std::uniform_int_distribution<int>(0, 9)(rng))
+        {
+        case 0:
+            f.value = f.min;
+            break;
+        case 1:
+            f.value = f.max;
+            break;
+        default:
+            f.value = std::uniform_real_distribution<float>(f.min, f.max)(rng);
+            break;
+        }
+    }
+
+    bit_stream_measurer measurer;
+    for (const auto& f : fields)
+        measurer.write_quantized(f.value, f.min, f.max, f.resolution).write_half(f.value);
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    for (const auto& f : fields)
+        writer.write_quantized(f.value, f.min, f.max, f.resolution).write_half(f.value);
+    QT_ASSERT(writer.flush_final(), "writer failed");
+    QT_ASSERT(writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", writer.used_bits());
+
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        const auto& f = fields[i];
+
+        float quantized, half;
+        reader.read_quantized(quantized, f.min, f.max, f.resolution).read_half(half);
+        QT_ASSERT(reader, "read #", i, " failed");
+
+        // Allow the float rounding error on top of the half resolution.
+        const float tolerance = f.resolution / 2 + 4 * std::numeric_limits<float>::epsilon() * std::abs(f.max - f.min) +
+                                std::numeric_limits<float>::epsilon() * std::max(std::abs(f.min), std::abs(f.max));
+        QT_ASSERT(std::abs(quantized - f.value) <= tolerance, "read #", i, ", value = ", f.value, ", got = ", quantized,
+                  ", resolution = ", f.resolution);
+        QT_ASSERT(f.min <= quantized && quantized <= f.max, "read #", i, " out of range, got = ", quantized);
+
+        QT_ASSERT(half == half_to_float(float_to_half(f.value)), "read #", i, " half mismatch");
+    }
+
+    // Out of range, NaN and invalid ranges should fail.
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const quantized_field invalid_fields[] = {
+        {1.5f, -1.0f, 1.0f, 0.1f}, {nan, -1.0f, 1.0f, 0.1f},   {0.0f, 1.0f, 1.0f, 0.1f},
+        {0.0f, -1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 1.0f, -0.1f}, {0.0f, -1e30f, 1e30f, 1e-30f},
+    };
+    for (const auto& f : invalid_fields)
+    {
+        Writer fail_writer(buffer.data(), words_length, logical_bytes_length);
+        fail_writer.write_quantized(f.value, f.min, f.max, f.resolution);
+        QT_ASSERT(fail_writer.fail(), "writer not failed on value = ", f.value, ", min = ", f.min, ", max = ", f.max,
+                  ", resolution = ", f.resolution);
+    }
+
+    // Quantized value exceeding the range should fail on read.
+    // `[0, 2]` with `0.5` resolution has 5 steps in 3 bits.
+    Writer raw_writer(buffer.data(), words_length, logical_bytes_length);
+    raw_writer.write(std::uint8_t(7), std::uint8_t(0), std::uint8_t(7));
+    QT_ASSERT(raw_writer.flush_final(), "raw writer failed");
+
+    Reader fail_reader(buffer.data(), words_length, logical_bytes_length);
+    float out_of_range;
+    fail_reader.read_quantized(out_of_range, 0.0f, 2.0f, 0.5f);
+    QT_ASSERT(fail_reader.fail(), "reader not failed on quantized value exceeding the range");
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_quantization_all(const seed_type seed)
+{
+    test_quantization<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_quantization<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_quantization`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_quantization <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream quantization test ===\n";
+
+    test_half_conversion();
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_quantization_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_quantization_all(rng());
+    }
+
+    std::cout << "bit_stream quantization test succeeded" << std::endl;
+}
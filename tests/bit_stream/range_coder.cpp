@@ -0,0 +1,324 @@
+#include <nalchi/bit_stream.hpp>
+#include <nalchi/range_coder.hpp>
+
+#include "../assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define RC_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::size_t MAX_OPERATIONS = 2000;
+constexpr std::size_t BIT_MODELS = 3;
+constexpr std::size_t SYMBOLS = 16;
+
+enum class operation_kind
+{
+    BIT,
+    SYMBOL,
+    RAW_BITS,
+};
+
+/// @brief Operation to code in the range coded section.
+struct operation
+{
+    operation_kind kind;
+    std::size_t model; ///< Index of the bit model, only for `BIT`.
+    std::uint32_t value;
+    int bits; ///< Number of bits, only for `RAW_BITS`.
+};
+
+/// @brief Models shared by the writer and the reader, which must start from the same state.
+struct models
+{
+    std::array<adaptive_bit_model, BIT_MODELS> bits;
+    adaptive_symbol_model<SYMBOLS> symbol;
+};
+
+/// @brief Generates random operations, whose bits and symbols are skewed.
+/// @param rng Rng to use.
+/// @return Generated operations.
+auto generate_operations(rng_type& rng) -> std::vector<operation>
+{
+    std::vector<operation> ops(std::uniform_int_distribution<std::size_t>(0, MAX_OPERATIONS)(rng));
+
+    // Each bit model has its own probability, including the extreme ones.
+    const double random_probability = std::uniform_real_distribution<double>(0, 1)(rng);
+    const double extreme_probability = std::uniform_int_distribution<int>(0, 1)(rng) ? 0.999 : 0.001;
+    const std::array<double, BIT_MODELS> probabilities = {0.5, random_probability, extreme_probability};
+    std::geometric_distribution<std::uint32_t> symbol_dist(std::uniform_real_distribution<double>(0.05, 0.9)(rng));
+
+    for (auto& op : ops)
+    {
+        switch (std::uniform_int_distribution<int>(0, 9)(rng))
+        {
+        case 0:
+            op.kind = operation_kind::RAW_BITS;
+            op.bits = std::uniform_int_distribution<int>(1, 32)(rng);
+            op.value = static_cast<std::uint32_t>(rng() >> (64 - op.bits));
+            break;
+        case 1:
+        case 2:
+        case 3:
+            op.kind = operation_kind::SYMBOL;
+            op.value = std::min<std::uint32_t>(symbol_dist(rng), SYMBOLS - 1);
+            break;
+        default:
+            op.kind = operation_kind::BIT;
+            op.model = std::uniform_int_distribution<std::size_t>(0, BIT_MODELS - 1)(rng);
+            op.value = std::bernoulli_distribution(probabilities[op.model])(rng);
+            break;
+        }
+    }
+
+    return ops;
+}
+
+/// @brief Codes @p ops with @p coder.
+template <typename Coder>
+void write_operations(Coder& coder, const std::vector<operation>& ops)
+{
+    models m;
+    for (const auto& op : ops)
+    {
+        switch (op.kind)
+        {
+        case operation_kind::BIT:
+            coder.write_bit(m.bits[op.model], op.value != 0);
+            break;
+        case operation_kind::SYMBOL:
+            coder.write_symbol(m.symbol, op.value);
+            break;
+        case operation_kind::RAW_BITS:
+            coder.write_raw_bits(op.value, op.bits);
+            break;
+        }
+    }
+}
+
+/// @brief Tests that a range coded section between the normal fields is measured, written and read correctly.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_range_coder(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    const auto ops = generate_operations(rng);
+
+    // Unaligned prefix and suffix, so that the section doesn't start on the byte boundary.
+    const int prefix_bits = std::uniform_int_distribution<int>(1, 40)(rng);
+    const std::uint64_t prefix_max = (std::uint64_t(1) << prefix_bits) - 1;
+    const std::uint64_t prefix = rng() & prefix_max;
+    const std::uint32_t suffix = static_cast<std::uint32_t>(rng());
+
+    bit_stream_measurer measurer;
+    measurer.write(prefix, std::uint64_t(0), prefix_max);
+    range_coder_writer measuring_coder(measurer);
+    write_operations(measuring_coder, ops);
+    RC_ASSERT(measuring_coder.flush(), "measuring coder failed");
+    measurer.write(suffix);
+
+    const size_type logical_bytes_length = measurer.used_bytes();
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    writer.write(prefix, std::uint64_t(0), prefix_max);
+    range_coder_writer coder(writer);
+    write_operations(coder, ops);
+    RC_ASSERT(coder.flush(), "coder failed");
+    writer.write(suffix);
+    RC_ASSERT(writer.flush_final(), "writer failed");
+    RC_ASSERT(writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", writer.used_bits());
+
+    // Writing after `flush()` should fail.
+    adaptive_bit_model unused_model;
+    coder.write_bit(unused_model, true);
+    RC_ASSERT(coder.fail(), "coder not failed on writing after flush");
+
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    std::uint64_t read_prefix;
+    reader.read(read_prefix, std::uint64_t(0), prefix_max);
+    RC_ASSERT(read_prefix == prefix, "prefix mismatch");
+
+    {
+        range_coder_reader decoder(reader);
+        models m;
+        for (std::size_t i = 0; i < ops.size(); ++i)
+        {
+            const auto& op = ops[i];
+            std::uint32_t value = 0;
+            switch (op.kind)
+            {
+            case operation_kind::BIT: {
+                bool bit;
+                decoder.read_bit(m.bits[op.model], bit);
+                value = bit;
+                break;
+            }
+            case operation_kind::SYMBOL: {
+                std::size_t symbol;
+                decoder.read_symbol(m.symbol, symbol);
+                value = static_cast<std::uint32_t>(symbol);
+                break;
+            }
+            case operation_kind::RAW_BITS:
+                decoder.read_raw_bits(value, op.bits);
+                break;
+            }
+
+            RC_ASSERT(decoder, "decode #", i, " failed");
+            RC_ASSERT(value == op.value, "decode #", i, ", kind = ", static_cast<int>(op.kind),
+                      ", expected = ", op.value, ", got = ", value);
+        }
+    }
+
+    // The section should end exactly where the writer has ended it.
+    std::uint32_t read_suffix;
+    reader.read(read_suffix);
+    RC_ASSERT(reader, "reader failed");
+    RC_ASSERT(read_suffix == suffix, "suffix mismatch, expected = ", suffix, ", got = ", read_suffix);
+    RC_ASSERT(reader.used_bits() == measurer.used_bits(), "read bits = ", reader.used_bits());
+
+    // Buffer a byte smaller than the section should fail.
+    const size_type small_bytes_length = logical_bytes_length - sizeof(suffix) - 1;
+    Writer small_writer(buffer.data(), words_length, small_bytes_length);
+    small_writer.write(prefix, std::uint64_t(0), prefix_max);
+    range_coder_writer small_coder(small_writer);
+    write_operations(small_coder, ops);
+    RC_ASSERT(!small_coder.flush(), "coder not failed on too small buffer");
+}
+
+/// @brief Tests the compression ratio and the invalid arguments, which don't depend on the seed.
+/// @tparam Writer Bit stream writer type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer>
+void test_range_coder_fixed(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    // Heavily skewed bits should take far less than a bit each.
+    constexpr int SKEWED_BITS = 4000;
+    bit_stream_measurer measurer;
+    range_coder_writer skewed_coder(measurer);
+    adaptive_bit_model model;
+    for (int i = 0; i < SKEWED_BITS; ++i)
+        skewed_coder.write_bit(model, (i % 100) == 0);
+    RC_ASSERT(skewed_coder.flush(), "skewed coder failed");
+    RC_ASSERT(measurer.used_bits() < SKEWED_BITS / 4, "skewed bits took ", measurer.used_bits(), " bits");
+
+    // A symbol coded many times should stay dominant, and take far less than a bit each.
+    // Its frequency would exceed `std::uint16_t` if the model rescaled too late.
+    constexpr int SKEWED_SYMBOLS = 10000;
+    constexpr std::size_t SKEWED_SYMBOL = 3;
+    bit_stream_measurer symbol_measurer;
+    range_coder_writer skewed_symbol_coder(symbol_measurer);
+    adaptive_symbol_model<SYMBOLS> skewed_model;
+    for (int i = 0; i < SKEWED_SYMBOLS; ++i)
+    {
+        skewed_symbol_coder.write_symbol(skewed_model, SKEWED_SYMBOL);
+        if (i < 100)
+            continue;
+
+        RC_ASSERT(skewed_model.total() <= skewed_model.MAX_TOTAL, "total = ", skewed_model.total());
+        RC_ASSERT(skewed_model.frequency(SKEWED_SYMBOL) * 10 > skewed_model.total() * 9, "frequency = ",
+                  skewed_model.frequency(SKEWED_SYMBOL), ", total = ", skewed_model.total(), " after ", i + 1,
+                  " symbols");
+    }
+    RC_ASSERT(skewed_symbol_coder.flush(), "skewed symbol coder failed");
+    RC_ASSERT(symbol_measurer.used_bits() < SKEWED_SYMBOLS / 8, "skewed symbols took ", symbol_measurer.used_bits(),
+              " bits");
+
+    // Empty section takes only the flushed bytes.
+    bit_stream_measurer empty_measurer;
+    range_coder_writer empty_coder(empty_measurer);
+    RC_ASSERT(empty_coder.flush() && empty_measurer.used_bytes() == 4, "empty section took ",
+              empty_measurer.used_bytes(), " bytes");
+
+    word_type buffer[4] = {};
+    Writer writer(buffer, 4, sizeof(buffer));
+
+    range_coder_writer symbol_coder(writer);
+    adaptive_symbol_model<SYMBOLS> symbol_model;
+    symbol_coder.write_symbol(symbol_model, SYMBOLS);
+    RC_ASSERT(symbol_coder.fail(), "coder not failed on invalid symbol");
+
+    range_coder_writer raw_coder(writer);
+    raw_coder.write_raw_bits(0, 33);
+    RC_ASSERT(raw_coder.fail(), "coder not failed on too many raw bits");
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_range_coder_all(const seed_type seed)
+{
+    test_range_coder<bit_stream_writer, bit_stream_reader>(seed);
+    test_range_coder_fixed<bit_stream_writer>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_range_coder<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+    test_range_coder_fixed<wide_bit_stream_writer>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_range_coder`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_range_coder <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream range coder test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_range_coder_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_range_coder_all(rng());
+    }
+
+    std::cout << "bit_stream range coder test succeeded" << std::endl;
+}
@@ -0,0 +1,285 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define RV_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, ", prefix bits = ", prefix_bits, ", length = ", str.length(), \
+                        '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using word_type = bit_stream_writer::word_type;
+using size_type = bit_stream_writer::size_type;
+
+constexpr size_type MAX_STR_LENGTH = 300;
+
+/// @brief Tests that `read_view()` reads the same string as the owning `read()`,
+/// and views directly into the buffer whenever it's possible.
+/// @tparam CharT Character type to test.
+/// @param seed Internal seed to run the rng.
+template <character CharT>
+void test_read_view(const seed_type seed)
+{
+    using UChar = std::make_unsigned_t<CharT>;
+
+    rng_type rng(seed);
+
+    // Generate the inputs: prefix bits to unalign the stream, a string, and a suffix.
+    const int prefix_bits = std::uniform_int_distribution<int>(0, 40)(rng);
+    const std::uint64_t prefix_max = (std::uint64_t(1) << prefix_bits) - 1;
+    const std::uint64_t prefix = std::uniform_int_distribution<std::uint64_t>(0, prefix_max)(rng);
+
+    std::basic_string<CharT> str(std::uniform_int_distribution<size_type>(0, MAX_STR_LENGTH)(rng), CharT(0));
+    for (auto& ch : str)
+        ch = static_cast<CharT>(std::uniform_int_distribution<std::uint64_t>(0, UChar(-1))(rng));
+
+    const std::uint16_t suffix = static_cast<std::uint16_t>(std::uniform_int_distribution<unsigned>(0, 0xFFFF)(rng));
+
+    // Write them.
+    bit_stream_measurer measurer;
+    if (prefix_bits > 0)
+        measurer.write(prefix, std::uint64_t(0), prefix_max);
+    measurer.write(std::basic_string_view<CharT>(str));
+    measurer.write(suffix);
+
+    const size_type logical_bytes_length = measurer.used_bytes();
+    std::vector<word_type> buffer((logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type));
+
+    bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), logical_bytes_length);
+    if (prefix_bits > 0)
+        writer.write(prefix, std::uint64_t(0), prefix_max);
+    writer.write(std::basic_string_view<CharT>(str));
+    writer.write(suffix);
+    RV_ASSERT(writer.flush_final(), "writer failed");
+
+    // Read them with `read_view()`.
+    std::vector<CharT> scratch(MAX_STR_LENGTH);
+    std::basic_string_view<CharT> view;
+    std::uint64_t read_prefix = 0;
+    std::uint16_t read_suffix;
+
+    bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), logical_bytes_length);
+    if (prefix_bits > 0)
+        reader.read(read_prefix, std::uint64_t(0), prefix_max);
+    const size_type str_begin_bits = reader.used_bits();
+    reader.read_view(view, MAX_STR_LENGTH, std::span<CharT>(scratch));
+    reader.read(read_suffix);
+    RV_ASSERT(reader, "reader failed");
+
+    RV_ASSERT(read_prefix == prefix, "prefix mismatch");
+    RV_ASSERT(view == str, "string mismatch");
+    RV_ASSERT(read_suffix == suffix, "suffix mismatch");
+
+    // Check if it viewed directly into the buffer when it's possible.
+    constexpr bool VIEWABLE =
+        std::is_unsigned_v<CharT> && (sizeof(CharT) == 1 || std::endian::native == std::endian::little);
+
+    const auto buffer_begin = reinterpret_cast<std::uintptr_t>(buffer.data());
+    const auto buffer_end = reinterpret_cast<std::uintptr_t>(buffer.data() + buffer.size());
+    const auto view_begin = reinterpret_cast<std::uintptr_t>(view.data());
+    const bool viewed_directly = buffer_begin <= view_begin && view_begin < buffer_end;
+
+    // String payload begins after the string length prefix, which is 2 + 8 or 2 + 16 bits.
+    const size_type payload_begin_bits = str_begin_bits + 2 + (str.length() <= 0xFF ? 8 : 16);
+    const bool aligned = (payload_begin_bits % (8 * sizeof(CharT)) == 0);
+
+    if (!str.empty())
+        RV_ASSERT(viewed_directly == (VIEWABLE && aligned), "expected direct view = ", (VIEWABLE && aligned),
+                  ", got = ", viewed_directly);
+
+    // Too small scratch should fail, if it couldn't view directly.
+    if (!str.empty() && !viewed_directly)
+    {
+        bit_stream_reader small_reader(buffer.data(), static_cast<size_type>(buffer.size()), logical_bytes_length);
+        if (prefix_bits > 0)
+            small_reader.read(read_prefix, std::uint64_t(0), prefix_max);
+        small_reader.read_view(view, MAX_STR_LENGTH, std::span<CharT>(scratch.data(), str.length() - 1));
+        RV_ASSERT(small_reader.fail(), "reader not failed on too small scratch");
+    }
+}
+
+/// @brief Checks that `read_aligned_string_view()` reads the string written with `write_aligned_string()`,
+/// and always views directly into the buffer when the character type is viewable.
+/// @tparam CharT Character type to test.
+/// @param seed Internal seed used to generate the inputs, which is only for the failure message.
+/// @param prefix_bits Number of bits written before the string to unalign the stream.
+/// @param prefix Value written before the string.
+/// @param str String to write.
+template <character CharT>
+void check_aligned_string_view(const seed_type seed, const int prefix_bits, const std::uint64_t prefix,
+                               const std::basic_string<CharT>& str)
+{
+    const std::uint64_t prefix_max = (std::uint64_t(1) << prefix_bits) - 1;
+    const std::uint16_t suffix = 0xA55A;
+
+    // Write them.
+    bit_stream_measurer measurer;
+    if (prefix_bits > 0)
+        measurer.write(prefix, std::uint64_t(0), prefix_max);
+    measurer.write_aligned_string(str);
+    measurer.write(suffix);
+
+    const size_type logical_bytes_length = measurer.used_bytes();
+    std::vector<word_type> buffer((logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type));
+
+    bit_stream_writer writer(buffer.data(), static_cast<size_type>(buffer.size()), logical_bytes_length);
+    if (prefix_bits > 0)
+        writer.write(prefix, std::uint64_t(0), prefix_max);
+    writer.write_aligned_string(str);
+    writer.write(suffix);
+    RV_ASSERT(writer.used_bits() == measurer.used_bits(), "measurer mismatch, writer = ", writer.used_bits(),
+              ", measurer = ", measurer.used_bits());
+    RV_ASSERT(writer.flush_final(), "writer failed");
+
+    // Read them with `read_aligned_string_view()`.
+    std::vector<CharT> scratch(MAX_STR_LENGTH);
+    std::basic_string_view<CharT> view;
+    std::uint64_t read_prefix = 0;
+    std::uint16_t read_suffix;
+
+    bit_stream_reader reader(buffer.data(), static_cast<size_type>(buffer.size()), logical_bytes_length);
+    if (prefix_bits > 0)
+        reader.read(read_prefix, std::uint64_t(0), prefix_max);
+    reader.read_aligned_string_view(view, MAX_STR_LENGTH, std::span<CharT>(scratch));
+    reader.read(read_suffix);
+    RV_ASSERT(reader, "reader failed");
+
+    RV_ASSERT(read_prefix == prefix, "prefix mismatch");
+    RV_ASSERT(view == str, "string mismatch");
+    RV_ASSERT(read_suffix == suffix, "suffix mismatch");
+
+    // Check if it viewed directly into the buffer, regardless of the prefix bits.
+    constexpr bool VIEWABLE =
+        std::is_unsigned_v<CharT> && (sizeof(CharT) == 1 || std::endian::native == std::endian::little);
+
+    const auto buffer_begin = reinterpret_cast<std::uintptr_t>(buffer.data());
+    const auto buffer_end = reinterpret_cast<std::uintptr_t>(buffer.data() + buffer.size());
+    const auto view_begin = reinterpret_cast<std::uintptr_t>(view.data());
+    const bool viewed_directly = buffer_begin <= view_begin && view_begin < buffer_end;
+
+    if (!str.empty())
+        RV_ASSERT(viewed_directly == VIEWABLE, "expected direct view = ", VIEWABLE, ", got = ", viewed_directly);
+}
+
+/// @brief Tests `write_aligned_string()` and `read_aligned_string_view()` with random inputs.
+/// @tparam CharT Character type to test.
+/// @param seed Internal seed to run the rng.
+template <character CharT>
+void test_read_aligned_string_view(const seed_type seed)
+{
+    using UChar = std::make_unsigned_t<CharT>;
+
+    rng_type rng(seed);
+
+    const int prefix_bits = std::uniform_int_distribution<int>(0, 40)(rng);
+    const std::uint64_t prefix =
+        std::uniform_int_distribution<std::uint64_t>(0, (std::uint64_t(1) << prefix_bits) - 1)(rng);
+
+    std::basic_string<CharT> str(std::uniform_int_distribution<size_type>(0, MAX_STR_LENGTH)(rng), CharT(0));
+    for (auto& ch : str)
+        ch = static_cast<CharT>(std::uniform_int_distribution<std::uint64_t>(0, UChar(-1))(rng));
+
+    check_aligned_string_view(seed, prefix_bits, prefix, str);
+}
+
+/// @brief Tests that `read_aligned_string_view()` views directly on every stream position,
+/// for both 8-bit and 16-bit length prefixes.
+/// @tparam CharT Character type to test.
+template <character CharT>
+void test_aligned_string_direct_view()
+{
+    for (int prefix_bits = 0; prefix_bits <= 40; ++prefix_bits)
+    {
+        for (const size_type length : {size_type(1), size_type(0xFF), size_type(0x100), MAX_STR_LENGTH})
+        {
+            std::basic_string<CharT> str(length, CharT(0));
+            for (size_type i = 0; i < length; ++i)
+                str[i] = static_cast<CharT>('a' + i % 26);
+
+            check_aligned_string_view(seed_type(0), prefix_bits, std::uint64_t(prefix_bits) / 2, str);
+        }
+    }
+}
+
+/// @brief Tests `read_view()` and `read_aligned_string_view()` for every character types.
+/// @param seed Internal seed to run the rng.
+void test_read_view_all(const seed_type seed)
+{
+    test_read_view<char>(seed);
+    test_read_view<wchar_t>(seed);
+    test_read_view<char8_t>(seed);
+    test_read_view<char16_t>(seed);
+    test_read_view<char32_t>(seed);
+
+    test_read_aligned_string_view<char>(seed);
+    test_read_aligned_string_view<wchar_t>(seed);
+    test_read_aligned_string_view<char8_t>(seed);
+    test_read_aligned_string_view<char16_t>(seed);
+    test_read_aligned_string_view<char32_t>(seed);
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_read_view`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_read_view <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream read view test ===\n";
+
+    // The direct view of the aligned strings doesn't depend on the seed, so check it on every stream position once.
+    test_aligned_string_direct_view<char8_t>();
+    test_aligned_string_direct_view<char16_t>();
+    test_aligned_string_direct_view<char32_t>();
+    if constexpr (std::is_unsigned_v<char>)
+        test_aligned_string_direct_view<char>();
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_read_view_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_read_view_all(rng());
+    }
+
+    std::cout << "bit_stream read view test succeeded" << std::endl;
+}
@@ -0,0 +1,278 @@
+#include <nalchi/serialize.hpp>
+
+#include "../assert.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define SR_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::uint32_t MAX_PLAYERS = 32;
+constexpr size_type MAX_NAME_LENGTH = 16;
+
+constexpr float POSITION_MIN = -1000.0f;
+constexpr float POSITION_MAX = 1000.0f;
+constexpr float POSITION_RESOLUTION = 0.01f;
+
+constexpr int UNIT_VECTOR_BITS = 12;
+
+static_assert(serialize_stream<bit_stream_writer>);
+static_assert(serialize_stream<bit_stream_reader>);
+static_assert(serialize_stream<bit_stream_measurer>);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+static_assert(serialize_stream<wide_bit_stream_writer>);
+static_assert(serialize_stream<wide_bit_stream_reader>);
+#endif
+
+/// @brief Nested struct serialized with a member function.
+struct vitals
+{
+    int hp;
+    int mana;
+    bool alive;
+
+    template <serialize_stream Stream>
+    void serialize(Stream& stream)
+    {
+        nalchi::serialize(stream, hp, 0, 100);
+        nalchi::serialize<0, 500>(stream, mana);
+        nalchi::serialize(stream, alive);
+    }
+
+    bool operator==(const vitals&) const = default;
+};
+
+/// @brief Struct serialized with a free function.
+struct player_state
+{
+    std::uint32_t id;
+    std::int64_t gold;
+    std::int32_t ammo; ///< Delta encoded against `ammo_baseline()`.
+    std::array<float, 3> position;
+    std::array<float, 3> facing;
+    float speed;
+    double score;
+    vitals vit;
+    std::string name;
+    std::array<std::uint8_t, 8> token;
+};
+
+/// @brief Gets the baseline of `player_state::ammo`, which the reader knows from the `id` read before it.
+auto ammo_baseline(const player_state& player) -> std::int32_t
+{
+    return static_cast<std::int32_t>(player.id % 1000);
+}
+
+/// @brief Message with a variable number of players.
+struct snapshot
+{
+    std::uint16_t tick;
+    std::vector<player_state> players;
+};
+
+template <serialize_stream Stream>
+auto serialize(Stream& stream, player_state& player) -> Stream&
+{
+    serialize(stream, player.id);
+    serialize_varint(stream, player.gold);
+    serialize_delta(stream, player.ammo, ammo_baseline(player), 0, 999);
+    for (float& c : player.position)
+        serialize_quantized(stream, c, POSITION_MIN, POSITION_MAX, POSITION_RESOLUTION);
+    serialize_unit_vector(stream, player.facing, UNIT_VECTOR_BITS);
+    serialize_half(stream, player.speed);
+    serialize(stream, player.score);
+    serialize(stream, player.vit);
+    serialize(stream, player.name, MAX_NAME_LENGTH);
+    return serialize_bytes(stream, player.token.data(), static_cast<size_type>(player.token.size()));
+}
+
+template <serialize_stream Stream>
+auto serialize(Stream& stream, snapshot& snap) -> Stream&
+{
+    serialize(stream, snap.tick);
+
+    auto count = static_cast<std::uint32_t>(snap.players.size());
+    if (!serialize(stream, count, 0, MAX_PLAYERS))
+        return stream;
+
+    if constexpr (Stream::is_reading)
+        snap.players.resize(count);
+
+    for (auto& player : snap.players)
+        serialize(stream, player);
+
+    return stream;
+}
+
+/// @brief Generates a random snapshot, whose lossy fields are already close to the quantization steps.
+/// @param rng Rng to use.
+/// @return Generated snapshot.
+auto generate_snapshot(rng_type& rng) -> snapshot
+{
+    snapshot snap;
+    snap.tick = static_cast<std::uint16_t>(rng());
+    snap.players.resize(std::uniform_int_distribution<std::size_t>(0, MAX_PLAYERS)(rng));
+
+    const std::int64_t q_max = quantized_max(POSITION_MIN, POSITION_MAX, POSITION_RESOLUTION);
+
+    for (auto& player : snap.players)
+    {
+        player.id = static_cast<std::uint32_t>(rng());
+        player.gold = static_cast<std::int64_t>(rng()) >> std::uniform_int_distribution<int>(0, 63)(rng);
+        player.ammo = std::uniform_int_distribution<int>(0, 1)(rng)
+                          ? ammo_baseline(player)
+                          : std::uniform_int_distribution<std::int32_t>(0, 999)(rng);
+        for (float& c : player.position)
+            c = dequantize(std::uniform_int_distribution<std::uint32_t>(0, static_cast<std::uint32_t>(q_max))(rng),
+                           POSITION_MIN, POSITION_MAX, POSITION_RESOLUTION);
+        player.facing = decode_octahedral(rng() & ((std::uint64_t(1) << (2 * UNIT_VECTOR_BITS)) - 1), UNIT_VECTOR_BITS);
+        player.speed = half_to_float(float_to_half(std::uniform_real_distribution<float>(0, 30)(rng)));
+        player.score = std::uniform_real_distribution<double>(-1e9, 1e9)(rng);
+        player.vit.hp = std::uniform_int_distribution<int>(0, 100)(rng);
+        player.vit.mana = std::uniform_int_distribution<int>(0, 500)(rng);
+        player.vit.alive = std::uniform_int_distribution<int>(0, 1)(rng);
+        player.name.resize(std::uniform_int_distribution<std::size_t>(0, MAX_NAME_LENGTH)(rng));
+        for (char& c : player.name)
+            c = static_cast<char>(std::uniform_int_distribution<int>('a', 'z')(rng));
+        for (auto& byte : player.token)
+            byte = static_cast<std::uint8_t>(rng());
+    }
+
+    return snap;
+}
+
+/// @brief Tests that a single `serialize()` measures, writes and reads the same bits.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_serialize(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    const snapshot snap = generate_snapshot(rng);
+
+    // Size exactly.
+    const size_type bits = serialized_bits(snap);
+    const size_type logical_bytes_length = serialized_bytes(snap);
+    SR_ASSERT(logical_bytes_length == (bits + 7) / 8, "bits = ", bits, ", bytes = ", logical_bytes_length);
+
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> buffer(words_length);
+
+    Writer writer(buffer.data(), words_length, logical_bytes_length);
+    snapshot write_snap = snap;
+    SR_ASSERT(serialize(writer, write_snap).flush_final(), "writer failed");
+    SR_ASSERT(writer.used_bits() == bits, "measured bits = ", bits, ", written bits = ", writer.used_bits());
+
+    Reader reader(buffer.data(), words_length, logical_bytes_length);
+    snapshot read_snap;
+    SR_ASSERT(serialize(reader, read_snap), "reader failed");
+    SR_ASSERT(reader.used_bits() == bits, "read bits = ", reader.used_bits());
+
+    SR_ASSERT(read_snap.tick == snap.tick, "tick mismatch");
+    SR_ASSERT(read_snap.players.size() == snap.players.size(), "players count mismatch");
+    for (std::size_t i = 0; i < snap.players.size(); ++i)
+    {
+        const player_state& expected = snap.players[i];
+        const player_state& actual = read_snap.players[i];
+
+        SR_ASSERT(actual.id == expected.id && actual.gold == expected.gold && actual.ammo == expected.ammo,
+                  "player #", i, " integers mismatch");
+        SR_ASSERT(actual.speed == expected.speed && actual.score == expected.score, "player #", i, " floats mismatch");
+        SR_ASSERT(actual.vit == expected.vit, "player #", i, " vitals mismatch");
+        SR_ASSERT(actual.name == expected.name, "player #", i, " name mismatch");
+        SR_ASSERT(actual.token == expected.token, "player #", i, " token mismatch");
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            SR_ASSERT(std::abs(actual.position[axis] - expected.position[axis]) <= POSITION_RESOLUTION / 2,
+                      "player #", i, " position mismatch");
+            SR_ASSERT(std::abs(actual.facing[axis] - expected.facing[axis]) <= 1e-3f, "player #", i,
+                      " facing mismatch");
+        }
+    }
+
+    // Writing a string longer than `max_length` should fail, as reading it would fail.
+    if (!snap.players.empty())
+    {
+        snapshot long_name_snap = snap;
+        long_name_snap.players.back().name.assign(MAX_NAME_LENGTH + 1, 'x');
+
+        std::vector<word_type> long_buffer(words_length + 2);
+        Writer long_writer(long_buffer.data(), static_cast<size_type>(long_buffer.size()),
+                           static_cast<size_type>(sizeof(word_type) * long_buffer.size()));
+        SR_ASSERT(!serialize(long_writer, long_name_snap), "writer not failed on a long string");
+    }
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_serialize_all(const seed_type seed)
+{
+    test_serialize<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_serialize<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_serialize`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_serialize <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream serialize test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_serialize_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_serialize_all(rng());
+    }
+
+    std::cout << "bit_stream serialize test succeeded" << std::endl;
+}
@@ -0,0 +1,223 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define US_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, ", fields = ", fields.size(), \
+                        '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+constexpr std::size_t MAX_FIELDS = 256;
+
+/// @brief Field to write, which can be one of the supported types.
+struct field
+{
+    enum class kind
+    {
+        u8,
+        s16,
+        u32,
+        s64,
+        f32,
+        f64,
+        bytes,
+    };
+
+    kind type;
+    std::int64_t value;
+    std::int64_t min;
+    std::int64_t max;
+    double real;
+    std::vector<std::uint8_t> bytes;
+};
+
+/// @brief Generates random fields.
+/// @param rng Rng to use.
+/// @return Generated fields.
+auto generate_fields(rng_type& rng) -> std::vector<field>
+{
+    std::vector<field> fields(std::uniform_int_distribution<std::size_t>(0, MAX_FIELDS)(rng));
+
+    for (auto& f : fields)
+    {
+        f.type = static_cast<field::kind>(std::uniform_int_distribution<int>(0, 6)(rng));
+
+        switch (f.type)
+        {
+        case field::kind::u8:
+            f.min = std::uniform_int_distribution<std::int64_t>(0, 254)(rng);
+            f.max = std::uniform_int_distribution<std::int64_t>(f.min + 1, 255)(rng);
+            break;
+        case field::kind::s16:
+            f.min = std::uniform_int_distribution<std::int64_t>(INT16_MIN, INT16_MAX - 1)(rng);
+            f.max = std::uniform_int_distribution<std::int64_t>(f.min + 1, INT16_MAX)(rng);
+            break;
+        case field::kind::u32:
+            f.min = 0;
+            f.max = UINT32_MAX;
+            break;
+        case field::kind::s64:
+            f.min = std::uniform_int_distribution<std::int64_t>(INT64_MIN, INT64_MAX - 1)(rng);
+            f.max = std::uniform_int_distribution<std::int64_t>(f.min + 1, INT64_MAX)(rng);
+            break;
+        case field::kind::f32:
+        case field::kind::f64:
+            f.real = std::uniform_real_distribution<double>(-1e6, 1e6)(rng);
+            break;
+        case field::kind::bytes:
+            f.bytes.resize(std::uniform_int_distribution<std::size_t>(0, 32)(rng));
+            for (auto& byte : f.bytes)
+                byte = static_cast<std::uint8_t>(std::uniform_int_distribution<unsigned>(0, 255)(rng));
+            break;
+        }
+
+        if (f.type != field::kind::f32 && f.type != field::kind::f64 && f.type != field::kind::bytes)
+            f.value = std::uniform_int_distribution<std::int64_t>(f.min, f.max)(rng);
+    }
+
+    return fields;
+}
+
+/// @brief Writes the fields to the stream or session.
+/// @param stream Stream or session to write to.
+/// @param fields Fields to write.
+template <typename Stream>
+void write_fields(Stream& stream, const std::vector<field>& fields)
+{
+    for (const auto& f : fields)
+    {
+        switch (f.type)
+        {
+        case field::kind::u8:
+            stream.write(static_cast<std::uint8_t>(f.value), static_cast<std::uint8_t>(f.min),
+                         static_cast<std::uint8_t>(f.max));
+            break;
+        case field::kind::s16:
+            stream.write(static_cast<std::int16_t>(f.value), static_cast<std::int16_t>(f.min),
+                         static_cast<std::int16_t>(f.max));
+            break;
+        case field::kind::u32:
+            stream.write(static_cast<std::uint32_t>(f.value));
+            break;
+        case field::kind::s64:
+            stream.write(f.value, f.min, f.max);
+            break;
+        case field::kind::f32:
+            stream.write(static_cast<float>(f.real));
+            break;
+        case field::kind::f64:
+            stream.write(f.real);
+            break;
+        case field::kind::bytes:
+            stream.write(f.bytes.data(), static_cast<size_type>(f.bytes.size()));
+            break;
+        }
+    }
+}
+
+/// @brief Tests that `unchecked_session` produces bit-identical results to the checked writes.
+/// @param seed Internal seed to run the rng.
+void test_unchecked_session(const seed_type seed)
+{
+    rng_type rng(seed);
+
+    const std::vector<field> fields = generate_fields(rng);
+
+    // Size the buffer exactly with the measurer.
+    bit_stream_measurer measurer;
+    write_fields(measurer, fields);
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length =
+        (logical_bytes_length + sizeof(bit_stream_writer::word_type) - 1) / sizeof(bit_stream_writer::word_type);
+
+    std::vector<bit_stream_writer::word_type> checked_buffer(words_length, 0xCDCDCDCD);
+    std::vector<bit_stream_writer::word_type> unchecked_buffer(words_length, 0xCDCDCDCD);
+
+    // Write with the checked writes.
+    bit_stream_writer checked_writer(checked_buffer.data(), words_length, logical_bytes_length);
+    write_fields(checked_writer, fields);
+    US_ASSERT(checked_writer.flush_final(), "checked writer failed");
+
+    // Write with the unchecked session.
+    bit_stream_writer unchecked_writer(unchecked_buffer.data(), words_length, logical_bytes_length);
+    {
+        auto session = unchecked_writer.begin_unchecked(measurer.used_bits());
+        US_ASSERT(session, "session is invalid");
+        write_fields(session, fields);
+    }
+    US_ASSERT(unchecked_writer.flush_final(), "unchecked writer failed");
+
+    // Compare the writers.
+    US_ASSERT(checked_writer.used_bits() == unchecked_writer.used_bits(), "used bits mismatch, checked = ",
+              checked_writer.used_bits(), ", unchecked = ", unchecked_writer.used_bits());
+    US_ASSERT(checked_buffer == unchecked_buffer, "written buffer mismatch");
+
+    // Reserving more than the capacity should fail up front, and make the session no-op.
+    bit_stream_writer overflow_writer(unchecked_buffer.data(), words_length, logical_bytes_length);
+    {
+        auto session = overflow_writer.begin_unchecked(8 * logical_bytes_length + 1);
+        US_ASSERT(!session, "session is valid on reserved bits overflow");
+        write_fields(session, fields);
+    }
+    US_ASSERT(overflow_writer.fail(), "writer not failed on reserved bits overflow");
+    US_ASSERT(overflow_writer.used_bits() == 0, "invalid session wrote something");
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_unchecked_session`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_unchecked_session <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream unchecked session test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_unchecked_session(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_unchecked_session(rng());
+    }
+
+    std::cout << "bit_stream unchecked session test succeeded" << std::endl;
+}
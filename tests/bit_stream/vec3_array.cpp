@@ -0,0 +1,253 @@
+#include <nalchi/bit_stream.hpp>
+
+#include "../assert.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#ifndef BS_ITERATIONS
+#define BS_ITERATIONS 10000
+#endif
+
+#define V3_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using size_type = bit_stream_writer::size_type;
+
+using vector3 = std::array<float, 3>;
+
+constexpr std::size_t MAX_ELEMENTS = 700;
+
+/// @brief Tests that quantized 3D vector arrays are measured, written and read correctly,
+/// and they match the one by one `write_quantized()` bit by bit.
+/// @tparam Writer Bit stream writer type to test.
+/// @tparam Reader Bit stream reader type to test.
+/// @param seed Internal seed to run the rng.
+template <typename Writer, typename Reader>
+void test_vec3_array(const seed_type seed)
+{
+    using word_type = typename Writer::word_type;
+
+    rng_type rng(seed);
+
+    // Generate the bounds, which are sometimes same for every axis,
+    // so that both packing paths (a code per vector, and over 64 bits per vector) are tested.
+    const float resolution = std::pow(10.0f, std::uniform_real_distribution<float>(-3, 1)(rng));
+    const bool same_bounds = std::uniform_int_distribution<int>(0, 2)(rng) == 0;
+    vector3 min, max;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (same_bounds && axis > 0)
+        {
+            min[axis] = min[0];
+            max[axis] = max[0];
+            continue;
+        }
+
+        // Regenerate if the float rounding makes too many steps.
+        do
+        {
+            const int bits = std::uniform_int_distribution<int>(1, 32)(rng);
+            const std::uint64_t min_steps = std::uint64_t(1) << (bits - 1);
+            const std::uint64_t steps = std::uniform_int_distribution<std::uint64_t>(min_steps, 2 * min_steps - 1)(rng);
+
+            min[axis] = std::uniform_real_distribution<float>(-1000, 1000)(rng);
+            max[axis] = static_cast<float>(min[axis] + static_cast<double>(steps) * resolution);
+        } while (quantized_max(min[axis], max[axis], resolution) < 0);
+    }
+
+    std::vector<vector3> data(std::uniform_int_distribution<std::size_t>(0, MAX_ELEMENTS)(rng));
+    for (auto& vec : data)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            // Sometimes pick the bounds themselves.
+            switch (std::uniform_int_distribution<int>(0, 9)(rng))
+            {
+            case 0:
+                vec[axis] = min[axis];
+                break;
+            case 1:
+                vec[axis] = max[axis];
+                break;
+            default:
+                vec[axis] = std::uniform_real_distribution<float>(min[axis], max[axis])(rng);
+                break;
+            }
+        }
+    }
+
+    // Unaligned prefix, so that the array doesn't start on the word boundary.
+    const int prefix_bits = std::uniform_int_distribution<int>(1, 40)(rng);
+    const std::uint64_t prefix_max = (std::uint64_t(1) << prefix_bits) - 1;
+    const std::uint64_t prefix = rng() & prefix_max;
+
+    bit_stream_measurer measurer;
+    measurer.write(prefix, std::uint64_t(0), prefix_max);
+    measurer.write_vec3_array(data, min, max, resolution);
+
+    const size_type logical_bytes_length = std::max<size_type>(1, measurer.used_bytes());
+    const size_type words_length = (logical_bytes_length + sizeof(word_type) - 1) / sizeof(word_type);
+    std::vector<word_type> single_buffer(words_length);
+    std::vector<word_type> array_buffer(words_length);
+
+    // Write one by one.
+    Writer single_writer(single_buffer.data(), words_length, logical_bytes_length);
+    single_writer.write(prefix, std::uint64_t(0), prefix_max);
+    for (const auto& vec : data)
+        for (int axis = 0; axis < 3; ++axis)
+            single_writer.write_quantized(vec[axis], min[axis], max[axis], resolution);
+    V3_ASSERT(single_writer.flush_final(), "single writer failed");
+    V3_ASSERT(single_writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", single_writer.used_bits());
+
+    // Write as an array.
+    Writer array_writer(array_buffer.data(), words_length, logical_bytes_length);
+    array_writer.write(prefix, std::uint64_t(0), prefix_max);
+    array_writer.write_vec3_array(data, min, max, resolution);
+    V3_ASSERT(array_writer.flush_final(), "array writer failed");
+    V3_ASSERT(array_writer.used_bits() == measurer.used_bits(), "measured bits = ", measurer.used_bits(),
+              ", written bits = ", array_writer.used_bits());
+
+    V3_ASSERT(single_buffer == array_buffer, "array writer result differs from single writer");
+
+    // Read as an array, which should match the one by one reads exactly.
+    Reader single_reader(array_buffer.data(), words_length, logical_bytes_length);
+    Reader array_reader(array_buffer.data(), words_length, logical_bytes_length);
+
+    std::uint64_t read_prefix;
+    single_reader.read(read_prefix, std::uint64_t(0), prefix_max);
+    array_reader.read(read_prefix, std::uint64_t(0), prefix_max);
+
+    std::vector<vector3> read_data(data.size());
+    array_reader.read_vec3_array(read_data, min, max, resolution);
+    V3_ASSERT(array_reader, "array reader failed");
+    V3_ASSERT(array_reader.used_bits() == measurer.used_bits(), "read bits = ", array_reader.used_bits());
+
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float expected;
+            single_reader.read_quantized(expected, min[axis], max[axis], resolution);
+            V3_ASSERT(single_reader, "single read #", i, " failed");
+            V3_ASSERT(read_data[i][axis] == expected, "read #", i, ", axis = ", axis, ", expected = ", expected,
+                      ", got = ", read_data[i][axis]);
+        }
+    }
+
+    // Out of range, NaN and invalid ranges should fail, without writing anything.
+    if (!data.empty())
+    {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+
+        std::vector<vector3> invalid_data = data;
+        const std::size_t invalid_index = std::uniform_int_distribution<std::size_t>(0, data.size() - 1)(rng);
+        const int invalid_axis = std::uniform_int_distribution<int>(0, 2)(rng);
+        for (const float invalid_value : {nan, std::nextafter(max[invalid_axis], 1e30f),
+                                          std::nextafter(min[invalid_axis], -1e30f)})
+        {
+            invalid_data[invalid_index][invalid_axis] = invalid_value;
+
+            Writer fail_writer(array_buffer.data(), words_length, logical_bytes_length);
+            fail_writer.write_vec3_array(invalid_data, min, max, resolution);
+            V3_ASSERT(fail_writer.fail() && fail_writer.used_bits() == 0, "writer not failed on value = ",
+                      invalid_value);
+        }
+    }
+
+    vector3 invalid_max = max;
+    invalid_max[std::uniform_int_distribution<int>(0, 2)(rng)] = -2000;
+
+    Writer fail_writer(array_buffer.data(), words_length, logical_bytes_length);
+    fail_writer.write_vec3_array(data, min, invalid_max, resolution);
+    V3_ASSERT(fail_writer.fail(), "writer not failed on invalid range");
+
+    Reader fail_reader(array_buffer.data(), words_length, logical_bytes_length);
+    fail_reader.read_vec3_array(read_data, min, invalid_max, resolution);
+    V3_ASSERT(fail_reader.fail(), "reader not failed on invalid range");
+
+    bit_stream_measurer fail_measurer;
+    fail_measurer.write_vec3_array(data, min, invalid_max, resolution);
+    V3_ASSERT(fail_measurer.used_bits() == 0, "measurer counted ", fail_measurer.used_bits(),
+              " bits on invalid range");
+
+    // Quantized value exceeding the range should fail on read.
+    // `[0, 2]` with `0.5` resolution has 5 steps in 3 bits.
+    const vector3 small_min = {0, 0, 0};
+    const vector3 small_max = {2, 2, 2};
+
+    word_type raw_buffer[2] = {};
+
+    Writer raw_writer(raw_buffer, 2, sizeof(raw_buffer));
+    raw_writer.write(std::uint16_t(0b111'000'001), std::uint16_t(0), std::uint16_t(0b111'111'111));
+    V3_ASSERT(raw_writer.flush_final(), "raw writer failed");
+
+    Reader range_reader(raw_buffer, 2, sizeof(raw_buffer));
+    vector3 out_of_range[1];
+    range_reader.read_vec3_array(out_of_range, small_min, small_max, 0.5f);
+    V3_ASSERT(range_reader.fail(), "reader not failed on quantized value exceeding the range");
+}
+
+/// @brief Tests every bit stream variants.
+/// @param seed Internal seed to run the rng.
+void test_vec3_array_all(const seed_type seed)
+{
+    test_vec3_array<bit_stream_writer, bit_stream_reader>(seed);
+#if defined(NALCHI_HAS_WIDE_BIT_STREAM)
+    test_vec3_array<wide_bit_stream_writer, wide_bit_stream_reader>(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./bit_stream_vec3_array`\n";
+        std::cout << '\t' << "Runs the test " << BS_ITERATIONS << " times.\n";
+        std::cout << "`./bit_stream_vec3_array <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== bit_stream vec3 array test ===\n";
+
+    if (argc == 1 + 1)
+    {
+        const seed_type seed = static_cast<seed_type>(std::atoll(argv[1]));
+
+        std::cout << "Starting with seed = " << seed << " ...\n";
+
+        test_vec3_array_all(seed);
+    }
+    else
+    {
+        std::cout << "Starting " << BS_ITERATIONS << " iterations...\n";
+
+        rng_type rng(std::random_device{}());
+
+        for (std::size_t i = 0; i < BS_ITERATIONS; ++i)
+            test_vec3_array_all(rng());
+    }
+
+    std::cout << "bit_stream vec3 array test succeeded" << std::endl;
+}
@@ -0,0 +1,109 @@
+#include <nalchi/shared_payload.hpp>
+
+#include "../assert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#define AR_ASSERT(condition, ...) NALCHI_TESTS_ASSERT(condition __VA_OPT__(, ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using alloc_size_t = shared_payload::alloc_size_t;
+
+// Small enough to run out, so that the pool falls back to the global heap.
+constexpr std::size_t RESERVE_BYTES = 4 * 1024 * 1024;
+
+/// @brief Gets the name of the pages.
+auto name_of(shared_payload_arena_pages pages) -> const char*
+{
+    switch (pages)
+    {
+    case shared_payload_arena_pages::none:
+        return "none";
+    case shared_payload_arena_pages::normal:
+        return "normal";
+    case shared_payload_arena_pages::transparent_huge:
+        return "transparent huge";
+    case shared_payload_arena_pages::huge:
+        return "huge";
+    }
+    return "unknown";
+}
+
+/// @brief Fills the payload with the byte made from its index.
+void fill(const shared_payload& payload, std::size_t index)
+{
+    std::memset(payload.ptr, static_cast<int>(index & 0xFF), payload.word_ceiled_size());
+}
+
+/// @brief Checks the payload is not overwritten by another one.
+void verify(const shared_payload& payload, std::size_t index)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(payload.ptr);
+    const alloc_size_t size = payload.word_ceiled_size();
+
+    AR_ASSERT(bytes[0] == (index & 0xFF) && bytes[size - 1] == (index & 0xFF), "payload ", index,
+              " of size ", payload.size(), " overwritten");
+}
+
+/// @brief Tests that payloads more than the arena are allocated, on multiple threads.
+void test_allocations()
+{
+    constexpr int THREADS = 4;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([t] {
+            // Sizes spread over small & large classes, to carve slabs of many classes from the arena.
+            std::vector<shared_payload> payloads;
+            std::size_t total_bytes = 0;
+            for (std::size_t i = 0; total_bytes < 2 * RESERVE_BYTES; ++i)
+            {
+                const alloc_size_t size = static_cast<alloc_size_t>(1 + (i * 977 + t * 131) % 9000);
+                const shared_payload payload = shared_payload::allocate(size);
+                AR_ASSERT(payload.ptr && payload.size() == size, "allocation of size ", size, " failed");
+                AR_ASSERT(reinterpret_cast<std::uintptr_t>(payload.ptr) % sizeof(std::uint64_t) == 0,
+                          "payload not aligned to word");
+
+                fill(payload, i);
+                payloads.push_back(payload);
+                total_bytes += size;
+            }
+
+            for (std::size_t i = 0; i < payloads.size(); ++i)
+            {
+                verify(payloads[i], i);
+                shared_payload::force_deallocate(payloads[i]);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+}
+
+} // namespace nalchi::tests
+
+int main()
+{
+    using namespace nalchi;
+    using namespace nalchi::tests;
+
+    std::cout << "=== shared_payload arena test ===\n";
+
+    const shared_payload_arena_pages pages = shared_payload::init_arena(RESERVE_BYTES);
+    std::cout << "Arena pages: " << name_of(pages) << '\n';
+
+    // Reserved only once.
+    AR_ASSERT(shared_payload::init_arena(2 * RESERVE_BYTES) == pages, "second init changed the pages");
+
+    test_allocations();
+
+    std::cout << "shared_payload arena test succeeded" << std::endl;
+}
@@ -0,0 +1,442 @@
+#include <nalchi/shared_payload.hpp>
+
+#include "../assert.hpp"
+
+#include <steam/steamnetworkingtypes.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifndef PS_THREADS
+#define PS_THREADS 4
+#endif
+
+#ifndef PS_ITERATIONS
+#define PS_ITERATIONS 200000
+#endif
+
+#define PS_ASSERT(condition, ...) \
+    NALCHI_TESTS_ASSERT(condition, "seed = ", seed, '\n' __VA_OPT__(, '\t', ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using rng_type = std::mt19937_64;
+using seed_type = rng_type::result_type;
+
+using alloc_size_t = shared_payload::alloc_size_t;
+
+constexpr alloc_size_t MAX_SIZE = k_cbMaxSteamNetworkingSocketsMessageSizeSend;
+
+/// @brief Payloads handed over to be deallocated on another thread, like GameNetworkingSockets' service thread.
+struct handover
+{
+    std::mutex mutex;
+    std::vector<shared_payload> payloads;
+};
+
+/// @brief Generates a payload size, which is mostly small as in real game messages.
+auto generate_size(rng_type& rng) -> alloc_size_t
+{
+    const int kind = std::uniform_int_distribution<int>(0, 99)(rng);
+
+    if (kind < 70)
+        return std::uniform_int_distribution<alloc_size_t>(1, 128)(rng);
+    if (kind < 95)
+        return std::uniform_int_distribution<alloc_size_t>(129, 4096)(rng);
+    if (kind < 99)
+        return std::uniform_int_distribution<alloc_size_t>(4097, 64 * 1024)(rng);
+    return std::uniform_int_distribution<alloc_size_t>(64 * 1024 + 1, MAX_SIZE)(rng);
+}
+
+/// @brief Gets the byte to fill the payload with, which differs among the live payloads.
+auto pattern_of(const shared_payload& payload) -> std::byte
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(payload.ptr);
+    return static_cast<std::byte>((address >> 3) ^ payload.size());
+}
+
+/// @brief Fills the whole word-ceiled payload, which must be safe to access.
+void fill(const shared_payload& payload)
+{
+    std::memset(payload.ptr, static_cast<int>(pattern_of(payload)), payload.word_ceiled_size());
+}
+
+/// @brief Checks the payload is not overwritten by another one, then deallocates it.
+void verify_and_deallocate(const seed_type seed, const shared_payload payload)
+{
+    const std::byte pattern = pattern_of(payload);
+    const auto* bytes = static_cast<const std::byte*>(payload.ptr);
+
+    // Check only the both ends, as checking every byte of large payloads takes too long.
+    const alloc_size_t size = payload.word_ceiled_size();
+    const alloc_size_t checks = std::min<alloc_size_t>(size, 64);
+    for (alloc_size_t i = 0; i < checks; ++i)
+    {
+        PS_ASSERT(bytes[i] == pattern, "payload of size ", payload.size(), " overwritten at ", i);
+        PS_ASSERT(bytes[size - 1 - i] == pattern, "payload of size ", payload.size(), " overwritten at ",
+                  size - 1 - i);
+    }
+
+    shared_payload::force_deallocate(payload);
+}
+
+/// @brief Allocates, fills and deallocates payloads,
+/// handing some of them over to be deallocated on the next thread.
+/// @param seed Internal seed to run the rng.
+/// @param incoming Payloads handed over from the previous thread.
+/// @param outgoing Payloads to hand over to the next thread.
+void run_thread(const seed_type seed, handover& incoming, handover& outgoing)
+{
+    rng_type rng(seed);
+
+    std::vector<shared_payload> live;
+    std::vector<shared_payload> received;
+
+    for (int i = 0; i < PS_ITERATIONS; ++i)
+    {
+        const alloc_size_t size = generate_size(rng);
+        const bool wide = std::uniform_int_distribution<int>(0, 1)(rng);
+        const shared_payload payload = wide ? shared_payload::allocate_wide(size) : shared_payload::allocate(size);
+        const alloc_size_t word_size = wide ? sizeof(std::uint64_t) : sizeof(std::uint32_t);
+
+        PS_ASSERT(payload.ptr, "allocation of size ", size, " failed");
+        PS_ASSERT(reinterpret_cast<std::uintptr_t>(payload.ptr) % sizeof(std::uint64_t) == 0,
+                  "payload not aligned to word");
+        PS_ASSERT(payload.size() == size, "size = ", payload.size(), ", expected = ", size);
+        PS_ASSERT(payload.word_ceiled_size() >= size && payload.word_ceiled_size() < size + word_size &&
+                      payload.word_ceiled_size() % word_size == 0,
+                  "word_ceiled_size = ", payload.word_ceiled_size(), ", wide = ", wide);
+        PS_ASSERT(payload.internal_alloc_size() >= payload.word_ceiled_size(),
+                  "internal_alloc_size = ", payload.internal_alloc_size());
+        PS_ASSERT(!payload.used_bit_stream(), "new payload marked as used bit stream");
+
+        fill(payload);
+        live.push_back(payload);
+
+        const int action = std::uniform_int_distribution<int>(0, 9)(rng);
+        if (action < 4 && !live.empty())
+        {
+            // Deallocate a random live payload on this thread.
+            const std::size_t index = std::uniform_int_distribution<std::size_t>(0, live.size() - 1)(rng);
+            std::swap(live[index], live.back());
+            verify_and_deallocate(seed, live.back());
+            live.pop_back();
+        }
+        else if (action < 8 && !live.empty())
+        {
+            // Hand a random live payload over to the next thread.
+            const std::size_t index = std::uniform_int_distribution<std::size_t>(0, live.size() - 1)(rng);
+            std::swap(live[index], live.back());
+            {
+                std::lock_guard lock(outgoing.mutex);
+                outgoing.payloads.push_back(live.back());
+            }
+            live.pop_back();
+        }
+
+        // Deallocate the payloads handed over from the previous thread.
+        if (i % 64 == 0)
+        {
+            {
+                std::lock_guard lock(incoming.mutex);
+                received.swap(incoming.payloads);
+            }
+            for (const shared_payload& p : received)
+                verify_and_deallocate(seed, p);
+            received.clear();
+        }
+
+        // Keep the number of live payloads bounded.
+        if (live.size() > 1024)
+        {
+            for (const shared_payload& p : live)
+                verify_and_deallocate(seed, p);
+            live.clear();
+        }
+    }
+
+    for (const shared_payload& p : live)
+        verify_and_deallocate(seed, p);
+}
+
+/// @brief Tests the allocation size limits.
+/// @param seed Internal seed to run the rng.
+void test_size_limits(const seed_type seed)
+{
+    PS_ASSERT(!shared_payload::allocate(0).ptr, "allocation of size 0 succeeded");
+    PS_ASSERT(!shared_payload::allocate(MAX_SIZE + 1).ptr, "allocation of size ", MAX_SIZE + 1, " succeeded");
+
+    for (const alloc_size_t size : {alloc_size_t(1), alloc_size_t(8), alloc_size_t(64), alloc_size_t(65), MAX_SIZE})
+    {
+        const shared_payload payload = shared_payload::allocate(size);
+        PS_ASSERT(payload.ptr && payload.size() == size, "allocation of size ", size, " failed");
+        fill(payload);
+        verify_and_deallocate(seed, payload);
+
+        const shared_payload wide_payload = shared_payload::allocate_wide(size);
+        PS_ASSERT(wide_payload.ptr && wide_payload.size() == size, "wide allocation of size ", size, " failed");
+        fill(wide_payload);
+        verify_and_deallocate(seed, wide_payload);
+    }
+
+    // Only the wide payloads are ceiled to 8 bytes.
+    for (const alloc_size_t size : {alloc_size_t(1), alloc_size_t(4), alloc_size_t(5), alloc_size_t(12)})
+    {
+        const shared_payload payload = shared_payload::allocate(size);
+        PS_ASSERT(payload.word_ceiled_size() == (size + 3) / 4 * 4, "word_ceiled_size = ", payload.word_ceiled_size(),
+                  ", size = ", size);
+        shared_payload::force_deallocate(payload);
+
+        const shared_payload wide_payload = shared_payload::allocate_wide(size);
+        PS_ASSERT(wide_payload.word_ceiled_size() == (size + 7) / 8 * 8,
+                  "wide word_ceiled_size = ", wide_payload.word_ceiled_size(), ", size = ", size);
+        shared_payload::force_deallocate(wide_payload);
+    }
+}
+
+/// @brief Tests allocations & deallocations on multiple threads,
+/// where some payloads are deallocated on the other threads.
+/// @param seed Internal seed to run the rng.
+void test_handover(const seed_type seed)
+{
+    std::vector<handover> handovers(PS_THREADS);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < PS_THREADS; ++t)
+        threads.emplace_back(run_thread, seed + t, std::ref(handovers[t]), std::ref(handovers[(t + 1) % PS_THREADS]));
+    for (auto& thread : threads)
+        thread.join();
+
+    // Deallocate the leftovers, after their threads are gone.
+    for (auto& h : handovers)
+        for (const shared_payload& p : h.payloads)
+            verify_and_deallocate(seed, p);
+}
+
+/// @brief Tests that payloads are deallocated only on a thread which never allocates,
+/// like GameNetworkingSockets' service thread.
+/// @param seed Internal seed to run the rng.
+void test_release_thread(const seed_type seed)
+{
+    handover queue;
+    std::atomic<int> running_producers = PS_THREADS;
+
+    std::thread releaser([&] {
+        std::vector<shared_payload> received;
+        for (;;)
+        {
+            const bool last = (running_producers.load() == 0);
+            {
+                std::lock_guard lock(queue.mutex);
+                received.swap(queue.payloads);
+            }
+            for (const shared_payload& p : received)
+                verify_and_deallocate(seed, p);
+            received.clear();
+
+            if (last)
+                return;
+            std::this_thread::yield();
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < PS_THREADS; ++t)
+    {
+        producers.emplace_back([&, t] {
+            rng_type rng(seed + PS_THREADS + t);
+            std::vector<shared_payload> batch;
+
+            for (int i = 0; i < PS_ITERATIONS; ++i)
+            {
+                const shared_payload payload = shared_payload::allocate(generate_size(rng));
+                PS_ASSERT(payload.ptr, "allocation failed");
+                fill(payload);
+                batch.push_back(payload);
+
+                if (batch.size() == 32 || i == PS_ITERATIONS - 1)
+                {
+                    std::lock_guard lock(queue.mutex);
+                    queue.payloads.insert(queue.payloads.end(), batch.begin(), batch.end());
+                    batch.clear();
+                }
+            }
+
+            --running_producers;
+        });
+    }
+
+    for (auto& producer : producers)
+        producer.join();
+    releaser.join();
+}
+
+/// @brief Tests that payloads are deallocated after their allocating threads exit,
+/// while new threads are reusing their pools.
+/// @param seed Internal seed to run the rng.
+void test_thread_exit(const seed_type seed)
+{
+    constexpr int ROUNDS = 16;
+    constexpr int PAYLOADS_PER_ROUND = 2048;
+
+    std::vector<shared_payload> leftovers;
+
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        std::vector<shared_payload> kept;
+
+        std::thread thread([&] {
+            rng_type rng(seed + 2 * PS_THREADS + round);
+            for (int i = 0; i < PAYLOADS_PER_ROUND; ++i)
+            {
+                const shared_payload payload = shared_payload::allocate(generate_size(rng));
+                PS_ASSERT(payload.ptr, "allocation failed");
+                fill(payload);
+
+                if (i % 2 == 0)
+                    kept.push_back(payload);
+                else
+                    verify_and_deallocate(seed, payload);
+            }
+        });
+
+        // Deallocate the payloads of the previous thread, while the next thread is allocating.
+        for (const shared_payload& p : leftovers)
+            verify_and_deallocate(seed, p);
+        leftovers.clear();
+
+        thread.join();
+        leftovers.swap(kept);
+    }
+
+    for (const shared_payload& p : leftovers)
+        verify_and_deallocate(seed, p);
+}
+
+#if defined(NALCHI_PAYLOAD_POOL)
+/// @brief Tests that fewer payloads than a remote batch, deallocated on another thread which stays alive,
+/// are still reused by the allocating thread.
+/// @param seed Internal seed to run the rng.
+void test_partial_remote_batch(const seed_type seed)
+{
+    constexpr int PAYLOADS = 10;
+    constexpr int MAX_ALLOCATIONS = 4096;
+
+    struct partial_case
+    {
+        alloc_size_t size;
+        bool flush; ///< Whether to call `shared_payload::flush_remote_frees()` after deallocating.
+    };
+
+    // Small ones are held back until flushed, while each large one exceeds the bytes of a batch by itself.
+    for (const partial_case c : {partial_case{100, true}, partial_case{64 * 1024, false}})
+    {
+        std::vector<shared_payload> payloads;
+        std::vector<const void*> addresses;
+        std::atomic<int> stage = 0;
+
+        auto wait_for = [&stage](int target) {
+            while (stage.load() != target)
+                std::this_thread::yield();
+        };
+
+        std::thread allocator([&] {
+            for (int i = 0; i < PAYLOADS; ++i)
+            {
+                const shared_payload payload = shared_payload::allocate(c.size);
+                PS_ASSERT(payload.ptr, "allocation failed");
+                fill(payload);
+                payloads.push_back(payload);
+                addresses.push_back(payload.ptr);
+            }
+            stage = 1;
+            wait_for(2);
+
+            // Allocate until all of them are reused, which needs a cache miss to take the returned ones.
+            std::vector<shared_payload> kept;
+            int reused = 0;
+            for (int i = 0; i < MAX_ALLOCATIONS && reused < PAYLOADS; ++i)
+            {
+                const shared_payload payload = shared_payload::allocate(c.size);
+                PS_ASSERT(payload.ptr, "allocation failed");
+                if (std::find(addresses.begin(), addresses.end(), payload.ptr) != addresses.end())
+                    ++reused;
+                kept.push_back(payload);
+            }
+            PS_ASSERT(reused == PAYLOADS, "only ", reused, " of ", PAYLOADS, " payloads of size ", c.size,
+                      " reused");
+
+            for (const shared_payload& p : kept)
+                shared_payload::force_deallocate(p);
+            stage = 3;
+        });
+
+        // Deallocate them on another thread, which stays alive until the check is done,
+        // as the thread exit returns the held back ones anyway.
+        std::thread releaser([&] {
+            wait_for(1);
+            for (const shared_payload& p : payloads)
+                verify_and_deallocate(seed, p);
+            if (c.flush)
+                shared_payload::flush_remote_frees();
+            stage = 2;
+            wait_for(3);
+        });
+
+        allocator.join();
+        releaser.join();
+    }
+}
+#endif
+
+/// @brief Runs all the tests.
+/// @param seed Internal seed to run the rng.
+void test_pool_stress(const seed_type seed)
+{
+    test_size_limits(seed);
+    test_handover(seed);
+    test_release_thread(seed);
+    test_thread_exit(seed);
+#if defined(NALCHI_PAYLOAD_POOL)
+    test_partial_remote_batch(seed);
+#endif
+}
+
+} // namespace nalchi::tests
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "=== Usage ===\n";
+        std::cout << "`./shared_payload_pool_stress`\n";
+        std::cout << '\t' << "Runs the test with a random seed.\n";
+        std::cout << "`./shared_payload_pool_stress <seed>`\n";
+        std::cout << '\t' << "Runs the test with specified <seed>.\n";
+        return 2;
+    }
+
+    using namespace nalchi::tests;
+
+    std::cout << "=== shared_payload pool stress test ===\n";
+
+    const seed_type seed =
+        (argc == 1 + 1) ? static_cast<seed_type>(std::atoll(argv[1])) : static_cast<seed_type>(std::random_device{}());
+
+    std::cout << "Starting with seed = " << seed << ", " << PS_THREADS << " threads ...\n";
+
+    test_pool_stress(seed);
+
+    std::cout << "shared_payload pool stress test succeeded" << std::endl;
+}
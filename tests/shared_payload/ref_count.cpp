@@ -0,0 +1,209 @@
+#include <nalchi/shared_payload.hpp>
+
+#include "../assert.hpp"
+
+#include <steam/steamnetworkingtypes.h>
+
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#define RC_ASSERT(condition, ...) NALCHI_TESTS_ASSERT(condition __VA_OPT__(, ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using alloc_size_t = shared_payload::alloc_size_t;
+
+// Hack to access private functions of an arbitrary class.
+// See https://www.worldcadaccess.com/blog/2020/05/how-to-hack-c-with-templates-and-friends.html
+template <void (shared_payload::*AddToMessage)(SteamNetworkingMessage_t*, int),
+          void (shared_payload::*SetRefCountBeforeSend)(std::int32_t),
+          auto (shared_payload::*RefCount)() -> shared_payload::ref_count_t&>
+struct shared_payload_private_accessor
+{
+    friend void add_to_message(shared_payload& payload, SteamNetworkingMessage_t* msg, int logical_bytes_length)
+    {
+        (payload.*AddToMessage)(msg, logical_bytes_length);
+    }
+
+    friend void set_ref_count_before_send(shared_payload& payload, std::int32_t count)
+    {
+        (payload.*SetRefCountBeforeSend)(count);
+    }
+
+    friend auto get_ref_count(shared_payload& payload) -> shared_payload::ref_count_t&
+    {
+        return (payload.*RefCount)();
+    }
+};
+
+template struct shared_payload_private_accessor<&shared_payload::add_to_message,
+                                                &shared_payload::set_ref_count_before_send,
+                                                &shared_payload::ref_count>;
+
+void add_to_message(shared_payload& payload, SteamNetworkingMessage_t* msg, int logical_bytes_length);
+void set_ref_count_before_send(shared_payload& payload, std::int32_t count);
+auto get_ref_count(shared_payload& payload) -> shared_payload::ref_count_t&;
+
+/// @brief Message owned by the test instead of GameNetworkingSockets, which releases its payload on `release()`.
+struct test_message : SteamNetworkingMessage_t
+{
+    test_message() : SteamNetworkingMessage_t()
+    {
+    }
+
+    void release()
+    {
+        m_pfnFreeData(this);
+    }
+};
+
+/// @brief Adds @p payload to @p count messages, and sets the ref count as `socket_extensions` does.
+auto make_messages(shared_payload payload, int count) -> std::vector<test_message>
+{
+    std::vector<test_message> messages(static_cast<std::size_t>(count));
+    for (test_message& msg : messages)
+        add_to_message(payload, &msg, static_cast<int>(payload.size()));
+
+    set_ref_count_before_send(payload, count);
+    return messages;
+}
+
+/// @brief Tests that a unicast message deallocates the payload on release,
+/// through the single reference fast path.
+void test_unicast()
+{
+    constexpr alloc_size_t SIZE = 100;
+
+    shared_payload::enable_stats(true);
+    const shared_payload_stats before = shared_payload::stats();
+
+    shared_payload payload = shared_payload::allocate(SIZE);
+    RC_ASSERT(payload.ptr, "allocation failed");
+
+    std::vector<test_message> messages = make_messages(payload, 1);
+    RC_ASSERT(messages[0].m_pData == payload.ptr && messages[0].m_cbSize == static_cast<int>(SIZE),
+              "message not set to the payload");
+    RC_ASSERT(get_ref_count(payload).load() == 1, "ref count = ", get_ref_count(payload).load(), ", expected = 1");
+
+    messages[0].release();
+
+    const shared_payload_stats after = shared_payload::stats();
+    RC_ASSERT(after.deallocations - before.deallocations == 1, "payload not deallocated on unicast release");
+    RC_ASSERT(after.live_payloads == before.live_payloads, "live_payloads = ", after.live_payloads,
+              ", expected = ", before.live_payloads);
+
+    shared_payload::enable_stats(false);
+}
+
+/// @brief Tests that a multicast payload is deallocated only on the last release.
+void test_multicast()
+{
+    constexpr int MESSAGES = 64;
+    constexpr int ROUNDS = 1000;
+    constexpr alloc_size_t SIZE = 1200;
+
+    shared_payload::enable_stats(true);
+    const shared_payload_stats before = shared_payload::stats();
+
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        shared_payload payload = shared_payload::allocate(SIZE);
+        RC_ASSERT(payload.ptr, "allocation failed");
+
+        std::vector<test_message> messages = make_messages(payload, MESSAGES);
+        for (int i = 0; i < MESSAGES - 1; ++i)
+        {
+            messages[i].release();
+            RC_ASSERT(get_ref_count(payload).load() == MESSAGES - 1 - i, "ref count = ",
+                      get_ref_count(payload).load(), ", expected = ", MESSAGES - 1 - i);
+        }
+        RC_ASSERT(shared_payload::stats().deallocations == before.deallocations + round,
+                  "payload deallocated before the last release");
+        messages[MESSAGES - 1].release();
+    }
+
+    const shared_payload_stats after = shared_payload::stats();
+    RC_ASSERT(after.deallocations - before.deallocations == ROUNDS, "deallocations = ",
+              after.deallocations - before.deallocations, ", expected = ", ROUNDS);
+    RC_ASSERT(after.live_payloads == before.live_payloads, "live_payloads = ", after.live_payloads,
+              ", expected = ", before.live_payloads);
+
+    shared_payload::enable_stats(false);
+}
+
+/// @brief Tests that a multicast payload released on many threads at once is deallocated after all the accesses
+/// through the other messages.
+///
+/// The threads synchronize only between the rounds, so within a round, only the release ordering of the ref count
+/// orders the accesses before the deallocation. \n
+/// Run this with ThreadSanitizer (`NALCHI_TSAN`) to check the ordering.
+void test_multicast_threads()
+{
+    constexpr int THREADS = 4;
+    constexpr int MESSAGES = 64;
+    constexpr int ROUNDS = 2000;
+    constexpr alloc_size_t SIZE = 1200;
+
+    std::vector<test_message> messages;
+    std::barrier sync(THREADS + 1);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int round = 0; round < ROUNDS; ++round)
+            {
+                sync.arrive_and_wait();
+
+                // Access the payload through each message before releasing it.
+                for (int i = t; i < MESSAGES; i += THREADS)
+                {
+                    auto* data = static_cast<std::byte*>(messages[i].m_pData);
+                    RC_ASSERT(data[i] == std::byte(i), "payload content changed before release");
+                    data[i] = std::byte(~i);
+                    messages[i].release();
+                }
+
+                sync.arrive_and_wait();
+            }
+        });
+    }
+
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        shared_payload payload = shared_payload::allocate(SIZE);
+        RC_ASSERT(payload.ptr, "allocation failed");
+
+        // Write the content before sending, as the sending thread does.
+        for (int i = 0; i < MESSAGES; ++i)
+            static_cast<std::byte*>(payload.ptr)[i] = std::byte(i);
+
+        messages = make_messages(payload, MESSAGES);
+
+        sync.arrive_and_wait();
+        sync.arrive_and_wait();
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+} // namespace nalchi::tests
+
+int main()
+{
+    using namespace nalchi::tests;
+
+    std::cout << "=== shared_payload ref count test ===\n";
+
+    test_unicast();
+    test_multicast();
+    test_multicast_threads();
+
+    std::cout << "shared_payload ref count test succeeded" << std::endl;
+}
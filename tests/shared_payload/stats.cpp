@@ -0,0 +1,192 @@
+#include <nalchi/shared_payload.hpp>
+
+#include "../assert.hpp"
+
+#include <steam/steamnetworkingtypes.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#define ST_ASSERT(condition, ...) NALCHI_TESTS_ASSERT(condition __VA_OPT__(, ) __VA_ARGS__)
+
+namespace nalchi::tests
+{
+
+using alloc_size_t = shared_payload::alloc_size_t;
+
+constexpr alloc_size_t MAX_SIZE = k_cbMaxSteamNetworkingSocketsMessageSizeSend;
+
+/// @brief Checks that the counters changed by the expected amounts.
+void assert_diff(const shared_payload_stats& before, const shared_payload_stats& after, std::uint64_t allocations,
+                 std::uint64_t failed_allocations, std::uint64_t deallocations, std::uint64_t live_payloads,
+                 std::uint64_t live_bytes)
+{
+    ST_ASSERT(after.allocations - before.allocations == allocations, "allocations = ",
+              after.allocations - before.allocations, ", expected = ", allocations);
+    ST_ASSERT(after.failed_allocations - before.failed_allocations == failed_allocations, "failed_allocations = ",
+              after.failed_allocations - before.failed_allocations, ", expected = ", failed_allocations);
+    ST_ASSERT(after.deallocations - before.deallocations == deallocations, "deallocations = ",
+              after.deallocations - before.deallocations, ", expected = ", deallocations);
+    ST_ASSERT(after.live_payloads == live_payloads, "live_payloads = ", after.live_payloads,
+              ", expected = ", live_payloads);
+    ST_ASSERT(after.live_bytes == live_bytes, "live_bytes = ", after.live_bytes, ", expected = ", live_bytes);
+    ST_ASSERT(after.peak_live_bytes >= after.live_bytes, "peak_live_bytes = ", after.peak_live_bytes,
+              ", live_bytes = ", after.live_bytes);
+}
+
+/// @brief Tests that nothing is counted while disabled.
+void test_disabled()
+{
+    const shared_payload_stats before = shared_payload::stats();
+
+    const shared_payload payload = shared_payload::allocate(100);
+    ST_ASSERT(payload.ptr, "allocation failed");
+    ST_ASSERT(!shared_payload::allocate(0).ptr, "allocation of size 0 succeeded");
+    shared_payload::force_deallocate(payload);
+
+    assert_diff(before, shared_payload::stats(), 0, 0, 0, 0, 0);
+}
+
+/// @brief Tests the counters & histogram of the allocations on a single thread.
+void test_single_thread()
+{
+    shared_payload::enable_stats(true);
+    const shared_payload_stats before = shared_payload::stats();
+
+    std::vector<shared_payload> payloads;
+    for (const alloc_size_t size : {alloc_size_t(1), alloc_size_t(2), alloc_size_t(3), alloc_size_t(4),
+                                    alloc_size_t(1200), MAX_SIZE})
+    {
+        const shared_payload payload = shared_payload::allocate(size);
+        ST_ASSERT(payload.ptr && payload.size() == size, "allocation of size ", size, " failed");
+        ST_ASSERT(!payload.used_bit_stream(), "counted payload marked as used bit stream");
+        payloads.push_back(payload);
+    }
+    ST_ASSERT(!shared_payload::allocate(0).ptr, "allocation of size 0 succeeded");
+    ST_ASSERT(!shared_payload::allocate(MAX_SIZE + 1).ptr, "allocation of size ", MAX_SIZE + 1, " succeeded");
+
+    const std::uint64_t total_bytes = 1 + 2 + 3 + 4 + 1200 + MAX_SIZE;
+
+    const shared_payload_stats allocated = shared_payload::stats();
+    assert_diff(before, allocated, 6, 2, 0, 6, total_bytes);
+    ST_ASSERT(allocated.peak_live_bytes >= total_bytes, "peak_live_bytes = ", allocated.peak_live_bytes);
+
+    // 1 -> 0, 2 -> 1, 3 & 4 -> 2, 1200 -> 11, 512 KiB -> 19
+    const std::uint64_t expected_histogram[shared_payload_stats::SIZE_HISTOGRAM_BUCKETS] = {
+        1, 1, 2, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1,
+    };
+    for (std::size_t i = 0; i < shared_payload_stats::SIZE_HISTOGRAM_BUCKETS; ++i)
+    {
+        const std::uint64_t count = allocated.size_histogram[i] - before.size_histogram[i];
+        ST_ASSERT(count == expected_histogram[i], "size_histogram[", i, "] = ", count,
+                  ", expected = ", expected_histogram[i]);
+    }
+
+    for (const shared_payload& payload : payloads)
+        shared_payload::force_deallocate(payload);
+
+    const shared_payload_stats deallocated = shared_payload::stats();
+    assert_diff(before, deallocated, 6, 2, 6, 0, 0);
+    ST_ASSERT(deallocated.peak_live_bytes >= total_bytes, "peak_live_bytes = ", deallocated.peak_live_bytes);
+
+    shared_payload::enable_stats(false);
+}
+
+/// @brief Tests that a payload is counted on deallocation only if its allocation was counted,
+/// even when the stats are toggled in between.
+void test_toggle()
+{
+    const shared_payload_stats before = shared_payload::stats();
+
+    const shared_payload uncounted = shared_payload::allocate(10);
+    shared_payload::enable_stats(true);
+    const shared_payload counted = shared_payload::allocate(20);
+    ST_ASSERT(uncounted.ptr && counted.ptr, "allocation failed");
+    ST_ASSERT(counted.size() == 20, "size = ", counted.size(), ", expected = 20");
+
+    shared_payload::force_deallocate(uncounted);
+    assert_diff(before, shared_payload::stats(), 1, 0, 0, 1, 20);
+
+    shared_payload::enable_stats(false);
+    shared_payload::force_deallocate(counted);
+    assert_diff(before, shared_payload::stats(), 1, 0, 1, 0, 0);
+}
+
+/// @brief Tests that payloads deallocated on another thread are counted,
+/// and the counters of the exited threads are kept.
+void test_threads()
+{
+    constexpr int THREADS = 4;
+    constexpr int PAYLOADS_PER_THREAD = 10000;
+    constexpr alloc_size_t SIZE = 100;
+
+    shared_payload::enable_stats(true);
+    const shared_payload_stats before = shared_payload::stats();
+
+    std::vector<std::vector<shared_payload>> payloads(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < PAYLOADS_PER_THREAD; ++i)
+            {
+                const shared_payload payload = shared_payload::allocate(SIZE);
+                ST_ASSERT(payload.ptr, "allocation failed");
+                payloads[t].push_back(payload);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    threads.clear();
+
+    const std::uint64_t total = std::uint64_t(THREADS) * PAYLOADS_PER_THREAD;
+
+    const shared_payload_stats allocated = shared_payload::stats();
+    assert_diff(before, allocated, total, 0, 0, total, total * SIZE);
+
+    // Deallocate on the other threads, while collecting the stats.
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (const shared_payload& payload : payloads[(t + 1) % THREADS])
+                shared_payload::force_deallocate(payload);
+        });
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        const shared_payload_stats stats = shared_payload::stats();
+        ST_ASSERT(stats.live_bytes <= total * SIZE, "live_bytes = ", stats.live_bytes);
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    const shared_payload_stats deallocated = shared_payload::stats();
+    assert_diff(before, deallocated, total, 0, total, 0, 0);
+
+    // The peak is only flushed every 64 KiB per thread.
+    constexpr std::uint64_t PEAK_SLACK = 64 * 1024;
+    ST_ASSERT(deallocated.peak_live_bytes + THREADS * PEAK_SLACK >= total * SIZE, "peak_live_bytes = ",
+              deallocated.peak_live_bytes);
+
+    shared_payload::enable_stats(false);
+}
+
+} // namespace nalchi::tests
+
+int main()
+{
+    using namespace nalchi::tests;
+
+    std::cout << "=== shared_payload stats test ===\n";
+
+    test_disabled();
+    test_single_thread();
+    test_toggle();
+    test_threads();
+
+    std::cout << "shared_payload stats test succeeded" << std::endl;
+}